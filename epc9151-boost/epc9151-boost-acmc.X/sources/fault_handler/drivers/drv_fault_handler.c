@@ -236,3 +236,505 @@ volatile uint16_t fault_check(volatile FAULT_OBJECT_t* fltobj) {
     
     return (fres); // Fault handler executed successfully
 }
+
+/*!flt_engine_initialize()
+ *****************************************************************************
+ * Function:	 uint16_t flt_engine_initialize(volatile FLT_ENGINE_t* engine, 
+ *                  const FLT_DEFINITION_t* table, uint16_t size, uint16_t init_status)
+ * Arguments:	 FLT_ENGINE_t* engine, FLT_DEFINITION_t* table, uint16_t size, uint16_t init_status
+ * Return Value: Unsigned Integer (1=success, 0=error)
+ *
+ * Summary:
+ * Binds a fault definition table to a fault engine object
+ *
+ * Description:
+ * The table is checked for size and order of comparison types and the group
+ * boundaries are determined. Filter settings of faults using integrating
+ * fault event filters are validated. All fault checks are enabled. Faults set in 
+ * init_status are initialized as tripped and have to be cleared by the 
+ * fault engine before the power supply can be started. References of 
+ * DEVIATION checks have to be set by the user. Trip and reset levels are
+ * copied into the engine object, where they can be changed at runtime.
+ *
+ *****************************************************************************/
+
+volatile uint16_t flt_engine_initialize(volatile FLT_ENGINE_t* engine, 
+                const FLT_DEFINITION_t* table, volatile uint16_t size, volatile uint16_t init_status)
+{
+    volatile uint16_t _i=0, _group=0;
+    volatile uint16_t _mask=0, _filtered=0;
+    
+    if ((engine == NULL) || (table == NULL)) return(0);
+    if ((size == 0) || (size > FLT_ENGINE_SIZE_MAX)) return(0);
+    
+    for (_i=0; _i<FLT_ENGINE_GROUPS; _i++)
+    { engine->group_end[_i] = 0; }
+    
+    // Determine group boundaries (table has to be sorted by comparison type)
+    for (_i=0; _i<size; _i++)
+    {
+        if (table[_i].source == NULL) return(0);
+        
+        switch (table[_i].type)
+        {
+            case FLTCMP_GREATER_THAN: 
+                if (_group > 0) return(0);
+                break;
+            case FLTCMP_LESS_THAN:
+                if (_group > 1) return(0);
+                _group = 1;
+                break;
+            case FLTCMP_DEVIATION:
+                _group = 2;
+                break;
+            default: // Comparison type not supported by fault engine
+                return(0);
+        }
+        
+        // Validate fault event filter settings
+        switch (table[_i].filter)
+        {
+            case FLTFILTER_CONSECUTIVE:
+                break;
+            case FLTFILTER_LEAKY_BUCKET:
+                if ((table[_i].tripcnt_max == 0) || (table[_i].rstcnt_max == 0)) return(0);
+                _filtered |= (1 << _i);
+                break;
+            case FLTFILTER_N_OF_M:
+                if ((table[_i].window == 0) || (table[_i].window > FLT_FILTER_WINDOW_MAX)) return(0);
+                if ((table[_i].tripcnt_max == 0) || (table[_i].rstcnt_max == 0)) return(0);
+                if ((table[_i].tripcnt_max > table[_i].window) || (table[_i].rstcnt_max > table[_i].window)) return(0);
+                _filtered |= (1 << _i);
+                break;
+            default: // Filter mode not supported by fault engine
+                return(0);
+        }
+        
+        engine->group_end[_group] = (_i + 1);
+        engine->reference[_i] = NULL;
+        engine->trip_level[_i] = table[_i].trip_level;
+        engine->reset_level[_i] = table[_i].reset_level;
+        engine->counter[_i] = 0;
+    }
+    
+    // Empty groups end where the previous group ends
+    if (engine->group_end[1] < engine->group_end[0]) engine->group_end[1] = engine->group_end[0];
+    if (engine->group_end[2] < engine->group_end[1]) engine->group_end[2] = engine->group_end[1];
+    
+    _mask = (size < 16) ? ((1 << size) - 1) : 0xFFFF;
+    
+    engine->table = table;
+    engine->size = size;
+    engine->enabled = _mask;
+    engine->status = (init_status & _mask);
+    engine->active = engine->status;
+    engine->counting = 0;
+    engine->filtered = _filtered;
+    engine->tripped = 0;
+    engine->cleared = 0;
+    
+    return(1);
+}
+
+/*!flt_engine_enable()
+ *****************************************************************************
+ * Function:	 uint16_t flt_engine_enable(volatile FLT_ENGINE_t* engine, uint16_t index, bool enable)
+ * Arguments:	 FLT_ENGINE_t* engine, uint16_t index, bool enable
+ * Return Value: Unsigned Integer (1=success, 0=error)
+ *
+ * Summary:
+ * Enables or disables a single fault check
+ *
+ * Description:
+ * When a fault check is disabled, its immediate fault condition and fault 
+ * status are cleared by the next pass of the fault engine without calling
+ * the user-defined reset response.
+ *
+ *****************************************************************************/
+
+volatile uint16_t flt_engine_enable(volatile FLT_ENGINE_t* engine, volatile uint16_t index, volatile bool enable)
+{
+    if (engine == NULL) return(0);
+    if (index >= engine->size) return(0);
+    
+    if (enable)
+        engine->enabled |= (1 << index);
+    else
+        engine->enabled &= ~(1 << index);
+    
+    return(1);
+}
+
+/*!flt_bit_count()
+ *****************************************************************************
+ * Function:	 uint16_t flt_bit_count(uint16_t value)
+ * Arguments:	 uint16_t value
+ * Return Value: Number of set bits in VALUE
+ *
+ * Summary:
+ * Counts the set bits of a 16-bit word
+ *
+ * Description:
+ * Set bits are counted nibble by nibble using a lookup table.
+ *
+ *****************************************************************************/
+
+static const uint8_t flt_nibble_bits[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+static inline uint16_t flt_bit_count(uint16_t value)
+{
+    return( flt_nibble_bits[value & 0x000F] + flt_nibble_bits[(value >> 4) & 0x000F] +
+            flt_nibble_bits[(value >> 8) & 0x000F] + flt_nibble_bits[(value >> 12) & 0x000F] );
+}
+
+/*!flt_engine_execute()
+ *****************************************************************************
+ * Function:	 uint16_t flt_engine_execute(volatile FLT_ENGINE_t* engine)
+ * Arguments:	 FLT_ENGINE_t* engine
+ * Return Value: Unsigned Integer (1=success, 0=error)
+ *
+ * Summary:
+ * Evaluates all fault definitions of a fault engine in one pass
+ *
+ * Description:
+ * Each comparison type group of the fault definition table is evaluated 
+ * by its own loop, collecting trip and release conditions in bit masks.
+ * The immediate fault conditions are then updated for all faults at once 
+ * considering the hysteresis between trip and reset level:
+ * 
+ *      active = ((active & ~release) | trip) & enabled
+ * 
+ * Faults whose immediate fault condition differs from the tripped fault 
+ * status are pending. Only their fault event counters are incremented. 
+ * Counters of faults which are no longer pending are cleared. When a 
+ * counter reaches TRIPCNT_MAX (fault condition) respectively RSTCNT_MAX 
+ * (no fault condition), the fault status is toggled. User-defined 
+ * responses are called for faults which have been tripped or cleared 
+ * during this pass.
+ * 
+ * Counters of faults using integrating fault event filters (leaky bucket,
+ * N-of-M) are not cleared when a fault is no longer pending. They are 
+ * updated in every pass as long as they hold a non-zero value.
+ * 
+ * DEVIATION checks compare the absolute difference between SOURCE and 
+ * REFERENCE against trip and reset level. DEVIATION checks without 
+ * reference are always released.
+ *
+ *****************************************************************************/
+
+volatile uint16_t flt_engine_execute(volatile FLT_ENGINE_t* engine)
+{
+    volatile uint16_t fres=1;
+    uint16_t _i=0, _end=0, _bit=1;
+    uint16_t _value=0, _ref=0;
+    uint16_t _trip=0, _release=0;
+    uint16_t _active=0, _prev=0, _status=0, _pending=0, _mask=0;
+    uint16_t _counting=0, _cnt=0, _limit=0, _hist=0;
+    const FLT_DEFINITION_t* _def;
+    
+    if (engine == NULL) return(0);
+    if (engine->table == NULL) return(0);
+    
+    _def = engine->table;
+    
+    // Group #1: SOURCE > TRIP_LEVEL, released when SOURCE < RESET_LEVEL
+    _end = engine->group_end[0];
+    for (; _i<_end; _i++, _def++, _bit<<=1)
+    {
+        _value = *_def->source;
+        if (_value > engine->trip_level[_i]) _trip |= _bit;
+        if (_value < engine->reset_level[_i]) _release |= _bit;
+    }
+    
+    // Group #2: SOURCE < TRIP_LEVEL, released when SOURCE > RESET_LEVEL
+    _end = engine->group_end[1];
+    for (; _i<_end; _i++, _def++, _bit<<=1)
+    {
+        _value = *_def->source;
+        if (_value < engine->trip_level[_i]) _trip |= _bit;
+        if (_value > engine->reset_level[_i]) _release |= _bit;
+    }
+    
+    // Group #3: |SOURCE - REFERENCE| > TRIP_LEVEL, released when below RESET_LEVEL
+    _end = engine->group_end[2];
+    for (; _i<_end; _i++, _def++, _bit<<=1)
+    {
+        if (engine->reference[_i] == NULL) 
+        { _release |= _bit; continue; }
+        
+        _value = *_def->source;
+        _ref = *engine->reference[_i];
+        _value = (_value > _ref) ? (_value - _ref) : (_ref - _value);
+        if (_value > engine->trip_level[_i]) _trip |= _bit;
+        if (_value < engine->reset_level[_i]) _release |= _bit;
+    }
+    
+    // Update immediate fault conditions of all faults at once
+    _active = (((engine->active & ~_release) | _trip) & engine->enabled);
+    _prev = (engine->status & engine->enabled);
+    _pending = (_active ^ _prev);
+    engine->active = _active;
+    
+    // Clear consecutive count filters of faults which are not pending anymore
+    _mask = (engine->counting & ~_pending & ~engine->filtered);
+    for (_i=0, _bit=1; _mask; _i++, _bit<<=1)
+    {
+        if (_mask & _bit) 
+        { engine->counter[_i] = 0; _mask &= ~_bit; }
+    }
+    
+    // Increment consecutive count filters of pending faults
+    _status = _prev;
+    _counting = (_pending & ~engine->filtered);
+    _mask = _counting;
+    for (_i=0, _bit=1; _mask; _i++, _bit<<=1)
+    {
+        if (!(_mask & _bit)) continue;
+        _mask &= ~_bit;
+        
+        if (++engine->counter[_i] >= ((_active & _bit) ? 
+            engine->table[_i].tripcnt_max : engine->table[_i].rstcnt_max))
+        {
+            _status ^= _bit;            // Toggle fault status
+            _counting &= ~_bit;         // Stop fault event counter
+            engine->counter[_i] = 0;
+        }
+    }
+    
+    // Update integrating filters of pending faults and of faults with non-zero filter state
+    _mask = (engine->filtered & (engine->counting | _pending));
+    for (_i=0, _bit=1; _mask; _i++, _bit<<=1)
+    {
+        if (!(_mask & _bit)) continue;
+        _mask &= ~_bit;
+        
+        _def = &engine->table[_i];
+        _limit = ((_prev & _bit) ? _def->rstcnt_max : _def->tripcnt_max);
+        _cnt = engine->counter[_i];
+        
+        if (_def->filter == FLTFILTER_LEAKY_BUCKET)
+        {
+            if (_pending & _bit)
+                _cnt += ((_def->rate_up > 0) ? _def->rate_up : 1);
+            else
+            {
+                _value = ((_def->rate_down > 0) ? _def->rate_down : 1);
+                _cnt = ((_cnt > _value) ? (_cnt - _value) : 0);
+            }
+            _hist = _cnt;
+        }
+        else // FLTFILTER_N_OF_M
+        {
+            _cnt = ((_cnt << 1) | ((_pending & _bit) ? 1 : 0));
+            if (_def->window < FLT_FILTER_WINDOW_MAX) _cnt &= ((1 << _def->window) - 1);
+            _hist = flt_bit_count(_cnt);
+        }
+        
+        if (_hist >= _limit)
+        {
+            _status ^= _bit;            // Toggle fault status
+            _cnt = 0;                   // Restart filter in opposite direction
+        }
+        
+        engine->counter[_i] = _cnt;
+        if (_cnt) _counting |= _bit;
+    }
+    
+    engine->counting = _counting;
+    engine->tripped = (_status & ~_prev);
+    engine->cleared = (_prev & ~_status);
+    engine->status = _status;
+    
+    // Call user-defined responses of faults tripped or cleared during this pass
+    _mask = (engine->tripped | engine->cleared);
+    for (_i=0, _bit=1; _mask; _i++, _bit<<=1)
+    {
+        if (!(_mask & _bit)) continue;
+        _mask &= ~_bit;
+        
+        if (engine->tripped & _bit)
+        {
+            if (engine->table[_i].trip_response != NULL)
+                fres &= engine->table[_i].trip_response();
+        }
+        else
+        {
+            if (engine->table[_i].reset_response != NULL)
+                fres &= engine->table[_i].reset_response();
+        }
+    }
+    
+    return(fres);
+}
+
+/*!flt_fast_initialize()
+ *****************************************************************************
+ * Function:	 uint16_t flt_fast_initialize(volatile FLT_FAST_ENGINE_t* engine, 
+ *                  uint16_t filter, uint16_t blanking, uint16_t blank_mask)
+ * Arguments:	 FLT_FAST_ENGINE_t* engine, uint16_t filter, uint16_t blanking,
+ *               uint16_t blank_mask
+ * Return Value: Unsigned Integer (1=success, 0=error)
+ *
+ * Summary:
+ * Resets a fast fault check object
+ *
+ * Description:
+ * All fast fault checks are removed and latched faults are cleared. Checks
+ * have to be declared by flt_fast_define() afterwards. The filter count 
+ * is limited to a minimum of one sample. BLANK_MASK selects the checks 
+ * which are suppressed during blanking (bit n = check n).
+ *
+ *****************************************************************************/
+
+volatile uint16_t flt_fast_initialize(volatile FLT_FAST_ENGINE_t* engine, 
+                volatile uint16_t filter, volatile uint16_t blanking, volatile uint16_t blank_mask)
+{
+    volatile uint16_t _i=0;
+    
+    if (engine == NULL) return(0);
+    
+    engine->size = 0; // Suspend execution while object is being reset
+    
+    for (_i=0; _i<FLT_FAST_SIZE_MAX; _i++)
+    {
+        engine->source[_i] = NULL;
+        engine->level[_i] = 0;
+        engine->polarity[_i] = 0;
+        engine->counter[_i] = 0;
+    }
+    
+    engine->filter = ((filter > 0) ? filter : 1);
+    engine->blanking = blanking;
+    engine->blank_counter = blanking;
+    engine->blank_mask = blank_mask;
+    engine->active = 0;
+    engine->latched = 0;
+    
+    return(1);
+}
+
+/*!flt_fast_define()
+ *****************************************************************************
+ * Function:	 uint16_t flt_fast_define(volatile FLT_FAST_ENGINE_t* engine, uint16_t index,
+ *                  uint16_t* source, uint16_t level, uint16_t polarity)
+ * Arguments:	 FLT_FAST_ENGINE_t* engine, uint16_t index, uint16_t* source, 
+ *               uint16_t level, uint16_t polarity
+ * Return Value: Unsigned Integer (1=success, 0=error)
+ *
+ * Summary:
+ * Declares a single fast fault check
+ *
+ * Description:
+ * The index of the check is the bit position of this fault in the fault
+ * bit masks. Checks have to be declared in ascending order without gaps,
+ * as execution covers all indices below the highest declared index.
+ * Polarity mask 0x0000 trips above, 0xFFFF trips below the given level.
+ *
+ *****************************************************************************/
+
+volatile uint16_t flt_fast_define(volatile FLT_FAST_ENGINE_t* engine, volatile uint16_t index,
+                volatile uint16_t* source, volatile uint16_t level, volatile uint16_t polarity)
+{
+    if ((engine == NULL) || (source == NULL)) return(0);
+    if ((index >= FLT_FAST_SIZE_MAX) || (index > engine->size)) return(0);
+    
+    polarity = ((polarity != 0) ? 0xFFFF : 0x0000);
+    
+    engine->source[index] = source;
+    engine->polarity[index] = polarity;
+    engine->level[index] = (level ^ polarity); // Precompute trip level in comparison domain
+    engine->counter[index] = 0;
+    
+    if (index == engine->size) engine->size++; // Enable execution of this check
+    
+    return(1);
+}
+
+/*!flt_fast_clear()
+ *****************************************************************************
+ * Function:	 uint16_t flt_fast_clear(volatile FLT_FAST_ENGINE_t* engine, uint16_t mask)
+ * Arguments:	 FLT_FAST_ENGINE_t* engine, uint16_t mask
+ * Return Value: Unsigned Integer (1=success, 0=error)
+ *
+ * Summary:
+ * Clears latched fast faults
+ *
+ * Description:
+ * Latched faults selected by MASK are cleared. The latched fault word is
+ * cleared by a single read-modify-write instruction and thus cannot 
+ * corrupt faults latched by the control interrupt in the meantime.
+ *
+ *****************************************************************************/
+
+volatile uint16_t flt_fast_clear(volatile FLT_FAST_ENGINE_t* engine, volatile uint16_t mask)
+{
+    if (engine == NULL) return(0);
+    
+    engine->latched &= ~mask;
+    
+    return(1);
+}
+
+/*!flt_fast_execute()
+ *****************************************************************************
+ * Function:	 uint16_t flt_fast_execute(volatile FLT_FAST_ENGINE_t* engine, bool blank)
+ * Arguments:	 FLT_FAST_ENGINE_t* engine, bool blank
+ * Return Value: Bit mask of faults latched during this call (0=no new fault)
+ *
+ * Summary:
+ * Evaluates all fast fault checks on the most recent ADC samples
+ *
+ * Description:
+ * This function is called by the control interrupt. Each check converts
+ * its comparison result into a bit mask (0xFFFF = fault condition), which
+ * resets or increments the consecutive-sample counter without branch:
+ * 
+ *      counter = (counter + (counter < filter)) & mask
+ * 
+ * Counters saturate at the filter count. While BLANK is set, the blanking
+ * counter is reloaded, after BLANK has been released it counts down once 
+ * per call. Checks selected by the blanking mask are only latched when
+ * the blanking counter is zero, all other checks are latched at any time.
+ * The caller has to shut down the power stage when a non-zero value is 
+ * returned.
+ *
+ *****************************************************************************/
+
+uint16_t flt_fast_execute(volatile FLT_FAST_ENGINE_t* engine, bool blank)
+{
+    uint16_t _i=0, _bit=1, _size=0, _filter=0;
+    uint16_t _cnt=0, _mask=0, _blank=0;
+    uint16_t _active=0, _trip=0;
+    
+    _size = engine->size;
+    _filter = engine->filter;
+    
+    // Reload blanking counter while blanking is requested, count down otherwise
+    _blank = engine->blank_counter;
+    _mask = -(uint16_t)blank;
+    _blank = (engine->blanking & _mask) | ((_blank - (_blank != 0)) & ~_mask);
+    engine->blank_counter = _blank;
+    
+    for (_i=0; _i<_size; _i++)
+    {
+        // Fault condition mask (0xFFFF = sample beyond trip level)
+        _mask = -(uint16_t)((*engine->source[_i] ^ engine->polarity[_i]) > engine->level[_i]);
+        
+        _cnt = engine->counter[_i];
+        _cnt = (_cnt + (_cnt < _filter)) & _mask;
+        engine->counter[_i] = _cnt;
+        
+        _active |= (_bit & _mask);
+        _trip |= (_bit & -(uint16_t)(_cnt >= _filter));
+        _bit <<= 1;
+    }
+    
+    engine->active = _active;
+    
+    // Suppress latching of blanked checks and report newly latched faults only
+    _trip &= ~(engine->blank_mask & -(uint16_t)(_blank != 0));
+    _trip &= ~engine->latched;
+    engine->latched |= _trip;
+    
+    return(_trip);
+}
@@ -42,8 +42,18 @@
 
 // APPLICATION LAYER HEADER FILES
 #include "fault_handler/app_faults.h"
+#include "fault_handler/app_fault_log.h"
 #include "pwr_control/app_power_control.h"
+#include "telemetry/app_telemetry.h"
+#include "telemetry/app_capture.h"
+#include "telemetry/app_stats.h"
+#include "tuning/app_params.h"
+#include "pmbus/app_pmbus.h"
+#include "settings/app_settings.h"
 #include "uart/app_uart.h"
+#include "sequencer/app_sequencer.h"
+#include "scheduler/app_scheduler.h"
+#include "profiler/app_profiler.h"
 
 #ifdef	__cplusplus
 extern "C" {
@@ -20,13 +20,11 @@
 #include "config/init/init_opa.h"
 #include "config/init/init_dac.h"
 
-#define  TMR1_TIMEOUT 30000   // Timeout protection for Timer1 interrupt flag bit
 volatile bool LOW_PRIORITY_GO = false;  // Flag allowing low priority tasks to be executed
 
 int main(void) {
 
     volatile uint16_t retval=1;
-    volatile uint16_t timeout = 0;
     
     retval &= init_fosc();        // Set up system oscillator for 100 MIPS operation
     retval &= init_aclk();        // Set up Auxiliary PLL for 500 MHz (source clock to PWM module)
@@ -44,12 +42,22 @@ int main(void) {
     
     retval &= appPowerSupply_Initialize(); // Initialize BUCK converter object and state machine
     retval &= appFaults_Initialize(); // Initialize fault objects and fault handler task
+    retval &= appFaultLog_Initialize(); // Restore persistent fault event log and initialize snapshot buffer
+    retval &= appTelemetry_Initialize(); // Initialize telemetry stream and loop saturation counters
+    retval &= appCapture_Initialize(); // Initialize triggered capture of control cycle data
+    retval &= appStats_Initialize(); // Initialize running statistics of control cycle data
+    retval &= appParams_Initialize(); // Initialize parameter registry for online tuning
+    retval &= appPMBus_Initialize(); // Initialize PMBus command layer
+    retval &= appSettings_Initialize(); // Load non-volatile settings (module address) from flash
     retval &= appUart_Initialize();     // Initialize uart object and uart task
+    retval &= appSequencer_Initialize(); // Initialize setpoint profile sequencer
+    retval &= appScheduler_Initialize(); // Initialize task scheduler and register application tasks
+    retval &= appProfiler_Initialize(); // Initialize CPU load and control interrupt latency profiler
     
     // Enable Timer1
-    _T1IP = 0;  // Set interrupt priority to zero
+    _T1IP = 2;  // Set interrupt priority to two (alternate working register set #1)
     _T1IF = 0;  // Reset interrupt flag bit
-    _T1IE = 0;  // Enable/Disable Timer1 interrupt
+    _T1IE = 1;  // Enable Timer1 interrupt waking up the CPU every scheduler tick
     T1CONbits.TON = 1; // Turn on Timer1
     retval &= T1CONbits.TON; // Add timer enable bit to list of checked bits
     
@@ -62,17 +70,13 @@ int main(void) {
     // Main program execution
     while (1) {
 
-        // wait for timer1 to overrun
-        while ((!_T1IF) && (timeout++ < TMR1_TIMEOUT));
-        _T1IF = 0;
-        timeout = 0;    // Reset timeout counter
+        // Wait in Idle mode until timer1 overruns
+        appScheduler_Wait();
 
         // Execute main application tasks
         DBGPIN_2_SET;               // Set the CPU debugging pin HIGH
 
-        appPowerSupply_Execute();   // Execute power supply state machine
-        appFaults_Execute();        // Execute fault handler
-        appUart_Execute();          // Execute uart
+        appScheduler_Execute();     // Execute all application tasks due in this scheduler tick
 
         DBGPIN_2_CLEAR;             // Clear the CPU debugging pin
         
@@ -0,0 +1,363 @@
+/*
+ * File:   app_pmbus.c
+ * Author: M91406
+ *
+ * Created on November 29, 2020, 2:15 PM
+ */
+
+#include <stddef.h>
+
+#include "app_pmbus.h"
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/app_power_control.h"
+#include "fault_handler/app_faults.h"
+
+
+// Define PMBus object
+volatile PMBUS_OBJECT_t pmbusobj_Buck;
+
+// Supported transactions (number of data bytes of read and write transactions)
+typedef struct {
+    uint8_t command;    // PMBus command code
+    uint8_t read;       // Number of data bytes returned by read transactions
+    uint8_t write;      // Number of data bytes expected by write transactions
+} PMBUS_COMMAND_DEFINITION_t;
+
+const PMBUS_COMMAND_DEFINITION_t pmbus_command_table[] = {
+//    Command                           Read                    Write
+    { PMBUS_CMD_OPERATION,              1,                      1 },
+    { PMBUS_CMD_CLEAR_FAULTS,           PMBUS_NOT_SUPPORTED,    0 },
+    { PMBUS_CMD_VOUT_MODE,              1,                      PMBUS_NOT_SUPPORTED },
+    { PMBUS_CMD_VOUT_COMMAND,           2,                      2 },
+    { PMBUS_CMD_STATUS_BYTE,            1,                      PMBUS_NOT_SUPPORTED },
+    { PMBUS_CMD_STATUS_WORD,            2,                      PMBUS_NOT_SUPPORTED },
+    { PMBUS_CMD_STATUS_CML,             1,                      PMBUS_NOT_SUPPORTED },
+    { PMBUS_CMD_READ_VIN,               2,                      PMBUS_NOT_SUPPORTED },
+    { PMBUS_CMD_READ_VOUT,              2,                      PMBUS_NOT_SUPPORTED },
+    { PMBUS_CMD_READ_IOUT,              2,                      PMBUS_NOT_SUPPORTED },
+    { PMBUS_CMD_READ_TEMPERATURE_1,     PMBUS_NOT_SUPPORTED,    PMBUS_NOT_SUPPORTED },
+    { PMBUS_CMD_PMBUS_REVISION,         1,                      PMBUS_NOT_SUPPORTED }
+};
+
+#define PMBUS_COMMANDS  (sizeof(pmbus_command_table) / sizeof(PMBUS_COMMAND_DEFINITION_t)) // Number of supported commands
+
+// Private function prototypes
+uint16_t pmbus_status_word(volatile PMBUS_OBJECT_t* pmbus);
+
+
+/* @@pmbus_length
+ * ********************************************************************************
+ * Summary:
+ * Returns the number of data bytes of a transaction
+ *
+ * Parameters:
+ *  volatile uint16_t command: PMBus command code
+ *  volatile bool write: true = write transaction, false = read transaction
+ *
+ * Returns:
+ *  Number of data bytes (PMBUS_NOT_SUPPORTED = unsupported transaction)
+ *
+ * Description:
+ * Transports use this function to determine the number of data bytes to 
+ * receive or to transmit after the command code.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t pmbus_length(volatile uint16_t command, volatile bool write)
+{
+    volatile uint16_t _i=0;
+
+    for (_i=0; _i<PMBUS_COMMANDS; _i++)
+    {
+        if (pmbus_command_table[_i].command != command) continue;
+        return(write ? pmbus_command_table[_i].write : pmbus_command_table[_i].read);
+    }
+
+    return(PMBUS_NOT_SUPPORTED);
+}
+
+/* @@pmbus_linear11
+ * ********************************************************************************
+ * Summary:
+ * Converts a fixed-point number into Linear11 format
+ *
+ * Parameters:
+ *  int32_t value: Fixed-point value (value * 2^exponent)
+ *  int16_t exponent: Exponent of the fixed-point value
+ *
+ * Returns:
+ *  Linear11 data word (exponent in bits <15:11>, mantissa in bits <10:0>)
+ *
+ * Description:
+ * The value is shifted right until it fits into the signed 11-bit mantissa. 
+ * The exponent is increased accordingly.
+ *
+ * ********************************************************************************/
+
+uint16_t pmbus_linear11(int32_t value, int16_t exponent)
+{
+    while (((value > 1023) || (value < -1024)) && (exponent < 15))
+    {
+        value >>= 1;
+        exponent++;
+    }
+
+    return((uint16_t)((((uint16_t)exponent & 0x001F) << 11) | ((uint16_t)value & 0x07FF)));
+}
+
+/* @@pmbus_status_word
+ * ********************************************************************************
+ * Summary:
+ * Derives the PMBus STATUS_WORD from the fault engine and the converter state
+ *
+ * Parameters:
+ *  volatile PMBUS_OBJECT_t* pmbus: Pointer to PMBus object
+ *
+ * Returns:
+ *  STATUS_WORD
+ *
+ * Description:
+ * Each tripped fault object sets the summary bit of its group in the upper 
+ * byte and, where available, the specific bit in the lower byte. Faults 
+ * without specific bit in the lower byte set NONE_OF_THE_ABOVE. The fast fault
+ * trip is reported as output over voltage or over current depending on the 
+ * latched fast fault check.
+ *
+ * ********************************************************************************/
+
+uint16_t pmbus_status_word(volatile PMBUS_OBJECT_t* pmbus)
+{
+    uint16_t _status=0;
+    uint16_t _faults=fltengine_Buck.status;
+
+    if (_faults & FLT_MASK_BUCK_OVLO) 
+        _status |= PMBUS_STATUS_INPUT | PMBUS_STATUS_NONE_ABOVE;
+    if (_faults & FLT_MASK_BUCK_UVLO) 
+        _status |= PMBUS_STATUS_INPUT | PMBUS_STATUS_VIN_UV;
+    if (_faults & (FLT_MASK_BUCK_OCP | FLT_MASK_BUCK_OCP1 | FLT_MASK_BUCK_OCP2)) 
+        _status |= PMBUS_STATUS_IOUT | PMBUS_STATUS_IOUT_OC;
+    if (_faults & FLT_MASK_BUCK_IMBAL) 
+        _status |= PMBUS_STATUS_IOUT | PMBUS_STATUS_NONE_ABOVE;
+    if (_faults & FLT_MASK_BUCK_REGERR) 
+        _status |= PMBUS_STATUS_VOUT | PMBUS_STATUS_NONE_ABOVE;
+    if (_faults & FLT_MASK_BUCK_FASTTRIP)
+    {
+        if (fltfast_Buck.latched & (1U << FFC_BUCK_OVP))
+            _status |= PMBUS_STATUS_VOUT | PMBUS_STATUS_VOUT_OV;
+        if (fltfast_Buck.latched & ((1U << FFC_BUCK_OCP1) | (1U << FFC_BUCK_OCP2)))
+            _status |= PMBUS_STATUS_IOUT | PMBUS_STATUS_IOUT_OC;
+    }
+
+    if (pmbus->status_cml) 
+        _status |= PMBUS_STATUS_CML;
+
+    // Output is off until the PWM outputs have been launched
+    if ((buck.mode < BUCK_STATE_LAUNCH_V_RAMP) || (buck.mode == BUCK_STATE_SUSPEND))
+        _status |= PMBUS_STATUS_OFF;
+    if (buck.mode != BUCK_STATE_ONLINE)
+        _status |= PMBUS_STATUS_POWER_GOOD_N;
+
+    return(_status);
+}
+
+/* @@pmbus_write
+ * ********************************************************************************
+ * Summary:
+ * Executes a PMBus write transaction
+ *
+ * Parameters:
+ *  volatile PMBUS_OBJECT_t* pmbus: Pointer to PMBus object
+ *  volatile uint16_t command: PMBus command code
+ *  volatile uint8_t* data: Pointer to data bytes (low byte first)
+ *  volatile uint16_t length: Number of data bytes
+ *
+ * Returns:
+ *  1: success
+ *  0: error (invalid command or data, STATUS_CML has been updated)
+ *
+ * Description:
+ * OPERATION turns the converter on by setting the autorun option, which starts
+ * the converter from standby as soon as all startup conditions are met. Off 
+ * commands clear the autorun option and reset a running state machine, which 
+ * disables the PWM outputs immediately. VOUT_COMMAND updates the user reference, 
+ * the state machine tunes into the new reference. Values above PMBUS_VOUT_MAXIMUM
+ * are rejected.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t pmbus_write(volatile PMBUS_OBJECT_t* pmbus, volatile uint16_t command, 
+                volatile uint8_t* data, volatile uint16_t length)
+{
+    volatile uint16_t _value=0;
+    volatile uint32_t _ref=0;
+
+    if (pmbus == NULL) return(0);
+
+    if ((!pmbus->status.bits.enabled) || (length != pmbus_length(command, true)))
+    {
+        pmbus->status_cml |= PMBUS_CML_INVALID_COMMAND;
+        return(0);
+    }
+    if ((length > 0) && (data == NULL)) return(0);
+    
+    if (length == 2) _value = ((uint16_t)data[1] << 8) | data[0];
+    pmbus->transactions++;
+
+    switch (command)
+    {
+        case PMBUS_CMD_OPERATION:
+            if (data[0] == PMBUS_OPERATION_ON)
+            {
+                buck.status.bits.autorun = true;
+            }
+            else if ((data[0] == PMBUS_OPERATION_OFF) || (data[0] == PMBUS_OPERATION_SOFT_OFF))
+            {
+                buck.status.bits.autorun = false;
+                buck.status.bits.GO = false;
+                if ((buck.mode > BUCK_STATE_STANDBY) && (buck.mode != BUCK_STATE_SUSPEND))
+                    buck.mode = BUCK_STATE_RESET; // Shut down PWM and reset the state machine
+            }
+            else
+            {
+                pmbus->status_cml |= PMBUS_CML_INVALID_DATA;
+                return(0);
+            }
+            break;
+
+        case PMBUS_CMD_CLEAR_FAULTS:
+            pmbus->status_cml = 0; // Converter faults are cleared by the fault handler only
+            break;
+
+        case PMBUS_CMD_VOUT_COMMAND:
+            _ref = ((uint32_t)__builtin_muluu(_value, PMBUS_VREF_FACTOR) >> PMBUS_VREF_SHIFT);
+            if (_ref > PMBUS_VREF_MAX)
+            {
+                pmbus->status_cml |= PMBUS_CML_INVALID_DATA;
+                return(0);
+            }
+            buck.set_values.v_ref = (uint16_t)_ref;
+            break;
+
+        default:
+            pmbus->status_cml |= PMBUS_CML_INVALID_COMMAND;
+            return(0);
+    }
+
+    return(1);
+}
+
+/* @@pmbus_read
+ * ********************************************************************************
+ * Summary:
+ * Executes a PMBus read transaction
+ *
+ * Parameters:
+ *  volatile PMBUS_OBJECT_t* pmbus: Pointer to PMBus object
+ *  volatile uint16_t command: PMBus command code
+ *  volatile uint8_t* data: Pointer to data buffer (2 bytes)
+ *
+ * Returns:
+ *  Number of data bytes (0 = invalid command, STATUS_CML has been updated)
+ *
+ * Description:
+ * Measurements are converted from ADC ticks by a single multiply-and-shift 
+ * operation with the constants declared in the hardware description. The 
+ * output current is the sum of both phase currents after offset compensation
+ * and becomes negative when the converter is operated in reverse direction.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t pmbus_read(volatile PMBUS_OBJECT_t* pmbus, volatile uint16_t command, 
+                volatile uint8_t* data)
+{
+    volatile uint16_t _length=0;
+    volatile uint16_t _value=0;
+    volatile int16_t _signed=0;
+
+    if ((pmbus == NULL) || (data == NULL)) return(0);
+
+    _length = pmbus_length(command, false);
+    if (_length == PMBUS_NOT_SUPPORTED)
+    {
+        pmbus->status_cml |= PMBUS_CML_INVALID_COMMAND;
+        return(0);
+    }
+    pmbus->transactions++;
+
+    switch (command)
+    {
+        case PMBUS_CMD_OPERATION:
+            _value = (buck.status.bits.autorun ? PMBUS_OPERATION_ON : PMBUS_OPERATION_OFF);
+            break;
+
+        case PMBUS_CMD_VOUT_MODE:
+            _value = ((uint16_t)PMBUS_VOUT_EXPONENT & 0x001F); // Linear mode, exponent in bits <4:0>
+            break;
+
+        case PMBUS_CMD_VOUT_COMMAND:
+            _value = (uint16_t)(__builtin_muluu(buck.set_values.v_ref, PMBUS_VOUT_FACTOR) >> PMBUS_VOUT_SHIFT);
+            break;
+
+        case PMBUS_CMD_STATUS_BYTE:
+        case PMBUS_CMD_STATUS_WORD:
+            _value = pmbus_status_word(pmbus);
+            break;
+
+        case PMBUS_CMD_STATUS_CML:
+            _value = pmbus->status_cml;
+            break;
+
+        case PMBUS_CMD_READ_VIN:
+            _value = pmbus_linear11((int32_t)(__builtin_muluu(buck.data.v_in, PMBUS_VIN_FACTOR) >> PMBUS_VIN_SHIFT), 
+                        PMBUS_L11_EXPONENT);
+            break;
+
+        case PMBUS_CMD_READ_VOUT:
+            _value = (uint16_t)(__builtin_muluu(buck.data.v_out, PMBUS_VOUT_FACTOR) >> PMBUS_VOUT_SHIFT);
+            break;
+
+        case PMBUS_CMD_READ_IOUT:
+            _signed = (int16_t)(buck.data.i_sns[0] - buck.i_loop[0].feedback_offset) + 
+                      (int16_t)(buck.data.i_sns[1] - buck.i_loop[1].feedback_offset);
+            _value = pmbus_linear11((__builtin_mulsu(_signed, PMBUS_IOUT_FACTOR) >> PMBUS_IOUT_SHIFT), 
+                        PMBUS_L11_EXPONENT);
+            break;
+
+        case PMBUS_CMD_PMBUS_REVISION:
+            _value = PMBUS_REVISION;
+            break;
+
+        default:
+            pmbus->status_cml |= PMBUS_CML_INVALID_COMMAND;
+            return(0);
+    }
+
+    data[0] = (_value & 0xFF);
+    if (_length > 1) data[1] = (_value >> 8);
+
+    return(_length);
+}
+
+
+volatile uint16_t appPMBus_Initialize(void)
+{
+    volatile uint16_t retval=1;
+
+    // Initialize buck PMBus object
+    pmbusobj_Buck.status.value = 0;
+    pmbusobj_Buck.status_cml = 0;
+    pmbusobj_Buck.transactions = 0;
+
+    pmbusobj_Buck.status.bits.enabled = PMBUS_ENABLE; // Enable PMBus write transactions
+
+    return(retval);
+}
+
+volatile uint16_t appPMBus_Dispose(void)
+{
+    volatile uint16_t retval=1;
+
+    pmbusobj_Buck.status.bits.enabled = false;   // Disable PMBus write transactions
+
+    return(retval);
+}
@@ -0,0 +1,160 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/*
+ * File:   app_pmbus.h
+ * Author: M91406
+ * Comments: PMBus command layer application layer API
+ * Revision history:
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef APPLICATION_LAYER_PMBUS_HEADER_H
+#define	APPLICATION_LAYER_PMBUS_HEADER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!PMBUS_COMMAND_e
+ * ***************************************************************************************************
+ * Summary:
+ * Supported PMBus command codes
+ *
+ * Description:
+ * The command layer is transport-agnostic: a transport (UART protocol, I2C/SMBus slave) passes 
+ * the command code and data bytes of write transactions to pmbus_write() and requests the data 
+ * bytes of read transactions from pmbus_read(). Packet error checking is part of the transport.
+ *
+ *  Command             Access              Data
+ *  OPERATION           read/write byte     0x80 = on, 0x00/0x40 = off
+ *  CLEAR_FAULTS        send byte           clears communication faults
+ *  VOUT_MODE           read byte           Linear16 mode with exponent PMBUS_VOUT_EXPONENT
+ *  VOUT_COMMAND        read/write word     output voltage reference (Linear16)
+ *  STATUS_BYTE         read byte           lower byte of STATUS_WORD
+ *  STATUS_WORD         read word           summary status (PMBUS_STATUS_xxx)
+ *  STATUS_CML          read byte           communication faults (PMBUS_CML_xxx)
+ *  READ_VIN            read word           input voltage (Linear11)
+ *  READ_VOUT           read word           output voltage (Linear16)
+ *  READ_IOUT           read word           output current, negative in reverse direction (Linear11)
+ *  READ_TEMPERATURE_1  (not supported)     no temperature sensor assigned
+ *  PMBUS_REVISION      read byte           PMBUS_REVISION
+ *
+ * *************************************************************************************************** */
+
+typedef enum {
+    PMBUS_CMD_OPERATION         = 0x01,
+    PMBUS_CMD_CLEAR_FAULTS      = 0x03,
+    PMBUS_CMD_VOUT_MODE         = 0x20,
+    PMBUS_CMD_VOUT_COMMAND      = 0x21,
+    PMBUS_CMD_STATUS_BYTE       = 0x78,
+    PMBUS_CMD_STATUS_WORD       = 0x79,
+    PMBUS_CMD_STATUS_CML        = 0x7E,
+    PMBUS_CMD_READ_VIN          = 0x88,
+    PMBUS_CMD_READ_VOUT         = 0x8B,
+    PMBUS_CMD_READ_IOUT         = 0x8C,
+    PMBUS_CMD_READ_TEMPERATURE_1 = 0x8D,
+    PMBUS_CMD_PMBUS_REVISION    = 0x98
+} PMBUS_COMMAND_e;
+
+#define PMBUS_NOT_SUPPORTED     0xFFU   // Data length of unsupported transactions
+
+#define PMBUS_OPERATION_ON      0x80U   // OPERATION: turn output on
+#define PMBUS_OPERATION_OFF     0x00U   // OPERATION: turn output off immediately
+#define PMBUS_OPERATION_SOFT_OFF 0x40U  // OPERATION: turn output off (no sequencing, same as immediate off)
+
+// STATUS_WORD bits
+#define PMBUS_STATUS_NONE_ABOVE 0x0001U // a fault not listed in bits [7:1] is active
+#define PMBUS_STATUS_CML        0x0002U // communication fault
+#define PMBUS_STATUS_TEMPERATURE 0x0004U // over temperature fault
+#define PMBUS_STATUS_VIN_UV     0x0008U // input under voltage fault
+#define PMBUS_STATUS_IOUT_OC    0x0010U // output over current fault
+#define PMBUS_STATUS_VOUT_OV    0x0020U // output over voltage fault
+#define PMBUS_STATUS_OFF        0x0040U // output is not providing power
+#define PMBUS_STATUS_OTHER      0x0200U // other fault
+#define PMBUS_STATUS_POWER_GOOD_N 0x0800U // power good signal is negated
+#define PMBUS_STATUS_MFR        0x1000U // manufacturer specific fault
+#define PMBUS_STATUS_INPUT      0x2000U // input voltage fault
+#define PMBUS_STATUS_IOUT       0x4000U // output current fault
+#define PMBUS_STATUS_VOUT       0x8000U // output voltage fault
+
+// STATUS_CML bits
+#define PMBUS_CML_INVALID_COMMAND 0x80U // unsupported command code or transaction
+#define PMBUS_CML_INVALID_DATA  0x40U   // invalid or out of range data
+#define PMBUS_CML_PEC_FAILED    0x20U   // packet error check failed (set by the transport)
+
+/*!PMBUS_OBJECT_t
+ * ***************************************************************************************************
+ * Summary:
+ * PMBus command layer data object
+ *
+ * Description:
+ * Status information is derived from the fault engine and the converter state when it is read.
+ * Only communication faults are latched in the PMBus object until CLEAR_FAULTS is received.
+ *
+ * *************************************************************************************************** */
+
+typedef union{
+
+	struct {
+		volatile unsigned : 8;			// Bit <7:0>: (reserved)
+		volatile unsigned : 7;			// Bit <14:8> (reserved)
+		volatile bool enabled : 1;      // Bit 15: Control bit enabling/disabling write transactions
+	} __attribute__((packed)) bits; // PMBus object status bit field for single bit access
+
+	volatile uint16_t value;		// PMBus object status word
+
+} PMBUS_OBJECT_STATUS_t;	// PMBus object status
+
+typedef struct {
+	volatile PMBUS_OBJECT_STATUS_t status; // Status word of this PMBus object
+    volatile uint8_t status_cml;    // Latched communication faults (STATUS_CML)
+    volatile uint16_t transactions; // Number of executed transactions
+} PMBUS_OBJECT_t;
+
+// Public Function Prototypes
+extern volatile uint16_t pmbus_length(volatile uint16_t command, volatile bool write);
+extern volatile uint16_t pmbus_write(volatile PMBUS_OBJECT_t* pmbus, volatile uint16_t command, 
+                volatile uint8_t* data, volatile uint16_t length);
+extern volatile uint16_t pmbus_read(volatile PMBUS_OBJECT_t* pmbus, volatile uint16_t command, 
+                volatile uint8_t* data);
+extern uint16_t pmbus_linear11(int32_t value, int16_t exponent);
+
+// Public Variable Declaration
+extern volatile PMBUS_OBJECT_t pmbusobj_Buck;
+
+// PUBLIC FUNCTION PROTOTYPE DECLARATIONS
+extern volatile uint16_t appPMBus_Initialize(void);
+extern volatile uint16_t appPMBus_Dispose(void);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_PMBUS_HEADER_H */
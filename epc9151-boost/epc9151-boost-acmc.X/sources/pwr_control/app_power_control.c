@@ -34,7 +34,6 @@ volatile uint16_t appPowerSupply_ControllerInitialize(void);
 volatile uint16_t appPowerSupply_PeripheralsInitialize(void);
 
 void appPowerSupply_CurrentBalancing(void); 
-void appPowerSupply_CurrentSenseCalibration(void);
 
 
 /* CURRENT SENSE CALIBRATION */
@@ -122,33 +121,32 @@ volatile uint16_t appPowerSupply_Execute(void)
         ((BUCK_VIN_UVLO_TRIP < buck.data.v_in) && (buck.data.v_in<BUCK_VIN_OVLO_TRIP));
     #endif    
     
+    // Release fast fault checks latched by the control interrupt once the 
+    // fault handler has suspended the converter and taken over the recovery.
+    if ((fltfast_Buck.latched != 0) && (fltengine_Buck.status & FLT_MASK_BUCK_FASTTRIP))
+        flt_fast_clear(&fltfast_Buck, fltfast_Buck.latched);
+    
     // Combine individual fault bits to a common fault indicator
-    buck.status.bits.fault_active = (bool) (
-        fltobj_BuckUVLO.status.bits.fault_status | 
-        fltobj_BuckOVLO.status.bits.fault_status |
-        fltobj_BuckRegErr.status.bits.fault_status |
-        fltobj_BuckOCP.status.bits.fault_status
-        );
+    buck.status.bits.fault_active = (bool)(fltengine_Buck.status != 0);
     
     // Execute buck converter state machine
     retval &= drv_BuckConverter_Execute(&buck);
     
-    // Execute slower, advanced control options
-    appPowerSupply_CurrentSenseCalibration();
+    // Execute advanced control options
 //    appPowerSupply_CurrentBalancing();
 
     // Buck regulation error is only active while controller is running
     // and while being tied to a valid reference
     if(buck.mode >= BUCK_STATE_V_RAMP_UP) 
     {
-        fltobj_BuckRegErr.ref_obj = buck.v_loop.controller->Ports.ptrControlReference;
+        fltengine_Buck.reference[FLT_BUCK_REGERR] = buck.v_loop.controller->Ports.ptrControlReference;
         #if (PLANT_MEASUREMENT == false)
-        fltobj_BuckRegErr.status.bits.enabled = buck.v_loop.controller->status.bits.enabled;
+        flt_engine_enable(&fltengine_Buck, FLT_BUCK_REGERR, buck.v_loop.controller->status.bits.enabled);
         #endif
     }
     else 
     {
-        fltobj_BuckRegErr.status.bits.enabled = false;
+        flt_engine_enable(&fltengine_Buck, FLT_BUCK_REGERR, false);
     }
     
     return(retval); 
@@ -255,6 +253,7 @@ volatile uint16_t appPowerSupply_ConverterObjectInitialize(void)
     // Set Reference values
     buck.set_values.control_mode = BUCK_CONTROL_MODE_ACMC; // Set Control Mode
     buck.set_values.i_ref = BUCK_ISNS_REF; // Set current loop reference
+    buck.set_values.i_limit = BUCK_ISNS_REF_MAX; // Set nominal current limit
 #if (BOOST_MODE == false)
     buck.set_values.v_ref = BUCK_VOUT_REF; // Set voltage loop reference
 #elif (BOOST_MODE == true)
@@ -436,6 +435,7 @@ volatile uint16_t appPowerSupply_ConverterObjectInitialize(void)
         if (buck.startup.i_ramp.ref_inc_step == 0)
             buck.startup.i_ramp.ref_inc_step = 1;        
         buck.startup.i_ramp.reference = BUCK_ISNS_REF;
+        buck.startup.i_load = BUCK_ISNS_LOAD;
     }
     
     buck.startup.power_good_delay.counter = 0;
@@ -446,7 +446,12 @@ volatile uint16_t appPowerSupply_ConverterObjectInitialize(void)
     #else    
     buck.startup.power_good_delay.reference = BUCK_VOUT_REF;
     #endif
-    
+
+    // Initialize Reference Trajectory Generator
+    buck.v_traj.scaler = BUCK_TRAJ_SCALER;
+    buck.v_traj.steps_per_tick = BUCK_TRAJ_STEPS;
+    retval &= buckTraj_Initialize(&buck.v_traj);
+
     return(retval);
 }
 
@@ -813,18 +818,25 @@ inline void appPowerSupply_CurrentBalancing(void)
 
 }
 
-/* @@<function_name>
+/* @@appPowerSupply_CurrentSenseCalibration
  * ********************************************************************************
  * Summary:
+ * Determines the zero-current offsets of the current sense feedback
  * 
  * Parameters:
+ *  (none)
  * 
  * Returns:
+ *  1: success
  * 
  * Description:
+ * This function is executed by the scheduler in the slow tier. While the 
+ * converter is in STANDBY, the most recent phase current samples captured by 
+ * the power supply task are accumulated and averaged. The result is written 
+ * to the source offsets of the current loop controllers.
  * 
  * ********************************************************************************/
-inline void appPowerSupply_CurrentSenseCalibration(void)
+volatile uint16_t appPowerSupply_CurrentSenseCalibration(void)
 {
 
     // Current Calibration Procedure
@@ -832,7 +844,7 @@ inline void appPowerSupply_CurrentSenseCalibration(void)
         (buck.status.bits.cs_calib_complete) || 
         (!buck.status.bits.adc_active)
        )
-    { return; }
+    { return(1); }
         
         
     if (++calib_cs1.cs_calib_cnt < CS_CALIB_STEPS)
@@ -850,11 +862,13 @@ inline void appPowerSupply_CurrentSenseCalibration(void)
 
         buck.i_loop[0].controller->Ports.Source.Offset = calib_cs1.cs_calib_offset; // Update controller offset
         buck.i_loop[1].controller->Ports.Source.Offset = calib_cs2.cs_calib_offset;
+        buck.i_loop[0].feedback_offset = calib_cs1.cs_calib_offset; // Update phase over current check reference
+        buck.i_loop[1].feedback_offset = calib_cs2.cs_calib_offset;
         
         buck.status.bits.cs_calib_complete = true;   // Set CALIB_DONE flag
     }
 
-    return;
+    return(1);
     
 }
 
@@ -46,6 +46,21 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/*!BUCK_POWER_CONTROLLER_t data structure
+ * *************************************************************************************************
+ * Summary:
+ * Global data object for the BUCK CONVERTER 
+ * 
+ * Description:
+ * the 'buck' data object holds all status, control and monitoring values of the BUCK power 
+ * controller. The BUCK_POWER_CONTROLLER_t data structure is defined in dev_buck_typedef.h.
+ * The object is declared by the application layer only. The converter device driver 
+ * (pwr_control/devices) does not see this declaration and operates exclusively on the 
+ * instance pointer handed in by the caller, so any reference to this object inside the 
+ * driver fails to compile.
+ *  
+ * *************************************************************************************************/
+extern volatile BUCK_POWER_CONTROLLER_t buck;
     
 // PUBLIC FUNCTION PROTOTYPE DECLARATION
 extern volatile uint16_t appPowerSupply_Initialize(void);
@@ -53,6 +68,7 @@ extern volatile uint16_t appPowerSupply_Dispose(void);
 extern volatile uint16_t appPowerSupply_Execute(void);
 extern volatile uint16_t appPowerSupply_Suspend(void);
 extern volatile uint16_t appPowerSupply_Resume(void);
+extern volatile uint16_t appPowerSupply_CurrentSenseCalibration(void);
 
 
 
@@ -7,6 +7,13 @@
 
 
 #include "pwr_control/app_power_control.h"
+#include "fault_handler/app_faults.h"
+#include "fault_handler/app_fault_log.h"
+#include "profiler/app_profiler.h"
+#include "telemetry/app_telemetry.h"
+#include "telemetry/app_capture.h"
+#include "telemetry/app_stats.h"
+#include "tuning/app_params.h"
 
 /*!Power Converter Control Loop Interrupt
  * **************************************************************************************************
@@ -28,15 +35,41 @@
  * this interrupt is thrown is determined by selecting the BUCK_VOUT_TRIGGER_MODE
  * option. 
  * 
+ * Before the control loops are updated, the fast fault checks compare the 
+ * most recent ADC samples against their trip levels and shut down the PWM 
+ * outputs in the same switching cycle a fault gets latched. The execution
+ * time of the fast fault checks adds to the interrupt duration captured
+ * by the CPU profiler.
+ * 
+ * Parameter sets staged by the communication task are written at the end
+ * of the interrupt, so each control cycle runs with a consistent set.
+ * 
  * ********************************************************************************/
 
 void __attribute__((__interrupt__, auto_psv, context))_BUCK_VLOOP_Interrupt(void)
 {
+    #if (CPU_PROFILER_ENABLE == true)
+    prof_isr_entry(&profobj_Main); // Capture interrupt entry time and trigger latency
+    #endif
     
     DBGPIN_1_SET;
 //    PWRGOOD_SET;
     
     buck.status.bits.adc_active = true;
+    
+    #if (FAULT_LOG_ENABLE == true)
+    flog_capture(&flogsnap_Buck); // Add recent samples to pre-fault snapshot
+    #endif
+    
+    #if (FAST_FAULT_ENABLE == true)
+    // Fast fault checks on raw ADC samples, over current checks blanked during reference ramps
+    if (flt_fast_execute(&fltfast_Buck, buck.v_traj.status.bits.active))
+    {
+        buckPWM_Suspend(&buck);
+        flogsnap_Buck.frozen = true; // Keep pre-fault snapshot until the fault has been logged
+    }
+    #endif
+    
     #if (PLANT_MEASUREMENT == false)
     buck.v_loop.ctrl_Update(buck.v_loop.controller);
     buck.i_loop[0].ctrl_Update(buck.i_loop[0].controller);
@@ -45,6 +78,26 @@ void __attribute__((__interrupt__, auto_psv, context))_BUCK_VLOOP_Interrupt(void
     v_loop_PTermUpdate(&v_loop);
     #endif
 
+    // Advance reference trajectory (soft-start and runtime reference changes)
+    buckTraj_Update(&buck.v_traj);
+
+    #if (TELEMETRY_ENABLE == true)
+    telem_sample(&telemobj_Buck); // Update loop saturation counters and sample telemetry channels
+    #endif
+    
+    #if (CAPTURE_ENABLE == true)
+    capture_sample(&capobj_Buck); // Record triggered capture samples
+    #endif
+
+    #if (STATS_ENABLE == true)
+    if (statsobj_Buck.status.bits.running) // Not running until configured by STATS_CONFIG
+        stats_sample(&statsobj_Buck); // Update running statistics
+    #endif
+
+    #if (PARAM_ACCESS_ENABLE == true)
+    param_apply(&paramobj_Buck); // Write staged parameter set (safe point after all functions of this cycle)
+    #endif
+
     Nop(); // Debugging break point anchors
     Nop();
     Nop();
@@ -55,5 +108,9 @@ void __attribute__((__interrupt__, auto_psv, context))_BUCK_VLOOP_Interrupt(void
     
     DBGPIN_1_CLEAR;
 //    PWRGOOD_CLEAR;
+
+    #if (CPU_PROFILER_ENABLE == true)
+    prof_isr_exit(&profobj_Main); // Capture interrupt duration
+    #endif
     
 }
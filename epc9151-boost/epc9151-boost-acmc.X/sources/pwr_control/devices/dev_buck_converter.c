@@ -13,6 +13,86 @@
 #include "pwr_control/devices/dev_buck_typedef.h"
 #include "pwr_control/devices/dev_buck_converter.h"
 
+/* PRIVATE DATA TYPES */
+typedef struct {
+    volatile uint16_t (*Entry)(volatile BUCK_POWER_CONTROLLER_t*);   // Function pointer to ENTRY hook (optional)
+    volatile uint16_t (*Execute)(volatile BUCK_POWER_CONTROLLER_t*); // Function pointer to EXECUTE handler
+    volatile uint16_t (*Exit)(volatile BUCK_POWER_CONTROLLER_t*);    // Function pointer to EXIT hook (optional)
+} BUCK_SM_STATE_HANDLER_t; // State handler table entry
+
+typedef struct {
+    BUCK_MODE_STATE_e state;    // Active state
+    BUCK_SM_EVENT_e   event;    // Event reported by the state handler
+    BUCK_MODE_STATE_e next;     // Next state
+} BUCK_SM_TRANSITION_t; // State transition table entry
+
+/* PRIVATE FUNCTION PROTOTYPES */
+volatile uint16_t buckSM_Dispatch(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckSM_Transition(volatile BUCK_POWER_CONTROLLER_t* buckInstance, 
+            volatile BUCK_MODE_STATE_e next, volatile BUCK_SM_EVENT_e event);
+
+volatile uint16_t buckState_InitializeExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_ResetExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_StandbyEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_StandbyExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_StandbyExit(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_PowerOnDelayEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_PowerOnDelayExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_LaunchVRampExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_VRampUpEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_VRampUpExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_VRampUpExit(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_IRampUpEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_IRampUpExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_PowerGoodDelayEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_PowerGoodDelayExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_OnlineEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_OnlineExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+volatile uint16_t buckState_SuspendExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
+
+/* STATE HANDLER TABLE */
+// Entry and exit hooks are executed once per state visit. The execute handler is 
+// called each time the state machine is executed and reports events.
+const BUCK_SM_STATE_HANDLER_t buck_state_handler[BUCK_STATE_COUNT] = {
+//    Entry Hook                      Execute Handler                      Exit Hook
+    { NULL,                           &buckState_InitializeExecute,        NULL },                      // BUCK_STATE_INITIALIZE
+    { NULL,                           &buckState_ResetExecute,             NULL },                      // BUCK_STATE_RESET
+    { &buckState_StandbyEntry,        &buckState_StandbyExecute,           &buckState_StandbyExit },    // BUCK_STATE_STANDBY
+    { &buckState_PowerOnDelayEntry,   &buckState_PowerOnDelayExecute,      NULL },                      // BUCK_STATE_POWER_ON_DELAY
+    { NULL,                           &buckState_LaunchVRampExecute,       NULL },                      // BUCK_STATE_LAUNCH_V_RAMP
+    { &buckState_VRampUpEntry,        &buckState_VRampUpExecute,           &buckState_VRampUpExit },    // BUCK_STATE_V_RAMP_UP
+    { &buckState_IRampUpEntry,        &buckState_IRampUpExecute,           NULL },                      // BUCK_STATE_I_RAMP_UP
+    { &buckState_PowerGoodDelayEntry, &buckState_PowerGoodDelayExecute,    NULL },                      // BUCK_STATE_PWRGOOD_DELAY
+    { &buckState_OnlineEntry,         &buckState_OnlineExecute,            NULL },                      // BUCK_STATE_ONLINE
+    { NULL,                           &buckState_SuspendExecute,           NULL }                       // BUCK_STATE_SUSPEND
+};
+
+/* STATE TRANSITION TABLE */
+// Events of the active state without entry in this table are ignored
+const BUCK_SM_TRANSITION_t buck_transition_table[] = {
+//    Active State                 Event               Next State
+    { BUCK_STATE_INITIALIZE,     BUCK_EVT_DONE,      BUCK_STATE_RESET },
+    { BUCK_STATE_RESET,          BUCK_EVT_DONE,      BUCK_STATE_STANDBY },
+    { BUCK_STATE_STANDBY,        BUCK_EVT_START,     BUCK_STATE_POWER_ON_DELAY },
+    { BUCK_STATE_POWER_ON_DELAY, BUCK_EVT_DONE,      BUCK_STATE_LAUNCH_V_RAMP },
+    { BUCK_STATE_POWER_ON_DELAY, BUCK_EVT_SHUTDOWN,  BUCK_STATE_RESET },
+    { BUCK_STATE_LAUNCH_V_RAMP,  BUCK_EVT_DONE,      BUCK_STATE_V_RAMP_UP },
+    { BUCK_STATE_LAUNCH_V_RAMP,  BUCK_EVT_SHUTDOWN,  BUCK_STATE_RESET },
+    { BUCK_STATE_V_RAMP_UP,      BUCK_EVT_DONE,      BUCK_STATE_I_RAMP_UP },
+    { BUCK_STATE_V_RAMP_UP,      BUCK_EVT_SKIP,      BUCK_STATE_PWRGOOD_DELAY },
+    { BUCK_STATE_V_RAMP_UP,      BUCK_EVT_SHUTDOWN,  BUCK_STATE_RESET },
+    { BUCK_STATE_I_RAMP_UP,      BUCK_EVT_DONE,      BUCK_STATE_PWRGOOD_DELAY },
+    { BUCK_STATE_I_RAMP_UP,      BUCK_EVT_SHUTDOWN,  BUCK_STATE_RESET },
+    { BUCK_STATE_PWRGOOD_DELAY,  BUCK_EVT_DONE,      BUCK_STATE_ONLINE },
+    { BUCK_STATE_PWRGOOD_DELAY,  BUCK_EVT_SHUTDOWN,  BUCK_STATE_RESET },
+    { BUCK_STATE_ONLINE,         BUCK_EVT_SHUTDOWN,  BUCK_STATE_RESET },
+    { BUCK_STATE_SUSPEND,        BUCK_EVT_DONE,      BUCK_STATE_RESET },
+    { BUCK_STATE_SUSPEND,        BUCK_EVT_SHUTDOWN,  BUCK_STATE_RESET }
+};
+
+#define BUCK_SM_TRANSITIONS  (sizeof(buck_transition_table) / sizeof(BUCK_SM_TRANSITION_t)) // Number of transitions
+
+
 /* @@drv_BuckConverter_Initialize
  * ********************************************************************************
  * Summary:
@@ -35,7 +115,7 @@ volatile uint16_t drv_BuckConverter_Initialize(volatile BUCK_POWER_CONTROLLER_t*
     
     if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC) { // In current mode...
      
-        for (_i=0; _i<buck.set_values.phases; _i++) // Reset phase current values
+        for (_i=0; _i<buckInstance->set_values.phases; _i++) // Reset phase current values
         { buckInstance->i_loop[_i].controller->status.bits.enabled = false; } // Disable current loop
     
     }
@@ -43,18 +123,47 @@ volatile uint16_t drv_BuckConverter_Initialize(volatile BUCK_POWER_CONTROLLER_t*
     buckInstance->status.bits.enabled = false;  // Disable Buck Converter
     buckInstance->mode = BUCK_STATE_INITIALIZE; // Reset state machine
     
+    // Reset state machine transition log and timing data
+    buckInstance->sm.state = BUCK_STATE_INITIALIZE;
+    buckInstance->sm.event = BUCK_EVT_NONE;
+    buckInstance->sm.tick = 0;
+    buckInstance->sm.start_time = 0;
+    buckInstance->sm.startup_time = 0;
+    buckInstance->sm.log_index = 0;
+    buckInstance->sm.log_count = 0;
+    
+    for (_i=0; _i<BUCK_STATE_COUNT; _i++)
+    {
+        buckInstance->sm.entry_time[_i] = 0;
+        buckInstance->sm.duration[_i] = 0;
+    }
+    
     return(retval);
 }
 
 /* @@drv_BuckConverter_Execute
  * ********************************************************************************
  * Summary:
+ * Executes the power converter state machine
  * 
  * Parameters:
+ *  volatile BUCK_POWER_CONTROLLER_t* buckInstance: Pointer to power converter object
  * 
  * Returns:
+ *  1: success
+ *  0: error
  * 
  * Description:
+ * The state machine is table-driven. Each call executes the handler of the active
+ * state, which reports an event. The event is looked up in the transition table
+ * together with the active state. When a matching transition is found, the exit 
+ * hook of the active state and the entry hook of the next state are executed. 
+ * Entry and exit actions are therefore only executed once per state visit.
+ * 
+ * Each transition is recorded in the transition log with a time stamp based on 
+ * the state machine call counter. The time spent in each state during its most
+ * recent visit as well as the time-to-regulation of the most recent startup are
+ * tracked in the state machine timing data of the converter object.
  * 
  * ********************************************************************************/
 
@@ -62,10 +171,22 @@ volatile uint16_t drv_BuckConverter_Execute(volatile BUCK_POWER_CONTROLLER_t* bu
     
     // generic auxiliary variables
     volatile uint16_t retval = 1;
-    volatile uint16_t _i = 0;
 
-    // auxiliary variables for calculation of estimated duty cycle
-    volatile uint32_t _vout=0, _vin=0, _start_dc=0; 
+    // Advance state machine time base
+    buckInstance->sm.tick++;
+    
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    /* EXTERNAL STATE CHANGE                                                              */
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    // When the state has been set by external software (e.g. by calling the suspend 
+    // or resume API), the transition is executed including exit and entry hooks
+    if (buckInstance->mode != buckInstance->sm.state)
+    {
+        if ((uint16_t)buckInstance->mode >= BUCK_STATE_COUNT) // Undefined state
+            buckInstance->mode = BUCK_STATE_INITIALIZE;       // will reset the state machine
+        
+        retval &= buckSM_Transition(buckInstance, buckInstance->mode, BUCK_EVT_EXTERNAL);
+    }
     
     /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
     /* DISABLE-RESET                                                                      */
@@ -75,454 +196,677 @@ volatile uint16_t drv_BuckConverter_Execute(volatile BUCK_POWER_CONTROLLER_t* bu
         (!buckInstance->status.bits.power_source_detected) ||
         (buckInstance->status.bits.fault_active))
     {
-        if (!buckInstance->status.bits.ready)
-            buckInstance->mode = BUCK_STATE_INITIALIZE;
-        else
-            buckInstance->mode = BUCK_STATE_RESET;
+        // When the power source has been lost, the full power-on delay has to be observed again
+        if (!buckInstance->status.bits.power_source_detected)
+            buckInstance->startup.power_on_delay.counter = 0;
+
+        buckInstance->sm.event = BUCK_EVT_SHUTDOWN;
+        retval &= buckSM_Dispatch(buckInstance);
     }    
     /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
     /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
     /* EXECUTE STATE MACHINE                                                              */
     /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-    switch (buckInstance->mode) {
-
-        /*!BUCK_STATE_INITIALIZE
-         * ============================
-         * If the controller has not been run yet, the POWER ON and POWER GOOD delay
-         * counters are reset and conditional flag bits are cleared. Status of 
-         * power source, ADC and current sensor calibration have to be set during
-         * runtime by system check routines. 
-         * */
-        case BUCK_STATE_INITIALIZE:
-
-            // Set the BUSY bit indicating a delay/ramp period being executed
-            buckInstance->status.bits.busy = true;
-            
-            buckInstance->startup.power_on_delay.counter = 0;   // Reset power on counter
-            buckInstance->startup.power_good_delay.counter = 0; // Reset power good counter
-
-            // Reset all status bits
-            buckInstance->status.bits.power_source_detected = false;
-            buckInstance->status.bits.adc_active = false;
-
-            // Initiate current sensor calibration flag bit
-            if (buckInstance->status.bits.cs_calib)
-                buckInstance->status.bits.cs_calib_complete = false; 
-            else
-                buckInstance->status.bits.cs_calib_complete = true; 
-            
-            // If defined, set POWER_GOOD output
-            if(buckInstance->gpio.PowerGood.enabled)
-                buckGPIO_Clear(&buckInstance->gpio.PowerGood);
-            
-            // switch to soft-start phase RESUME
-            buckInstance->mode = BUCK_STATE_RESET;
+    buckInstance->sm.event = BUCK_EVT_NONE;
+    
+    if (buck_state_handler[buckInstance->sm.state].Execute != NULL)
+        retval &= buck_state_handler[buckInstance->sm.state].Execute(buckInstance);
+    
+    retval &= buckSM_Dispatch(buckInstance);
+    
+    return(retval);
+}
+
+/* @@buckSM_Dispatch
+ * ********************************************************************************
+ * Summary:
+ * Looks up the most recent event in the transition table
+ * 
+ * Parameters:
+ *  volatile BUCK_POWER_CONTROLLER_t* buckInstance: Pointer to power converter object
+ * 
+ * Returns:
+ *  1: success
+ *  0: error
+ * 
+ * Description:
+ * Events without a matching entry for the active state are ignored.
+ * 
+ * ********************************************************************************/
 
+volatile uint16_t buckSM_Dispatch(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    volatile uint16_t retval=1;
+    volatile uint16_t _i=0;
+    
+    if (buckInstance->sm.event == BUCK_EVT_NONE)
+        return(retval);
+    
+    for (_i=0; _i<BUCK_SM_TRANSITIONS; _i++)
+    {
+        if ((buck_transition_table[_i].state == buckInstance->sm.state) &&
+            (buck_transition_table[_i].event == buckInstance->sm.event))
+        {
+            retval &= buckSM_Transition(buckInstance, 
+                        buck_transition_table[_i].next, buckInstance->sm.event);
             break;
+        }
+    }
+    
+    return(retval);
+}
 
-        /*!BUCK_STATE_RESET
-         * ============================
-         * After successful initialization or after an externally triggered state machine reset,
-         * the state machine returns to this RESET mode, re-initiating control mode, references 
-         * and status bits before switching further into STANDBY mode
-         * */
-        case BUCK_STATE_RESET:
-
-            // Set the BUSY bit indicating a delay/ramp period being executed
-            buckInstance->status.bits.busy = true;
-
-            // Disable PWM outputs & control loops (immediate power cut-off)
-            retval &= buckPWM_Suspend(buckInstance); // Disable PWM outputs
-
-            // Disable voltage loop controller and reset control loop histories
-            buckInstance->v_loop.controller->status.bits.enabled = false; // disable voltage control loop
-            buckInstance->v_loop.ctrl_Reset(buckInstance->v_loop.controller); // Reset control histories of outer voltage controller
-            *buckInstance->v_loop.controller->Ports.Target.ptrAddress = 
-                buckInstance->v_loop.controller->Limits.MinOutput;
-            
-            // Disable current loop controller and reset control loop histories
-            if (buck.set_values.control_mode == BUCK_CONTROL_MODE_ACMC) 
-            {   // Disable all current control loops and reset control loop histories
-                
-                for (_i=0; _i<buck.set_values.phases; _i++)  { 
-
-                    buckInstance->i_loop[_i].controller->status.bits.enabled = false; 
-                    buckInstance->i_loop[_i].ctrl_Reset(buckInstance->i_loop[_i].controller); 
-                    *buckInstance->i_loop[_i].controller->Ports.Target.ptrAddress = 
-                        buckInstance->i_loop[_i].controller->Limits.MinOutput;
-                }
-            }
-                
-            // If defined, set POWER_GOOD output
-            if(buckInstance->gpio.PowerGood.enabled)
-                buckGPIO_Clear(&buckInstance->gpio.PowerGood);
-
-            // Switch to STANDBY mode
-            buckInstance->mode = BUCK_STATE_STANDBY;  
+/* @@buckSM_Transition
+ * ********************************************************************************
+ * Summary:
+ * Executes a state transition
+ * 
+ * Parameters:
+ *  volatile BUCK_POWER_CONTROLLER_t* buckInstance: Pointer to power converter object
+ *  volatile BUCK_MODE_STATE_e next: State to be entered
+ *  volatile BUCK_SM_EVENT_e event: Event triggering the transition
+ * 
+ * Returns:
+ *  1: success
+ *  0: error
+ * 
+ * Description:
+ * Executes the exit hook of the active state, updates state timing data and 
+ * transition log and executes the entry hook of the next state. 
+ * 
+ * ********************************************************************************/
 
-            break;
-            
-        /*!BUCK_STATE_STANDBY
-         * ============================
-         * After a successful state machine reset, the state machine waits in  
-         * STANDBY mode until all conditional flag bits are set/cleared allowing  
-         * the converter to run.
-         * */
-        case BUCK_STATE_STANDBY:
-            
-            // Set the BUSY bit indicating a delay/ramp period being executed
-            buckInstance->status.bits.busy = false;
-
-            // if the 'autorun' option is set, automatically set the GO bit when the 
-            // converter is enabled
-            if ((buckInstance->status.bits.enabled) && (buckInstance->status.bits.autorun))
-            { buckInstance->status.bits.GO = true; }
-            
-            // If converter supports external ENABLE pin, the pin state may override the GO bit
-            if (buckInstance->gpio.Enable.enabled)
-                buckInstance->status.bits.GO &= buckGPIO_GetPinState(&buckInstance->gpio.Enable);
-            
-            // Wait for all startup conditions to be met
-            if ((buckInstance->status.bits.enabled) &&          // state machine needs to be enabled
-                (buckInstance->status.bits.GO) &&               // GO-bit needs to be set
-                (buckInstance->status.bits.adc_active) &&       // ADC needs to be running
-                (buckInstance->status.bits.pwm_active) &&       // PWM needs to be running 
-                (!buckInstance->status.bits.fault_active) &&    // No active fault is present
-                (buckInstance->status.bits.cs_calib_complete)      // Current Sensor Calibration complete
-                )
-            {
-                // switch to soft-start phase POWER-ON DELAY
-                buckInstance->status.bits.GO = false;   // Clear the GO bit
-                buckInstance->mode = BUCK_STATE_POWER_ON_DELAY; // Step over of POD
-            }
-                
-            break;
-            
-            
-        /*!BUCK_STATE_POWER_ON_DELAY
-         * ================================
-         * After the converter has been cleared to get started, the power-on 
-         * delay counter until the defined power-on delay period has expired.
-         * */
-        case BUCK_STATE_POWER_ON_DELAY:
-
-            buckInstance->status.bits.busy = true;  // Set the BUSY bit
-
-            // delay startup until POWER ON DELAY has expired
-            
-            if(buckInstance->startup.power_on_delay.counter++ > buckInstance->startup.power_on_delay.period)
-            {
-                // Clamp POD counter to EXPIRED
-                buckInstance->startup.power_on_delay.counter = 
-                    (buckInstance->startup.power_on_delay.period + 1); // Saturate power on counter
-
-                if (buckInstance->status.bits.cs_calib_complete)   // if current sensors is calibrated
-                {
-                    buckInstance->mode = BUCK_STATE_LAUNCH_V_RAMP; // ramp up output
-                }
-
-            }
-                
-            break;
+volatile uint16_t buckSM_Transition(volatile BUCK_POWER_CONTROLLER_t* buckInstance, 
+            volatile BUCK_MODE_STATE_e next, volatile BUCK_SM_EVENT_e event)
+{
+    volatile uint16_t retval=1;
+    volatile BUCK_MODE_STATE_e _prev;
+    volatile BUCK_SM_LOG_ENTRY_t* _log;
+    
+    _prev = buckInstance->sm.state;
+    
+    // Leave active state
+    if (buck_state_handler[_prev].Exit != NULL)
+        retval &= buck_state_handler[_prev].Exit(buckInstance);
+    
+    buckInstance->sm.duration[_prev] = (buckInstance->sm.tick - buckInstance->sm.entry_time[_prev]);
+    
+    // Record transition
+    _log = &buckInstance->sm.log[buckInstance->sm.log_index];
+    _log->time_stamp = buckInstance->sm.tick;
+    _log->from = (uint8_t)_prev;
+    _log->to = (uint8_t)next;
+    _log->event = (uint8_t)event;
+    
+    if (++buckInstance->sm.log_index >= BUCK_SM_LOG_SIZE) 
+        buckInstance->sm.log_index = 0;
+    if (buckInstance->sm.log_count < 0xFFFF) 
+        buckInstance->sm.log_count++;
+    
+    // Capture startup timing (start command until output is in regulation)
+    if ((_prev == BUCK_STATE_STANDBY) && (next == BUCK_STATE_POWER_ON_DELAY))
+        buckInstance->sm.start_time = buckInstance->sm.tick;
+    else if (next == BUCK_STATE_ONLINE)
+        buckInstance->sm.startup_time = (buckInstance->sm.tick - buckInstance->sm.start_time);
+    
+    // Enter next state
+    buckInstance->sm.state = next;
+    buckInstance->mode = next;
+    buckInstance->sm.entry_time[next] = buckInstance->sm.tick;
+    
+    if (buck_state_handler[next].Entry != NULL)
+        retval &= buck_state_handler[next].Entry(buckInstance);
+    
+    return(retval);
+}
 
-        /*!BUCK_STATE_LAUNCH_V_RAMP
-         * ================================
-         * After the POWER ON DELAY has expired, the ramp up starting point is determined by measuring the input and output 
-         * voltage and calculates the ideal duty ratio of the PWM. This value is then programmed into
-         * the PWM module duty cycle register and is also used to pre-charge the control loop output
-         * history. In addition the measured output voltage also set as reference to ensure the loop 
-         * starts without jerks and jumps.
-         * When voltage mode control is enabled, the voltage loop control history is charged, 
-         * when average current mode control is enabled, the current loop control history is charged.
-         *  */
-        case BUCK_STATE_LAUNCH_V_RAMP:
-
-            buckInstance->status.bits.busy = true;  // Set the BUSY bit
-            
-            // Hijack voltage loop controller reference
-            buckInstance->startup.v_ramp.reference = 0; // Reset Soft-Start Voltage Reference
-            buckInstance->startup.i_ramp.reference = BUCK_ISNS_REF; // Reset Soft-Start Current Reference
-            buckInstance->v_loop.controller->Ports.ptrControlReference = 
-                &buckInstance->startup.v_ramp.reference; // Voltage loop is pointing to Soft-Start Reference
-
-            // Pre-charge reference and never start above the pre-biased output voltage.
-            // Always start at or slightly below the pre-biased output voltage
-            #if (BOOST_MODE == true)
-            buckInstance->startup.v_ramp.reference = buckInstance->data.v_in;
-            #else
-            buckInstance->startup.v_ramp.reference = buckInstance->data.v_out;
-            #endif
-            // In average current mode, set current reference limit to max startup current level
-            if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC) 
-            {   // Disable all current control loops and reset control loop histories
-                buckInstance->v_loop.maximum = buckInstance->startup.i_ramp.reference;
-                buckInstance->v_loop.controller->Limits.MaxOutput = buckInstance->v_loop.maximum;
-            }
-                
-            // Pre-charge PWM and control loop history 
-            if(((buckInstance->data.v_in - buckInstance->feedback.ad_vin.scaling.offset) > 0) &&
-               ((buckInstance->data.v_out - buckInstance->feedback.ad_vout.scaling.offset) > 0) )
-            {
-                _vout = __builtin_muluu(
-                    (buckInstance->data.v_out - buckInstance->feedback.ad_vout.scaling.offset), 
-                    buckInstance->feedback.ad_vout.scaling.factor);
-                _vout >>= (16 - buckInstance->feedback.ad_vout.scaling.scaler);
-
-                _vin = __builtin_muluu(
-                    (buckInstance->data.v_in - buckInstance->feedback.ad_vin.scaling.offset), 
-                    buckInstance->feedback.ad_vin.scaling.factor);
-                _vin >>= (16 - buckInstance->feedback.ad_vin.scaling.scaler);
-
-                _start_dc = __builtin_muluu(_vout, buckInstance->sw_node[0].period);
-                _start_dc = __builtin_divud(_start_dc, (uint16_t)_vin);
-                
-                #if (BOOST_MODE == true)
-                if (_vin > _vout)
-                    _start_dc = buckInstance->sw_node[0].period - _start_dc;
-                else
-                    _start_dc = (uint16_t)buckInstance->sw_node[0].duty_ratio_min;
-                    buckInstance->startup.v_ramp.reference += 50*buckInstance->startup.v_ramp.ref_inc_step;
-                #endif
-            }
-            else
-            // If there is no input voltage or no output voltage, start with minimum duty ratio
-            {
-                _start_dc = (uint16_t)buckInstance->sw_node[0].duty_ratio_min;
-            }
-            
-            if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_VMC)
-            {
-                if(_start_dc < buckInstance->v_loop.minimum) 
-                { _start_dc = buckInstance->v_loop.minimum; }
-                else if(_start_dc > buckInstance->v_loop.maximum) 
-                { _start_dc = buckInstance->v_loop.maximum; }
-
-                buckInstance->v_loop.ctrl_Precharge(buckInstance->v_loop.controller, 0, _start_dc);
-                *buckInstance->v_loop.controller->Ports.Target.ptrAddress = _start_dc; // set initial PWM duty ratio
-                *buckInstance->v_loop.controller->Ports.AltTarget.ptrAddress = _start_dc; // set initial PWM duty ratio
-
-            }
-            else if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC) 
-            {   
-                for (_i=0; _i<buck.set_values.phases; _i++)  
-                { 
-                    if(_start_dc < buckInstance->i_loop[_i].minimum) 
-                    { _start_dc = buckInstance->i_loop[_i].minimum; }
-                    else if(_start_dc > buckInstance->i_loop[_i].maximum) 
-                    { _start_dc = buckInstance->i_loop[_i].maximum; }
-
-                    buckInstance->i_loop[_i].ctrl_Precharge(
-                                buckInstance->i_loop[_i].controller, 0, _start_dc
-                            );
-
-                    *buckInstance->i_loop[_i].controller->Ports.Target.ptrAddress = _start_dc; // set initial PWM duty ratio
-                    *buckInstance->i_loop[_i].controller->Ports.AltTarget.ptrAddress = _start_dc; // set initial PWM duty ratio
-                }
-            }
-
-            // switch to soft-start phase RAMP UP
-            buckInstance->mode = BUCK_STATE_V_RAMP_UP;
+/* *************************************************************************************************
+ * STATE HANDLERS
+ * ************************************************************************************************/
+
+/*!BUCK_STATE_INITIALIZE
+ * ============================
+ * If the controller has not been run yet, the POWER ON and POWER GOOD delay
+ * counters are reset and conditional flag bits are cleared. Status of 
+ * power source, ADC and current sensor calibration have to be set during
+ * runtime by system check routines. 
+ * */
+volatile uint16_t buckState_InitializeExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    // Set the BUSY bit indicating a delay/ramp period being executed
+    buckInstance->status.bits.busy = true;
 
-            break;
-            
-        /*!BUCK_STATE_V_RAMP_UP
-         * ===========================
-         * This is the essential step in which the output voltage is ramped up by incrementing the 
-         * outer control loop reference. In voltage mode the output voltage will ramp up to the 
-         * nominal regulation point. 
-         * In average current mode the inner loop will limit the current as soon as the current 
-         * reference limit is hit and the output is switched to constant current mode. 
-         * */
-        case BUCK_STATE_V_RAMP_UP:
-
-            buckInstance->status.bits.busy = true;  // Set the BUSY bit
-
-            // enable control loop
-            if(!buckInstance->v_loop.controller->status.bits.enabled) {
-
-                // Enable input power source
-                retval &= buckPWM_Resume(buckInstance);  // Enable PWM outputs
-
-                if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_VMC)
-                {   
-                    buckInstance->v_loop.controller->status.bits.enabled = true; // enable voltage loop controller
-                }
-                else if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC)
-                {
-                    buckInstance->v_loop.controller->status.bits.enabled = true; // enable voltage loop controller
-                    for (_i=0; _i<buckInstance->set_values.phases; _i++)
-                    { buckInstance->i_loop[_i].controller->status.bits.enabled = true; } // enable phase current loop controller
-                }
-
-            }
-            
-            // increment reference
-            buckInstance->startup.v_ramp.reference += buckInstance->startup.v_ramp.ref_inc_step;
-            
-            // check if ramp is complete
-            if (buckInstance->startup.v_ramp.reference > buckInstance->v_loop.reference) 
-            {
-                // Set reference to the desired level
-                buckInstance->startup.v_ramp.reference = buckInstance->v_loop.reference;
-                
-                // Reconnect API reference to controller
-                buckInstance->v_loop.controller->Ports.ptrControlReference = &buckInstance->v_loop.reference;
-                
-                if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_VMC)
-                    buckInstance->mode = BUCK_STATE_PWRGOOD_DELAY;
-                else if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC)
-                    buckInstance->mode = BUCK_STATE_I_RAMP_UP;
-
-            }
+    buckInstance->startup.power_on_delay.counter = 0;   // Reset power on counter
+    buckInstance->startup.power_good_delay.counter = 0; // Reset power good counter
 
-            break;
+    // Reset all status bits
+    buckInstance->status.bits.power_source_detected = false;
+    buckInstance->status.bits.adc_active = false;
 
-        /*!BUCK_STATE_I_RAMP_UP
-         * ===========================
-         * This phase of the soft-start ramp is only executed in average current mode and will 
-         * only take effect when the current limit is hit before the nominal voltage regulation 
-         * point. In this case the constant output current is ramped up to from the startup current
-         * to the nominal constant charging current. 
-         * */
-        case BUCK_STATE_I_RAMP_UP:
-
-            if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC)
-            {
-            
-                buckInstance->status.bits.busy = true;  // Set the BUSY bit
-
-                // increment current limit
-                buckInstance->v_loop.controller->Limits.MaxOutput += buckInstance->startup.i_ramp.ref_inc_step; // Increment maximum current limit
-
-                // check if ramp is complete
-                if (buckInstance->v_loop.controller->Limits.MaxOutput >= BUCK_ISNS_REF_MAX)
-                {
-                    buckInstance->v_loop.maximum = BUCK_ISNS_REF_MAX;
-                    buckInstance->v_loop.controller->Limits.MaxOutput = buckInstance->v_loop.maximum;
-                    buckInstance->mode = BUCK_STATE_PWRGOOD_DELAY;
-
-                }
-            
-            }
-            else // Non-Current Loops Ending up here need to be lifted to PG_DELAY
-            { 
-                buckInstance->v_loop.controller->Limits.MaxOutput = buckInstance->v_loop.maximum;
-                buckInstance->mode = BUCK_STATE_PWRGOOD_DELAY; 
-            }
-            
-            break;
+    // Initiate current sensor calibration flag bit
+    if (buckInstance->status.bits.cs_calib)
+        buckInstance->status.bits.cs_calib_complete = false; 
+    else
+        buckInstance->status.bits.cs_calib_complete = true; 
 
-        /*!BUCK_STATE_PWRGOOD_DELAY
-         * =============================
-         * In this phase of the soft-start procedure a counter is incremented until the power good 
-         * delay has expired before the soft-start process is marked as COMPLETEd 
-         * */
-        case BUCK_STATE_PWRGOOD_DELAY:
-            // POWER GOOD Delay
-
-            buckInstance->status.bits.busy = true;  // Set the BUSY bit
-            
-            // increment delay counter until the GOWER GOOD delay has expired
-            if(buckInstance->startup.power_good_delay.counter++ > buckInstance->startup.power_good_delay.period)
-            {
-                buckInstance->mode = BUCK_STATE_ONLINE; // Set COMPLETE flag
-                buckInstance->startup.power_good_delay.counter = 
-                    (buckInstance->startup.power_good_delay.period + 1); // Clamp to PERIOD_EXPIRED for future startups
-                
-                // If defined, set POWER_GOOD output
-                if(buckInstance->gpio.PowerGood.enabled)
-                    buckGPIO_Set(&buckInstance->gpio.PowerGood);
-            }
+    // If defined, set POWER_GOOD output
+    if(buckInstance->gpio.PowerGood.enabled)
+        buckGPIO_Clear(&buckInstance->gpio.PowerGood);
 
-            break;
-            
-        /*!BUCK_STATE_COMPLETE
-         * =============================
-         * When the soft-start step is set to BUCK_STATE_CHARGING, the soft-start state machine 
-         * will not be executed any further and the converter has entered normal operation.  
-         * */
-        case BUCK_STATE_ONLINE:
-            
-            /*!Runtime Reference Tuning
-             * ==================================================================================
-             * Description:
-             * If the user reference setting has been changed and is different from the most recent 
-             * controller reference/current clamping, the state machine will tune the controller 
-             * reference/current clamping into the new user control reference level. 
-             * While ramping the output voltage up or down, the BUSY bit will be set and any new 
-             * changes to the reference will be ignored until the ramp up/down is complete.
-             * =================================================================================*/
-
-            if(buckInstance->set_values.v_ref != buckInstance->v_loop.reference) 
-            {
-                // Set the BUSY bit indicating a delay/ramp period being executed
-                buckInstance->status.bits.busy = true;
-                
-                // New reference value is less than controller reference value => ramp down
-                if(buckInstance->set_values.v_ref < buckInstance->v_loop.reference){
-                    // decrement reference until new reference level is reached
-                    buckInstance->v_loop.reference -= buckInstance->startup.v_ramp.ref_inc_step; // decrement reference
-                    if(buckInstance->v_loop.reference < buckInstance->set_values.v_ref) { // check if ramp is complete
-                        buckInstance->v_loop.reference = buckInstance->set_values.v_ref; // clamp reference level to setting
-                    }
-                        
-                }
-                // New reference value is greater than controller reference value => ramp up
-                else if(buckInstance->set_values.v_ref > buckInstance->v_loop.reference){
-                    // increment reference until new reference level is reached
-                    buckInstance->v_loop.reference += buckInstance->startup.v_ramp.ref_inc_step; // increment reference
-                    if(buckInstance->v_loop.reference > buckInstance->set_values.v_ref) { // check if ramp is complete
-                        buckInstance->v_loop.reference = buckInstance->set_values.v_ref; // clamp reference level to setting
-                    }
-                        
-                }
-                
-            }
-            else{
-                // Clear the BUSY bit indicating "no state machine activity"
-                buckInstance->status.bits.busy = false;
-            }
-              
-            break;
+    // Converter object has been initialized, future shut-downs only reset the state machine
+    buckInstance->status.bits.ready = true;
+    
+    // switch to soft-start phase RESUME
+    buckInstance->sm.event = BUCK_EVT_DONE;
 
-        /*!BUCK_STATE_SUSPEND
-         * =============================
-         * When the state machine step is set to BATCRG_STEP_SUSPEND, the PWM and control
-         * loops are reset and the state machine is reset to RESUME mode WITH all
-         * delay counters pre-charged. When re-enabled, the state machine will perform 
-         * a soft-start without POWER ON and POWER GOOD delays.
-         * */
-        case BUCK_STATE_SUSPEND:
-
-            // Disable PWM outputs & control loops (immediate power shut-down)
-            retval &= buckPWM_Stop(buckInstance); // Disable PWM outputs
-            
-            buckInstance->v_loop.controller->status.bits.enabled = false;   // disable voltage control loop
-            
-            if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC){
-                for (_i=0; _i<buckInstance->set_values.phases; _i++)
-                { buckInstance->i_loop[_i].controller->status.bits.enabled = false; } // disable current control loop
-            }
-            
-            // Reset the state machine to repeat the soft-start without delays (ramp only)
-            buckInstance->startup.power_on_delay.counter = (buckInstance->startup.power_on_delay.period + 1); // Clamp POD counter to PERIOD_EXPIRED for future startups
-            buckInstance->startup.power_good_delay.counter = (buckInstance->startup.power_good_delay.period + 1); // Clamp PG counter to PERIOD_EXPIRED for future startups
-
-            buckInstance->mode = BUCK_STATE_RESET; // Reset state machine to RESUME
-            
-            break;
+    return(1);
+}
 
-        /*!BUCK_STATE_UNDEFINED
-         * ===========================
-         * When this state-machine step is executed, something went wrong in the master state machine.
-         * To fix this issue the state-machine will be reset to INITIALIZATE.  
-         * */
-        default:
-            buckInstance->mode = BUCK_STATE_INITIALIZE;
-            break;
-    }            
+/*!BUCK_STATE_RESET
+ * ============================
+ * After successful initialization or after an externally triggered state machine reset,
+ * the state machine returns to this RESET mode, re-initiating control mode, references 
+ * and status bits before switching further into STANDBY mode
+ * */
+volatile uint16_t buckState_ResetExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    volatile uint16_t retval=1;
+    volatile uint16_t _i=0;
     
+    // Set the BUSY bit indicating a delay/ramp period being executed
+    buckInstance->status.bits.busy = true;
+
+    // Disable PWM outputs & control loops (immediate power cut-off)
+    retval &= buckPWM_Suspend(buckInstance); // Disable PWM outputs
+    retval &= buckTraj_Abort(&buckInstance->v_traj); // Stop reference trajectory
+
+    // Disable voltage loop controller and reset control loop histories
+    buckInstance->v_loop.controller->status.bits.enabled = false; // disable voltage control loop
+    buckInstance->v_loop.ctrl_Reset(buckInstance->v_loop.controller); // Reset control histories of outer voltage controller
+    *buckInstance->v_loop.controller->Ports.Target.ptrAddress = 
+        buckInstance->v_loop.controller->Limits.MinOutput;
+
+    // Disable current loop controller and reset control loop histories
+    if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC) 
+    {   // Disable all current control loops and reset control loop histories
+
+        for (_i=0; _i<buckInstance->set_values.phases; _i++)  { 
+
+            buckInstance->i_loop[_i].controller->status.bits.enabled = false; 
+            buckInstance->i_loop[_i].ctrl_Reset(buckInstance->i_loop[_i].controller); 
+            *buckInstance->i_loop[_i].controller->Ports.Target.ptrAddress = 
+                buckInstance->i_loop[_i].controller->Limits.MinOutput;
+        }
+    }
+
+    // If defined, set POWER_GOOD output
+    if(buckInstance->gpio.PowerGood.enabled)
+        buckGPIO_Clear(&buckInstance->gpio.PowerGood);
+
+    // Switch to STANDBY mode
+    buckInstance->sm.event = BUCK_EVT_DONE;
+
+    return(retval);
+}
+
+/*!BUCK_STATE_STANDBY
+ * ============================
+ * After a successful state machine reset, the state machine waits in  
+ * STANDBY mode until all conditional flag bits are set/cleared allowing  
+ * the converter to run.
+ * */
+volatile uint16_t buckState_StandbyEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    // Clear the BUSY bit indicating "no state machine activity"
+    buckInstance->status.bits.busy = false;
+    
+    return(1);
+}
+
+volatile uint16_t buckState_StandbyExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    // if the 'autorun' option is set, automatically set the GO bit when the 
+    // converter is enabled
+    if ((buckInstance->status.bits.enabled) && (buckInstance->status.bits.autorun))
+    { buckInstance->status.bits.GO = true; }
+
+    // Power-on delay period starts as soon as a valid power source is present
+    if ((buckInstance->status.bits.power_source_detected) &&
+        (buckInstance->startup.power_on_delay.counter <= buckInstance->startup.power_on_delay.period))
+        buckInstance->startup.power_on_delay.counter++;
+
+    // If converter supports external ENABLE pin, the pin state may override the GO bit
+    if (buckInstance->gpio.Enable.enabled)
+        buckInstance->status.bits.GO &= buckGPIO_GetPinState(&buckInstance->gpio.Enable);
+
+    // Wait for all startup conditions to be met
+    if ((buckInstance->status.bits.enabled) &&          // state machine needs to be enabled
+        (buckInstance->status.bits.GO) &&               // GO-bit needs to be set
+        (buckInstance->status.bits.power_source_detected) && // Valid power source needs to be present
+        (buckInstance->status.bits.adc_active) &&       // ADC needs to be running
+        (buckInstance->status.bits.pwm_active) &&       // PWM needs to be running 
+        (!buckInstance->status.bits.fault_active) &&    // No active fault is present
+        (buckInstance->status.bits.cs_calib_complete)      // Current Sensor Calibration complete
+        )
+    {
+        // switch to soft-start phase POWER-ON DELAY
+        buckInstance->sm.event = BUCK_EVT_START;
+    }
+
+    return(1);
+}
+
+volatile uint16_t buckState_StandbyExit(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    buckInstance->status.bits.GO = false;   // Clear the GO bit
+    
+    return(1);
+}
+
+/*!BUCK_STATE_POWER_ON_DELAY
+ * ================================
+ * After the converter has been cleared to get started, the power-on 
+ * delay counter until the defined power-on delay period has expired.
+ * The counter already runs in STANDBY while a valid power source is present.
+ * When the input has been stable for longer than the power-on delay period 
+ * (e.g. during a restart after a fault), this state is passed without delay.
+ * */
+volatile uint16_t buckState_PowerOnDelayEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    buckInstance->status.bits.busy = true;  // Set the BUSY bit
+    
+    return(1);
+}
+
+volatile uint16_t buckState_PowerOnDelayExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    // delay startup until POWER ON DELAY has expired
+    if(buckInstance->startup.power_on_delay.counter++ > buckInstance->startup.power_on_delay.period)
+    {
+        // Clamp POD counter to EXPIRED
+        buckInstance->startup.power_on_delay.counter = 
+            (buckInstance->startup.power_on_delay.period + 1); // Saturate power on counter
+
+        if (buckInstance->status.bits.cs_calib_complete)   // if current sensors is calibrated
+            buckInstance->sm.event = BUCK_EVT_DONE; // ramp up output
+    }
+
+    return(1);
+}
+
+/*!BUCK_STATE_LAUNCH_V_RAMP
+ * ================================
+ * After the POWER ON DELAY has expired, the ramp up starting point is determined by measuring the input and output 
+ * voltage and calculates the ideal duty ratio of the PWM. This value is then programmed into
+ * the PWM module duty cycle register and is also used to pre-charge the control loop output
+ * history. In addition the measured output voltage also set as reference to ensure the loop 
+ * starts without jerks and jumps.
+ * When voltage mode control is enabled, the voltage loop control history is charged, 
+ * when average current mode control is enabled, the voltage loop history is charged with
+ * the configured load current estimate of each phase (startup.i_load) and the current 
+ * loop histories are charged with the estimated duty ratio. All three loops thus start from 
+ * the same pre-biased operating point. (The phase currents cannot be used for this estimate
+ * as they are measured while the PWM outputs are still turned off.) A load estimate of 
+ * zero disables the pre-charge of the current reference, the voltage loop then starts
+ * from zero current and has to build up the load current from the control error.
+ *  */
+volatile uint16_t buckState_LaunchVRampExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    // generic auxiliary variables
+    volatile uint16_t _i = 0;
+
+    // auxiliary variables for calculation of estimated duty cycle
+    volatile uint32_t _vout=0, _vin=0, _start_dc=0; 
+    
+    // auxiliary variable for the pre-charged current reference
+    volatile uint16_t _i_ref=0;
+    
+    #if (BOOST_MODE == true)
+    // auxiliary variable for calculation of lowest controllable boost output voltage
+    volatile uint32_t _vmin=0;
+    #endif
+
+    buckInstance->status.bits.busy = true;  // Set the BUSY bit
+    
+    // Hijack voltage loop controller reference
+    buckInstance->startup.v_ramp.reference = 0; // Reset Soft-Start Voltage Reference
+    buckInstance->v_loop.controller->Ports.ptrControlReference = 
+        &buckInstance->startup.v_ramp.reference; // Voltage loop is pointing to Soft-Start Reference
+
+    // Pre-charge reference with the most recent output voltage. The ramp always 
+    // starts at the pre-biased output voltage, so the initial control error is zero
+    #if (BOOST_MODE == true)
+    buckInstance->startup.v_ramp.reference = buckInstance->data.v_in;
+    #else
+    buckInstance->startup.v_ramp.reference = buckInstance->data.v_out;
+    #endif
+    // In average current mode, set current reference limit to max startup current level
+    if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC) 
+    {   // Disable all current control loops and reset control loop histories
+        buckInstance->v_loop.maximum = buckInstance->startup.i_ramp.reference;
+        buckInstance->v_loop.controller->Limits.MaxOutput = buckInstance->v_loop.maximum;
+    }
+        
+    // Estimate steady-state duty ratio from measured input and output voltage (D = V_out / V_in)
+    // If there is no input voltage or no output voltage, start with minimum duty ratio
+    _start_dc = (uint16_t)buckInstance->sw_node[0].duty_ratio_min;
+    
+    if(((buckInstance->data.v_in - buckInstance->feedback.ad_vin.scaling.offset) > 0) &&
+       ((buckInstance->data.v_out - buckInstance->feedback.ad_vout.scaling.offset) > 0) )
+    {
+        _vout = __builtin_muluu(
+            (buckInstance->data.v_out - buckInstance->feedback.ad_vout.scaling.offset), 
+            buckInstance->feedback.ad_vout.scaling.factor);
+        _vout >>= (16 - buckInstance->feedback.ad_vout.scaling.scaler);
+
+        _vin = __builtin_muluu(
+            (buckInstance->data.v_in - buckInstance->feedback.ad_vin.scaling.offset), 
+            buckInstance->feedback.ad_vin.scaling.factor);
+        _vin >>= (16 - buckInstance->feedback.ad_vin.scaling.scaler);
+    }
+
+    // Input voltage scaled to zero cannot be divided by, an output pre-biased above 
+    // the input would overflow the 16-bit quotient (clamped to maximum duty ratio below)
+    if ((_vin > 0) && (_vout > 0))
+    {
+        if (_vout < _vin)
+        {
+            _start_dc = __builtin_muluu((uint16_t)_vout, buckInstance->sw_node[0].period);
+            _start_dc = __builtin_divud(_start_dc, (uint16_t)_vin);
+        }
+        else
+        { _start_dc = buckInstance->sw_node[0].period; }
+        
+        #if (BOOST_MODE == true)
+        // In boost mode the duty ratio of the active switch is D = 1 - (V_low / V_high)
+        if (_vin > _vout)
+            _start_dc = buckInstance->sw_node[0].period - _start_dc;
+        else
+            _start_dc = (uint16_t)buckInstance->sw_node[0].duty_ratio_min;
+        
+        // The lowest output voltage which can be regulated is determined by the minimum 
+        // duty ratio: V_high(min) = V_low / (1 - D_min). When the pre-biased output 
+        // is below this level, the ramp starts at the lowest controllable level.
+        _vmin = __builtin_muluu((uint16_t)_vout, buckInstance->sw_node[0].period);
+        _vmin = __builtin_divud(_vmin, 
+            (buckInstance->sw_node[0].period - buckInstance->sw_node[0].duty_ratio_min));
+        if (_vin < _vmin)
+        {
+            _vmin = __builtin_muluu(buckInstance->data.v_in, (uint16_t)_vmin);
+            buckInstance->startup.v_ramp.reference = (uint16_t)__builtin_divud(_vmin, (uint16_t)_vin);
+        }
+        #endif
+    }
+    
+    // Feed-forward current reference of each phase is the configured load current 
+    // estimate (zero = no pre-charge), limited to the maximum current reference
+    _i_ref = buckInstance->startup.i_load;
+    if (_i_ref > buckInstance->v_loop.maximum) 
+    { _i_ref = buckInstance->v_loop.maximum; }
+    
+    // Pre-charge PWM and control loop histories
+    if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_VMC)
+    {
+        if(_start_dc < buckInstance->v_loop.minimum) 
+        { _start_dc = buckInstance->v_loop.minimum; }
+        else if(_start_dc > buckInstance->v_loop.maximum) 
+        { _start_dc = buckInstance->v_loop.maximum; }
+
+        buckInstance->v_loop.ctrl_Precharge(buckInstance->v_loop.controller, 0, _start_dc);
+        *buckInstance->v_loop.controller->Ports.Target.ptrAddress = _start_dc; // set initial PWM duty ratio
+        if (buckInstance->v_loop.controller->Ports.AltTarget.ptrAddress != NULL)
+            *buckInstance->v_loop.controller->Ports.AltTarget.ptrAddress = _start_dc; // set initial PWM duty ratio
+
+    }
+    else if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC) 
+    {   
+        // Outer voltage loop output is the estimated current reference of all phases
+        buckInstance->v_loop.ctrl_Precharge(buckInstance->v_loop.controller, 0, (int16_t)_i_ref);
+        *buckInstance->v_loop.controller->Ports.Target.ptrAddress = (uint16_t)_i_ref; // set initial current reference
+        if (buckInstance->v_loop.controller->Ports.AltTarget.ptrAddress != NULL)
+            *buckInstance->v_loop.controller->Ports.AltTarget.ptrAddress = (uint16_t)_i_ref; // set initial current reference
+        
+        // Inner current loop outputs are the estimated steady-state duty ratio
+        for (_i=0; _i<buckInstance->set_values.phases; _i++)  
+        { 
+            if(_start_dc < buckInstance->i_loop[_i].minimum) 
+            { _start_dc = buckInstance->i_loop[_i].minimum; }
+            else if(_start_dc > buckInstance->i_loop[_i].maximum) 
+            { _start_dc = buckInstance->i_loop[_i].maximum; }
+
+            buckInstance->i_loop[_i].ctrl_Precharge(
+                        buckInstance->i_loop[_i].controller, 0, _start_dc
+                    );
+
+            *buckInstance->i_loop[_i].controller->Ports.Target.ptrAddress = _start_dc; // set initial PWM duty ratio
+            if (buckInstance->i_loop[_i].controller->Ports.AltTarget.ptrAddress != NULL)
+                *buckInstance->i_loop[_i].controller->Ports.AltTarget.ptrAddress = _start_dc; // set initial PWM duty ratio
+        }
+    }
+
+    // switch to soft-start phase RAMP UP
+    buckInstance->sm.event = BUCK_EVT_DONE;
+
+    return(1);
+}
+
+/*!BUCK_STATE_V_RAMP_UP
+ * ===========================
+ * This is the essential step in which the output voltage is ramped up by incrementing the 
+ * outer control loop reference. In voltage mode the output voltage will ramp up to the 
+ * nominal regulation point. The reference follows a jerk-limited (S-curve) trajectory,
+ * which is advanced by the control interrupt service routine.
+ * In average current mode the inner loop will limit the current as soon as the current 
+ * reference limit is hit and the output is switched to constant current mode. 
+ * */
+volatile uint16_t buckState_VRampUpEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    volatile uint16_t retval=1;
+    volatile uint16_t _i=0;
+
+    buckInstance->status.bits.busy = true;  // Set the BUSY bit
+
+    // Enable input power source
+    retval &= buckPWM_Resume(buckInstance);  // Enable PWM outputs
+
+    // enable control loop
+    if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_VMC)
+    {   
+        buckInstance->v_loop.controller->status.bits.enabled = true; // enable voltage loop controller
+    }
+    else if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC)
+    {
+        buckInstance->v_loop.controller->status.bits.enabled = true; // enable voltage loop controller
+        for (_i=0; _i<buckInstance->set_values.phases; _i++)
+        { buckInstance->i_loop[_i].controller->status.bits.enabled = true; } // enable phase current loop controller
+    }
+
+    // Launch jerk-limited reference trajectory from pre-charged starting point
+    retval &= buckTraj_Launch(&buckInstance->v_traj, 
+        &buckInstance->startup.v_ramp.reference,    // soft-start reference is driven by the trajectory
+        buckInstance->startup.v_ramp.reference,     // start at most recent soft-start reference
+        buckInstance->v_loop.reference,             // end at nominal controller reference
+        buckInstance->startup.v_ramp.ref_inc_step   // average slope of the ramp
+        );
+
+    return(retval);
+}
+
+volatile uint16_t buckState_VRampUpExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    // check if ramp is complete (reference is incremented by the control interrupt)
+    if (!buckInstance->v_traj.status.bits.active) 
+    {
+        if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC)
+            buckInstance->sm.event = BUCK_EVT_DONE; // continue with current limit ramp
+        else
+            buckInstance->sm.event = BUCK_EVT_SKIP; // current limit ramp is not required
+    }
+
+    return(1);
+}
+
+volatile uint16_t buckState_VRampUpExit(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    // Set reference to the desired level
+    buckInstance->startup.v_ramp.reference = buckInstance->v_loop.reference;
+
+    // Reconnect API reference to controller
+    buckInstance->v_loop.controller->Ports.ptrControlReference = &buckInstance->v_loop.reference;
+
+    return(1);
+}
+
+/*!BUCK_STATE_I_RAMP_UP
+ * ===========================
+ * This phase of the soft-start ramp is only executed in average current mode and will 
+ * only take effect when the current limit is hit before the nominal voltage regulation 
+ * point. In this case the constant output current is ramped up to from the startup current
+ * to the nominal constant charging current. 
+ * */
+volatile uint16_t buckState_IRampUpEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    buckInstance->status.bits.busy = true;  // Set the BUSY bit
+    
+    return(1);
+}
+
+volatile uint16_t buckState_IRampUpExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC)
+    {
+        // increment current limit
+        buckInstance->v_loop.controller->Limits.MaxOutput += buckInstance->startup.i_ramp.ref_inc_step; // Increment maximum current limit
+
+        // check if ramp is complete
+        if (buckInstance->v_loop.controller->Limits.MaxOutput >= buckInstance->set_values.i_limit)
+        {
+            buckInstance->v_loop.maximum = buckInstance->set_values.i_limit;
+            buckInstance->v_loop.controller->Limits.MaxOutput = buckInstance->v_loop.maximum;
+            buckInstance->sm.event = BUCK_EVT_DONE;
+        }
+    }
+    else // Non-Current Loops Ending up here need to be lifted to PG_DELAY
+    { 
+        buckInstance->v_loop.controller->Limits.MaxOutput = buckInstance->v_loop.maximum;
+        buckInstance->sm.event = BUCK_EVT_DONE;
+    }
+
+    return(1);
+}
+
+/*!BUCK_STATE_PWRGOOD_DELAY
+ * =============================
+ * In this phase of the soft-start procedure a counter is incremented until the power good 
+ * delay has expired before the soft-start process is marked as COMPLETEd 
+ * */
+volatile uint16_t buckState_PowerGoodDelayEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    buckInstance->status.bits.busy = true;  // Set the BUSY bit
+    
+    return(1);
+}
+
+volatile uint16_t buckState_PowerGoodDelayExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    // increment delay counter until the GOWER GOOD delay has expired
+    if(buckInstance->startup.power_good_delay.counter++ > buckInstance->startup.power_good_delay.period)
+    {
+        buckInstance->startup.power_good_delay.counter = 
+            (buckInstance->startup.power_good_delay.period + 1); // Clamp to PERIOD_EXPIRED for future startups
+        
+        buckInstance->sm.event = BUCK_EVT_DONE; // Set COMPLETE flag
+    }
+
+    return(1);
+}
+
+/*!BUCK_STATE_ONLINE
+ * =============================
+ * When the soft-start has been completed, the state machine remains in ONLINE state
+ * and the converter has entered normal operation.  
+ * */
+volatile uint16_t buckState_OnlineEntry(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    // If defined, set POWER_GOOD output
+    if(buckInstance->gpio.PowerGood.enabled)
+        buckGPIO_Set(&buckInstance->gpio.PowerGood);
+
+    return(1);
+}
+
+volatile uint16_t buckState_OnlineExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    volatile uint16_t retval=1;
+    
+    /*!Runtime Reference Tuning
+     * ==================================================================================
+     * Description:
+     * If the user reference setting has been changed and is different from the most recent 
+     * controller reference/current clamping, the state machine will tune the controller 
+     * reference/current clamping into the new user control reference level. 
+     * While ramping the output voltage up or down, the BUSY bit will be set and any new 
+     * changes to the reference will be ignored until the ramp up/down is complete.
+     * The transition follows a jerk-limited trajectory executed by the control interrupt,
+     * using the average slope of the soft-start ramp.
+     * =================================================================================*/
+
+    if((buckInstance->v_traj.status.bits.active) ||
+       (buckInstance->set_values.v_ref != buckInstance->v_loop.reference))
+    {
+        // Set the BUSY bit indicating a delay/ramp period being executed
+        buckInstance->status.bits.busy = true;
+
+        // Tune controller reference into new user reference level
+        if(!buckInstance->v_traj.status.bits.active) 
+        {
+            retval &= buckTraj_Launch(&buckInstance->v_traj, 
+                &buckInstance->v_loop.reference,            // controller reference is driven by the trajectory
+                buckInstance->v_loop.reference,             // start at most recent controller reference
+                buckInstance->set_values.v_ref,             // end at new user reference
+                buckInstance->startup.v_ramp.ref_inc_step   // average slope of the ramp
+                );
+        }
+
+    }
+    else{
+        // Clear the BUSY bit indicating "no state machine activity"
+        buckInstance->status.bits.busy = false;
+    }
+
+    return(retval);
+}
+
+/*!BUCK_STATE_SUSPEND
+ * =============================
+ * When the state machine step is set to BUCK_STATE_SUSPEND, the PWM and control
+ * loops are reset and the state machine is reset to RESET mode WITH all
+ * delay counters pre-charged. When re-enabled, the state machine will perform 
+ * a soft-start without POWER ON and POWER GOOD delays.
+ * */
+volatile uint16_t buckState_SuspendExecute(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    volatile uint16_t retval=1;
+    volatile uint16_t _i=0;
+    
+    // Disable PWM outputs & control loops (immediate power shut-down)
+    retval &= buckPWM_Stop(buckInstance); // Disable PWM outputs
+    retval &= buckTraj_Abort(&buckInstance->v_traj); // Stop reference trajectory
+
+    buckInstance->v_loop.controller->status.bits.enabled = false;   // disable voltage control loop
+
+    if (buckInstance->set_values.control_mode == BUCK_CONTROL_MODE_ACMC){
+        for (_i=0; _i<buckInstance->set_values.phases; _i++)
+        { buckInstance->i_loop[_i].controller->status.bits.enabled = false; } // disable current control loop
+    }
+
+    // Reset the state machine to repeat the soft-start without delays (ramp only)
+    buckInstance->startup.power_on_delay.counter = (buckInstance->startup.power_on_delay.period + 1); // Clamp POD counter to PERIOD_EXPIRED for future startups
+    buckInstance->startup.power_good_delay.counter = (buckInstance->startup.power_good_delay.period + 1); // Clamp PG counter to PERIOD_EXPIRED for future startups
+
+    buckInstance->sm.event = BUCK_EVT_DONE; // Reset state machine to RESET
+
     return(retval);
 }
 
@@ -51,6 +51,9 @@ extern volatile uint16_t drv_BuckConverter_Suspend(volatile BUCK_POWER_CONTROLLE
 extern volatile uint16_t drv_BuckConverter_Resume(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
 
 // POWER CONVERTER PERIPHERAL CONFIGURATION ROUTINES
+// All functions operate on the instance passed in. Module initialization routines 
+// (buckPWM_ModuleInitialize, buckADC_ModuleInitialize) configure peripheral modules shared 
+// by all instances and have to be called once before the first channel is initialized.
     
 extern volatile uint16_t buckPWM_ModuleInitialize(volatile BUCK_POWER_CONTROLLER_t* buckInstance);
 
@@ -69,6 +72,14 @@ extern volatile uint16_t buckGPIO_Set(volatile BUCK_GPIO_INSTANCE_t* buckGPIOIns
 extern volatile uint16_t buckGPIO_Clear(volatile BUCK_GPIO_INSTANCE_t* buckGPIOInstance);
 extern volatile bool buckGPIO_GetPinState(volatile BUCK_GPIO_INSTANCE_t* buckGPIOInstance);
 
+// POWER CONVERTER REFERENCE TRAJECTORY ROUTINES
+
+extern volatile uint16_t buckTraj_Initialize(volatile BUCK_REF_TRAJECTORY_t* traj);
+extern volatile uint16_t buckTraj_Launch(volatile BUCK_REF_TRAJECTORY_t* traj,
+        volatile uint16_t* target, uint16_t start, uint16_t end, uint16_t slew);
+extern volatile uint16_t buckTraj_Abort(volatile BUCK_REF_TRAJECTORY_t* traj);
+extern void buckTraj_Update(volatile BUCK_REF_TRAJECTORY_t* traj);
+
 #ifdef	__cplusplus
 }
 #endif /* __cplusplus */
@@ -189,7 +189,7 @@ volatile uint16_t buckPWM_ChannelInitialize(volatile BUCK_POWER_CONTROLLER_t* bu
         else {
             pg->PGxCONH.bits.MSTEN = 0; // Make all other PWMs of switch node objects SLAVES
             pg->PGxCONH.bits.UPDMOD = P33C_PGxCONH_UPDMOD_SLV; // Slave PWMs update PWM registers Immediately at MASTER trigger
-            pg->PGxCONH.bits.SOCS = BUCK_PWM_MASTER_SOCS; // Slave PWMs are triggered by MASTER PWM
+            pg->PGxCONH.bits.SOCS = (((buckInstance->sw_node[0].pwm_instance - 1) & 0x0003) + 1); // Slave PWMs are triggered by MASTER PWM (SOCS 0b0001...0b0100 = PG1/5...PG4/8)
             pg->PGxEVTL.bits.PGTRGSEL = 0b000; // Slave PWM does not have PWM trigger output 
             pg->PGxTRIGC.bits.TRIG = buckInstance->sw_node[_i].phase; // Set phase shift of trigger
         }
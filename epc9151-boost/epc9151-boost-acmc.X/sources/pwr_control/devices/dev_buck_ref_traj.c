@@ -0,0 +1,226 @@
+/*
+ * File:   dev_buck_ref_traj.c
+ * Author: M91406
+ *
+ * Created on October 19, 2020, 9:12 AM
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pwr_control/devices/dev_buck_typedef.h"
+#include "pwr_control/devices/dev_buck_converter.h"
+
+/* PRIVATE CONSTANTS */
+// Normalized jerk-limited transition shape (Q15). The table has been generated offline by 
+// integrating a piece-wise constant jerk profile (+J, -J, -J, +J of equal length) three times
+// using trapezoidal integration and normalizing the resulting position curve to Q15. As 
+// constant table, the shape is shared by all trajectory generator instances.
+#if (BUCK_TRAJ_TABLE_SIZE != 32U)
+  #error "BUCK_TRAJ_TABLE_SIZE does not match the size of the normalized trajectory shape table"
+#endif
+
+const uint16_t traj_shape[BUCK_TRAJ_TABLE_SIZE + 1] = {
+    0x0000, 0x0007, 0x002F, 0x0097, 0x015F, 0x02A7, 0x048F, 0x0737, // first quarter: +J
+    0x0ABF, 0x0F37, 0x148F, 0x1AA7, 0x215F, 0x2897, 0x302F, 0x3807, // second quarter: -J
+    0x3FFF, 0x47F7, 0x4FCF, 0x5767, 0x5E9F, 0x6557, 0x6B6F, 0x70C7, // third quarter: -J
+    0x753F, 0x78C7, 0x7B6F, 0x7D57, 0x7E9F, 0x7F67, 0x7FCF, 0x7FF7, // fourth quarter: +J
+    0x7FFF  // end point
+};
+
+#define TRAJ_PHASE_END  ((uint32_t)BUCK_TRAJ_TABLE_SIZE << 16) // Phase accumulator end value
+
+/* @@buckTraj_Initialize
+ * ********************************************************************************
+ * Summary:
+ * Initializes the reference trajectory generator
+ *
+ * Parameters:
+ *  volatile BUCK_REF_TRAJECTORY_t* traj: Pointer to trajectory generator object
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * Resets the trajectory generator object. The normalized jerk-limited transition 
+ * shape is a constant table shared by all instances, which is used by every 
+ * subsequent trajectory launch to calculate absolute reference values.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t buckTraj_Initialize(volatile BUCK_REF_TRAJECTORY_t* traj)
+{
+    volatile uint16_t retval=1;
+
+    if (traj == NULL) return(0);
+
+    // Reset trajectory object
+    traj->status.value = 0;
+    traj->ptrTarget = NULL;
+    traj->phase = 0;
+    traj->phase_inc = 0;
+    traj->scaler_counter = 0;
+    if (traj->scaler == 0) traj->scaler = 1;
+    if (traj->steps_per_tick == 0) traj->steps_per_tick = 1;
+
+    return(retval);
+}
+
+/* @@buckTraj_Launch
+ * ********************************************************************************
+ * Summary:
+ * Calculates and starts a new reference trajectory
+ *
+ * Parameters:
+ *  volatile BUCK_REF_TRAJECTORY_t* traj: Pointer to trajectory generator object
+ *  volatile uint16_t* target: Pointer to the reference variable to be driven
+ *  uint16_t start: Reference value at the beginning of the transition
+ *  uint16_t end: Reference value at the end of the transition
+ *  uint16_t slew: Average reference change per state machine call
+ *
+ * Returns:
+ *  1: success
+ *  0: error (trajectory already active or invalid parameters)
+ *
+ * Description:
+ * This function is executed by the state machine (slow task). The normalized
+ * S-curve is scaled to the given start and end values and written to the
+ * trajectory table. The transition period is derived from the given slew rate
+ * to keep the same average slope as the former linear ramp. Once the table is
+ * complete, the ACTIVE bit hands the trajectory over to the control interrupt.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t buckTraj_Launch(volatile BUCK_REF_TRAJECTORY_t* traj,
+        volatile uint16_t* target, uint16_t start, uint16_t end, uint16_t slew)
+{
+    volatile uint16_t retval=1;
+    volatile uint16_t _i=0;
+    volatile uint16_t _delta=0;
+    volatile uint32_t _steps=0;
+
+    if ((traj == NULL) || (target == NULL) || (slew == 0)) return(0);
+    if (traj->status.bits.active) return(0);
+
+    traj->status.bits.complete = false;
+    traj->ptrTarget = target;
+
+    // Without change there is nothing to shape
+    if (start == end)
+    {
+        *traj->ptrTarget = end;
+        traj->status.bits.complete = true;
+        return(retval);
+    }
+
+    // Scale normalized shape to absolute reference values
+    if (end > start)
+    {
+        _delta = (end - start);
+        for (_i=0; _i<BUCK_TRAJ_TABLE_SIZE; _i++)
+        { traj->table[_i] = start + (uint16_t)(__builtin_muluu(_delta, traj_shape[_i]) >> 15); }
+    }
+    else
+    {
+        _delta = (start - end);
+        for (_i=0; _i<BUCK_TRAJ_TABLE_SIZE; _i++)
+        { traj->table[_i] = start - (uint16_t)(__builtin_muluu(_delta, traj_shape[_i]) >> 15); }
+    }
+    traj->table[BUCK_TRAJ_TABLE_SIZE] = end; // Always end exactly at the given reference
+
+    // Determine number of trajectory updates from average slew rate
+    _steps = __builtin_muluu(((_delta / slew) + 1), traj->steps_per_tick);
+    if (_steps <= BUCK_TRAJ_TABLE_SIZE) _steps = (BUCK_TRAJ_TABLE_SIZE + 1);
+    else if (_steps > 0xFFFF) _steps = 0xFFFF;
+
+    traj->phase_inc = __builtin_divud(TRAJ_PHASE_END, (uint16_t)_steps);
+    traj->phase = 0;
+    traj->scaler_counter = 0;
+
+    // Hand trajectory over to control interrupt
+    traj->status.bits.active = true;
+
+    return(retval);
+}
+
+/* @@buckTraj_Abort
+ * ********************************************************************************
+ * Summary:
+ * Stops the most recent trajectory
+ *
+ * Parameters:
+ *  volatile BUCK_REF_TRAJECTORY_t* traj: Pointer to trajectory generator object
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * The reference variable keeps the most recent value written by the trajectory.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t buckTraj_Abort(volatile BUCK_REF_TRAJECTORY_t* traj)
+{
+    if (traj == NULL) return(0);
+
+    traj->status.bits.active = false;
+    traj->status.bits.complete = false;
+
+    return(1);
+}
+
+/* @@buckTraj_Update
+ * ********************************************************************************
+ * Summary:
+ * Advances the active trajectory
+ *
+ * Parameters:
+ *  volatile BUCK_REF_TRAJECTORY_t* traj: Pointer to trajectory generator object
+ *
+ * Returns:
+ *  (none)
+ *
+ * Description:
+ * This function is called by the control interrupt service routine. Every n-th
+ * call the phase accumulator is incremented and the new reference value is
+ * interpolated between the two adjacent table entries.
+ *
+ * ********************************************************************************/
+
+void buckTraj_Update(volatile BUCK_REF_TRAJECTORY_t* traj)
+{
+    uint16_t _idx=0, _frac=0, _y0=0, _y1=0;
+
+    if (!traj->status.bits.active) return;
+    if (++traj->scaler_counter < traj->scaler) return;
+    traj->scaler_counter = 0;
+
+    traj->phase += traj->phase_inc;
+
+    // End of trajectory reached
+    if (traj->phase >= TRAJ_PHASE_END)
+    {
+        *traj->ptrTarget = traj->table[BUCK_TRAJ_TABLE_SIZE];
+        traj->status.bits.active = false;
+        traj->status.bits.complete = true;
+        return;
+    }
+
+    // Linear interpolation between table entries
+    _idx = (uint16_t)(traj->phase >> 16);
+    _frac = (uint16_t)(traj->phase & 0xFFFF);
+    _y0 = traj->table[_idx];
+    _y1 = traj->table[_idx + 1];
+
+    if (_y1 >= _y0)
+        *traj->ptrTarget = _y0 + (uint16_t)(__builtin_muluu((_y1 - _y0), _frac) >> 16);
+    else
+        *traj->ptrTarget = _y0 - (uint16_t)(__builtin_muluu((_y0 - _y1), _frac) >> 16);
+
+    return;
+}
+
+// END OF FILE
@@ -144,6 +144,65 @@ typedef enum {
     BUCK_STATE_SUSPEND        = 9   // power converter control state #9: state machine will be reset without POD and PG delays
 } BUCK_MODE_STATE_e;
 
+#define BUCK_STATE_COUNT          10U   // Number of power converter control states
+
+/*!BUCK_SM_EVENT_e
+ * ***************************************************************************************************
+ * Summary:
+ * Power controller state-machine events
+ * 
+ * Description:
+ * State handlers report the progress of the active state by events. The state machine looks up
+ * the active state and the most recent event in the transition table to determine the next state.
+ * 
+ * *************************************************************************************************** */
+typedef enum {
+    BUCK_EVT_NONE             = 0,  // no event: state machine remains in the active state
+    BUCK_EVT_DONE             = 1,  // the process of the active state has been completed
+    BUCK_EVT_SKIP             = 2,  // process completed; next process is not required in the selected control mode
+    BUCK_EVT_START            = 3,  // all startup conditions have been met
+    BUCK_EVT_SHUTDOWN         = 4,  // converter disabled, power source lost or fault condition active
+    BUCK_EVT_EXTERNAL         = 5   // state has been set by external software (e.g. suspend/resume API)
+} BUCK_SM_EVENT_e;
+
+/*!BUCK_STATE_MACHINE_t
+ * ***************************************************************************************************
+ * Summary:
+ * Power controller state-machine transition log and timing data
+ * 
+ * Description:
+ * Each state is defined by an optional entry hook, an execute handler and an optional exit hook. 
+ * Entry and exit hooks are only executed once per state visit. All state transitions are recorded
+ * in the transition log ring buffer. Time stamps are counted in state machine calls (time base = 
+ * MAIN_EXECUTION_PERIOD). The time spent in each state during its most recent visit and the 
+ * time-to-regulation of the most recent startup (startup command until ONLINE) can be read from
+ * the timing data without additional instrumentation.
+ * 
+ * *************************************************************************************************** */
+
+#define BUCK_SM_LOG_SIZE          16U   // Number of entries of the state transition log
+
+typedef struct {
+    volatile uint32_t time_stamp;   // State machine tick at which the transition occurred
+    volatile uint8_t from;          // State which has been left
+    volatile uint8_t to;            // State which has been entered
+    volatile uint8_t event;         // Event triggering the transition
+    volatile uint8_t reserved;      // (reserved)
+} BUCK_SM_LOG_ENTRY_t; // State transition log entry
+
+typedef struct {
+    volatile BUCK_MODE_STATE_e state;   // Active state (read only)
+    volatile BUCK_SM_EVENT_e event;     // Most recent event reported by the active state handler (read only)
+    volatile uint32_t tick;             // State machine time base (read only)
+    volatile uint32_t entry_time[BUCK_STATE_COUNT]; // Time stamp of the most recent entry into each state
+    volatile uint32_t duration[BUCK_STATE_COUNT];   // Time spent in each state during its most recent visit
+    volatile uint32_t start_time;       // Time stamp of the most recent startup command (STANDBY exit)
+    volatile uint32_t startup_time;     // Time-to-regulation of the most recent startup (STANDBY exit to ONLINE entry)
+    volatile uint16_t log_index;        // Index of the next transition log entry to be written
+    volatile uint16_t log_count;        // Number of recorded transitions (saturates at 0xFFFF)
+    volatile BUCK_SM_LOG_ENTRY_t log[BUCK_SM_LOG_SIZE]; // State transition log ring buffer
+} BUCK_STATE_MACHINE_t; // Power converter state machine transition log and timing data
+
 
 /*!BUCK_STARTUP_SETTINGS_t
  * ***************************************************************************************************
@@ -170,8 +229,62 @@ typedef struct {
     volatile BUCK_STARTUP_PERIOD_HANDLER_t power_good_delay;
     volatile BUCK_STARTUP_PERIOD_HANDLER_t i_ramp;
     volatile BUCK_STARTUP_PERIOD_HANDLER_t v_ramp;
+    volatile uint16_t i_load; // Configured load current estimate per phase at launch (pre-charged current reference, 0 = no pre-charge)
 } BUCK_CONVERTER_STARTUP_t; // Power converter start-up settings and variables
 
+/*!BUCK_REF_TRAJECTORY_t
+ * ***************************************************************************************************
+ * Summary:
+ * Jerk-limited (S-curve) reference trajectory generator
+ *
+ * Description:
+ * Reference changes during soft-start and runtime tuning are shaped by a jerk-limited trajectory.
+ * The trajectory table holding the absolute reference values of one transition is computed by
+ * the state machine (slow task). The control interrupt service routine advances through this
+ * table every n-th control cycle using a fixed-point phase accumulator and interpolates linearly
+ * between table entries. The most recent value is written to the reference the control loop
+ * is pointing to.
+ *
+ * *************************************************************************************************** */
+
+#define BUCK_TRAJ_TABLE_SIZE    32U // Number of trajectory segments (must be a multiple of 4)
+
+typedef union
+{
+    struct{
+        volatile bool active:1;     // Bit #0: Trajectory is being executed by the control interrupt
+        volatile bool complete:1;   // Bit #1: Most recent trajectory has reached its final value
+        volatile unsigned :1;       // Bit #2: (reserved)
+        volatile unsigned :1;       // Bit #3: (reserved)
+        volatile unsigned :1;       // Bit #4: (reserved)
+        volatile unsigned :1;       // Bit #5: (reserved)
+        volatile unsigned :1;       // Bit #6: (reserved)
+        volatile unsigned :1;       // Bit #7: (reserved)
+        volatile unsigned :1;       // Bit #8: (reserved)
+        volatile unsigned :1;       // Bit #9: (reserved)
+        volatile unsigned :1;       // Bit #10: (reserved)
+        volatile unsigned :1;       // Bit #11: (reserved)
+        volatile unsigned :1;       // Bit #12: (reserved)
+        volatile unsigned :1;       // Bit #13: (reserved)
+        volatile unsigned :1;       // Bit #14: (reserved)
+        volatile unsigned :1;       // Bit #15: (reserved)
+    } __attribute__((packed)) bits; // data structure for single bit addressing operations
+
+	volatile uint16_t value; // buffer for 16-bit word read/write operations
+
+} BUCK_REF_TRAJECTORY_STATUS_t;
+
+typedef struct {
+    volatile BUCK_REF_TRAJECTORY_STATUS_t status; // Trajectory generator status bits
+    volatile uint16_t* ptrTarget; // Pointer to reference variable driven by the trajectory
+    volatile uint32_t phase; // Table position in Q16.16 format (integer = table index)
+    volatile uint16_t phase_inc; // Table position increment per trajectory update
+    volatile uint16_t scaler; // Number of control cycles per trajectory update
+    volatile uint16_t scaler_counter; // Control cycle counter (read only)
+    volatile uint16_t steps_per_tick; // Number of trajectory updates per state machine call
+    volatile uint16_t table[BUCK_TRAJ_TABLE_SIZE + 1]; // Absolute reference values of the most recent trajectory
+} BUCK_REF_TRAJECTORY_t; // Reference trajectory generator data object
+
 // ==============================================================================================
 // BUCK converter runtime data object 
 // ==============================================================================================
@@ -204,6 +317,7 @@ typedef struct {
     volatile BUCK_CONTROL_MODE_e control_mode; // Fundamental control mode 
     volatile uint16_t v_ref; // User reference setting used to control the power converter controller
     volatile uint16_t i_ref; // User reference setting used to control the power converter controller
+    volatile uint16_t i_limit; // Nominal current limit (maximum voltage loop output) reached at the end of the current ramp
     volatile uint16_t phases; // number of converter phases
 } BUCK_CONVERTER_CONTROL_t;
 
@@ -335,7 +449,9 @@ typedef struct {
     
     volatile BUCK_CONVERTER_STATUS_t status; // BUCK operation status bits
     volatile BUCK_MODE_STATE_e mode; // BUCK state machine state
-    volatile BUCK_CONVERTER_STARTUP_t startup; // BUCK startup timing settings 
+    volatile BUCK_STATE_MACHINE_t sm; // BUCK state machine transition log and timing data
+    volatile BUCK_CONVERTER_STARTUP_t startup; // BUCK startup timing settings
+    volatile BUCK_REF_TRAJECTORY_t v_traj; // BUCK voltage reference trajectory generator
     volatile BUCK_CONVERTER_CONTROL_t set_values; // Control field for global access to references
     volatile BUCK_CONVERTER_DATA_t data;     // BUCK runtime data
     volatile BUCK_FEEDBACK_SETTINGS_t feedback; // BUCK converter feedback settings
@@ -348,20 +464,6 @@ typedef struct {
     
 } BUCK_POWER_CONTROLLER_t; // BUCK control & monitoring data structure
 
-
-/*!BUCK_POWER_CONTROLLER_t data structure
- * *************************************************************************************************
- * Summary:
- * Global data object for the BUCK CONVERTER 
- * 
- * Description:
- * the 'buck' data object holds all status, control and monitoring values of the BUCK power 
- * controller. The BUCK_POWER_CONTROLLER_t data structure is defined in drv_buck_converter.h.
- * Please refer to the comments on top of this file for further information.
- *  
- * *************************************************************************************************/
-extern volatile BUCK_POWER_CONTROLLER_t buck;
-
 #else
     #pragma message "Warning: dev_buck_typedef.h inclusion bypassed"
 #endif	/* BUCK_CONVERTER_TYPE_DEF_H */
@@ -0,0 +1,329 @@
+/*
+ * File:   app_scheduler.c
+ * Author: M91406
+ *
+ * Created on October 21, 2020, 10:26 AM
+ */
+
+#include <xc.h>
+#include <stddef.h>
+
+#include "app_scheduler.h"
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/app_power_control.h"
+#include "fault_handler/app_faults.h"
+#include "uart/app_uart.h"
+#include "sequencer/app_sequencer.h"
+#include "profiler/app_profiler.h"
+#include "telemetry/app_stats.h"
+
+
+// Define scheduler object
+volatile SCHED_OBJECT_t schedobj_Main;
+
+/* @@sched_add_task
+ * ********************************************************************************
+ * Summary:
+ * Adds a task to the task list of the scheduler
+ *
+ * Parameters:
+ *  volatile SCHED_OBJECT_t* schedobj: Pointer to scheduler object
+ *  volatile uint16_t (*task)(void): Pointer to task function
+ *  volatile SCHED_TIER_e tier: Scheduler tier the task is assigned to
+ *  volatile uint16_t period: Execution period in slots of the given tier
+ *  volatile uint16_t offset: Scheduler tick within the tier slot
+ *
+ * Returns:
+ *  1: success
+ *  0: error (task list full or invalid parameters)
+ *
+ * Description:
+ * Tasks are executed in the order they have been added within each tier.
+ * Tasks have to be added in order of priority.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t sched_add_task(volatile SCHED_OBJECT_t* schedobj, volatile uint16_t (*task)(void),
+                volatile SCHED_TIER_e tier, volatile uint16_t period, volatile uint16_t offset)
+{
+    volatile SCHED_TASK_t* _task;
+
+    if ((schedobj == NULL) || (task == NULL)) return(0);
+    if ((schedobj->count >= SCHED_TASKS_MAX) || (tier >= SCHED_TIER_COUNT)) return(0);
+    if ((period == 0) || (offset >= schedobj->tier[tier].divider)) return(0);
+
+    _task = &schedobj->task[schedobj->count];
+
+    _task->execute = task;
+    _task->tier = tier;
+    _task->period = period;
+    _task->offset = offset;
+    _task->counter = (period - 1); // First execution in the first slot of the tier
+    _task->exec_time = 0;
+    _task->exec_time_max = 0;
+    _task->overruns = 0;
+    _task->errors = 0;
+
+    schedobj->count++;
+
+    return(1);
+}
+
+/* @@sched_wait
+ * ********************************************************************************
+ * Summary:
+ * Waits in Idle mode for the next scheduler tick
+ *
+ * Parameters:
+ *  volatile SCHED_OBJECT_t* schedobj: Pointer to scheduler object
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * The CPU is put into Idle mode until the Timer1 interrupt has advanced the
+ * time base. The control interrupt wakes up the CPU as well, which is put back
+ * into Idle mode when no new scheduler tick is pending. The CPU priority is
+ * raised while the time base is checked to not miss a Timer1 interrupt right
+ * before entering Idle mode. Enabled interrupts still wake up the CPU and are
+ * executed as soon as the CPU priority has been restored.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t sched_wait(volatile SCHED_OBJECT_t* schedobj)
+{
+    volatile uint16_t _ipl=0, _timebase=0;
+
+    // If the scheduler object is not initialized, exit here with error
+    if (schedobj == NULL)
+        return(0);
+
+    SET_AND_SAVE_CPU_IPL(_ipl, 7); // Block interrupts while checking the time base
+
+    while (schedobj->timebase == schedobj->tick_id)
+    {
+        Idle(); // Enter Idle mode until the next interrupt occurs
+        RESTORE_CPU_IPL(_ipl); // Execute pending interrupts
+        SET_AND_SAVE_CPU_IPL(_ipl, 7);
+    }
+
+    _timebase = schedobj->timebase;
+    schedobj->ticks_lost += (_timebase - schedobj->tick_id - 1); // Count ticks passed without execution
+    schedobj->tick_id = _timebase;
+
+    RESTORE_CPU_IPL(_ipl);
+
+    return(1);
+}
+
+/* @@sched_execute
+ * ********************************************************************************
+ * Summary:
+ * Executes all tasks due in the recent scheduler tick
+ *
+ * Parameters:
+ *  volatile SCHED_OBJECT_t* schedobj: Pointer to scheduler object
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * This function has to be called once per scheduler tick, right after
+ * sched_wait() has returned. Tiers are executed in order of priority. The
+ * execution time of each task is captured from TMR1. When the time base has
+ * been advanced by the Timer1 interrupt after a task has been executed, the
+ * scheduler tick has been exceeded. The overrun is counted for the task which
+ * has exceeded the tick and for each tier which has completed late. When a
+ * wrapping interrupt time counter is available, interrupt time occurred during
+ * task execution is excluded from the accumulated tier execution time.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t sched_execute(volatile SCHED_OBJECT_t* schedobj)
+{
+    volatile uint16_t _i=0, _t=0;
+    volatile uint16_t _start=0, _stop=0, _exec=0, _isr=0;
+    volatile bool _tick_missed=false, _tier_missed=false;
+    volatile SCHED_TASK_t* _task;
+    volatile SCHED_TIER_t* _tier;
+
+    // If the scheduler object is not initialized, exit here with error
+    if (schedobj == NULL)
+        return(0);
+
+    // If scheduler is disabled, exit here
+    if (!schedobj->status.bits.enabled)
+        return(1);
+
+    schedobj->ticks++;
+
+    for (_t=0; _t<SCHED_TIER_COUNT; _t++)
+    {
+        _tier = &schedobj->tier[_t];
+        _tier->load = 0;
+        _tier_missed = false;
+
+        for (_i=0; _i<schedobj->count; _i++)
+        {
+            _task = &schedobj->task[_i];
+
+            // Skip tasks of other tiers and tasks not due in this tick
+            if ((_task->tier != _t) || (_task->offset != _tier->tick))
+                continue;
+            if (++_task->counter < _task->period)
+                continue;
+            _task->counter = 0;
+
+            // Execute task and capture execution time
+            if (schedobj->ptrIsrTime != NULL) _isr = *schedobj->ptrIsrTime;
+            _start = TMR1;
+
+            if (!_task->execute())
+            {
+                _task->errors++;
+                schedobj->status.bits.task_error = true;
+            }
+
+            _stop = TMR1;
+
+            if (_stop >= _start) // Consider Timer1 roll-over
+                _exec = (_stop - _start);
+            else
+                _exec = (schedobj->period - _start) + _stop;
+
+            _task->exec_time = _exec;
+            if (_exec > _task->exec_time_max)
+                _task->exec_time_max = _exec;
+            _tier->load += _exec;
+
+            // Accumulate execution time excluding interrupts occurred during task execution
+            if (schedobj->ptrIsrTime != NULL)
+            {
+                _isr = (*schedobj->ptrIsrTime - _isr);
+                if (_exec > _isr) _tier->busy += (_exec - _isr);
+            }
+            else
+            {
+                _tier->busy += _exec;
+            }
+
+            // Check if the next scheduler tick is already pending
+            if (schedobj->timebase != schedobj->tick_id)
+            {
+                if (!_tick_missed)
+                {   // This task has exceeded the scheduler tick
+                    _task->overruns++;
+                    _tick_missed = true;
+                }
+                if (!_tier_missed)
+                {   // This tier has missed its slot
+                    _tier->overruns++;
+                    _tier_missed = true;
+                }
+                schedobj->status.bits.overrun = true;
+            }
+        }
+
+        if (_tier->load > _tier->load_max)
+            _tier->load_max = _tier->load;
+
+        // Advance to next scheduler tick within the tier slot
+        if (++_tier->tick >= _tier->divider)
+            _tier->tick = 0;
+    }
+
+    return(1);
+}
+
+
+volatile uint16_t appScheduler_Initialize(void)
+{
+    volatile uint16_t retval=1;
+    volatile uint16_t _t=0;
+
+    // Initialize scheduler object
+    schedobj_Main.status.value = 0;
+    schedobj_Main.ticks = 0;
+    schedobj_Main.timebase = 0;
+    schedobj_Main.tick_id = 0;
+    schedobj_Main.ticks_lost = 0;
+    schedobj_Main.period = (MAIN_EXEC_PER + 1);
+    schedobj_Main.count = 0;
+    schedobj_Main.ptrIsrTime = NULL;
+
+    schedobj_Main.tier[SCHED_TIER_FAST].divider = 1;
+    schedobj_Main.tier[SCHED_TIER_MEDIUM].divider = SCHED_TIER_MED_DIV;
+    schedobj_Main.tier[SCHED_TIER_SLOW].divider = SCHED_TIER_SLOW_DIV;
+
+    for (_t=0; _t<SCHED_TIER_COUNT; _t++)
+    {
+        schedobj_Main.tier[_t].tick = 0;
+        schedobj_Main.tier[_t].load = 0;
+        schedobj_Main.tier[_t].load_max = 0;
+        schedobj_Main.tier[_t].overruns = 0;
+        schedobj_Main.tier[_t].busy = 0;
+    }
+
+    // Register tasks in order of priority
+    retval &= sched_add_task(&schedobj_Main, &appPowerSupply_Execute, SCHED_TIER_FAST, 1, 0); // Power supply state machine
+    retval &= sched_add_task(&schedobj_Main, &appFaults_Execute, SCHED_TIER_FAST, 1, 0); // Fault handler
+    #if (CPU_PROFILER_ENABLE == true)
+    retval &= sched_add_task(&schedobj_Main, &appProfiler_Execute, SCHED_TIER_FAST, 1, 0); // CPU load profiler
+    schedobj_Main.ptrIsrTime = &profobj_Main.duration.sum; // Exclude control interrupt time from task load
+    #endif
+    #if (STATS_ENABLE == true)
+    retval &= sched_add_task(&schedobj_Main, &appStats_Execute, SCHED_TIER_MEDIUM, 1, 0); // Evaluation of completed statistics windows
+    #endif
+    retval &= sched_add_task(&schedobj_Main, &appUart_Execute, SCHED_TIER_MEDIUM, 1, 0); // UART communication
+    retval &= sched_add_task(&schedobj_Main, &appSequencer_Execute, SCHED_TIER_MEDIUM, 1, 5); // Setpoint profile sequencer
+    retval &= sched_add_task(&schedobj_Main, &appPowerSupply_CurrentSenseCalibration, SCHED_TIER_SLOW, 1, 3); // Current sense calibration
+
+    schedobj_Main.status.bits.enabled = retval; // Enable scheduler
+
+    return(retval);
+}
+
+volatile uint16_t appScheduler_Wait(void)
+{
+    return(sched_wait(&schedobj_Main));
+}
+
+volatile uint16_t appScheduler_Execute(void)
+{
+    return(sched_execute(&schedobj_Main));
+}
+
+volatile uint16_t appScheduler_Dispose(void)
+{
+    schedobj_Main.status.value = 0;
+    schedobj_Main.count = 0;
+
+    return(1);
+}
+
+/* @@_T1Interrupt
+ * ********************************************************************************
+ * Summary:
+ * Scheduler time base interrupt
+ *
+ * Parameters:
+ *  (none)
+ *
+ * Returns:
+ *  (none)
+ *
+ * Description:
+ * Advances the scheduler time base every Timer1 period and wakes up the CPU
+ * from Idle mode.
+ *
+ * ********************************************************************************/
+
+void __attribute__((__interrupt__, no_auto_psv, context))_T1Interrupt(void)
+{
+    schedobj_Main.timebase++;
+    _T1IF = 0;
+}
+
+// END OF FILE
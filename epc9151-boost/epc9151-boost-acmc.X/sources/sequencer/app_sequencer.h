@@ -0,0 +1,119 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/* 
+ * File:   app_sequencer.h
+ * Author: M91406
+ * Comments: setpoint profile sequencer application layer API
+ * Revision history: 
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.  
+#ifndef APPLICATION_LAYER_SEQUENCER_HEADER_H
+#define	APPLICATION_LAYER_SEQUENCER_HEADER_H 
+
+#include <xc.h> // include processor files - each processor file is guarded.  
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!SEQ_OBJECT_t
+ * ***************************************************************************************************
+ * Summary:
+ * Setpoint profile sequencer data object
+ * 
+ * Description:
+ * The sequencer plays back a table of setpoints, each consisting of a dwell time, an output 
+ * voltage reference and an output current limit. The table is uploaded point by point via UART
+ * and executed by the main scheduler without further communication. Dwell times are counted in 
+ * sequencer ticks of SEQUENCER_TICK_PERIOD, starting when the setpoint has been applied. 
+ * 
+ * *************************************************************************************************** */
+
+#define SEQ_POINTS_MAX      32U  // Maximum number of setpoints per profile
+
+// Sequencer control commands
+#define SEQ_CMD_STOP        0U   // Stop profile execution
+#define SEQ_CMD_RUN         1U   // Run profile once
+#define SEQ_CMD_LOOP        2U   // Run profile continuously
+
+typedef union{
+
+	struct {
+		volatile bool running : 1;      // Bit 0: Flag bit indicating that the profile is being executed
+		volatile bool loop : 1;         // Bit 1: Control bit selecting continuous profile execution
+		volatile bool complete : 1;     // Bit 2: Flag bit indicating that the profile has been completed
+		volatile bool aborted : 1;      // Bit 3: Flag bit indicating that the profile has been aborted by the power controller
+		volatile bool applied : 1;      // Bit 4: Flag bit indicating that the active setpoint has been applied
+		volatile unsigned : 3;			// Bit <7:5>: (reserved)
+		volatile unsigned : 7;			// Bit <14:8> (reserved)
+		volatile bool enabled : 1;      // Bit 15: Control bit enabling/disabling the sequencer
+	} __attribute__((packed)) bits; // Sequencer object status bit field for single bit access  
+
+	volatile uint16_t value;		// Sequencer object status word  
+
+} SEQ_OBJECT_STATUS_t;	// Sequencer object status
+
+typedef struct {
+    volatile uint16_t time;         // Dwell time of this setpoint in sequencer ticks
+    volatile uint16_t v_ref;        // Output voltage reference
+    volatile uint16_t i_limit;      // Output current limit (0 = no change)
+} SEQ_POINT_t;  // Single setpoint of a profile
+
+typedef struct {
+	volatile SEQ_OBJECT_STATUS_t status; // Status word of this sequencer object
+    volatile uint16_t count;        // Number of setpoints of the uploaded profile
+    volatile uint16_t index;        // Index of the active setpoint
+    volatile uint16_t counter;      // Dwell time counter of the active setpoint
+    volatile uint16_t prescaler;    // Number of scheduler calls per sequencer tick
+    volatile uint16_t prescaler_counter; // Scheduler call counter
+    volatile uint16_t loops;        // Number of completed profile loops
+    volatile SEQ_POINT_t point[SEQ_POINTS_MAX]; // Profile setpoints
+} SEQ_OBJECT_t;
+
+// Public Function Prototypes
+extern volatile uint16_t seq_load_point(volatile SEQ_OBJECT_t* seqobj, volatile uint16_t index, 
+                volatile uint16_t time, volatile uint16_t v_ref, volatile uint16_t i_limit);
+extern volatile uint16_t seq_start(volatile SEQ_OBJECT_t* seqobj, volatile uint16_t count, volatile bool loop);
+extern volatile uint16_t seq_stop(volatile SEQ_OBJECT_t* seqobj);
+extern volatile uint16_t seq_check(volatile SEQ_OBJECT_t* seqobj);
+
+// Public Variable Declaration
+extern volatile SEQ_OBJECT_t seqobj_Buck;
+
+// PUBLIC FUNCTION PROTOTYPE DECLARATIONS
+extern volatile uint16_t appSequencer_Initialize(void);
+extern volatile uint16_t appSequencer_Execute(void);
+extern volatile uint16_t appSequencer_Dispose(void);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_SEQUENCER_HEADER_H */
+
@@ -0,0 +1,141 @@
+/*
+ * File:   app_settings.c
+ * Author: M91406
+ *
+ * Created on November 30, 2020, 10:05 AM
+ */
+
+#include <stddef.h>
+
+#include "app_settings.h"
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/app_power_control.h"
+#include "uart/drivers/drv_frame.h"
+
+
+// Define settings object
+volatile SETTINGS_OBJECT_t settingsobj_Buck;
+
+/* @@settings_load
+ * ********************************************************************************
+ * Summary:
+ * Loads the most recent settings record from flash
+ *
+ * Parameters:
+ *  volatile SETTINGS_OBJECT_t* settings: Pointer to settings object
+ *
+ * Returns:
+ *  1: valid record found
+ *  0: no valid record found (default settings are used)
+ *
+ * Description:
+ * The log is scanned up to the first erased word pair, which marks the next
+ * free record. Records with invalid tag, inverted copy or address are skipped.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t settings_load(volatile SETTINGS_OBJECT_t* settings)
+{
+    volatile uint16_t _i=0;
+    volatile uint16_t _w0=0, _w1=0, _inv=0;
+
+    if (settings == NULL) return(0);
+
+    settings->status.bits.valid = false;
+    settings->address = UART_ADDRESS_DEFAULT;
+
+    for (_i=0; _i<SETTINGS_RECORDS; _i++)
+    {
+        _w0 = nvm_read(_i * SETTINGS_RECORD_WORDS);
+        _w1 = nvm_read((_i * SETTINGS_RECORD_WORDS) + 1);
+
+        if ((_w0 == 0xFFFF) && (_w1 == 0xFFFF)) break; // first free record
+
+        _inv = ~_w0; // expected check word (complement truncated to 16 bit)
+
+        if (((_w0 >> 8) != SETTINGS_RECORD_TAG) || (_w1 != _inv)) continue;
+        if (((_w0 & 0xFF) < FRAME_ADDRESS_MIN) || ((_w0 & 0xFF) > FRAME_ADDRESS_MAX)) continue;
+
+        settings->address = (_w0 & 0xFF);
+        settings->status.bits.valid = true;
+    }
+
+    settings->next = _i;
+
+    return(settings->status.bits.valid);
+}
+
+/* @@settings_set_address
+ * ********************************************************************************
+ * Summary:
+ * Stores a new module address in flash
+ *
+ * Parameters:
+ *  volatile SETTINGS_OBJECT_t* settings: Pointer to settings object
+ *  volatile uint16_t address: New module address
+ *
+ * Returns:
+ *  1: success
+ *  0: error (invalid address, converter running, writes disabled or flash error)
+ *
+ * Description:
+ * A new record is appended to the log. When the page is full, it is erased 
+ * first. Unchanged settings are not written again. Flash operations stall the
+ * CPU incl. the control interrupt, so the request is rejected while the power
+ * converter is not in standby.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t settings_set_address(volatile SETTINGS_OBJECT_t* settings, volatile uint16_t address)
+{
+    volatile uint16_t retval=1;
+    volatile uint16_t _w0=0;
+
+    if (settings == NULL) return(0);
+    if (!settings->status.bits.enabled) return(0);
+    if ((address < FRAME_ADDRESS_MIN) || (address > FRAME_ADDRESS_MAX)) return(0);
+    if ((buck.mode > BUCK_STATE_STANDBY) && (buck.mode != BUCK_STATE_SUSPEND)) return(0);
+
+    if ((settings->status.bits.valid) && (settings->address == address)) return(1);
+
+    if (settings->next >= SETTINGS_RECORDS)
+    {
+        retval &= nvm_erase();
+        settings->next = 0;
+    }
+
+    _w0 = ((SETTINGS_RECORD_TAG << 8) | address);
+    retval &= nvm_write_pair((settings->next * SETTINGS_RECORD_WORDS), _w0, (uint16_t)(~_w0));
+    settings->next++;
+
+    if (retval)
+    {
+        settings->address = address;
+        settings->status.bits.valid = true;
+        settings->writes++;
+    }
+
+    return(retval);
+}
+
+
+volatile uint16_t appSettings_Initialize(void)
+{
+    volatile uint16_t retval=1;
+
+    // Initialize buck settings object
+    settingsobj_Buck.status.value = 0;
+    settingsobj_Buck.writes = 0;
+    settings_load(&settingsobj_Buck); // Default settings are used when no record is found
+
+    settingsobj_Buck.status.bits.enabled = true; // Enable writes to flash
+
+    return(retval);
+}
+
+volatile uint16_t appSettings_Dispose(void)
+{
+    settingsobj_Buck.status.bits.enabled = false; // Disable writes to flash
+
+    return(1);
+}
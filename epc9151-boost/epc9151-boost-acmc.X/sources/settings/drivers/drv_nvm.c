@@ -0,0 +1,124 @@
+/*
+ * File:   drv_nvm.c
+ * Author: M91406
+ *
+ * Created on November 30, 2020, 9:20 AM
+ */
+
+
+#include <xc.h>
+#include <stddef.h>
+#include "drv_nvm.h"
+
+#define NVM_LATCH_PAGE          0x00FAU // Table page of the flash write latches
+#define NVM_OP_PROGRAM_DWORD    0x4001U // NVMCON: WREN = 1, NVMOP = 0b0001 (double-word programming)
+#define NVM_OP_ERASE_PAGE       0x4003U // NVMCON: WREN = 1, NVMOP = 0b0011 (page erase)
+
+// Settings page (one erase page aligned to the page size in program memory address units)
+const uint16_t __attribute__((space(prog), aligned(2 * NVM_PAGE_WORDS), noload)) nvm_page[NVM_PAGE_WORDS];
+
+/*!nvm_read()
+ *****************************************************************************
+ * Function:	 uint16_t nvm_read(volatile uint16_t index)
+ * Arguments:	 uint16_t index
+ * Return Value: Unsigned Integer (lower 16 bits of the instruction word)
+ *
+ * Summary:
+ * Reads one word of the settings page
+ *
+ * Description:
+ * The page is aligned to its size, so it never crosses a table page 
+ * boundary and the table offset of each word is calculated from the
+ * offset of the first word.
+ *
+ *****************************************************************************/
+
+uint16_t nvm_read(volatile uint16_t index)
+{
+    volatile uint16_t _tblpag=TBLPAG;
+    volatile uint16_t _value=0xFFFF;
+
+    if (index >= NVM_PAGE_WORDS) return(_value);
+
+    TBLPAG = __builtin_tblpage(nvm_page);
+    _value = __builtin_tblrdl(__builtin_tbloffset(nvm_page) + (index << 1));
+    TBLPAG = _tblpag;
+
+    return(_value);
+}
+
+/*!nvm_write_pair()
+ *****************************************************************************
+ * Function:	 uint16_t nvm_write_pair(volatile uint16_t index, 
+ *                  volatile uint16_t word0, volatile uint16_t word1)
+ * Arguments:	 uint16_t index, uint16_t word0, uint16_t word1
+ * Return Value: Unsigned Integer (1=success, 0=failure)
+ *
+ * Summary:
+ * Programs two consecutive words of the settings page
+ *
+ * Description:
+ * The index has to be even. Both words must be erased before they are 
+ * programmed. The upper byte of both instruction words is left erased. 
+ * The CPU stalls until programming has been completed.
+ *
+ *****************************************************************************/
+
+volatile uint16_t nvm_write_pair(volatile uint16_t index, volatile uint16_t word0, volatile uint16_t word1)
+{
+    volatile uint16_t _tblpag=TBLPAG;
+    volatile uint16_t retval=1;
+
+    if ((index & 0x0001) || (index >= NVM_PAGE_WORDS)) return(0);
+
+    NVMCON = NVM_OP_PROGRAM_DWORD;
+    
+    // Load write latches
+    TBLPAG = NVM_LATCH_PAGE;
+    __builtin_tblwtl(0, word0);
+    __builtin_tblwth(0, 0x00FF);
+    __builtin_tblwtl(2, word1);
+    __builtin_tblwth(2, 0x00FF);
+
+    // Set target address and execute unlock sequence
+    NVMADRU = __builtin_tblpage(nvm_page);
+    NVMADR = (__builtin_tbloffset(nvm_page) + (index << 1));
+    __builtin_write_NVM();
+    while (NVMCONbits.WR);
+
+    retval &= (uint16_t)(!NVMCONbits.WRERR);
+    NVMCONbits.WREN = 0;
+    TBLPAG = _tblpag;
+
+    return(retval);
+}
+
+/*!nvm_erase()
+ *****************************************************************************
+ * Function:	 uint16_t nvm_erase(void)
+ * Arguments:	 (none)
+ * Return Value: Unsigned Integer (1=success, 0=failure)
+ *
+ * Summary:
+ * Erases the settings page
+ *
+ * Description:
+ * The CPU stalls until the page has been erased.
+ *
+ *****************************************************************************/
+
+volatile uint16_t nvm_erase(void)
+{
+    volatile uint16_t retval=1;
+
+    NVMCON = NVM_OP_ERASE_PAGE;
+    NVMADRU = __builtin_tblpage(nvm_page);
+    NVMADR = __builtin_tbloffset(nvm_page);
+    __builtin_write_NVM();
+    while (NVMCONbits.WR);
+
+    retval &= (uint16_t)(!NVMCONbits.WRERR);
+    NVMCONbits.WREN = 0;
+
+    return(retval);
+}
@@ -0,0 +1,379 @@
+/*
+ * File:   app_capture.c
+ * Author: M91406
+ *
+ * Created on November 26, 2020, 9:15 AM
+ */
+
+#include <stddef.h>
+
+#include "app_capture.h"
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/app_power_control.h"
+#include "fault_handler/app_faults.h"
+
+
+// Define capture object
+volatile CAPTURE_OBJECT_t capobj_Buck;
+
+/* @@capture_sample
+ * ********************************************************************************
+ * Summary:
+ * Records the selected channels and evaluates the trigger condition
+ *
+ * Parameters:
+ *  volatile CAPTURE_OBJECT_t* cap: Pointer to capture object
+ *
+ * Returns:
+ *  (none)
+ *
+ * Description:
+ * This function is called by the control interrupt. While the capture is
+ * armed, every n-th call adds one sample of all selected channels to the 
+ * circular buffer. The trigger condition is evaluated on every recorded 
+ * sample, but a trigger is only accepted when the pre-trigger section of the 
+ * buffer has been filled. Edge detection is based on the trigger variable 
+ * value of the previous sample. Once the post-trigger section has been 
+ * filled, the capture is disarmed and marked complete.
+ *
+ * ********************************************************************************/
+
+void capture_sample(volatile CAPTURE_OBJECT_t* cap)
+{
+    uint16_t _i=0, _idx=0;
+    uint16_t _value=0, _last=0;
+    bool _trig=false;
+
+    if ((!cap->status.bits.enabled) || (!cap->status.bits.armed)) return;
+
+    // Decimation
+    if (++cap->dec_counter < cap->decimation) return;
+    cap->dec_counter = 0;
+
+    // Add sample to circular buffer
+    _idx = cap->write_index;
+    for (_i=0; _i<cap->channels; _i++)
+    { cap->buffer[_idx++] = *cap->source[_i]; }
+    if (_idx >= (cap->depth * cap->channels)) _idx = 0;
+    cap->write_index = _idx;
+
+    if (cap->count < cap->depth) cap->count++;
+
+    // Wait for end of post-trigger section
+    if (cap->status.bits.triggered)
+    {
+        if (--cap->post_count == 0)
+        {
+            cap->status.bits.armed = false;
+            cap->status.bits.complete = true;
+        }
+        return;
+    }
+
+    // Evaluate trigger condition
+    if (cap->trigger_source != NULL)
+    {
+        _value = *cap->trigger_source;
+        _last = cap->last_value;
+        cap->last_value = _value;
+
+        switch (cap->trigger)
+        {
+            case CAPTURE_TRIG_FAULT:
+                _trig = (bool)((_value & ~_last) & 
+                        ((cap->trigger_level == 0) ? 0xFFFF : cap->trigger_level));
+                break;
+            case CAPTURE_TRIG_STATE:
+                _trig = (bool)((_value != _last) && 
+                        ((cap->trigger_level == CAPTURE_STATE_ANY) || (_value == cap->trigger_level)));
+                break;
+            case CAPTURE_TRIG_RISING:
+                _trig = (bool)((_last < cap->trigger_level) && (_value >= cap->trigger_level));
+                break;
+            case CAPTURE_TRIG_FALLING:
+                _trig = (bool)((_last > cap->trigger_level) && (_value <= cap->trigger_level));
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (cap->status.bits.force) _trig = true;
+
+    // Accept trigger when the pre-trigger section has been filled
+    if ((_trig) && (cap->count > cap->pre_trigger))
+    {
+        cap->trigger_cause = (cap->status.bits.force) ? CAPTURE_TRIG_MANUAL : cap->trigger;
+        cap->status.bits.triggered = true;
+        cap->status.bits.force = false;
+        cap->post_count = (cap->depth - cap->pre_trigger - 1);
+
+        if (cap->post_count == 0)
+        {
+            cap->status.bits.armed = false;
+            cap->status.bits.complete = true;
+        }
+    }
+
+    return;
+}
+
+/* @@capture_configure
+ * ********************************************************************************
+ * Summary:
+ * Selects the channels, the decimation and the trigger of the capture
+ *
+ * Parameters:
+ *  volatile CAPTURE_OBJECT_t* cap: Pointer to capture object
+ *  volatile uint16_t decimation: Number of control cycles per sample
+ *  volatile uint16_t pre_trigger: Number of samples before the trigger sample
+ *  volatile uint16_t trigger: Trigger source (CAPTURE_TRIGGER_e)
+ *  volatile uint16_t trigger_channel: Telemetry channel ID of the trigger variable (threshold triggers)
+ *  volatile uint16_t trigger_level: Trigger level (see CAPTURE_TRIGGER_e)
+ *  volatile uint16_t channels: Number of channels
+ *  volatile uint8_t* channel: Array of telemetry channel IDs
+ *
+ * Returns:
+ *  1: success
+ *  0: error (invalid parameter)
+ *
+ * Description:
+ * A running capture is stopped and the buffer contents are discarded. The
+ * buffer depth results from the number of channels and has to exceed the
+ * number of pre-trigger samples.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t capture_configure(volatile CAPTURE_OBJECT_t* cap, volatile uint16_t decimation,
+                volatile uint16_t pre_trigger, volatile uint16_t trigger, volatile uint16_t trigger_channel,
+                volatile uint16_t trigger_level, volatile uint16_t channels, volatile uint8_t* channel)
+{
+    volatile uint16_t _i=0;
+
+    if ((cap == NULL) || (channel == NULL)) return(0);
+    if ((channels == 0) || (channels > CAPTURE_CHANNELS_MAX)) return(0);
+    if ((decimation == 0) || (trigger >= CAPTURE_TRIG_COUNT)) return(0);
+    if (pre_trigger >= (CAPTURE_BUFFER_WORDS / channels)) return(0);
+    if (((trigger == CAPTURE_TRIG_RISING) || (trigger == CAPTURE_TRIG_FALLING)) && 
+        (trigger_channel >= TELEM_CH_COUNT)) return(0);
+    for (_i=0; _i<channels; _i++)
+    { if (channel[_i] >= TELEM_CH_COUNT) return(0); }
+
+    capture_stop(cap);
+    cap->status.bits.complete = false;
+
+    for (_i=0; _i<channels; _i++)
+    {
+        cap->channel[_i] = channel[_i];
+        cap->source[_i] = telem_channel_table[channel[_i]];
+    }
+    cap->channels = channels;
+    cap->depth = (CAPTURE_BUFFER_WORDS / channels);
+    cap->decimation = decimation;
+    cap->pre_trigger = pre_trigger;
+
+    cap->trigger = (CAPTURE_TRIGGER_e)trigger;
+    cap->trigger_level = trigger_level;
+    switch (cap->trigger)
+    {
+        case CAPTURE_TRIG_FAULT:
+            cap->trigger_source = &fltfast_Buck.latched; // latched in the control interrupt
+            break;
+        case CAPTURE_TRIG_STATE:
+            cap->trigger_source = (volatile uint16_t*)&buck.mode;
+            break;
+        case CAPTURE_TRIG_RISING:
+        case CAPTURE_TRIG_FALLING:
+            cap->trigger_source = telem_channel_table[trigger_channel];
+            break;
+        default:
+            cap->trigger_source = NULL;
+            break;
+    }
+
+    return(1);
+}
+
+/* @@capture_arm
+ * ********************************************************************************
+ * Summary:
+ * Arms the capture
+ *
+ * Parameters:
+ *  volatile CAPTURE_OBJECT_t* cap: Pointer to capture object
+ *
+ * Returns:
+ *  1: success
+ *  0: error (capture not configured or disabled)
+ *
+ * Description:
+ * The buffer contents of a previous capture are discarded and recording of 
+ * the pre-trigger section is started.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t capture_arm(volatile CAPTURE_OBJECT_t* cap)
+{
+    if (cap == NULL) return(0);
+    if ((cap->channels == 0) || (!cap->status.bits.enabled)) return(0);
+
+    cap->status.bits.armed = false;
+
+    cap->dec_counter = 0;
+    cap->write_index = 0;
+    cap->count = 0;
+    cap->post_count = 0;
+    cap->trigger_cause = CAPTURE_TRIG_MANUAL;
+    if (cap->trigger_source != NULL) 
+        cap->last_value = *cap->trigger_source;
+
+    cap->status.bits.triggered = false;
+    cap->status.bits.complete = false;
+    cap->status.bits.force = false;
+    cap->status.bits.armed = true;
+
+    return(1);
+}
+
+/* @@capture_stop
+ * ********************************************************************************
+ * Summary:
+ * Disarms the capture
+ *
+ * Parameters:
+ *  volatile CAPTURE_OBJECT_t* cap: Pointer to capture object
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * The contents of a completed capture remain available for readout.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t capture_stop(volatile CAPTURE_OBJECT_t* cap)
+{
+    if (cap == NULL) return(0);
+
+    cap->status.bits.armed = false;
+    cap->status.bits.force = false;
+
+    return(1);
+}
+
+/* @@capture_force
+ * ********************************************************************************
+ * Summary:
+ * Forces a trigger
+ *
+ * Parameters:
+ *  volatile CAPTURE_OBJECT_t* cap: Pointer to capture object
+ *
+ * Returns:
+ *  1: success
+ *  0: error (capture not configured or disabled)
+ *
+ * Description:
+ * The capture is armed if required. The trigger is accepted as soon as the
+ * pre-trigger section has been filled.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t capture_force(volatile CAPTURE_OBJECT_t* cap)
+{
+    volatile uint16_t fres=1;
+
+    if (cap == NULL) return(0);
+
+    if ((!cap->status.bits.armed) || (cap->status.bits.triggered))
+        fres &= capture_arm(cap);
+
+    if (fres) cap->status.bits.force = true;
+
+    return(fres);
+}
+
+/* @@capture_read_page
+ * ********************************************************************************
+ * Summary:
+ * Reads one data page of a completed capture
+ *
+ * Parameters:
+ *  volatile CAPTURE_OBJECT_t* cap: Pointer to capture object
+ *  volatile uint16_t page: Data page number
+ *  volatile uint16_t* buffer: Pointer to buffer of CAPTURE_PAGE_WORDS words
+ *
+ * Returns:
+ *  1: success
+ *  0: error (no completed capture available or invalid page)
+ *
+ * Description:
+ * Captured data is read oldest sample first with the channels of each sample
+ * in the order of selection. Words beyond the end of the capture are zero.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t capture_read_page(volatile CAPTURE_OBJECT_t* cap, volatile uint16_t page, 
+                volatile uint16_t* buffer)
+{
+    volatile uint16_t _i=0;
+    volatile uint16_t _words=0;
+    volatile uint16_t _pos=0;
+    volatile uint16_t _idx=0;
+
+    if ((cap == NULL) || (buffer == NULL)) return(0);
+    if (!cap->status.bits.complete) return(0);
+
+    _words = (cap->depth * cap->channels);
+    _pos = (page * CAPTURE_PAGE_WORDS);
+    if (_pos >= _words) return(0);
+
+    // The oldest sample is overwritten next
+    _idx = (cap->write_index + _pos);
+    if (_idx >= _words) _idx -= _words;
+
+    for (_i=0; _i<CAPTURE_PAGE_WORDS; _i++)
+    {
+        if ((_pos + _i) < _words)
+        {
+            buffer[_i] = cap->buffer[_idx++];
+            if (_idx >= _words) _idx = 0;
+        }
+        else
+        {
+            buffer[_i] = 0;
+        }
+    }
+
+    return(1);
+}
+
+
+volatile uint16_t appCapture_Initialize(void)
+{
+    volatile uint16_t retval=1;
+    volatile uint8_t _channel[3] = { TELEM_CH_V_OUT, TELEM_CH_I_SNS1, TELEM_CH_I_SNS2 };
+
+    // Initialize buck capture object
+    capobj_Buck.status.value = 0;
+    capobj_Buck.trigger_source = NULL;
+
+    // Default: output voltage and phase currents at full control rate, triggered by any fast fault
+    retval &= capture_configure(&capobj_Buck, 1, (CAPTURE_BUFFER_WORDS / 3 / 4), 
+                CAPTURE_TRIG_FAULT, 0, 0, 3, &_channel[0]);
+
+    capobj_Buck.status.bits.enabled = CAPTURE_ENABLE; // Enable triggered capture
+
+    return(retval);
+}
+
+volatile uint16_t appCapture_Dispose(void)
+{
+    volatile uint16_t fres=1;
+
+    fres &= capture_stop(&capobj_Buck);
+    capobj_Buck.status.bits.enabled = false;   // Disable triggered capture
+
+    return(fres);
+}
@@ -0,0 +1,165 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/*
+ * File:   app_capture.h
+ * Author: M91406
+ * Comments: triggered capture (oscilloscope mode) application layer API
+ * Revision history:
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef APPLICATION_LAYER_CAPTURE_HEADER_H
+#define	APPLICATION_LAYER_CAPTURE_HEADER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+#include "app_telemetry.h"
+#include "config/epc9151_r10_hwdescr.h"
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define CAPTURE_CHANNELS_MAX    4U   // Maximum number of captured channels (telemetry channel IDs)
+#if (CAPTURE_ENABLE == true)
+#define CAPTURE_BUFFER_WORDS    256U // Size of the capture buffer in 16-bit words (shared by all channels)
+#else
+#define CAPTURE_BUFFER_WORDS    CAPTURE_CHANNELS_MAX // Capture disabled: no RAM is reserved for samples
+#endif
+#define CAPTURE_PAGE_WORDS      16U  // Number of data words per readout page
+#define CAPTURE_STATE_ANY       0xFFFFU // Trigger level of CAPTURE_TRIG_STATE: trigger on any state transition
+
+#define CAPTURE_CMD_STOP        0U   // Command: disarm capture
+#define CAPTURE_CMD_ARM         1U   // Command: arm capture
+#define CAPTURE_CMD_FORCE       2U   // Command: force trigger (capture is armed if required)
+#define CAPTURE_CMD_STATUS      3U   // Command: read capture status only
+
+/*!CAPTURE_TRIGGER_e
+ * ***************************************************************************************************
+ * Summary:
+ * Trigger sources of the triggered capture
+ *
+ * Description:
+ * The trigger level is interpreted depending on the trigger source:
+ *  CAPTURE_TRIG_MANUAL:  (not used), the capture is only triggered by CAPTURE_CMD_FORCE
+ *  CAPTURE_TRIG_FAULT:   fast fault bit mask (bit n = fast fault check n, 0 = any fast fault)
+ *  CAPTURE_TRIG_STATE:   converter state entered (CAPTURE_STATE_ANY = any state transition)
+ *  CAPTURE_TRIG_RISING:  threshold of the trigger channel (crossing from below)
+ *  CAPTURE_TRIG_FALLING: threshold of the trigger channel (crossing from above)
+ *
+ * The fault trigger evaluates the latched fast faults, which are set by the control interrupt in
+ * the same control cycle as the fault condition has been detected. Faults detected by the fault
+ * engine are only evaluated every 100 us, which exceeds the capture time at full control rate.
+ * These faults can be captured by the state trigger (transition into the fault state).
+ *
+ * *************************************************************************************************** */
+
+typedef enum {
+    CAPTURE_TRIG_MANUAL     = 0, // trigger by command only
+    CAPTURE_TRIG_FAULT      = 1, // trigger when a fast fault trips (rising edge of latched fast faults)
+    CAPTURE_TRIG_STATE      = 2, // trigger on state transition of the converter state machine
+    CAPTURE_TRIG_RISING     = 3, // trigger on rising threshold crossing of the trigger channel
+    CAPTURE_TRIG_FALLING    = 4, // trigger on falling threshold crossing of the trigger channel
+    CAPTURE_TRIG_COUNT      = 5  // number of trigger sources
+} CAPTURE_TRIGGER_e;
+
+/*!CAPTURE_OBJECT_t
+ * ***************************************************************************************************
+ * Summary:
+ * Triggered capture data object
+ *
+ * Description:
+ * While armed, the control interrupt samples the selected channels every n-th control cycle
+ * (decimation) into a circular buffer. Each buffer entry holds one sample of all channels, so
+ * the buffer depth in samples depends on the number of channels. The trigger condition is
+ * evaluated as soon as the pre-trigger section of the buffer has been filled. After the trigger,
+ * sampling continues until the post-trigger section has been filled and the capture is marked 
+ * complete. The buffer contents are read out afterwards in pages, oldest sample first, where 
+ * sample number <pre_trigger> is the trigger sample.
+ *
+ * *************************************************************************************************** */
+
+typedef union{
+
+	struct {
+		volatile bool armed : 1;        // Bit 0: Flag bit indicating that the capture is running
+		volatile bool triggered : 1;    // Bit 1: Flag bit indicating that the trigger condition occurred
+		volatile bool complete : 1;     // Bit 2: Flag bit indicating that the capture buffer is ready for readout
+		volatile bool force : 1;        // Bit 3: Control bit forcing a trigger at the next sample
+		volatile unsigned : 4;			// Bit <7:4>: (reserved)
+		volatile unsigned : 7;			// Bit <14:8> (reserved)
+		volatile bool enabled : 1;      // Bit 15: Control bit enabling/disabling the triggered capture
+	} __attribute__((packed)) bits; // Capture object status bit field for single bit access
+
+	volatile uint16_t value;		// Capture object status word
+
+} CAPTURE_OBJECT_STATUS_t;	// Capture object status
+
+typedef struct {
+	volatile CAPTURE_OBJECT_STATUS_t status; // Status word of this capture object
+    volatile uint16_t decimation;   // Number of control cycles per sample
+    volatile uint16_t dec_counter;  // Control cycle counter (read only)
+    volatile uint16_t channels;     // Number of selected channels
+    volatile uint16_t depth;        // Buffer depth in samples
+    volatile uint16_t pre_trigger;  // Number of samples recorded before the trigger sample
+    volatile uint16_t* source[CAPTURE_CHANNELS_MAX]; // Pointers to the selected channel variables
+    volatile uint8_t channel[CAPTURE_CHANNELS_MAX]; // Selected channel IDs
+    volatile CAPTURE_TRIGGER_e trigger; // Trigger source
+    volatile uint16_t* trigger_source; // Pointer to the trigger channel variable (threshold triggers)
+    volatile uint16_t trigger_level; // Trigger level (see CAPTURE_TRIGGER_e)
+    volatile uint16_t trigger_cause; // Trigger source which caused the most recent trigger
+    volatile uint16_t last_value;   // Previous value of the trigger variable (edge detection)
+    volatile uint16_t write_index;  // Next buffer entry (sample) to be written
+    volatile uint16_t count;        // Number of samples recorded since arming (saturates at depth)
+    volatile uint16_t post_count;   // Number of samples still to be recorded after the trigger
+    volatile uint16_t buffer[CAPTURE_BUFFER_WORDS]; // Capture buffer (samples of all channels interleaved)
+} CAPTURE_OBJECT_t;
+
+// Public Function Prototypes
+extern void capture_sample(volatile CAPTURE_OBJECT_t* cap);
+extern volatile uint16_t capture_configure(volatile CAPTURE_OBJECT_t* cap, volatile uint16_t decimation,
+                volatile uint16_t pre_trigger, volatile uint16_t trigger, volatile uint16_t trigger_channel,
+                volatile uint16_t trigger_level, volatile uint16_t channels, volatile uint8_t* channel);
+extern volatile uint16_t capture_arm(volatile CAPTURE_OBJECT_t* cap);
+extern volatile uint16_t capture_stop(volatile CAPTURE_OBJECT_t* cap);
+extern volatile uint16_t capture_force(volatile CAPTURE_OBJECT_t* cap);
+extern volatile uint16_t capture_read_page(volatile CAPTURE_OBJECT_t* cap, volatile uint16_t page, 
+                volatile uint16_t* buffer);
+
+// Public Variable Declaration
+extern volatile CAPTURE_OBJECT_t capobj_Buck;
+
+// PUBLIC FUNCTION PROTOTYPE DECLARATIONS
+extern volatile uint16_t appCapture_Initialize(void);
+extern volatile uint16_t appCapture_Dispose(void);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_CAPTURE_HEADER_H */
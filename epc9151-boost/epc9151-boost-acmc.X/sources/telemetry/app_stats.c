@@ -0,0 +1,341 @@
+/*
+ * File:   app_stats.c
+ * Author: M91406
+ *
+ * Created on December 2, 2020, 9:30 AM
+ */
+
+#include <stddef.h>
+
+#include "app_stats.h"
+#include "config/epc9151_r10_hwdescr.h"
+
+
+// Define statistics object
+volatile STATS_OBJECT_t statsobj_Buck;
+
+/* PRIVATE FUNCTION PROTOTYPES */
+static uint16_t stats_sqrt(uint32_t value);
+
+static uint16_t stats_sqrt(uint32_t value)
+{
+    uint32_t _root=0;
+    uint32_t _bit=(1UL << 30);
+
+    // Bitwise integer square root (rounded down)
+    while (_bit > value) _bit >>= 2;
+    while (_bit != 0)
+    {
+        if (value >= (_root + _bit))
+        {
+            value -= (_root + _bit);
+            _root = ((_root >> 1) + _bit);
+        }
+        else
+        {
+            _root >>= 1;
+        }
+        _bit >>= 2;
+    }
+
+    return((uint16_t)_root);
+}
+
+/* @@stats_sample
+ * ********************************************************************************
+ * Summary:
+ * Adds one sample of the selected channels to the accumulators
+ *
+ * Parameters:
+ *  volatile STATS_OBJECT_t* stats: Pointer to statistics object
+ *
+ * Returns:
+ *  (none)
+ *
+ * Description:
+ * This function is called by the control interrupt. Every n-th call updates
+ * minimum, maximum, sum and sum of squares of each channel in the active 
+ * accumulator bank. The first sample of a window overwrites the accumulators. 
+ * When the window is complete, the bank is handed over to stats_execute() by
+ * toggling the bank index. If the previous bank has not been evaluated yet, 
+ * the completed window is discarded instead. A pending restart request 
+ * discards the current window before the sample is added.
+ *
+ * ********************************************************************************/
+
+void stats_sample(volatile STATS_OBJECT_t* stats)
+{
+    uint16_t _i=0;
+    uint16_t _value=0;
+    volatile STATS_ACCU_t* _accu;
+
+    if ((!stats->status.bits.enabled) || (!stats->status.bits.running)) return;
+
+    // Discard current window on request
+    if (stats->status.bits.restart)
+    {
+        stats->count = 0;
+        stats->dec_counter = 0;
+        stats->status.bits.restart = false;
+    }
+
+    // Decimation
+    if (++stats->dec_counter < stats->decimation) return;
+    stats->dec_counter = 0;
+
+    // Update accumulators of the active bank
+    _accu = &stats->accu[stats->bank][0];
+    if (stats->count == 0)
+    {
+        for (_i=0; _i<stats->channels; _i++)
+        {
+            _value = *stats->source[_i];
+            _accu[_i].minimum = _value;
+            _accu[_i].maximum = _value;
+            _accu[_i].sum = _value;
+            _accu[_i].sum_sq = __builtin_muluu(_value, _value);
+        }
+    }
+    else
+    {
+        for (_i=0; _i<stats->channels; _i++)
+        {
+            _value = *stats->source[_i];
+            if (_value < _accu[_i].minimum) _accu[_i].minimum = _value;
+            if (_value > _accu[_i].maximum) _accu[_i].maximum = _value;
+            _accu[_i].sum += _value;
+            _accu[_i].sum_sq += __builtin_muluu(_value, _value);
+        }
+    }
+
+    if (++stats->count < (1U << stats->window_shift)) return;
+    stats->count = 0;
+
+    // Hand completed bank over to stats_execute()
+    if (stats->status.bits.ready)
+    {   // Previous window has not been evaluated yet: refill active bank
+        stats->overruns++;
+        return;
+    }
+    stats->bank ^= 1;
+    stats->status.bits.ready = true;
+
+    return;
+}
+
+/* @@stats_execute
+ * ********************************************************************************
+ * Summary:
+ * Evaluates a completed window
+ *
+ * Parameters:
+ *  volatile STATS_OBJECT_t* stats: Pointer to statistics object
+ *
+ * Returns:
+ *  1: success
+ *  0: error (invalid parameter)
+ *
+ * Description:
+ * This function is called by a scheduler task. When the control interrupt
+ * has completed an accumulator bank, mean and variance are derived from 
+ * the sums of this bank by bit-shifts:
+ * 
+ *    mean = sum / N        variance = (N * sum_sq - sum^2) / N^2
+ *    RMS = sqrt(sum_sq / N)      AC RMS = sqrt(variance)
+ * 
+ * The results are published and the bank is released to the control 
+ * interrupt. The completed bank is not written by the control interrupt 
+ * until it has been released.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t stats_execute(volatile STATS_OBJECT_t* stats)
+{
+    volatile STATS_ACCU_t* _accu;
+    volatile uint16_t _shift=0;
+    volatile uint16_t _i=0;
+    uint64_t _var=0;
+
+    if (stats == NULL) return(0);
+    if (!stats->status.bits.ready) return(1);
+
+    _accu = &stats->accu[(stats->bank ^ 1)][0];
+    _shift = stats->window_shift;
+
+    for (_i=0; _i<stats->channels; _i++)
+    {
+        stats->result[_i].minimum = _accu[_i].minimum;
+        stats->result[_i].maximum = _accu[_i].maximum;
+        stats->result[_i].mean = (uint16_t)((_accu[_i].sum + (1UL << (_shift - 1))) >> _shift);
+        stats->result[_i].rms = stats_sqrt((uint32_t)(_accu[_i].sum_sq >> _shift));
+        _var = ((_accu[_i].sum_sq << _shift) - ((uint64_t)_accu[_i].sum * _accu[_i].sum));
+        stats->result[_i].ac_rms = stats_sqrt((uint32_t)(_var >> (_shift << 1)));
+        stats->result[_i].ripple = (_accu[_i].maximum - _accu[_i].minimum);
+    }
+
+    stats->window_count++;
+    stats->status.bits.valid = true;
+    stats->status.bits.ready = false; // Release bank to the control interrupt
+
+    return(1);
+}
+
+/* @@stats_configure
+ * ********************************************************************************
+ * Summary:
+ * Selects the channels, the decimation and the window length of the statistics
+ *
+ * Parameters:
+ *  volatile STATS_OBJECT_t* stats: Pointer to statistics object
+ *  volatile uint16_t decimation: Number of control cycles per sample
+ *  volatile uint16_t window_shift: Window length (2^n samples, n = 1...STATS_WINDOW_SHIFT_MAX)
+ *  volatile uint16_t channels: Number of channels
+ *  volatile uint8_t* channel: Array of telemetry channel IDs
+ *
+ * Returns:
+ *  1: success
+ *  0: error (invalid parameter)
+ *
+ * Description:
+ * The results of previous windows are discarded and the first window is 
+ * started immediately.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t stats_configure(volatile STATS_OBJECT_t* stats, volatile uint16_t decimation, 
+                volatile uint16_t window_shift, volatile uint16_t channels, volatile uint8_t* channel)
+{
+    volatile uint16_t _i=0;
+
+    if ((stats == NULL) || (channel == NULL)) return(0);
+    if ((channels == 0) || (channels > STATS_CHANNELS_MAX)) return(0);
+    if ((decimation == 0) || (window_shift == 0) || (window_shift > STATS_WINDOW_SHIFT_MAX)) return(0);
+    for (_i=0; _i<channels; _i++)
+    { if (channel[_i] >= TELEM_CH_COUNT) return(0); }
+
+    stats->status.bits.running = false;
+
+    for (_i=0; _i<channels; _i++)
+    {
+        stats->channel[_i] = channel[_i];
+        stats->source[_i] = telem_channel_table[channel[_i]];
+    }
+    stats->channels = channels;
+    stats->decimation = decimation;
+    stats->window_shift = window_shift;
+    stats->dec_counter = 0;
+    stats->count = 0;
+    stats->bank = 0;
+
+    stats->status.bits.restart = false;
+    stats->status.bits.ready = false;
+    stats->status.bits.valid = false;
+    stats->status.bits.running = true;
+
+    return(1);
+}
+
+/* @@stats_restart
+ * ********************************************************************************
+ * Summary:
+ * Discards the current window
+ *
+ * Parameters:
+ *  volatile STATS_OBJECT_t* stats: Pointer to statistics object
+ *
+ * Returns:
+ *  1: success
+ *  0: error (statistics not running)
+ *
+ * Description:
+ * The control interrupt restarts the window at the next sample, e.g. to 
+ * exclude a reference step from the statistics. The results of the most 
+ * recent completed window remain available.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t stats_restart(volatile STATS_OBJECT_t* stats)
+{
+    if (stats == NULL) return(0);
+    if (!stats->status.bits.running) return(0);
+
+    stats->status.bits.restart = true;
+
+    return(1);
+}
+
+/* @@stats_read
+ * ********************************************************************************
+ * Summary:
+ * Reads the statistics of the most recent published window
+ *
+ * Parameters:
+ *  volatile STATS_OBJECT_t* stats: Pointer to statistics object
+ *  STATS_RESULT_t* result: Pointer to array of STATS_CHANNELS_MAX results
+ *  volatile uint16_t* window: Pointer to window number of the results
+ *
+ * Returns:
+ *  1: success
+ *  0: error (no completed window available)
+ *
+ * Description:
+ * Results are published by stats_execute(), which is executed by the same 
+ * scheduler as the communication task, so all channels always belong to 
+ * the same window.
+ * 
+ * ********************************************************************************/
+
+volatile uint16_t stats_read(volatile STATS_OBJECT_t* stats, STATS_RESULT_t* result, 
+                volatile uint16_t* window)
+{
+    volatile uint16_t _i=0;
+
+    if ((stats == NULL) || (result == NULL) || (window == NULL)) return(0);
+    if (!stats->status.bits.valid) return(0);
+
+    for (_i=0; _i<stats->channels; _i++)
+    {
+        result[_i].minimum = stats->result[_i].minimum;
+        result[_i].maximum = stats->result[_i].maximum;
+        result[_i].mean = stats->result[_i].mean;
+        result[_i].rms = stats->result[_i].rms;
+        result[_i].ac_rms = stats->result[_i].ac_rms;
+        result[_i].ripple = stats->result[_i].ripple;
+    }
+    *window = stats->window_count;
+
+    return(1);
+}
+
+
+volatile uint16_t appStats_Initialize(void)
+{
+    volatile uint16_t retval=1;
+
+    // Initialize buck statistics object
+    statsobj_Buck.status.value = 0;
+    statsobj_Buck.window_count = 0;
+    statsobj_Buck.overruns = 0;
+    statsobj_Buck.channels = 0;
+    statsobj_Buck.window_shift = 0;
+
+    // Statistics are not running until channels have been selected by STATS_CONFIG, 
+    // so the control interrupt does not accumulate samples nobody reads
+    statsobj_Buck.status.bits.running = false;
+    statsobj_Buck.status.bits.enabled = STATS_ENABLE; // Enable running statistics
+
+    return(retval);
+}
+
+volatile uint16_t appStats_Execute(void)
+{
+    return(stats_execute(&statsobj_Buck)); // Evaluate completed window
+}
+
+volatile uint16_t appStats_Dispose(void)
+{
+    statsobj_Buck.status.bits.running = false;
+    statsobj_Buck.status.bits.enabled = false;   // Disable running statistics
+
+    return(1);
+}
@@ -0,0 +1,170 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/*
+ * File:   app_stats.h
+ * Author: M91406
+ * Comments: running statistics of control cycle data application layer API
+ * Revision history:
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef APPLICATION_LAYER_STATISTICS_HEADER_H
+#define	APPLICATION_LAYER_STATISTICS_HEADER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+#include "app_telemetry.h"
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define STATS_CHANNELS_MAX      4U   // Maximum number of evaluated channels (telemetry channel IDs)
+#define STATS_WINDOW_SHIFT_MAX  15U  // Maximum window length (2^n samples)
+
+#define STATS_CMD_READ          0U   // Command: read results of the most recent window
+#define STATS_CMD_RESTART       1U   // Command: read results and restart the current window
+
+/*!STATS_ACCU_t
+ * ***************************************************************************************************
+ * Summary:
+ * Accumulators of one channel
+ *
+ * Description:
+ * The sum of squares is accumulated in 64 bit, so windows of up to 2^15 samples of full-scale 
+ * 16-bit values cannot overflow.
+ *
+ * *************************************************************************************************** */
+
+typedef struct {
+    volatile uint16_t minimum;      // Smallest sample of the window
+    volatile uint16_t maximum;      // Largest sample of the window
+    volatile uint32_t sum;          // Sum of all samples of the window
+    volatile uint64_t sum_sq;       // Sum of the squares of all samples of the window
+} STATS_ACCU_t;
+
+/*!STATS_RESULT_t
+ * ***************************************************************************************************
+ * Summary:
+ * Statistics of one channel over one window
+ *
+ * Description:
+ * Values are given in the unit of the telemetry channel (e.g. ADC ticks). The RMS value is the 
+ * RMS value of the complete signal. The AC RMS value is the RMS value of the AC component 
+ * (standard deviation), which does not depend on feedback offsets.
+ *
+ * *************************************************************************************************** */
+
+typedef struct {
+    uint16_t minimum;       // Smallest sample
+    uint16_t maximum;       // Largest sample
+    uint16_t mean;          // Arithmetic mean (rounded)
+    uint16_t rms;           // RMS value
+    uint16_t ac_rms;        // RMS value of the AC component (standard deviation)
+    uint16_t ripple;        // Peak-to-peak ripple (maximum - minimum)
+} STATS_RESULT_t;
+
+/*!STATS_OBJECT_t
+ * ***************************************************************************************************
+ * Summary:
+ * Running statistics data object
+ *
+ * Description:
+ * The control interrupt adds every n-th control cycle (decimation) one sample of each selected 
+ * channel to one of two accumulator banks. The first sample of a window initializes the 
+ * accumulators, so they never have to be cleared. After 2^window_shift samples the control 
+ * interrupt only toggles the bank index and continues with the next window in the other bank 
+ * (tumbling windows). The completed bank is evaluated by stats_execute() in a scheduler task,
+ * which derives mean and RMS values by bit-shifts and a square root from the sums and publishes
+ * the results. The control interrupt therefore neither copies nor clears accumulators and 
+ * executes no division or square root.
+ *
+ * The ready flag is a handshake flag: it is only set by the control interrupt when a bank has 
+ * been completed and only cleared by stats_execute() after the bank has been evaluated. While it
+ * is set the control interrupt does not touch the completed bank. A window completed before 
+ * the previous one has been evaluated is discarded and counted as overrun.
+ *
+ * The restart flag is a handshake flag: it is only set by the communication task and only 
+ * cleared by the control interrupt.
+ *
+ * *************************************************************************************************** */
+
+typedef union{
+
+	struct {
+		volatile bool running : 1;      // Bit 0: Flag bit indicating that statistics are accumulated
+		volatile bool restart : 1;      // Bit 1: Control bit discarding the current window at the next sample
+		volatile bool valid : 1;        // Bit 2: Flag bit indicating that a completed window has been published
+		volatile bool ready : 1;        // Bit 3: Flag bit indicating that a completed bank waits for evaluation
+		volatile unsigned : 4;			// Bit <7:4>: (reserved)
+		volatile unsigned : 7;			// Bit <14:8> (reserved)
+		volatile bool enabled : 1;      // Bit 15: Control bit enabling/disabling the statistics engine
+	} __attribute__((packed)) bits; // Statistics object status bit field for single bit access
+
+	volatile uint16_t value;		// Statistics object status word
+
+} STATS_OBJECT_STATUS_t;	// Statistics object status
+
+typedef struct {
+	volatile STATS_OBJECT_STATUS_t status; // Status word of this statistics object
+    volatile uint16_t decimation;   // Number of control cycles per sample
+    volatile uint16_t dec_counter;  // Control cycle counter (read only)
+    volatile uint16_t channels;     // Number of selected channels
+    volatile uint16_t window_shift; // Window length (2^n samples)
+    volatile uint16_t count;        // Number of samples in the current window
+    volatile uint16_t window_count; // Free-running number of published windows
+    volatile uint16_t overruns;     // Number of windows discarded before evaluation
+    volatile uint16_t bank;         // Accumulator bank filled by the control interrupt (0 or 1)
+    volatile uint16_t* source[STATS_CHANNELS_MAX]; // Pointers to the selected channel variables
+    volatile uint8_t channel[STATS_CHANNELS_MAX]; // Selected channel IDs
+    volatile STATS_ACCU_t accu[2][STATS_CHANNELS_MAX]; // Accumulator banks of the current and the completed window
+    volatile STATS_RESULT_t result[STATS_CHANNELS_MAX]; // Results of the most recent published window
+} STATS_OBJECT_t;
+
+// Public Function Prototypes
+extern void stats_sample(volatile STATS_OBJECT_t* stats);
+extern volatile uint16_t stats_execute(volatile STATS_OBJECT_t* stats);
+extern volatile uint16_t stats_configure(volatile STATS_OBJECT_t* stats, volatile uint16_t decimation, 
+                volatile uint16_t window_shift, volatile uint16_t channels, volatile uint8_t* channel);
+extern volatile uint16_t stats_restart(volatile STATS_OBJECT_t* stats);
+extern volatile uint16_t stats_read(volatile STATS_OBJECT_t* stats, STATS_RESULT_t* result, 
+                volatile uint16_t* window);
+
+// Public Variable Declaration
+extern volatile STATS_OBJECT_t statsobj_Buck;
+
+// PUBLIC FUNCTION PROTOTYPE DECLARATIONS
+extern volatile uint16_t appStats_Initialize(void);
+extern volatile uint16_t appStats_Execute(void);
+extern volatile uint16_t appStats_Dispose(void);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_STATISTICS_HEADER_H */
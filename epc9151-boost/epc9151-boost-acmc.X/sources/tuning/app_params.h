@@ -0,0 +1,152 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/*
+ * File:   app_params.h
+ * Author: M91406
+ * Comments: live parameter access (online tuning) application layer API
+ * Revision history:
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef APPLICATION_LAYER_PARAMS_HEADER_H
+#define	APPLICATION_LAYER_PARAMS_HEADER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define PARAM_WRITE_MAX         8U   // Maximum number of parameters written in one atomic write
+#define PARAM_NAME_MAX          32U  // Maximum length of a parameter name in characters
+
+/*!PARAM_TYPE_e
+ * ***************************************************************************************************
+ * Summary:
+ * Data types of registered parameters
+ *
+ * Description:
+ * All parameters are 16-bit words. The data type selects how the word is interpreted when it is
+ * compared against the valid range of the parameter.
+ *
+ * *************************************************************************************************** */
+
+typedef enum {
+    PARAM_TYPE_U16          = 0, // unsigned 16-bit integer
+    PARAM_TYPE_I16          = 1  // signed 16-bit integer or Q15 fractional
+} PARAM_TYPE_e;
+
+typedef enum {
+    PARAM_ORDER_NONE        = 0, // no relation to other parameters
+    PARAM_ORDER_ABOVE_NEXT  = 1, // value has to be greater than the value of the following entry
+    PARAM_ORDER_BELOW_NEXT  = 2  // value has to be less than the value of the following entry
+} PARAM_ORDER_e;
+
+/*!PARAM_DEFINITION_t
+ * ***************************************************************************************************
+ * Summary:
+ * Entry of the constant parameter registry
+ *
+ * Description:
+ * Only variables listed in the parameter registry can be accessed through the communication
+ * interface. The position of an entry in the registry is the parameter ID. Writes outside the 
+ * range <minimum>...<maximum> are rejected. Protection thresholds can only be tightened with 
+ * respect to the compiled design limits.
+ * 
+ * Trip and reset levels of a protection are registered as adjacent entries. The order setting of
+ * the first entry declares the required relation to the following entry (e.g. trip level above 
+ * reset level for over-limit checks, below for under-limit checks). The relation is checked
+ * against the value written in the same request or, if only one of both is written, against the
+ * present value of the other one.
+ *
+ * *************************************************************************************************** */
+
+typedef struct {
+    const char* name;               // Parameter name (max. PARAM_NAME_MAX characters)
+    volatile uint16_t* address;     // Pointer to the parameter variable
+    PARAM_TYPE_e type;              // Data type used for range checks
+    int32_t minimum;                // Lowest valid value
+    int32_t maximum;                // Highest valid value
+    PARAM_ORDER_e order;            // Required relation to the following entry (default: none)
+} PARAM_DEFINITION_t; // Constant parameter definition
+
+/*!PARAM_OBJECT_t
+ * ***************************************************************************************************
+ * Summary:
+ * Live parameter access data object
+ *
+ * Description:
+ * Parameter writes are range checked and staged by the communication task. The staged set of
+ * values is written by the control interrupt after all functions of the control cycle have been
+ * executed, so each control cycle either runs with all old or all new values. A new set can only
+ * be staged after the previous one has been applied (single writer per flag, no interrupt locks).
+ *
+ * *************************************************************************************************** */
+
+typedef union{
+
+	struct {
+		volatile bool pending : 1;      // Bit 0: Flag bit indicating that a staged set waits to be applied
+		volatile unsigned : 7;			// Bit <7:1>: (reserved)
+		volatile unsigned : 7;			// Bit <14:8> (reserved)
+		volatile bool enabled : 1;      // Bit 15: Control bit enabling/disabling parameter writes
+	} __attribute__((packed)) bits; // Parameter object status bit field for single bit access
+
+	volatile uint16_t value;		// Parameter object status word
+
+} PARAM_OBJECT_STATUS_t;	// Parameter object status
+
+typedef struct {
+	volatile PARAM_OBJECT_STATUS_t status; // Status word of this parameter object
+    const PARAM_DEFINITION_t* table; // Pointer to parameter registry
+    volatile uint16_t size;         // Number of registered parameters
+    volatile uint16_t count;        // Number of staged values
+    volatile uint16_t id[PARAM_WRITE_MAX]; // Parameter IDs of staged values
+    volatile uint16_t value[PARAM_WRITE_MAX]; // Staged values
+    volatile uint16_t applied;      // Number of sets applied by the control interrupt (read only)
+} PARAM_OBJECT_t;
+
+// Public Function Prototypes
+extern void param_apply(volatile PARAM_OBJECT_t* params);
+extern volatile uint16_t param_read(volatile PARAM_OBJECT_t* params, volatile uint16_t id, volatile uint16_t* value);
+extern volatile uint16_t param_write(volatile PARAM_OBJECT_t* params, volatile uint16_t count,
+                volatile uint16_t* id, volatile uint16_t* value);
+extern const PARAM_DEFINITION_t* param_definition(volatile PARAM_OBJECT_t* params, volatile uint16_t id);
+
+// Public Variable Declaration
+extern volatile PARAM_OBJECT_t paramobj_Buck;
+
+// PUBLIC FUNCTION PROTOTYPE DECLARATIONS
+extern volatile uint16_t appParams_Initialize(void);
+extern volatile uint16_t appParams_Dispose(void);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_PARAMS_HEADER_H */
@@ -10,21 +10,425 @@
 #include "app_uart.h"
 #include "config/epc9151_r10_hwdescr.h"
 #include "pwr_control/app_power_control.h"
+#include "sequencer/app_sequencer.h"
+#include "profiler/app_profiler.h"
+#include "fault_handler/app_fault_log.h"
+#include "telemetry/app_telemetry.h"
+#include "telemetry/app_capture.h"
+#include "telemetry/app_stats.h"
+#include "tuning/app_params.h"
+#include "pmbus/app_pmbus.h"
+#include "settings/app_settings.h"
+#include "units/app_units.h"
 
 
 // Define uart object
 volatile UART_OBJECT_t uartobj_Buck;
 
-volatile uint16_t uart_check(volatile UART_OBJECT_t* uartobj) {
-    volatile char ReceivedChar;
+// Define uart driver object (transmit and receive ring buffers)
+volatile UART_DRIVER_t uartdrv_Buck;
+
+/* PRIVATE FUNCTION PROTOTYPES */
+static inline uint16_t proto_get_u16(volatile uint8_t* src);
+static inline void proto_put_u16(volatile uint8_t* dst, uint16_t value);
+volatile uint16_t uart_execute_request(volatile UART_OBJECT_t* uartobj);
+
+static inline uint16_t proto_get_u16(volatile uint8_t* src)
+{
+    return((uint16_t)src[0] | ((uint16_t)src[1] << 8));
+}
+
+static inline void proto_put_u16(volatile uint8_t* dst, uint16_t value)
+{
+    dst[0] = (value & 0xFF);    // low byte
+    dst[1] = (value >> 8);      // high byte
+}
+
+/* @@uart_execute_request
+ * ********************************************************************************
+ * Summary:
+ * Executes a received request frame and builds the response payload
+ * 
+ * Parameters:
+ *  volatile UART_OBJECT_t* uartobj: Pointer to uart object
+ * 
+ * Returns:
+ *  Number of response payload bytes (incl. status byte)
+ * 
+ * Description:
+ * The decoded request frame is read from the frame receiver buffer. The 
+ * response payload is written into the response frame buffer, starting with
+ * the request status. Data is only added to successful responses.
+ * 
+ * ********************************************************************************/
+
+volatile uint16_t uart_execute_request(volatile UART_OBJECT_t* uartobj)
+{
+    volatile uint8_t* _req = &uartobj->rx_frame.buffer[FRAME_OFS_PAYLOAD];
+    volatile uint8_t* _rsp = &uartobj->tx_frame[FRAME_OFS_PAYLOAD];
+    volatile uint16_t _length = uartobj->rx_frame.buffer[FRAME_OFS_LENGTH];
+    volatile uint16_t _page[CAPTURE_PAGE_WORDS];
+    volatile uint16_t _id[PARAM_WRITE_MAX];
+    const PARAM_DEFINITION_t* _def;
+    UNITS_DATA_t _units;
+    STATS_RESULT_t _stats[STATS_CHANNELS_MAX];
     volatile uint16_t _i=0;
+    volatile uint16_t _size=1;
+    volatile uint16_t fres=1;
+    
+    switch (uartobj->rx_frame.buffer[FRAME_OFS_COMMAND]) 
+    {
+        case PROTO_CMD_GET_VERSION:
+            if (_length != 0) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            _rsp[1] = FRAME_PROTOCOL_VERSION;
+            proto_put_u16(&_rsp[2], FIRMWARE_VER_NUM0);
+            proto_put_u16(&_rsp[4], FIRMWARE_VER_NUM1);
+            proto_put_u16(&_rsp[6], FIRMWARE_VER_NUM2);
+            _size = 8;
+            break;
+            
+        case PROTO_CMD_READ_DATA:
+            if (_length != 0) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            proto_put_u16(&_rsp[1], *uartobj->data1);
+            proto_put_u16(&_rsp[3], *uartobj->data2);
+            proto_put_u16(&_rsp[5], *uartobj->data3);
+            proto_put_u16(&_rsp[7], *uartobj->data4);
+            proto_put_u16(&_rsp[9], buck.mode);
+            proto_put_u16(&_rsp[11], buck.status.value);
+            _size = 13;
+            break;
+            
+        case PROTO_CMD_DISCOVER:
+            if (_length != 0) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            _rsp[1] = (uint8_t)uartobj->address;
+            _rsp[2] = FRAME_PROTOCOL_VERSION;
+            proto_put_u16(&_rsp[3], FIRMWARE_VER_NUM0);
+            proto_put_u16(&_rsp[5], FIRMWARE_VER_NUM1);
+            proto_put_u16(&_rsp[7], FIRMWARE_VER_NUM2);
+            _size = 9;
+            break;
+            
+        case PROTO_CMD_SET_ADDRESS:
+            if (_length != 2) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // 1st byte: new address, 2nd byte: store in flash (0 = no, else yes)
+            // a broadcast would assign the same address to all modules
+            if ((uartobj->rx_frame.buffer[FRAME_OFS_ADDRESS] == FRAME_ADDRESS_BROADCAST) ||
+                (_req[0] < FRAME_ADDRESS_MIN) || (_req[0] > FRAME_ADDRESS_MAX))
+                { _rsp[0] = PROTO_STATUS_REJECTED; return(1); }
+            if (_req[1] != 0)
+                fres &= settings_set_address(&settingsobj_Buck, _req[0]);
+            if (fres) 
+                uartobj->address = _req[0]; // the response is still sent with the previous address
+            _rsp[1] = (uint8_t)uartobj->address;
+            _size = 2;
+            break;
+            
+        case PROTO_CMD_READ_UNITS:
+            if (_length != 0) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            units_read(&_units);
+            proto_put_u16(&_rsp[1], _units.v_in);
+            proto_put_u16(&_rsp[3], _units.v_out);
+            proto_put_u16(&_rsp[5], _units.v_ref);
+            proto_put_u16(&_rsp[7], (uint16_t)_units.i_sns[0]);
+            proto_put_u16(&_rsp[9], (uint16_t)_units.i_sns[1]);
+            proto_put_u16(&_rsp[11], (uint16_t)_units.i_out);
+            proto_put_u16(&_rsp[13], (uint16_t)_units.temp);
+            proto_put_u16(&_rsp[15], buck.mode);
+            _size = 17;
+            break;
+            
+        case PROTO_CMD_SET_VREF:
+            if (_length != 2) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // update vout reference (the state machine tunes into the new reference)
+            buck.set_values.v_ref = proto_get_u16(&_req[0]);
+            proto_put_u16(&_rsp[1], buck.set_values.v_ref);
+            _size = 3;
+            break;
+            
+        case PROTO_CMD_SET_VOUT:
+            if (_length != 2) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // convert output voltage in [mV] into vout reference
+            _i = units_vref_ticks(proto_get_u16(&_req[0]));
+            if (_i > UNITS_VREF_MAX) { _rsp[0] = PROTO_STATUS_REJECTED; return(1); }
+            buck.set_values.v_ref = _i;
+            proto_put_u16(&_rsp[1], units_vout_mv(buck.set_values.v_ref));
+            proto_put_u16(&_rsp[3], buck.set_values.v_ref);
+            _size = 5;
+            break;
+            
+        case PROTO_CMD_SEQ_LOAD:
+            if (_length != 8) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // write setpoint (index, time, v_ref, i_limit) into profile table
+            fres &= seq_load_point(&seqobj_Buck, proto_get_u16(&_req[0]), proto_get_u16(&_req[2]),
+                        proto_get_u16(&_req[4]), proto_get_u16(&_req[6]));
+            break;
+            
+        case PROTO_CMD_SEQ_CONTROL:
+            if (_length != 2) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // 1st byte: command, 2nd byte: number of setpoints
+            if (_req[0] == SEQ_CMD_STOP)
+                fres &= seq_stop(&seqobj_Buck);
+            else
+                fres &= seq_start(&seqobj_Buck, _req[1], (_req[0] == SEQ_CMD_LOOP));
+            break;
+            
+        case PROTO_CMD_PROF_READ:
+            if (_length != 1) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // data page (0xFF = reset statistics)
+            if (_req[0] == PROF_PAGE_RESET)
+            {
+                fres &= prof_reset(&profobj_Main);
+            }
+            else
+            {
+                fres &= prof_read_page(&profobj_Main, _req[0], &_page[0]);
+                for (_i=0; _i<8; _i++) 
+                    proto_put_u16(&_rsp[1 + (_i << 1)], _page[_i]);
+                _size = 17;
+            }
+            break;
+            
+        case PROTO_CMD_FLOG_READ:
+            if (_length != 2) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // 1st byte: entry (0 = most recent, 0xFF = clear log), 2nd byte: data page
+            if (_req[0] == FLOG_CMD_CLEAR)
+            {
+                fres &= flog_clear(&flogobj_Buck);
+            }
+            else
+            {
+                fres &= flog_read_page(&flogobj_Buck, _req[0], _req[1], &_page[0]);
+                for (_i=0; _i<8; _i++) 
+                    proto_put_u16(&_rsp[1 + (_i << 1)], _page[_i]);
+                _size = 17;
+            }
+            break;
+            
+        case PROTO_CMD_STREAM_CONFIG:
+            if ((_length < 3) || (_length > (2 + TELEM_CHANNELS_MAX))) 
+                { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // decimation (16 bit) followed by the channel IDs
+            _rsp[1] = (uint8_t)(TELEM_BLOCK_WORDS / (_length - 2));
+            proto_put_u16(&_rsp[2], telem_min_decimation(_length - 2));
+            _size = 4;
+            // frame data is also returned when rejected, so the host learns the minimum decimation
+            if (!telem_configure(&telemobj_Buck, proto_get_u16(&_req[0]), (_length - 2), &_req[2]))
+                { _rsp[0] = PROTO_STATUS_REJECTED; return(_size); }
+            break;
+            
+        case PROTO_CMD_STREAM_CONTROL:
+            if (_length != 1) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            if (_req[0] == TELEM_CMD_STOP)
+            {
+                fres &= telem_stop(&telemobj_Buck);
+            }
+            else
+            {
+                // stream blocks of modules sharing a bus are sent on request only
+                uartobj->status.bits.stream_polled = (bool)(_req[0] == TELEM_CMD_START_POLLED);
+                fres &= telem_start(&telemobj_Buck);
+            }
+            proto_put_u16(&_rsp[1], telemobj_Buck.sample_index);
+            proto_put_u16(&_rsp[3], telemobj_Buck.dropped);
+            _size = 5;
+            break;
+            
+        case PROTO_CMD_STREAM_POLL:
+            if (_length != 0) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // next completed block in stream data frame format (0 samples = no block ready)
+            _size = telem_read_block(&telemobj_Buck, &_rsp[0]);
+            if (_size == 0)
+            {
+                _rsp[1] = 0;
+                proto_put_u16(&_rsp[2], telemobj_Buck.sample_index);
+                _size = TELEM_HEADER_SIZE;
+            }
+            break;
+            
+        case PROTO_CMD_STATS_CONFIG:
+            if ((_length < 4) || (_length > (3 + STATS_CHANNELS_MAX))) 
+                { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // decimation, window length, channel IDs
+            fres &= stats_configure(&statsobj_Buck, proto_get_u16(&_req[0]), _req[2], 
+                        (_length - 3), &_req[3]);
+            break;
+            
+        case PROTO_CMD_STATS_READ:
+            if (_length != 1) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            if (_req[0] > STATS_CMD_RESTART) { _rsp[0] = PROTO_STATUS_REJECTED; return(1); }
+            _size = 9;
+            if (stats_read(&statsobj_Buck, &_stats[0], &_i))
+            {
+                proto_put_u16(&_rsp[3], _i);
+                for (_i=0; _i<statsobj_Buck.channels; _i++)
+                {
+                    proto_put_u16(&_rsp[_size], _stats[_i].minimum);
+                    proto_put_u16(&_rsp[_size + 2], _stats[_i].maximum);
+                    proto_put_u16(&_rsp[_size + 4], _stats[_i].mean);
+                    proto_put_u16(&_rsp[_size + 6], _stats[_i].rms);
+                    proto_put_u16(&_rsp[_size + 8], _stats[_i].ac_rms);
+                    proto_put_u16(&_rsp[_size + 10], _stats[_i].ripple);
+                    _size += 12;
+                }
+            }
+            else
+            {
+                proto_put_u16(&_rsp[3], statsobj_Buck.window_count);
+            }
+            if (_req[0] == STATS_CMD_RESTART)
+                fres &= stats_restart(&statsobj_Buck);
+            proto_put_u16(&_rsp[1], statsobj_Buck.status.value);
+            proto_put_u16(&_rsp[5], ((statsobj_Buck.window_shift > 0) ? (1U << statsobj_Buck.window_shift) : 0));
+            proto_put_u16(&_rsp[7], statsobj_Buck.channels);
+            break;
+            
+        case PROTO_CMD_CAPTURE_CONFIG:
+            if ((_length < 9) || (_length > (8 + CAPTURE_CHANNELS_MAX))) 
+                { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // decimation, pre-trigger samples, trigger source, trigger channel, trigger level, channel IDs
+            fres &= capture_configure(&capobj_Buck, proto_get_u16(&_req[0]), proto_get_u16(&_req[2]),
+                        _req[4], _req[5], proto_get_u16(&_req[6]), (_length - 8), &_req[8]);
+            proto_put_u16(&_rsp[1], capobj_Buck.depth);
+            _size = 3;
+            break;
+            
+        case PROTO_CMD_CAPTURE_CONTROL:
+            if (_length != 1) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            if (_req[0] == CAPTURE_CMD_STOP)
+                fres &= capture_stop(&capobj_Buck);
+            else if (_req[0] == CAPTURE_CMD_ARM)
+                fres &= capture_arm(&capobj_Buck);
+            else if (_req[0] == CAPTURE_CMD_FORCE)
+                fres &= capture_force(&capobj_Buck);
+            else if (_req[0] != CAPTURE_CMD_STATUS)
+                fres = 0;
+            proto_put_u16(&_rsp[1], capobj_Buck.status.value);
+            proto_put_u16(&_rsp[3], capobj_Buck.trigger_cause);
+            proto_put_u16(&_rsp[5], capobj_Buck.count);
+            proto_put_u16(&_rsp[7], capobj_Buck.channels);
+            proto_put_u16(&_rsp[9], capobj_Buck.pre_trigger);
+            _size = 11;
+            break;
+            
+        case PROTO_CMD_CAPTURE_READ:
+            if (_length != 1) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            fres &= capture_read_page(&capobj_Buck, _req[0], &_page[0]);
+            for (_i=0; _i<CAPTURE_PAGE_WORDS; _i++) 
+                proto_put_u16(&_rsp[1 + (_i << 1)], _page[_i]);
+            _size = (1 + (CAPTURE_PAGE_WORDS << 1));
+            break;
+            
+        case PROTO_CMD_PARAM_INFO:
+            if (_length != 1) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            _def = param_definition(&paramobj_Buck, _req[0]);
+            if (_def == NULL) { _rsp[0] = PROTO_STATUS_REJECTED; return(1); }
+            _rsp[1] = (uint8_t)paramobj_Buck.size;
+            _rsp[2] = (uint8_t)_def->type;
+            proto_put_u16(&_rsp[3], (uint16_t)_def->minimum);
+            proto_put_u16(&_rsp[5], (uint16_t)_def->maximum);
+            proto_put_u16(&_rsp[7], *_def->address);
+            _size = 9;
+            for (_i=0; ((_i<PARAM_NAME_MAX) && (_def->name[_i] != 0)); _i++) 
+                _rsp[_size++] = _def->name[_i];
+            break;
+            
+        case PROTO_CMD_PARAM_READ:
+            if ((_length < 1) || (_length > PARAM_READ_MAX)) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // list of parameter IDs
+            for (_i=0; _i<_length; _i++)
+            {
+                fres &= param_read(&paramobj_Buck, _req[_i], &_page[0]);
+                proto_put_u16(&_rsp[1 + (_i << 1)], _page[0]);
+            }
+            _size = (1 + (_length << 1));
+            break;
+            
+        case PROTO_CMD_PARAM_WRITE:
+            if ((_length < 3) || (_length > (3 * PARAM_WRITE_MAX)) || (_length % 3)) 
+                { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // list of parameter IDs (8 bit) and values (16 bit), applied together
+            for (_i=0; _i<(_length / 3); _i++)
+            {
+                _id[_i] = _req[3 * _i];
+                _page[_i] = proto_get_u16(&_req[(3 * _i) + 1]);
+            }
+            fres &= param_write(&paramobj_Buck, (_length / 3), &_id[0], &_page[0]);
+            proto_put_u16(&_rsp[1], paramobj_Buck.applied);
+            _size = 3;
+            break;
+            
+        case PROTO_CMD_PMBUS_WRITE:
+            if ((_length < 1) || (_length > 3)) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // 1st byte: PMBus command code, followed by data bytes (low byte first)
+            fres &= pmbus_write(&pmbusobj_Buck, _req[0], &_req[1], (_length - 1));
+            break;
+            
+        case PROTO_CMD_PMBUS_READ:
+            if (_length != 1) { _rsp[0] = PROTO_STATUS_LENGTH; return(1); }
+            // PMBus command code
+            _size = (1 + pmbus_read(&pmbusobj_Buck, _req[0], &_rsp[1]));
+            fres &= (_size > 1);
+            break;
+            
+        default:
+            _rsp[0] = PROTO_STATUS_UNKNOWN;
+            return(1);
+    }
+    
+    if (!fres)
+    {
+        _rsp[0] = PROTO_STATUS_REJECTED;
+        return(1);
+    }
+    
+    _rsp[0] = PROTO_STATUS_OK;
+    return(_size);
+}
+
+/* @@uart_check
+ * ********************************************************************************
+ * Summary:
+ * Receives request frames and sends response frames
+ * 
+ * Parameters:
+ *  volatile UART_OBJECT_t* uartobj: Pointer to uart object
+ * 
+ * Returns:
+ *  1: success
+ *  0: error
+ * 
+ * Description:
+ * All bytes received since the most recent call are passed to the frame 
+ * receiver. Each valid request frame is executed and answered as soon as the 
+ * longest response fits into the transmit buffer. Otherwise the request is 
+ * kept waiting in the frame receiver and no more bytes are read until the 
+ * next call. Invalid frames are dropped without response, so the host has
+ * to repeat requests which have not been answered within its timeout.
+ * 
+ * Response frames and requests addressed to other modules are ignored. 
+ * Broadcast requests are executed without response. Responses to requests 
+ * addressed to all modules are scheduled (address x UART_SLOT_CALLS) calls 
+ * ahead and further requests are kept waiting until the scheduled response 
+ * has been sent. Completed telemetry blocks are sent after all pending 
+ * requests have been answered, so requests are never delayed by more than 
+ * one stream frame. In polled mode, blocks are only sent on request.
+ * 
+ * ********************************************************************************/
+
+volatile uint16_t uart_check(volatile UART_OBJECT_t* uartobj) {
+    volatile uint8_t ReceivedChar;
+    volatile uint16_t _length=0;
+    volatile uint16_t _address=0;
+    volatile uint16_t _source=0;
+
     // If the uart object is not initialized, exit here with error
     if (uartobj == NULL)
         return(0);
 
     // If FAULT CHECK is disabled, exit here
     if (!uartobj->status.bits.enabled) {
-        uartobj->counter = 0;                       // Clear Counter
+        uartobj->rx_length = 0;                     // Drop waiting request
+        uartobj->tx_delay = 0;                      // Drop scheduled response
         uartobj->status.bits.rx_active = false;     // Clear rx active flag
         uartobj->status.bits.rx_status = false;     // Clear rx status flag
         uartobj->status.bits.tx_active = false;     // Clear tx active flag
@@ -36,172 +440,133 @@ volatile uint16_t uart_check(volatile UART_OBJECT_t* uartobj) {
     if ( (uartobj->data1 == NULL) ||
          (uartobj->data2 == NULL) ||
          (uartobj->data3 == NULL) ||
-         (uartobj->data4 == NULL))
+         (uartobj->data4 == NULL) ||
+         (uartobj->driver == NULL))
         return(0);    
     
-    // If not transmitting, check for receiving
-    if (uartobj->status.bits.tx_active == false) {
-        /* Check for receive errors */
-        if(U1STAbits.FERR == 1)
-        {
-            return(0);
-        }
-        /* Must clear the overrun error to keep UART receiving */
-        if(U1STAbits.OERR == 1)
+    // Send scheduled response when the time slot of this module has been reached
+    if ((uartobj->tx_delay > 0) && (--uartobj->tx_delay == 0))
+    {
+        if (uart_write(uartobj->driver, uartobj->tx_data, uartobj->tx_length))
+            uartobj->tx_frames++;
+    }
+    
+    while (1)
+    {
+        // Collect received bytes until a valid request frame has been completed
+        while ((uartobj->rx_length == 0) && (uart_read(uartobj->driver, &ReceivedChar)))
+            uartobj->rx_length = frame_receive(&uartobj->rx_frame, ReceivedChar);
+        
+        if (uartobj->rx_length == 0) 
+            break; // no more data available
+        
+        // Ignore responses of other modules and requests addressed to other modules
+        _address = uartobj->rx_frame.buffer[FRAME_OFS_ADDRESS];
+        if ((uartobj->rx_frame.buffer[FRAME_OFS_COMMAND] & PROTO_RESPONSE_FLAG) ||
+            ((_address != uartobj->address) && (_address != FRAME_ADDRESS_BROADCAST) && 
+             (_address != FRAME_ADDRESS_ANY)))
         {
-            U1STAbits.OERR = 0;
-            return(1);
+            uartobj->rx_ignored++;
+            uartobj->rx_length = 0;
+            continue;
         }
-        /* Get the data */
-        if(!(U1STAHbits.URXBE == 1))
+        
+        // Keep request waiting while a response is scheduled or until the longest response fits into the transmit buffer
+        if ((uartobj->tx_delay > 0) || (uart_tx_free(uartobj->driver) < UART_RESPONSE_MAX)) 
+            break;
+        
+        // Execute request (broadcast requests are not answered)
+        _source = uartobj->address;
+        _length = uart_execute_request(uartobj);
+        uartobj->rx_length = 0;
+        if (_address == FRAME_ADDRESS_BROADCAST)
+            continue;
+        
+        // Encode response with the request ID of the request and the address of this module
+        _length = frame_encode(uartobj->tx_frame, _source,
+                        uartobj->rx_frame.buffer[FRAME_OFS_REQUEST_ID],
+                        (uartobj->rx_frame.buffer[FRAME_OFS_COMMAND] | PROTO_RESPONSE_FLAG),
+                        _length, uartobj->tx_data);
+        
+        // Requests addressed to all modules are answered in the time slot of this module
+        if (_address == FRAME_ADDRESS_ANY)
         {
-            ReceivedChar = U1RXREG;
-            if (uartobj->status.bits.rx_active == false) { // receiving first character
-                if (ReceivedChar == 'A') { // acquire data
-                    *uartobj->tx_data = (*uartobj->data1 & 0xFF); // low byte
-                    *(uartobj->tx_data + 1) = (*uartobj->data1 >> 8); // high byte
-                    *(uartobj->tx_data + 2) = (*uartobj->data2 & 0xFF); // low byte
-                    *(uartobj->tx_data + 3) = (*uartobj->data2 >> 8);
-                    *(uartobj->tx_data + 4) = (*uartobj->data3 & 0xFF);
-                    *(uartobj->tx_data + 5) = (*uartobj->data3 >> 8);             
-                    *(uartobj->tx_data + 6) = (*uartobj->data4 & 0xFF);
-                    *(uartobj->tx_data + 7) = (*uartobj->data4 >> 8);
-                    *(uartobj->tx_data + 8) = 0;
-                    *(uartobj->tx_data + 9) = 0;
-                    *(uartobj->tx_data + 10) = 0;
-                    *(uartobj->tx_data + 11) = 0;
-                    *(uartobj->tx_data + 12) = 0;
-                    *(uartobj->tx_data + 13) = 0;
-                    *(uartobj->tx_data + 14) = 0;
-                    *(uartobj->tx_data + 15) = 0;
-
-                    // start 1st group transmission 
-                    uartobj->status.bits.tx_active = true;
-                    uartobj->counter = 1;
-
-                    for (_i=0; _i<8; _i++) 
-                    {
-                        U1TXREG = *(uartobj->tx_data + _i);
-                    }
-                }
-                else if (ReceivedChar == 'C') { // send firmware version number
-                    U1TXREG = 'v';
-                    U1TXREG = (FIRMWARE_VER_NUM0 & 0xFF);
-                    U1TXREG = (FIRMWARE_VER_NUM0 >> 8);
-                    U1TXREG = (FIRMWARE_VER_NUM1 & 0xFF);
-                    U1TXREG = (FIRMWARE_VER_NUM1 >> 8);
-                    U1TXREG = (FIRMWARE_VER_NUM2 & 0xFF);
-                    U1TXREG = (FIRMWARE_VER_NUM2 >> 8);
-                    U1TXREG = FIRMWARE_RET_CKSUM;
-                }
-                else if (ReceivedChar == 'K') { // set buck voltage regulation
-                    // start rx sequence by setting rx_active
-                    *uartobj->rx_data = ReceivedChar;
-                    uartobj->status.bits.rx_active = true;
-                    uartobj->counter = 1;                
-                    uartobj->mode = BUCK_VOLTAGE_REG;
-
-                }
-                else if (ReceivedChar == 'T') { // set boost voltage regulation
-                    *uartobj->rx_data = ReceivedChar;
-                    uartobj->status.bits.rx_active = true;
-                    uartobj->counter = 1;                
-                    uartobj->mode = BOOST_VOLTAGE_REG;
-                }
-            }  else  { // rx is active, keep receiving more data
-                *(uartobj->rx_data + uartobj->counter) = ReceivedChar;
-                uartobj->counter++;
-                if (uartobj->counter > 3) { // received total 4 bytes
-                    uartobj->status.bits.rx_active = false;
-                    uartobj->counter = 0;
-                    // calculate checksum
-                    uart_calc_checksum(&uartobj_Buck);
-                    if ( (uartobj->rx_checksum) == *(uartobj->rx_data + 3) ) {
-                        // checksum is correct, decode integer
-                        uartobj->rx_decoded = *(uartobj->rx_data + 1) + (*(uartobj->rx_data + 2) << 8);
-                        // send acknowledgment data
-                        *uartobj->tx_data = *uartobj->rx_data; // low byte
-                        *(uartobj->tx_data + 1) = (uartobj->rx_decoded & 0xFF); // high byte
-                        *(uartobj->tx_data + 2) = (uartobj->rx_decoded >> 8); // high byte
-                        *(uartobj->tx_data + 3) = '0';
-                        *(uartobj->tx_data + 4) = '0';
-                        *(uartobj->tx_data + 5) = 'a';             
-                        *(uartobj->tx_data + 6) = 'c';
-                        *(uartobj->tx_data + 7) = 'k';                    
-                        for (_i=0; _i<8; _i++) 
-                        {
-                            U1TXREG = *(uartobj->tx_data + _i);
-                        }                               
-                        // set converter mode
-                        switch (uartobj->mode) {
-                            case BUCK_VOLTAGE_REG:
-                                // switch over to buck if not already in buck
-                                // update vout reference
-                                // buck.set_values.v_ref = uartobj->rx_decoded;
-                                break;
-                            case BUCK_CURRENT_REG: // future support
-                                // switch over to constant current output mode 
-                                // disable vloop, set i_ref
-                                break;
-                            case BOOST_VOLTAGE_REG:
-                                // switch over to boost if not already in boost
-                                // update vout reference
-                                buck.set_values.v_ref = uartobj->rx_decoded;
-                                break;
-                            case BOOST_CURRENT_REG: // future support
-                                // disable vloop, set i_ref
-                                break;
-                        }
-                    }
-               
-                }
-
-            }
-        }
-    } else { // transmission is active
-        if(U1STAbits.TRMT == 1) { // TX buffer empty, we can write
-            if (uartobj->counter == 1) { // transmit the 2nd group
-                for (_i=8; _i<16; _i++) 
-                {
-                    U1TXREG = *(uartobj->tx_data + _i);
-                }
-                
-                // finish transmission
-                uartobj->status.bits.tx_active = false;
-                uartobj->counter = 0;
-            }
+            uartobj->tx_length = _length;
+            uartobj->tx_delay = (_source * UART_SLOT_CALLS);
+            continue;
         }
+        
+        if (uart_write(uartobj->driver, uartobj->tx_data, _length))
+            uartobj->tx_frames++;
     }
+    
+    // Send completed telemetry blocks as long as they fit into the transmit buffer
+    while ((!uartobj->status.bits.stream_polled) && (uartobj->tx_delay == 0) &&
+           (uart_tx_free(uartobj->driver) >= UART_RESPONSE_MAX))
+    {
+        _length = telem_read_block(&telemobj_Buck, &uartobj->tx_frame[FRAME_OFS_PAYLOAD]);
+        if (_length == 0) 
+            break; // no more data available
+        
+        _length = frame_encode(uartobj->tx_frame, uartobj->address, 0, 
+                        (PROTO_CMD_STREAM_DATA | PROTO_RESPONSE_FLAG), 
+                        _length, uartobj->tx_data);
+        if (uart_write(uartobj->driver, uartobj->tx_data, _length))
+            uartobj->tx_stream++;
+    }
+    
+    // Update receive and transmit status (tx_status may be used to release an RS-485 bus driver)
+    uartobj->status.bits.rx_status = (bool)(uartobj->rx_length > 0);
+    uartobj->status.bits.rx_active = (bool)(uartobj->rx_frame.count > 0);
+    uartobj->status.bits.tx_active = (bool)(uart_tx_pending(uartobj->driver) > 0);
+    uartobj->status.bits.tx_status = (bool)(uart_tx_idle(uartobj->driver));
+    
     return (1);
 }
 
-volatile uint16_t uart_calc_checksum(volatile UART_OBJECT_t* uartobj) {
-    volatile uint16_t _sum = 0;
-    _sum = *(uartobj->rx_data) + *(uartobj->rx_data + 1) + *(uartobj->rx_data + 2);
-    uartobj->rx_checksum = (_sum & 0xFF);
-    return (1);
-}
-
-
 volatile uint16_t appUart_Initialize(void) 
 {
+    volatile uint16_t retval=1;
+    
+    // Initialize uart driver ring buffers
+    retval &= uart_driver_initialize(&uartdrv_Buck);
+    retval &= frame_receiver_initialize(&uartobj_Buck.rx_frame);
+    
     // Initialize buck uart object
+    uartobj_Buck.driver = &uartdrv_Buck;        // Set pointer to driver object
     uartobj_Buck.data1 = &buck.data.v_out;      // Set pointer to variable
     uartobj_Buck.data2 = &buck.data.v_in;       // Set pointer to variable
     uartobj_Buck.data3 = &buck.data.i_sns[0];   // Set pointer to variable
     uartobj_Buck.data4 = &buck.data.i_sns[1];   // Set pointer to variable
     
-    uartobj_Buck.counter = 0;
+    uartobj_Buck.address = settingsobj_Buck.address; // Set module address (loaded from flash by the settings module)
+    uartobj_Buck.rx_length = 0;
+    uartobj_Buck.rx_ignored = 0;
+    uartobj_Buck.tx_delay = 0;
+    uartobj_Buck.tx_length = 0;
+    uartobj_Buck.tx_frames = 0;
+    uartobj_Buck.tx_stream = 0;
     uartobj_Buck.status.bits.rx_active = 0;
     uartobj_Buck.status.bits.tx_active = 0;
+    uartobj_Buck.status.bits.stream_polled = 0;
 
     uartobj_Buck.status.bits.enabled = true;    // Enable uart 
 
-    return(1);
+    // Initialize uart interrupts (transmit interrupt is enabled by the driver when data is queued)
+    _U1RXIP = 1;
+    _U1TXIP = 1;
+    _U1RXIF = 0;
+    _U1TXIF = 0;
+    _U1RXIE = 1;
+
+    return(retval);
 }
 
 volatile uint16_t appUart_Dispose(void) 
 {
+    _U1RXIE = 0;
+    _U1TXIE = 0;
+    uartobj_Buck.status.bits.enabled = false;   // Disable uart 
     
     return(1);
 }
@@ -216,3 +581,47 @@ volatile uint16_t appUart_Execute(void)
  
     return (fres);
 }
+
+/* @@_U1RXInterrupt
+ * ********************************************************************************
+ * Summary:
+ * UART receive interrupt service routine
+ * 
+ * Parameters:
+ *  (none)
+ * 
+ * Returns:
+ *  (none)
+ * 
+ * Description:
+ * Moves all received bytes into the receive ring buffer. The interrupt priority
+ * is below the scheduler and control interrupts.
+ * 
+ * ********************************************************************************/
+
+void __attribute__((__interrupt__, auto_psv))_U1RXInterrupt(void)
+{
+    uart_rx_service(&uartdrv_Buck);
+}
+
+/* @@_U1TXInterrupt
+ * ********************************************************************************
+ * Summary:
+ * UART transmit interrupt service routine
+ * 
+ * Parameters:
+ *  (none)
+ * 
+ * Returns:
+ *  (none)
+ * 
+ * Description:
+ * Refills the transmit FIFO from the transmit ring buffer. The interrupt 
+ * disables itself when the ring buffer has been emptied.
+ * 
+ * ********************************************************************************/
+
+void __attribute__((__interrupt__, auto_psv))_U1TXInterrupt(void)
+{
+    uart_tx_service(&uartdrv_Buck);
+}
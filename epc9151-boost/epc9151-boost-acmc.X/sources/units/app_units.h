@@ -0,0 +1,80 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/*
+ * File:   app_units.h
+ * Author: M91406
+ * Comments: Conversion of feedback values and references between ADC ticks and engineering units
+ * Revision history:
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef APPLICATION_LAYER_UNITS_HEADER_H
+#define	APPLICATION_LAYER_UNITS_HEADER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!UNITS_DATA_t
+ * ***************************************************************************************************
+ * Summary:
+ * Snapshot of converter data in engineering units
+ *
+ * Description:
+ * Voltages are given in [mV], currents in [mA] and temperatures in [0.1 degree C]. Phase currents
+ * and the output current become negative when the converter is operated in reverse direction. 
+ * Values exceeding the 16-bit range are saturated. The temperature reads UNITS_TEMP_INVALID as long as
+ * no temperature sensor is assigned.
+ *
+ * *************************************************************************************************** */
+
+typedef struct {
+    uint16_t v_in;          // Input voltage in [mV]
+    uint16_t v_out;         // Output voltage in [mV]
+    uint16_t v_ref;         // Output voltage reference in [mV]
+    int16_t i_sns[2];       // Phase currents in [mA]
+    int16_t i_out;          // Output current (sum of phase currents) in [mA]
+    int16_t temp;           // Board temperature in [0.1 degree C]
+} UNITS_DATA_t;
+
+#define UNITS_TEMP_INVALID      INT16_MIN   // Temperature value reported without temperature measurement
+
+// Public Function Prototypes
+extern uint16_t units_vin_mv(uint16_t ticks);
+extern uint16_t units_vout_mv(uint16_t ticks);
+extern int16_t units_isns_ma(uint16_t ticks, uint16_t offset);
+extern uint16_t units_vref_ticks(uint16_t millivolts);
+extern volatile uint16_t units_read(UNITS_DATA_t* data);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_UNITS_HEADER_H */
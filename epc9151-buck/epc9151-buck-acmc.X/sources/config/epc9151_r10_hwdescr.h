@@ -83,6 +83,29 @@ extern "C" {
 #define MAIN_EXECUTION_PERIOD   (float)100.0e-6     // main state machine pace period in [sec]
 #define MAIN_EXEC_PER           (uint16_t)((CPU_FREQUENCY * MAIN_EXECUTION_PERIOD)-1)
 
+#define SCHED_TIER_FAST_PERIOD  MAIN_EXECUTION_PERIOD // fast scheduler tier period in [sec] (10 kHz)
+#define SCHED_TIER_MED_PERIOD   (float)1.0e-3       // medium scheduler tier period in [sec] (1 kHz)
+#define SCHED_TIER_SLOW_PERIOD  (float)10.0e-3      // slow scheduler tier period in [sec] (100 Hz)
+#define SCHED_TIER_MED_DIV      (uint16_t)((SCHED_TIER_MED_PERIOD / MAIN_EXECUTION_PERIOD) + 0.5) // number of scheduler ticks per medium tier slot
+#define SCHED_TIER_SLOW_DIV     (uint16_t)((SCHED_TIER_SLOW_PERIOD / MAIN_EXECUTION_PERIOD) + 0.5) // number of scheduler ticks per slow tier slot
+
+#define PROFILER_WINDOW_PERIOD  (float)100.0e-3     // CPU load profiler averaging window in [sec] (max. 65535 control interrupts per window)
+#define PROFILER_WINDOW_TICKS   (uint16_t)((PROFILER_WINDOW_PERIOD / MAIN_EXECUTION_PERIOD) + 0.5) // number of scheduler ticks per averaging window
+#define PROFILER_ISR_INTERVAL   (uint16_t)((CPU_FREQUENCY / SWITCHING_FREQUENCY) + 0.5) // nominal control interrupt interval in Timer1 counts
+
+#define SEQUENCER_TICK_PERIOD   (float)1.0e-3       // setpoint profile sequencer time base in [sec]
+#define SEQUENCER_TICK_SCALER   (uint16_t)((SEQUENCER_TICK_PERIOD / SCHED_TIER_MED_PERIOD) + 0.5) // number of sequencer task calls (medium tier) per sequencer tick
+
+#define UART_BAUDRATE           (float)921600.0     // UART baud rate in [baud] (max. 6.25 Mbaud)
+#define UART_CLOCK_FREQUENCY    CPU_FREQUENCY       // UART baud clock frequency in [Hz] (BCLKSEL = FOSC/2)
+#define UART_BRG                (uint32_t)((UART_CLOCK_FREQUENCY / UART_BAUDRATE) + 0.5) // fractional baud rate generator setting (BCLKMOD = 1, min. 16)
+#define UART_ADDRESS_DEFAULT    0x01                // module address on the shared serial bus used until an address has been stored in flash
+#define UART_SLOT_PERIOD        (float)3.0e-3       // response time slot per module address in [sec] (responses to requests addressed to all modules)
+#define UART_SLOT_CALLS         (uint16_t)((UART_SLOT_PERIOD / SCHED_TIER_MED_PERIOD) + 0.5) // number of uart task calls (medium tier) per response time slot
+
+#define TELEM_SAMPLE_FREQUENCY  (uint32_t)(SWITCHING_FREQUENCY) // telemetry base sample rate (control interrupt frequency) in [Hz]
+#define TELEM_LINK_BYTE_RATE    (uint32_t)(0.9 * UART_BAUDRATE / 10.0) // UART bandwidth available for telemetry in [bytes/sec] (90% of 10 bits per byte)
+
     
 /*!Hardware Abstraction
  * *************************************************************************************************
@@ -149,6 +172,14 @@ extern "C" {
 
 /* CUSTOM RUNTIME OPTIONS */
 #define PLANT_MEASUREMENT   false
+#define CPU_PROFILER_ENABLE true    // Enable built-in CPU load and control interrupt latency profiler
+#define FAST_FAULT_ENABLE   false   // Enable sample-by-sample over current/over voltage checks in the control interrupt (ISR cycle budget not verified yet)
+#define FAULT_LOG_ENABLE    true    // Enable persistent fault event log with pre-fault snapshot
+#define TELEMETRY_ENABLE    true    // Enable continuous telemetry streaming of control cycle data via UART
+#define CAPTURE_ENABLE      false   // Enable triggered capture of control cycle data (oscilloscope mode)
+#define STATS_ENABLE        true    // Enable running statistics (min/max/mean/RMS/ripple) of control cycle data
+#define PARAM_ACCESS_ENABLE true    // Enable online writes of registered control parameters via UART
+#define PMBUS_ENABLE        true    // Enable PMBus write transactions (OPERATION, VOUT_COMMAND)
 
     
 /*!Fundamental PWM Settings
@@ -228,8 +259,6 @@ extern "C" {
 #define BUCK_PWM2_ADTR1OFS              0 // ADC Trigger 1 Offset:  0...31
 #define BUCK_PWM2_ADTR1PS               0 // ADC Trigger 1 Postscaler: 0...31
     
-#define BUCK_PWM_MASTER_SOCS            0b0010  // PWM2 provides Master Trigger
-    
 // ~~~ conversion macros ~~~~~~~~~~~~~~~~~~~~~~~~~
 #define BUCK_SWITCHING_PERIOD      (float)(1.0/SWITCHING_FREQUENCY)   // Switching period in [sec]
 #define BUCK_PWM_PERIOD            (uint16_t)(float)(BUCK_SWITCHING_PERIOD / PWM_CLOCK_PERIOD)
@@ -366,6 +395,11 @@ extern "C" {
 #define BUCK_ISNS_RELEASE           (float) 25.00       // current reset level after over current event
 #define BUCK_ISNS_REFERENCE         (float) 1.000       // output current reference (average) for each phase
 #define BUCK_ISNS_REFERENCE_MAX     (float) 13.25       // output current reference maximum value (average) for each phase
+#define BUCK_ISNS_LOAD_STARTUP      (float) 1.000       // configured load current estimate (average) for each phase at the launch of pre-biased ACMC starts (0 = no pre-charge)
+#define BUCK_ISNS_PHASE_MAXIMUM     (float)(1.100 * BUCK_ISNS_REFERENCE_MAX) // phase over current level (average) for each phase
+#define BUCK_ISNS_PHASE_RELEASE     (float)(0.900 * BUCK_ISNS_REFERENCE_MAX) // phase current reset level after phase over current event
+#define BUCK_ISNS_IMBALANCE_MAXIMUM (float)(0.500 * BUCK_ISNS_REFERENCE_MAX) // phase current imbalance level (average difference between phases)
+#define BUCK_ISNS_IMBALANCE_RELEASE (float)(0.350 * BUCK_ISNS_REFERENCE_MAX) // phase current imbalance reset level
     
 #define BUCK_ISNS1_ADC_TRG_DELAY    (float) 420.0e-9    // ADC trigger delay for current sense in [sec]
 #define BUCK_ISNS2_ADC_TRG_DELAY    (float) 420.0e-9    // ADC trigger delay for current sense in [sec]    
@@ -400,6 +434,11 @@ extern "C" {
 #define BUCK_ISNS_OCL_RELEASE   (uint16_t)((BUCK_ISNS_RELEASE * BUCK_ISNS_FEEDBACK_GAIN + BUCK_ISNS1_FEEDBACK_OFFSET + BUCK_ISNS2_FEEDBACK_OFFSET) / ADC_GRAN)  // Over Current Release Level
 #define BUCK_ISNS_REF           (uint16_t)(BUCK_ISNS_REFERENCE * BUCK_ISNS_FEEDBACK_GAIN / ADC_GRAN)  // Output Current Reference
 #define BUCK_ISNS_REF_MAX       (uint16_t)(BUCK_ISNS_REFERENCE_MAX * BUCK_ISNS_FEEDBACK_GAIN / ADC_GRAN)
+#define BUCK_ISNS_LOAD          (uint16_t)(BUCK_ISNS_LOAD_STARTUP * BUCK_ISNS_FEEDBACK_GAIN / ADC_GRAN)  // Pre-charged current reference at launch
+#define BUCK_ISNS_PHASE_OCL     (uint16_t)(BUCK_ISNS_PHASE_MAXIMUM * BUCK_ISNS_FEEDBACK_GAIN / ADC_GRAN)  // Phase Over Current Limit (deviation from current sense offset)
+#define BUCK_ISNS_PHASE_OCL_RELEASE (uint16_t)(BUCK_ISNS_PHASE_RELEASE * BUCK_ISNS_FEEDBACK_GAIN / ADC_GRAN)  // Phase Over Current Release Level
+#define BUCK_ISNS_IMBAL         (uint16_t)(BUCK_ISNS_IMBALANCE_MAXIMUM * BUCK_ISNS_FEEDBACK_GAIN / ADC_GRAN)  // Phase Current Imbalance Limit
+#define BUCK_ISNS_IMBAL_RELEASE (uint16_t)(BUCK_ISNS_IMBALANCE_RELEASE * BUCK_ISNS_FEEDBACK_GAIN / ADC_GRAN)  // Phase Current Imbalance Release Level
 #define BUCK_ISNS1_OFFFSET      (uint16_t)(BUCK_ISNS1_FEEDBACK_OFFSET / ADC_GRAN)
 #define BUCK_ISNS2_OFFFSET      (uint16_t)(BUCK_ISNS2_FEEDBACK_OFFSET / ADC_GRAN)
 #define BUCK_ISNS1_ADC_TRGDLY   (uint16_t)(BUCK_ISNS1_ADC_TRG_DELAY / PWM_CLOCK_PERIOD)
@@ -412,6 +451,133 @@ extern "C" {
 // ~ conversion macros end ~~~~~~~~~~~~~~~~~
 
     
+/*!Fast Fault Checks
+ * *************************************************************************************************
+ * Summary:
+ * Declaration of trip levels, filter and blanking of the fast fault checks in the control interrupt
+ * 
+ * Description:
+ * The control interrupt compares the raw ADC samples of output voltage and phase currents against
+ * the trip levels declared below in every switching cycle. A fault condition needs to be present 
+ * for BUCK_FFC_FILTER_CYCLES consecutive samples before the PWM outputs are shut down. During 
+ * reference ramps and for BUCK_FFC_BLANKING_PERIOD after a ramp has ended, phase current fault 
+ * events are counted but not latched to tolerate the capacitor charging current. The output over 
+ * voltage check is never blanked, as it is the only output over voltage protection during 
+ * soft-start. Latched fast faults are handed over to the fault handler, which controls the 
+ * recovery.
+ * 
+ * Trip levels are placed above the software fault handler levels.
+ * 
+ * *************************************************************************************************/
+
+#define BUCK_FFC_VOUT_OVER_VOLTAGE  (float)(BUCK_VOUT_NOMINAL + 3.0 * BUCK_VOUT_TOLERANCE_MAX) // Output voltage trip level in [V]
+#define BUCK_FFC_ISNS_PEAK          (float)(1.250 * BUCK_ISNS_MAXIMUM / BUCK_NO_OF_PHASES) // Phase current trip level in [A] (125% of maximum average phase current)
+#define BUCK_FFC_FILTER_CYCLES      2U  // Number of consecutive samples above trip level before shutdown (1...65535)
+#define BUCK_FFC_BLANKING_PERIOD    (float)50.0e-6 // Blanking period of phase current checks after reference ramps in [sec]
+    
+// ~ conversion macros ~~~~~~~~~~~~~~~~~~~~~
+
+#define BUCK_FFC_OVP_ADCBUF     BUCK_VOUT_ADCBUF // ADC buffer monitored by the over voltage check
+#define BUCK_FFC_ISNS_POLARITY  0x0000U // Polarity mask of phase current checks (0x0000 = trip above level, 0xFFFF = trip below level)
+#define BUCK_FFC_OVP            (uint16_t)(BUCK_FFC_VOUT_OVER_VOLTAGE * BUCK_VOUT_FEEDBACK_GAIN / ADC_GRAN) // Output over voltage trip level
+#define BUCK_FFC_OCP1           (uint16_t)((BUCK_ISNS1_FEEDBACK_OFFSET + BUCK_FFC_ISNS_PEAK * BUCK_ISNS_FEEDBACK_GAIN) / ADC_GRAN) // Phase #1 over current trip level
+#define BUCK_FFC_OCP2           (uint16_t)((BUCK_ISNS2_FEEDBACK_OFFSET + BUCK_FFC_ISNS_PEAK * BUCK_ISNS_FEEDBACK_GAIN) / ADC_GRAN) // Phase #2 over current trip level
+#define BUCK_FFC_BLANKING       (uint16_t)(BUCK_FFC_BLANKING_PERIOD * SWITCHING_FREQUENCY) // Blanking period in control interrupt cycles
+    
+// ~ conversion macros end ~~~~~~~~~~~~~~~~~
+
+    
+/*!Fixed-Point Scaling
+ * *************************************************************************************************
+ * Summary:
+ * Conversion of scaling constants into unsigned Q15 factors and bit-shift scalers
+ * 
+ * Description:
+ * Values are converted between ADC ticks and external units (PMBus data formats, engineering 
+ * units) by a single multiply-and-shift operation without division:
+ * 
+ *    value = (ticks * FACTOR) >> SHIFT
+ * 
+ * Unlike the xxx_NORM_SCALER macros (natural logarithm, signed factor), SHIFT is derived from
+ * the binary logarithm of the scaling constant k, so FACTOR always is an unsigned Q15 number in
+ * the range of 0.5...1.0 and the full resolution of the 16-bit factor is used.
+ * 
+ * *************************************************************************************************/
+
+#define SCALE_SHIFT(k)          (uint16_t)(15.0 - ceil(log(k) / log(2.0))) // bit-shift scaler of scaling constant k
+#define SCALE_FACTOR(k)         (uint16_t)(((k) * pow(2.0, SCALE_SHIFT(k))) + 0.5) // Q15 factor of scaling constant k
+
+    
+/*!PMBus Command Interface
+ * *************************************************************************************************
+ * Summary:
+ * Scaling of feedback values into PMBus data formats
+ * 
+ * Description:
+ * Output voltages are reported in Linear16 format with the fixed exponent of VOUT_MODE, all other
+ * values in Linear11 format. ADC values are converted by SCALE_FACTOR/SCALE_SHIFT into fixed-point
+ * numbers with the exponents declared below.
+ * 
+ * *************************************************************************************************/
+
+#define PMBUS_REVISION          0x22    // PMBus revision (Part I and Part II revision 1.2)
+#define PMBUS_VOUT_EXPONENT     (-9)    // Linear16 exponent reported by VOUT_MODE (resolution 1/512 V)
+#define PMBUS_L11_EXPONENT      (-8)    // Exponent of the fixed-point values converted into Linear11 format
+#define PMBUS_VOUT_MAXIMUM      (float)(BUCK_VOUT_NOMINAL + BUCK_VOUT_TOLERANCE_MAX) // Highest output voltage accepted by VOUT_COMMAND in [V]
+
+// ~ conversion macros ~~~~~~~~~~~~~~~~~~~~~
+
+#define PMBUS_VIN_SCALE         (float)(ADC_GRAN / BUCK_VIN_FEEDBACK_GAIN * pow(2.0, -PMBUS_L11_EXPONENT)) // ticks to fixed-point input voltage
+#define PMBUS_VIN_FACTOR        SCALE_FACTOR(PMBUS_VIN_SCALE)
+#define PMBUS_VIN_SHIFT         SCALE_SHIFT(PMBUS_VIN_SCALE)
+#define PMBUS_VOUT_SCALE        (float)(ADC_GRAN / BUCK_VOUT_FEEDBACK_GAIN * pow(2.0, -PMBUS_VOUT_EXPONENT)) // ticks to Linear16 output voltage
+#define PMBUS_VOUT_FACTOR       SCALE_FACTOR(PMBUS_VOUT_SCALE)
+#define PMBUS_VOUT_SHIFT        SCALE_SHIFT(PMBUS_VOUT_SCALE)
+#define PMBUS_VREF_SCALE        (float)(1.0 / PMBUS_VOUT_SCALE) // Linear16 output voltage to ticks
+#define PMBUS_VREF_FACTOR       SCALE_FACTOR(PMBUS_VREF_SCALE)
+#define PMBUS_VREF_SHIFT        SCALE_SHIFT(PMBUS_VREF_SCALE)
+#define PMBUS_IOUT_SCALE        (float)(ADC_GRAN / BUCK_ISNS_FEEDBACK_GAIN * pow(2.0, -PMBUS_L11_EXPONENT)) // ticks to fixed-point output current
+#define PMBUS_IOUT_FACTOR       SCALE_FACTOR(PMBUS_IOUT_SCALE)
+#define PMBUS_IOUT_SHIFT        SCALE_SHIFT(PMBUS_IOUT_SCALE)
+#define PMBUS_VREF_MAX          (uint16_t)(PMBUS_VOUT_MAXIMUM * BUCK_VOUT_FEEDBACK_GAIN / ADC_GRAN) // Highest reference accepted by VOUT_COMMAND
+
+// ~ conversion macros end ~~~~~~~~~~~~~~~~~
+
+/*!Engineering Units
+ * *************************************************************************************************
+ * Summary:
+ * Scaling of feedback values and references into millivolts and milliamps
+ *
+ * Description:
+ * The scaling constants are derived from the inverted feedback gains of the normalization
+ * macros above and include the ADC granularity. ADC ticks and millivolts/milliamps are converted
+ * by SCALE_FACTOR/SCALE_SHIFT in both directions:
+ *
+ *    mV = (ticks * FACTOR) >> SHIFT       ticks = (mV * FACTOR) >> SHIFT
+ *
+ * Phase currents are converted after subtracting the feedback offsets determined by the current
+ * sense calibration.
+ *
+ * *************************************************************************************************/
+
+// ~ conversion macros ~~~~~~~~~~~~~~~~~~~~~
+
+#define UNITS_VIN_SCALE         (float)(1000.0 * ADC_GRAN * BUCK_VIN_NORM_INV_G) // ticks to input voltage in [mV]
+#define UNITS_VIN_FACTOR        SCALE_FACTOR(UNITS_VIN_SCALE)
+#define UNITS_VIN_SHIFT         SCALE_SHIFT(UNITS_VIN_SCALE)
+#define UNITS_VOUT_SCALE        (float)(1000.0 * ADC_GRAN * BUCK_VOUT_NORM_INV_G) // ticks to output voltage in [mV]
+#define UNITS_VOUT_FACTOR       SCALE_FACTOR(UNITS_VOUT_SCALE)
+#define UNITS_VOUT_SHIFT        SCALE_SHIFT(UNITS_VOUT_SCALE)
+#define UNITS_VREF_SCALE        (float)(1.0 / UNITS_VOUT_SCALE) // output voltage in [mV] to ticks
+#define UNITS_VREF_FACTOR       SCALE_FACTOR(UNITS_VREF_SCALE)
+#define UNITS_VREF_SHIFT        SCALE_SHIFT(UNITS_VREF_SCALE)
+#define UNITS_ISNS_SCALE        (float)(1000.0 * ADC_GRAN * BUCK_ISNS_NORM_INV_G) // ticks to phase current in [mA]
+#define UNITS_ISNS_FACTOR       SCALE_FACTOR(UNITS_ISNS_SCALE)
+#define UNITS_ISNS_SHIFT        SCALE_SHIFT(UNITS_ISNS_SCALE)
+#define UNITS_VREF_MAX          PMBUS_VREF_MAX // Highest reference accepted in engineering units (same limit as VOUT_COMMAND)
+
+// ~ conversion macros end ~~~~~~~~~~~~~~~~~
+    
 /*!Adaptive Gain Control Feed Forward
  * *************************************************************************************************
  * Summary:
@@ -472,6 +638,7 @@ extern "C" {
 #define BUCK_VRAMP_PERIOD            (float) 100e-3 // ramp period in [sec]
 #define BUCK_IRAMP_PERIOD            (float) 100e-3 // ramp period in [sec]
 #define BUCK_POWER_GOOD_DELAY        (float) 200e-3 // power good in [sec]
+#define BUCK_VREF_TRAJ_UPDATE_RATE   (float) 100e+3 // reference trajectory update rate in [Hz]
 
 // ~ conversion macros ~~~~~~~~~~~~~~~~~~~~~
 
@@ -481,6 +648,8 @@ extern "C" {
 #define BUCK_IRAMP_PER (uint16_t)(((float)BUCK_IRAMP_PERIOD / (float)MAIN_EXECUTION_PERIOD)-1.0)
 #define BUCK_IREF_STEP (uint16_t)((float)BUCK_ISNS_REF / (float)(BUCK_VRAMP_PER + 1.0))
 #define BUCK_PGD       (uint16_t)(((float)BUCK_POWER_GOOD_DELAY / (float)MAIN_EXECUTION_PERIOD)-1.0)
+#define BUCK_TRAJ_SCALER    (uint16_t)((float)SWITCHING_FREQUENCY / (float)BUCK_VREF_TRAJ_UPDATE_RATE) // control cycles per trajectory update
+#define BUCK_TRAJ_STEPS     (uint16_t)(((float)MAIN_EXECUTION_PERIOD * (float)SWITCHING_FREQUENCY) / (float)BUCK_TRAJ_SCALER) // trajectory updates per state machine call
 
 // ~ conversion macros end ~~~~~~~~~~~~~~~~~
 
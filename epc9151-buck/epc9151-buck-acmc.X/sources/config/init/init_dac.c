@@ -51,11 +51,11 @@ volatile uint16_t init_dac_channel(volatile uint16_t dacInstance) {
     dac->DACxCONL.bits.INSEL = 0b000; // Enable Comparator input A
     dac->DACxCONL.bits.HYSPOL = 0; // Hysteresis is applied to rising edge of comparator output
     dac->DACxCONL.bits.HYSSEL = 0b00; // no hysteresis selected
-    dac->DACxCONL.bits.DACOEN = 1; // Disable DAC output pin
+    dac->DACxCONL.bits.DACOEN = 1; // Enable DAC output pin (DACOUT1 = current sense amplifier reference)
     
     dac->DACxDATH.value = 0x07FF;
     
-    dac_mask = (1 << (dacInstance-1));
+    dac_mask |= (1 << (dacInstance-1));
     
     return (retval);
 }
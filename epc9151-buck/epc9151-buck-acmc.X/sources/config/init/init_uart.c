@@ -8,22 +8,23 @@
 
 #include <xc.h>
 #include "config/init/init_uart.h"
+#include "config/epc9151_r10_hwdescr.h"
 
 volatile uint16_t init_uart(void) {
     
     volatile uint16_t retval=1;
     // Data Bits = 8; Parity = None; Stop Bits = 1 Stop bit sent, 1 checked at RX;
     U1MODE = (0x8080 & ~(1<<15));  // disabling UARTEN bit
-    // STSEL 1 Stop bit sent, 1 checked at RX; BCLKMOD disabled; SLPEN disabled; FLO Off; BCLKSEL FOSC/2; C0EN disabled; RUNOVF disabled; UTXINV disabled; URXINV disabled; HALFDPLX disabled;
-    U1MODEH = 0x00;
+    // STSEL 1 Stop bit sent, 1 checked at RX; BCLKMOD enabled; SLPEN disabled; FLO Off; BCLKSEL FOSC/2; C0EN disabled; RUNOVF disabled; UTXINV disabled; URXINV disabled; HALFDPLX disabled;
+    U1MODEH = 0x0800;
     // OERIE disabled; RXBKIF disabled; RXBKIE disabled; ABDOVF disabled; OERR disabled; TXCIE disabled; TXCIF disabled; FERIE disabled; TXMTIE disabled; ABDOVE disabled; CERIE disabled; CERIF disabled; PERIE disabled;
     U1STA = 0x00;
     // URXISEL RX_ONE_WORD; UTXBE enabled; UTXISEL TX_BUF_EMPTY; URXBE enabled; STPMD disabled; TXWRE disabled;
     U1STAH = 0x7022;
-    // BaudRate = 9600; Frequency = 100000000 Hz; BRG 2603;
-    U1BRG = 0xA2B;
-    // BRG 0;
-    U1BRGH = 0x00;
+    // BaudRate = UART_BAUDRATE; Frequency = 100000000 Hz; BRG = UART_BRG (fractional baud rate generator);
+    U1BRG = (uint16_t)(UART_BRG & 0xFFFF);
+    // BRG <19:16>;
+    U1BRGH = (uint16_t)((UART_BRG >> 16) & 0x000F);
     // P1 0;
     U1P1 = 0x00;
     // P2 0;
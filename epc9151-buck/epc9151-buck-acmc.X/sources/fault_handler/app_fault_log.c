@@ -0,0 +1,391 @@
+/*
+ * File:   app_fault_log.c
+ * Author: M91406
+ *
+ * Created on November 9, 2020, 10:12 AM
+ */
+
+#include <xc.h>
+#include <stddef.h>
+
+#include "app_fault_log.h"
+#include "app_faults.h"
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/app_power_control.h"
+#include "scheduler/app_scheduler.h"
+
+
+// Define persistent fault log object (content survives all resets except power-on reset)
+volatile __attribute__((__persistent__)) FLOG_OBJECT_t flogobj_Buck;
+
+// Define snapshot buffer object
+volatile FLOG_SNAPSHOT_t flogsnap_Buck;
+
+// Snapshot decimation: the snapshot covers at least one fault handler period, so it still contains
+// the fault onset when the fault has been detected by the fault handler (16 x 4 x 2 us = 128 us)
+#define FLOG_SNAPSHOT_DECIMATION (uint16_t)(((MAIN_EXECUTION_PERIOD * SWITCHING_FREQUENCY) / FLOG_SNAPSHOT_SIZE) + 1.0)
+
+// Private variables
+volatile FLOG_CONTEXT_t flog_context; // Converter data captured before fault engine execution
+volatile uint16_t flog_values[FLT_BUCK_COUNT]; // Fault source values captured before fault engine execution
+volatile uint16_t flog_pending=0; // Fault conditions pending for trip during the previous pass
+
+/* @@flog_capture
+ * ********************************************************************************
+ * Summary:
+ * Adds the most recent control cycle samples to the snapshot buffer
+ *
+ * Parameters:
+ *  volatile FLOG_SNAPSHOT_t* snap: Pointer to snapshot buffer object
+ *
+ * Returns:
+ *  (none)
+ *
+ * Description:
+ * This function is called by the control interrupt. Every n-th call 
+ * (decimation) adds one sample of each signal. While the snapshot is 
+ * frozen, samples are not captured.
+ *
+ * ********************************************************************************/
+
+void flog_capture(volatile FLOG_SNAPSHOT_t* snap)
+{
+    uint16_t _i=0, _idx=0;
+
+    if (snap->frozen) return;
+
+    if (++snap->dec_counter < snap->decimation) return;
+    snap->dec_counter = 0;
+
+    _idx = snap->index;
+
+    for (_i=0; _i<FLOG_SIGNALS; _i++)
+    { snap->buffer[_i][_idx] = *snap->source[_i]; }
+
+    snap->index = ((_idx + 1) & (FLOG_SNAPSHOT_SIZE - 1));
+
+    return;
+}
+
+/* @@flog_clear
+ * ********************************************************************************
+ * Summary:
+ * Clears all log entries
+ *
+ * Parameters:
+ *  volatile FLOG_OBJECT_t* flogobj: Pointer to fault log object
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * All entries and counters are reset and the log is marked valid.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t flog_clear(volatile FLOG_OBJECT_t* flogobj)
+{
+    volatile uint16_t _i=0;
+    volatile uint16_t* _ptr;
+
+    if (flogobj == NULL) return(0);
+
+    _ptr = (volatile uint16_t*)&flogobj->entry[0];
+    for (_i=0; _i<((FLOG_DEPTH * sizeof(FLOG_ENTRY_t)) >> 1); _i++)
+    { _ptr[_i] = 0; }
+
+    flogobj->boots = 0;
+    flogobj->head = 0;
+    flogobj->count = 0;
+    flogobj->sequence = 0;
+    flogobj->signature = FLOG_SIGNATURE;
+
+    return(1);
+}
+
+/* @@flog_record
+ * ********************************************************************************
+ * Summary:
+ * Writes one fault event into the log
+ *
+ * Parameters:
+ *  volatile FLOG_OBJECT_t* flogobj: Pointer to fault log object
+ *  volatile FLOG_SNAPSHOT_t* snap: Pointer to snapshot buffer object
+ *  volatile uint16_t id: Fault definition table index
+ *  volatile uint16_t value: Fault source value
+ *  volatile FLOG_CONTEXT_t* context: Pointer to converter data captured at trip
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * The event is written to the head position of the ring buffer, overwriting
+ * the oldest entry when the log is full. Snapshot samples are copied in
+ * chronological order, oldest sample first. The snapshot buffer should be
+ * frozen by the caller while being copied.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t flog_record(volatile FLOG_OBJECT_t* flogobj, volatile FLOG_SNAPSHOT_t* snap,
+                volatile uint16_t id, volatile uint16_t value, volatile FLOG_CONTEXT_t* context)
+{
+    volatile uint16_t _i=0, _k=0, _idx=0;
+    volatile FLOG_ENTRY_t* _entry;
+
+    if ((flogobj == NULL) || (snap == NULL) || (context == NULL)) return(0);
+    if (flogobj->signature != FLOG_SIGNATURE) return(0);
+
+    _entry = &flogobj->entry[flogobj->head];
+
+    _entry->id = id;
+    _entry->sequence = flogobj->sequence++;
+    _entry->boot = flogobj->boots;
+    _entry->timestamp = schedobj_Main.ticks;
+    _entry->value = value;
+    _entry->context.mode = context->mode;
+    _entry->context.status = context->status;
+    _entry->context.v_in = context->v_in;
+    _entry->context.v_out = context->v_out;
+    _entry->context.i_sns[0] = context->i_sns[0];
+    _entry->context.i_sns[1] = context->i_sns[1];
+
+    // Copy snapshot starting at the oldest sample
+    for (_i=0; _i<FLOG_SIGNALS; _i++)
+    {
+        _idx = snap->index;
+        for (_k=0; _k<FLOG_SNAPSHOT_SIZE; _k++)
+        {
+            _entry->snapshot[_i][_k] = snap->buffer[_i][_idx];
+            _idx = ((_idx + 1) & (FLOG_SNAPSHOT_SIZE - 1));
+        }
+    }
+
+    if (++flogobj->head >= FLOG_DEPTH) flogobj->head = 0;
+    if (flogobj->count < FLOG_DEPTH) flogobj->count++;
+
+    return(1);
+}
+
+/* @@flog_read_page
+ * ********************************************************************************
+ * Summary:
+ * Copies one data page of a log entry into a buffer
+ *
+ * Parameters:
+ *  volatile FLOG_OBJECT_t* flogobj: Pointer to fault log object
+ *  volatile uint16_t entry: Entry index (0 = most recent event)
+ *  volatile uint16_t page: Data page index
+ *  volatile uint16_t* buffer: Pointer to buffer of 8 words
+ *
+ * Returns:
+ *  1: success
+ *  0: error (invalid entry or page index)
+ *
+ * Description:
+ * Data pages:
+ *  0: fault ID, sequence number, boot cycle, timestamp (low/high word),
+ *     fault source value, converter state, converter status
+ *  1: input voltage, output voltage, phase #1 current, phase #2 current,
+ *     snapshot size, number of snapshot signals, number of entries, boot cycles
+ *  2...7: snapshot samples (output voltage, phase #1 current, phase #2 current,
+ *     8 samples per page, oldest sample first)
+ *
+ * ********************************************************************************/
+
+volatile uint16_t flog_read_page(volatile FLOG_OBJECT_t* flogobj, volatile uint16_t entry,
+                volatile uint16_t page, volatile uint16_t* buffer)
+{
+    volatile uint16_t _i=0, _pos=0;
+    volatile FLOG_ENTRY_t* _entry;
+    volatile uint16_t* _samples;
+
+    if ((flogobj == NULL) || (buffer == NULL)) return(0);
+    if (flogobj->signature != FLOG_SIGNATURE) return(0);
+    if ((entry >= flogobj->count) || (page >= FLOG_PAGE_COUNT)) return(0);
+
+    // Entries are counted backwards from the most recent event
+    _pos = (flogobj->head + FLOG_DEPTH - 1 - entry);
+    if (_pos >= FLOG_DEPTH) _pos -= FLOG_DEPTH;
+    _entry = &flogobj->entry[_pos];
+
+    if (page == FLOG_PAGE_HEADER)
+    {
+        buffer[0] = _entry->id;
+        buffer[1] = _entry->sequence;
+        buffer[2] = _entry->boot;
+        buffer[3] = (uint16_t)(_entry->timestamp & 0xFFFF);
+        buffer[4] = (uint16_t)(_entry->timestamp >> 16);
+        buffer[5] = _entry->value;
+        buffer[6] = _entry->context.mode;
+        buffer[7] = _entry->context.status;
+    }
+    else if (page == FLOG_PAGE_CONTEXT)
+    {
+        buffer[0] = _entry->context.v_in;
+        buffer[1] = _entry->context.v_out;
+        buffer[2] = _entry->context.i_sns[0];
+        buffer[3] = _entry->context.i_sns[1];
+        buffer[4] = FLOG_SNAPSHOT_SIZE;
+        buffer[5] = FLOG_SIGNALS;
+        buffer[6] = flogobj->count;
+        buffer[7] = flogobj->boots;
+    }
+    else
+    {
+        _samples = &_entry->snapshot[0][0] + ((page - FLOG_PAGE_SNAPSHOT) << 3);
+        for (_i=0; _i<8; _i++)
+        { buffer[_i] = _samples[_i]; }
+    }
+
+    return(1);
+}
+
+/* @@appFaultLog_Initialize
+ * ********************************************************************************
+ * Summary:
+ * Initializes the fault log and snapshot buffer
+ *
+ * Parameters:
+ *  (none)
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * Log content found in persistent RAM is kept when the signature and ring
+ * buffer positions are valid and the boot cycle counter is incremented.
+ * Otherwise (e.g. after a power-on reset) the log is cleared.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t appFaultLog_Initialize(void)
+{
+    volatile uint16_t retval=1;
+    volatile uint16_t _i=0, _k=0;
+
+    if ((flogobj_Buck.signature != FLOG_SIGNATURE) ||
+        (flogobj_Buck.head >= FLOG_DEPTH) || (flogobj_Buck.count > FLOG_DEPTH))
+        retval &= flog_clear(&flogobj_Buck);
+    else
+        flogobj_Buck.boots++;
+
+    // Initialize snapshot buffer
+    flogsnap_Buck.frozen = true;
+    flogsnap_Buck.source[0] = &BUCK_VOUT_ADCBUF;
+    flogsnap_Buck.source[1] = &BUCK_ISNS1_ADCBUF;
+    flogsnap_Buck.source[2] = &BUCK_ISNS2_ADCBUF;
+    flogsnap_Buck.decimation = FLOG_SNAPSHOT_DECIMATION;
+    flogsnap_Buck.dec_counter = 0;
+    flogsnap_Buck.index = 0;
+    for (_i=0; _i<FLOG_SIGNALS; _i++)
+    {
+        for (_k=0; _k<FLOG_SNAPSHOT_SIZE; _k++)
+        { flogsnap_Buck.buffer[_i][_k] = 0; }
+    }
+
+    flog_pending = 0;
+    flogsnap_Buck.frozen = false;
+
+    return(retval);
+}
+
+/* @@appFaultLog_Capture
+ * ********************************************************************************
+ * Summary:
+ * Captures converter data before the fault engine is executed
+ *
+ * Parameters:
+ *  (none)
+ *
+ * Returns:
+ *  1: success
+ *
+ * Description:
+ * Fault responses called by the fault engine change the converter state.
+ * Converter state and data as well as the values of all fault sources are 
+ * therefore captured before the fault engine is executed. The recorded 
+ * trip value is the value the fault engine has evaluated in this pass.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t appFaultLog_Capture(void)
+{
+    volatile uint16_t _i=0;
+
+    for (_i=0; _i<FLT_BUCK_COUNT; _i++)
+    { flog_values[_i] = *fltdef_Buck[_i].source; }
+
+    flog_context.mode = buck.mode;
+    flog_context.status = buck.status.value;
+    flog_context.v_in = buck.data.v_in;
+    flog_context.v_out = buck.data.v_out;
+    flog_context.i_sns[0] = buck.data.i_sns[0];
+    flog_context.i_sns[1] = buck.data.i_sns[1];
+
+    return(1);
+}
+
+/* @@appFaultLog_Execute
+ * ********************************************************************************
+ * Summary:
+ * Records faults tripped during the most recent fault engine pass
+ *
+ * Parameters:
+ *  volatile FLT_ENGINE_t* engine: Pointer to fault engine object
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * This function has to be called right after the fault engine. The snapshot
+ * buffer is frozen when a new fault condition is pending for trip. One log
+ * entry is recorded for every fault tripped during the recent pass, using 
+ * the fault source value and converter data captured by appFaultLog_Capture()
+ * before the fault responses have been called. The
+ * snapshot is released after recording or when no fault condition is
+ * pending anymore. Snapshots frozen by a fast fault check are kept until
+ * the fast fault has been recorded.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t appFaultLog_Execute(volatile FLT_ENGINE_t* engine)
+{
+    volatile uint16_t retval=1;
+    volatile uint16_t _i=0, _bit=1;
+    volatile uint16_t _pending=0, _tripped=0;
+
+    if (engine == NULL) return(0);
+    if (engine->size > FLT_BUCK_COUNT) return(0);
+
+    _pending = (engine->active & ~engine->status);
+    _tripped = engine->tripped;
+
+    // Freeze snapshot at the onset of a new fault condition
+    if (_pending & ~flog_pending)
+        flogsnap_Buck.frozen = true;
+    flog_pending = _pending;
+
+    if (_tripped)
+    {
+        for (_i=0; _i<engine->size; _i++)
+        {
+            if (_tripped & _bit)
+            {
+                retval &= flog_record(&flogobj_Buck, &flogsnap_Buck, _i,
+                            flog_values[_i], &flog_context);
+            }
+            _bit <<= 1;
+        }
+        flogsnap_Buck.frozen = false;
+    }
+    else if ((_pending == 0) && (fltfast_Buck.latched == 0))
+    {
+        flogsnap_Buck.frozen = false;
+    }
+
+    return(retval);
+}
@@ -0,0 +1,139 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software
+ * and any derivatives exclusively with Microchip products.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+ * TERMS.
+ */
+
+/*
+ * File:   app_fault_log.h
+ * Author: M91406
+ * Comments: persistent fault event log application layer API
+ * Revision history:
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef APPLICATION_LAYER_FAULT_LOG_HEADER_H
+#define	APPLICATION_LAYER_FAULT_LOG_HEADER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+#include "fault_handler/drivers/drv_fault_handler.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!FLOG_OBJECT_t
+ * ***************************************************************************************************
+ * Summary:
+ * Persistent fault event log data objects
+ *
+ * Description:
+ * Every fault tripped by the fault engine is recorded in a ring buffer of FLOG_DEPTH entries. Each
+ * entry holds the fault definition index, a timestamp in scheduler ticks, the boot cycle number, 
+ * the value of the fault source, converter state and status word, the most recent samples of input
+ * voltage, output voltage and phase currents and a snapshot of the last FLOG_SNAPSHOT_SIZE control
+ * cycle samples of output voltage and phase currents. When the log is full, the oldest entry is 
+ * overwritten.
+ *
+ * The snapshot buffer is written by the control interrupt. It is frozen when a fault condition is
+ * first detected by the fault engine or when a fast fault check trips inside the interrupt, so the 
+ * snapshot shows the converter response around the fault onset rather than the moment the fault
+ * counter has expired. The snapshot is released when the fault has been recorded or when the
+ * fault condition disappears without trip.
+ *
+ * The log object is located in persistent RAM, which is not initialized by the runtime startup 
+ * code and keeps its content across all resets except power-on resets. A signature word marks 
+ * valid log content. Log entries can be downloaded via UART in data pages of 8 words.
+ *
+ * *************************************************************************************************** */
+
+#define FLOG_DEPTH          4U   // Number of log entries (ring buffer)
+#define FLOG_SNAPSHOT_SIZE  16U  // Number of control cycle samples per snapshot signal (must be a power of 2)
+#define FLOG_SIGNALS        3U   // Number of snapshot signals (output voltage, phase #1 current, phase #2 current)
+#define FLOG_SIGNATURE      0x464CU // Signature word marking valid log content
+
+#define FLOG_PAGE_HEADER    0U   // Data page: event header
+#define FLOG_PAGE_CONTEXT   1U   // Data page: converter data at fault trip
+#define FLOG_PAGE_SNAPSHOT  2U   // Data pages 2...7: snapshot samples (8 samples per page)
+#define FLOG_PAGE_COUNT     (FLOG_PAGE_SNAPSHOT + ((FLOG_SIGNALS * FLOG_SNAPSHOT_SIZE) >> 3)) // Number of data pages per entry
+#define FLOG_CMD_CLEAR      0xFFU // Command: clear log
+
+typedef struct {
+    volatile uint16_t mode;         // Converter state machine state
+    volatile uint16_t status;       // Converter status word
+    volatile uint16_t v_in;         // Input voltage sample
+    volatile uint16_t v_out;        // Output voltage sample
+    volatile uint16_t i_sns[2];     // Phase current samples
+} FLOG_CONTEXT_t; // Converter data captured before fault engine execution
+
+typedef struct {
+    volatile uint16_t id;           // Fault definition table index (FLT_BUCK_xxx)
+    volatile uint16_t sequence;     // Wrapping event sequence number
+    volatile uint16_t boot;         // Boot cycle number at which the event has been recorded
+    volatile uint32_t timestamp;    // Scheduler ticks since boot
+    volatile uint16_t value;        // Fault source value at trip (fast faults: latched fast fault mask)
+    volatile FLOG_CONTEXT_t context; // Converter data at trip
+    volatile uint16_t snapshot[FLOG_SIGNALS][FLOG_SNAPSHOT_SIZE]; // Decimated control cycle samples, oldest first
+} FLOG_ENTRY_t; // Fault event log entry
+
+typedef struct {
+    volatile uint16_t* source[FLOG_SIGNALS]; // Pointers to ADC buffers to be captured
+    volatile uint16_t decimation;   // Number of control cycles per snapshot sample
+    volatile uint16_t dec_counter;  // Control cycle counter
+    volatile uint16_t index;        // Next write position
+    volatile bool frozen;           // Control bit suspending capturing
+    volatile uint16_t buffer[FLOG_SIGNALS][FLOG_SNAPSHOT_SIZE]; // Sample ring buffers
+} FLOG_SNAPSHOT_t; // Pre-fault snapshot ring buffer
+
+typedef struct {
+    volatile uint16_t signature;    // Signature word (FLOG_SIGNATURE = valid log content)
+    volatile uint16_t boots;        // Number of boot cycles since the log has been cleared
+    volatile uint16_t head;         // Position of the next entry to be written
+    volatile uint16_t count;        // Number of valid entries
+    volatile uint16_t sequence;     // Sequence number of the next event
+    volatile FLOG_ENTRY_t entry[FLOG_DEPTH]; // Log entries
+} FLOG_OBJECT_t; // Fault event log
+
+// Public Function Prototypes
+extern void flog_capture(volatile FLOG_SNAPSHOT_t* snap);
+extern volatile uint16_t flog_clear(volatile FLOG_OBJECT_t* flogobj);
+extern volatile uint16_t flog_record(volatile FLOG_OBJECT_t* flogobj, volatile FLOG_SNAPSHOT_t* snap,
+                volatile uint16_t id, volatile uint16_t value, volatile FLOG_CONTEXT_t* context);
+extern volatile uint16_t flog_read_page(volatile FLOG_OBJECT_t* flogobj, volatile uint16_t entry, 
+                volatile uint16_t page, volatile uint16_t* buffer);
+
+// Public Variable Declaration
+extern volatile FLOG_OBJECT_t flogobj_Buck;
+extern volatile FLOG_SNAPSHOT_t flogsnap_Buck;
+
+// PUBLIC FUNCTION PROTOTYPE DECLARATIONS
+extern volatile uint16_t appFaultLog_Initialize(void);
+extern volatile uint16_t appFaultLog_Capture(void);
+extern volatile uint16_t appFaultLog_Execute(volatile FLT_ENGINE_t* engine);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_FAULT_LOG_HEADER_H */
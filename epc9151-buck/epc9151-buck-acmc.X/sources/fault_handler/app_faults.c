@@ -7,112 +7,110 @@
 
 #include <stddef.h>
 
+#include "app_faults.h"
+#include "app_fault_log.h"
 #include "drivers/drv_fault_handler.h"
 #include "config/epc9151_r10_hwdescr.h"
 #include "pwr_control/app_power_control.h"
 
 
-// Define fault objects
-volatile FAULT_OBJECT_t fltobj_BuckUVLO;
-volatile FAULT_OBJECT_t fltobj_BuckOVLO;
-volatile FAULT_OBJECT_t fltobj_BuckRegErr;
-volatile FAULT_OBJECT_t fltobj_BuckOCP;
+// Define fault definition table (sorted by comparison type, index = FLT_BUCK_xxx)
+const FLT_DEFINITION_t fltdef_Buck[FLT_BUCK_COUNT] = {
+    
+    // Input over voltage lock out (leaky bucket filter rejecting bus noise spikes)
+    { .source = &buck.data.v_in, .type = FLTCMP_GREATER_THAN,
+      .trip_level = BUCK_VIN_OVLO_TRIP, .tripcnt_max = 100,
+      .reset_level = BUCK_VIN_OVLO_RELEASE, .rstcnt_max = 1000,
+      .filter = FLTFILTER_LEAKY_BUCKET, .rate_up = 2, .rate_down = 1,
+      .trip_response = &appPowerSupply_Suspend, .reset_response = &appPowerSupply_Resume },
+    
+    // Output over current protection
+    { .source = &buck.data.i_out, .type = FLTCMP_GREATER_THAN,
+      .trip_level = BUCK_ISNS_OCL, .tripcnt_max = 50,
+      .reset_level = BUCK_ISNS_OCL_RELEASE, .rstcnt_max = 2000,
+      .trip_response = &appPowerSupply_Suspend, .reset_response = &appPowerSupply_Resume },
+    
+    // Fast fault check shutdown latched by the control interrupt
+    { .source = &fltfast_Buck.latched, .type = FLTCMP_GREATER_THAN,
+      .trip_level = 0, .tripcnt_max = 1,
+      .reset_level = 1, .rstcnt_max = 2000,
+      .trip_response = &appPowerSupply_Suspend, .reset_response = &appPowerSupply_Resume },
+    
+    // Input under voltage lock out (leaky bucket filter rejecting bus noise spikes)
+    { .source = &buck.data.v_in, .type = FLTCMP_LESS_THAN,
+      .trip_level = BUCK_VIN_UVLO_TRIP, .tripcnt_max = 100,
+      .reset_level = BUCK_VIN_UVLO_RELEASE, .rstcnt_max = 1000,
+      .filter = FLTFILTER_LEAKY_BUCKET, .rate_up = 2, .rate_down = 1,
+      .trip_response = &appPowerSupply_Suspend, .reset_response = &appPowerSupply_Resume },
+    
+    // Output voltage regulation error
+    { .source = &buck.data.v_out, .type = FLTCMP_DEVIATION,
+      .trip_level = BUCK_VOUT_DEV_TRIP, .tripcnt_max = 250,
+      .reset_level = BUCK_VOUT_DEV_RELEASE, .rstcnt_max = 1000,
+      .trip_response = &appPowerSupply_Suspend, .reset_response = &appPowerSupply_Resume },
+    
+    // Phase #1 over current protection (deviation from current sense offset, both current directions)
+    { .source = &buck.data.i_sns[0], .type = FLTCMP_DEVIATION,
+      .trip_level = BUCK_ISNS_PHASE_OCL, .tripcnt_max = 50,
+      .reset_level = BUCK_ISNS_PHASE_OCL_RELEASE, .rstcnt_max = 2000,
+      .trip_response = &appPowerSupply_Suspend, .reset_response = &appPowerSupply_Resume },
+    
+    // Phase #2 over current protection (deviation from current sense offset, both current directions)
+    { .source = &buck.data.i_sns[1], .type = FLTCMP_DEVIATION,
+      .trip_level = BUCK_ISNS_PHASE_OCL, .tripcnt_max = 50,
+      .reset_level = BUCK_ISNS_PHASE_OCL_RELEASE, .rstcnt_max = 2000,
+      .trip_response = &appPowerSupply_Suspend, .reset_response = &appPowerSupply_Resume },
+    
+    // Phase current imbalance (leaky bucket filter tolerating short transients)
+    { .source = &buck.data.i_sns[0], .type = FLTCMP_DEVIATION,
+      .trip_level = BUCK_ISNS_IMBAL, .tripcnt_max = 200,
+      .reset_level = BUCK_ISNS_IMBAL_RELEASE, .rstcnt_max = 4000,
+      .filter = FLTFILTER_LEAKY_BUCKET, .rate_up = 2, .rate_down = 1,
+      .trip_response = &appPowerSupply_Suspend, .reset_response = &appPowerSupply_Resume }
+    
+};
 
+// Define fault engine object
+volatile FLT_ENGINE_t fltengine_Buck;
 
-volatile uint16_t appFaults_Initialize(void) 
-{
-    // Initialize UVLO fault object
-
-    fltobj_BuckUVLO.source_obj = &buck.data.v_in;   // Set pointer to variable to monitor
-    fltobj_BuckUVLO.ref_obj = NULL;      // Clear pointer to "compare against" variable 
-    fltobj_BuckUVLO.bit_mask = 0xFFFF;  // Compare all bits of SOURCE (no bit filter)
-    
-    fltobj_BuckUVLO.status.bits.type = FLTCMP_LESS_THAN; // Select Compare-Type
-    fltobj_BuckUVLO.counter = 0;        // Clear fault event counter
-    fltobj_BuckUVLO.trip_level = BUCK_VIN_UVLO_TRIP;    // Set fault trip level
-    fltobj_BuckUVLO.tripcnt_max = 50;    // Set counter level at which a FAULT condition will be tripped
-    fltobj_BuckUVLO.reset_level = BUCK_VIN_UVLO_RELEASE;   // Set fault reset level
-    fltobj_BuckUVLO.rstcnt_max = 500;     // Set counter level at which a FAULT condition will be cleared
-    
-    // User-function declarations
-    fltobj_BuckUVLO.trip_response = &appPowerSupply_Suspend; // Set pointer to user-function which should be called when a FAULT is tripped
-    fltobj_BuckUVLO.reset_response = &appPowerSupply_Resume; // Set pointer to user-function which should be called when a FAULT is cleared
-    
-    fltobj_BuckOVLO.status.bits.fault_active = true; // Set fault condition flag (must be cleared by fault check)
-    fltobj_BuckOVLO.status.bits.fault_status = true; // Set fault flag (must be cleared by fault check)
-    fltobj_BuckUVLO.status.bits.enabled = true; // Enable fault checks
-
-    
-    // Initialize OVLO fault object
-
-    fltobj_BuckOVLO.source_obj = &buck.data.v_in;   // Set pointer to variable to monitor
-    fltobj_BuckOVLO.ref_obj = NULL;      // Clear pointer to "compare against" variable 
-    fltobj_BuckOVLO.bit_mask = 0xFFFF;  // Compare all bits of SOURCE (no bit filter)
-    
-    fltobj_BuckOVLO.status.bits.type = FLTCMP_GREATER_THAN; // Select Compare-Type
-    fltobj_BuckOVLO.counter = 0;        // Clear fault event counter
-    fltobj_BuckOVLO.trip_level = BUCK_VIN_OVLO_TRIP;    // Set fault trip level
-    fltobj_BuckOVLO.tripcnt_max = 50;    // Set counter level at which a FAULT condition will be tripped
-    fltobj_BuckOVLO.reset_level = BUCK_VIN_OVLO_RELEASE;   // Set fault reset level
-    fltobj_BuckOVLO.rstcnt_max = 500;     // Set counter level at which a FAULT condition will be cleared
-    
-    // User-function declarations
-    fltobj_BuckOVLO.trip_response = &appPowerSupply_Suspend; // Set pointer to user-function which should be called when a FAULT is tripped
-    fltobj_BuckOVLO.reset_response = &appPowerSupply_Resume; // Set pointer to user-function which should be called when a FAULT is cleared
-    
-    fltobj_BuckOVLO.status.bits.fault_active = true; // Set fault condition flag (must be cleared by fault check)
-    fltobj_BuckOVLO.status.bits.fault_status = true; // Set fault flag (must be cleared by fault check)
-    fltobj_BuckOVLO.status.bits.enabled = true; // Enable fault checks
-            
-    // Initialize regulation error fault object
+// Define fast fault check object (executed by the control interrupt)
+volatile FLT_FAST_ENGINE_t fltfast_Buck;
 
-    fltobj_BuckRegErr.source_obj = &buck.data.v_out; // Set pointer to variable to monitor
-    fltobj_BuckRegErr.ref_obj = &buck.set_values.v_ref; // Set pointer to "compare against" variable 
-    fltobj_BuckRegErr.bit_mask = 0xFFFF; // Compare all bits of SOURCE (no bit filter)
-    
-    fltobj_BuckRegErr.status.bits.type = FLTCMP_GREATER_THAN; // Select Compare-Type
-    fltobj_BuckRegErr.counter = 0;        // Clear fault event counter
-    fltobj_BuckRegErr.trip_level = BUCK_VOUT_DEV_TRIP;    // Set fault trip level
-    fltobj_BuckRegErr.tripcnt_max = 250;    // Set counter level at which a FAULT condition will be tripped
-    fltobj_BuckRegErr.reset_level = BUCK_VOUT_DEV_RELEASE;   // Set fault reset level
-    fltobj_BuckRegErr.rstcnt_max = 1000;     // Set counter level at which a FAULT condition will be cleared
-    
-    // User-function declarations
-    fltobj_BuckRegErr.trip_response = &appPowerSupply_Suspend; // Set pointer to user-function which should be called when a FAULT is tripped
-    fltobj_BuckRegErr.reset_response = &appPowerSupply_Resume; // Set pointer to user-function which should be called when a FAULT is cleared
-    
-    fltobj_BuckRegErr.status.bits.fault_active = false; // Set fault condition flag (must be cleared by fault check)
-    fltobj_BuckRegErr.status.bits.fault_status = false; // Set fault flag (must be cleared by fault check)
-    fltobj_BuckRegErr.status.bits.enabled = false; // Disable fault checks at startup
-    
-    // Initialize OCP fault object
 
-    fltobj_BuckOCP.source_obj = &buck.data.i_out;   // Set pointer to variable to monitor
-    fltobj_BuckOCP.ref_obj = NULL;      // Clear pointer to "compare against" variable 
-    fltobj_BuckOCP.bit_mask = 0xFFFF;  // Compare all bits of SOURCE (no bit filter)
-    
-    fltobj_BuckOCP.status.bits.type = FLTCMP_GREATER_THAN; // Select Compare-Type
-    fltobj_BuckOCP.counter = 0;        // Clear fault event counter
-    fltobj_BuckOCP.trip_level = BUCK_ISNS_OCL;    // Set fault trip level
-    fltobj_BuckOCP.tripcnt_max = 50;    // Set counter level at which a FAULT condition will be tripped
-    fltobj_BuckOCP.reset_level = BUCK_ISNS_OCL_RELEASE;   // Set fault reset level
-    fltobj_BuckOCP.rstcnt_max = 2000;     // Set counter level at which a FAULT condition will be cleared
-    
-    // User-function declarations
-    fltobj_BuckOCP.trip_response = &appPowerSupply_Suspend; // Set pointer to user-function which should be called when a FAULT is tripped
-    fltobj_BuckOCP.reset_response = &appPowerSupply_Resume; // Set pointer to user-function which should be called when a FAULT is cleared
-    
-    fltobj_BuckOCP.status.bits.fault_active = true; // Set fault condition flag (must be cleared by fault check)
-    fltobj_BuckOCP.status.bits.fault_status = true; // Set fault flag (must be cleared by fault check)
-    fltobj_BuckOCP.status.bits.enabled = true; // Enable fault checks    
+volatile uint16_t appFaults_Initialize(void) 
+{
+    volatile uint16_t retval=1;
+    
+    // Initialize fault engine: UVLO, OVLO and OCP start tripped and must be cleared by fault checks
+    retval &= flt_engine_initialize(&fltengine_Buck, fltdef_Buck, FLT_BUCK_COUNT, 
+                (FLT_MASK_BUCK_UVLO | FLT_MASK_BUCK_OVLO | FLT_MASK_BUCK_OCP));
+    
+    // Regulation error check is compared against the reference and disabled at startup
+    fltengine_Buck.reference[FLT_BUCK_REGERR] = &buck.set_values.v_ref;
+    retval &= flt_engine_enable(&fltengine_Buck, FLT_BUCK_REGERR, false);
+    
+    // Phase currents are compared against the (calibrated) current sense offsets and each other
+    fltengine_Buck.reference[FLT_BUCK_OCP1] = &buck.i_loop[0].feedback_offset;
+    fltengine_Buck.reference[FLT_BUCK_OCP2] = &buck.i_loop[1].feedback_offset;
+    fltengine_Buck.reference[FLT_BUCK_IMBAL] = &buck.data.i_sns[1];
+    
+    // Declare fast fault checks on raw ADC samples (only over current checks are blanked during reference ramps)
+    retval &= flt_fast_initialize(&fltfast_Buck, BUCK_FFC_FILTER_CYCLES, BUCK_FFC_BLANKING, 
+                (FFC_MASK_BUCK_OCP1 | FFC_MASK_BUCK_OCP2));
+    #if (FAST_FAULT_ENABLE == true)
+    retval &= flt_fast_define(&fltfast_Buck, FFC_BUCK_OVP, &BUCK_FFC_OVP_ADCBUF, BUCK_FFC_OVP, 0x0000);
+    retval &= flt_fast_define(&fltfast_Buck, FFC_BUCK_OCP1, &BUCK_ISNS1_ADCBUF, BUCK_FFC_OCP1, BUCK_FFC_ISNS_POLARITY);
+    retval &= flt_fast_define(&fltfast_Buck, FFC_BUCK_OCP2, &BUCK_ISNS2_ADCBUF, BUCK_FFC_OCP2, BUCK_FFC_ISNS_POLARITY);
+    #endif
 
-    return(1);
+    return(retval);
 }
 
 volatile uint16_t appFaults_Dispose(void) 
 {
-//    fltobj_BuckUVLO = NULL; // Delete Under Voltage Lock Out object
-//    fltobj_BuckOVLO = NULL; // Delete Under Voltage Lock Out object
+    fltengine_Buck.enabled = 0; // Disable all fault checks
+    fltengine_Buck.table = NULL; // Unbind fault definition table
+    fltfast_Buck.size = 0; // Disable all fast fault checks
     
     return(1);
 }
@@ -122,11 +120,16 @@ volatile uint16_t appFaults_Execute(void)
 {
     volatile uint16_t fres=1;
     
-    // Call fault handler
-    fres &= fault_check(&fltobj_BuckUVLO);
-    fres &= fault_check(&fltobj_BuckOVLO);
-    fres &= fault_check(&fltobj_BuckRegErr);
-    fres &= fault_check(&fltobj_BuckOCP);
+    #if (FAULT_LOG_ENABLE == true)
+    fres &= appFaultLog_Capture(); // Capture converter data before fault responses are called
+    #endif
+    
+    // Call fault engine
+    fres &= flt_engine_execute(&fltengine_Buck);
+    
+    #if (FAULT_LOG_ENABLE == true)
+    fres &= appFaultLog_Execute(&fltengine_Buck); // Record tripped faults in persistent fault log
+    #endif
     
     return (fres);
 }
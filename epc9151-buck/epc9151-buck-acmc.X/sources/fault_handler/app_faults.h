@@ -43,11 +43,40 @@
 extern "C" {
 #endif /* __cplusplus */
 
+// Fault definition table indices (= bit positions in fault engine bit masks)
+#define FLT_BUCK_OVLO       0U  // Input over voltage lock out (GREATER_THAN)
+#define FLT_BUCK_OCP        1U  // Output over current protection (GREATER_THAN)
+#define FLT_BUCK_FASTTRIP   2U  // Fast fault check shutdown (GREATER_THAN)
+#define FLT_BUCK_UVLO       3U  // Input under voltage lock out (LESS_THAN)
+#define FLT_BUCK_REGERR     4U  // Output voltage regulation error (DEVIATION)
+#define FLT_BUCK_OCP1       5U  // Phase #1 over current protection (DEVIATION)
+#define FLT_BUCK_OCP2       6U  // Phase #2 over current protection (DEVIATION)
+#define FLT_BUCK_IMBAL      7U  // Phase current imbalance (DEVIATION)
+#define FLT_BUCK_COUNT      8U  // Number of fault definitions
+
+#define FLT_MASK_BUCK_OVLO      (1U << FLT_BUCK_OVLO)
+#define FLT_MASK_BUCK_OCP       (1U << FLT_BUCK_OCP)
+#define FLT_MASK_BUCK_FASTTRIP  (1U << FLT_BUCK_FASTTRIP)
+#define FLT_MASK_BUCK_UVLO      (1U << FLT_BUCK_UVLO)
+#define FLT_MASK_BUCK_REGERR    (1U << FLT_BUCK_REGERR)
+#define FLT_MASK_BUCK_OCP1      (1U << FLT_BUCK_OCP1)
+#define FLT_MASK_BUCK_OCP2      (1U << FLT_BUCK_OCP2)
+#define FLT_MASK_BUCK_IMBAL     (1U << FLT_BUCK_IMBAL)
+
+// Fast fault check indices (= bit positions in fast fault bit masks)
+#define FFC_BUCK_OVP        0U  // Output over voltage
+#define FFC_BUCK_OCP1       1U  // Phase #1 over current
+#define FFC_BUCK_OCP2       2U  // Phase #2 over current
+#define FFC_BUCK_COUNT      3U  // Number of fast fault checks
+
+#define FFC_MASK_BUCK_OVP   (1U << FFC_BUCK_OVP)
+#define FFC_MASK_BUCK_OCP1  (1U << FFC_BUCK_OCP1)
+#define FFC_MASK_BUCK_OCP2  (1U << FFC_BUCK_OCP2)
+
 // Public Variable Declaration
-extern volatile FAULT_OBJECT_t fltobj_BuckUVLO;
-extern volatile FAULT_OBJECT_t fltobj_BuckOVLO;
-extern volatile FAULT_OBJECT_t fltobj_BuckRegErr;
-extern volatile FAULT_OBJECT_t fltobj_BuckOCP;
+extern const FLT_DEFINITION_t fltdef_Buck[FLT_BUCK_COUNT];
+extern volatile FLT_ENGINE_t fltengine_Buck;
+extern volatile FLT_FAST_ENGINE_t fltfast_Buck;
 
 // PUBLIC FUNCTION PROTOTYPE DECLARATIONS
 extern volatile uint16_t appFaults_Initialize(void);
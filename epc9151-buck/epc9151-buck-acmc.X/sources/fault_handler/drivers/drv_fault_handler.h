@@ -47,7 +47,8 @@ typedef enum {
 	FLTCMP_IS_EQUAL			= 3, // Check for condition: SOURCE = trip level
 	FLTCMP_IS_NOT_EQUAL		= 4, // Check for condition: SOURCE != trip level
 	FLTCMP_BETWEEN			= 5, // Check for condition: (reset_level < SOURCE) && (SOURCE < trip_level)
-	FLTCMP_OUTSIDE			= 6  // Check for condition: (SOURCE < reset_level) || (trip_level < SOURCE)
+	FLTCMP_OUTSIDE			= 6, // Check for condition: (SOURCE < reset_level) || (trip_level < SOURCE)
+	FLTCMP_DEVIATION		= 7  // Check for condition: |SOURCE - REFERENCE| > trip level (fault engine only)
 } FLT_COMPARE_TYPE_e;
 
 typedef union{
@@ -80,8 +81,131 @@ typedef struct {
 } FAULT_OBJECT_t;
 
 
+/*!FLT_ENGINE_t
+ * ***************************************************************************************************
+ * Summary:
+ * Batched fault engine data objects
+ * 
+ * Description:
+ * The fault engine evaluates all fault definitions of a constant fault definition table in one
+ * pass. The table has to be sorted by comparison type (GREATER_THAN, LESS_THAN, DEVIATION), so
+ * each group is evaluated by its own loop without decision on the comparison type. The position
+ * of a fault definition in the table is the bit position of this fault in all fault bit masks 
+ * of the engine. Fault event counters are only updated for faults whose immediate fault condition
+ * differs from the tripped fault status. User-defined responses are only called when the fault 
+ * status changes. Thus the CPU load of a pass without fault events mainly depends on the number
+ * of comparisons.
+ * 
+ * Trip and reset levels are copied from the table into the engine object at initialization and
+ * evaluated from there, so they can be tuned at runtime while the table remains constant.
+ * 
+ * Each fault definition selects a fault event filter. The default consecutive count filter
+ * toggles the fault status after TRIPCNT_MAX/RSTCNT_MAX consecutive passes with pending fault 
+ * status and restarts with every pass without. Integrating filters keep their state across 
+ * passes without pending fault status and are updated in every pass:
+ * 
+ *  - Leaky bucket: the counter is incremented by RATE_UP in passes with and decremented by 
+ *    RATE_DOWN in passes without pending fault status. The fault status is toggled when the
+ *    counter reaches TRIPCNT_MAX/RSTCNT_MAX. Intermittent faults trip when they are present 
+ *    for more than RATE_DOWN/(RATE_UP+RATE_DOWN) of the time, single spikes only reduce the
+ *    counter instead of restarting it.
+ *  - N-of-M: the last WINDOW passes (M = 1...16) are kept in a bit history. The fault status
+ *    is toggled when TRIPCNT_MAX/RSTCNT_MAX (N) of them had pending fault status.
+ * 
+ * *************************************************************************************************** */
+
+#define FLT_ENGINE_SIZE_MAX     16U // Maximum number of fault definitions per engine (= width of fault bit masks)
+#define FLT_ENGINE_GROUPS       3U  // Number of comparison type groups (GREATER_THAN, LESS_THAN, DEVIATION)
+#define FLT_FILTER_WINDOW_MAX   16U // Maximum window length of N-of-M filters (= width of history bit mask)
+
+typedef enum {
+    FLTFILTER_CONSECUTIVE   = 0, // Consecutive count: counter restarts with every pass without pending fault status
+    FLTFILTER_LEAKY_BUCKET  = 1, // Leaky bucket: counter is incremented by RATE_UP and decremented by RATE_DOWN
+    FLTFILTER_N_OF_M        = 2  // N-of-M: status toggles when N of the last M passes had pending fault status
+} FLT_FILTER_MODE_e;
+
+typedef struct {
+    volatile uint16_t* source;      // Pointer to variable or SFR to be monitored
+    uint16_t trip_level;            // Signal level at which the fault condition will be detected
+    uint16_t reset_level;           // Signal level at which the fault condition will be cleared
+    uint16_t tripcnt_max;           // Counter value at/above which the fault condition will be tripped
+    uint16_t rstcnt_max;            // Counter value at/above which the fault condition will be cleared
+    volatile uint16_t (*trip_response)(void); // pointer to a user function called when the fault trips (NULL = none)
+    volatile uint16_t (*reset_response)(void); // pointer to a user function called when the fault is cleared (NULL = none)
+    FLT_COMPARE_TYPE_e type;        // Comparison type (GREATER_THAN, LESS_THAN or DEVIATION)
+    FLT_FILTER_MODE_e filter;       // Fault event filter mode (default: consecutive count)
+    uint16_t rate_up;               // Leaky bucket: counter increment per pass with pending fault status (0 = 1)
+    uint16_t rate_down;             // Leaky bucket: counter decrement per pass without pending fault status (0 = 1)
+    uint16_t window;                // N-of-M: number of passes M in filter window (1...16)
+} __attribute__((packed)) FLT_DEFINITION_t; // Constant fault definition
+
+typedef struct {
+    const FLT_DEFINITION_t* table;  // Pointer to fault definition table sorted by comparison type
+    volatile uint16_t size;         // Number of fault definitions
+    volatile uint16_t group_end[FLT_ENGINE_GROUPS]; // Table index following the last definition of each comparison type group
+    volatile uint16_t enabled;      // Bit mask of enabled fault checks
+    volatile uint16_t active;       // Bit mask of immediate fault conditions (fault detected but not necessarily tripped)
+    volatile uint16_t status;       // Bit mask of tripped faults
+    volatile uint16_t counting;     // Bit mask of running fault event counters
+    volatile uint16_t filtered;     // Bit mask of faults using integrating fault event filters
+    volatile uint16_t tripped;      // Bit mask of faults tripped during the most recent pass
+    volatile uint16_t cleared;      // Bit mask of faults cleared during the most recent pass
+    volatile uint16_t* reference[FLT_ENGINE_SIZE_MAX]; // Pointers to reference values of DEVIATION checks
+    volatile uint16_t trip_level[FLT_ENGINE_SIZE_MAX]; // Trip levels (initialized from the fault definition table)
+    volatile uint16_t reset_level[FLT_ENGINE_SIZE_MAX]; // Reset levels (initialized from the fault definition table)
+    volatile uint16_t counter[FLT_ENGINE_SIZE_MAX]; // Fault event counters (N-of-M filters: pass history)
+} FLT_ENGINE_t; // Fault engine runtime object
+
+
+/*!FLT_FAST_ENGINE_t
+ * ***************************************************************************************************
+ * Summary:
+ * Fast fault check data object
+ * 
+ * Description:
+ * Fast fault checks are executed by the control interrupt in every switching cycle and compare raw
+ * ADC samples against precomputed trip levels. Each fault condition is converted into a bit mask
+ * which is used to update a consecutive-sample counter, so the evaluation of a check takes the same
+ * number of instruction cycles with and without fault condition. A fault is latched when its counter
+ * reaches the filter count. Blanking only suppresses latching of the checks selected by the blanking
+ * mask, all other checks remain active. Latched faults remain set until they are cleared by the 
+ * application.
+ * 
+ * Checks tripping below their trip level are declared by polarity mask 0xFFFF. Sample and trip
+ * level are then inverted before the comparison, which reverses the unsigned comparison result.
+ * 
+ * *************************************************************************************************** */
+
+#define FLT_FAST_SIZE_MAX       4U  // Maximum number of fast fault checks per object
+
+typedef struct {
+    volatile uint16_t size;         // Number of declared fast fault checks
+    volatile uint16_t filter;       // Number of consecutive samples with fault condition required to latch a fault
+    volatile uint16_t blanking;     // Number of control cycles fault latching is suppressed after blanking request has been released
+    volatile uint16_t blank_counter; // Remaining blanking cycles
+    volatile uint16_t blank_mask;   // Bit mask of checks suppressed during blanking
+    volatile uint16_t active;       // Bit mask of immediate fault conditions of the most recent sample
+    volatile uint16_t latched;      // Bit mask of latched fast faults
+    volatile uint16_t* source[FLT_FAST_SIZE_MAX]; // Pointers to ADC buffers to be monitored
+    volatile uint16_t level[FLT_FAST_SIZE_MAX];   // Trip levels (already XOR-ed with polarity mask)
+    volatile uint16_t polarity[FLT_FAST_SIZE_MAX]; // Polarity masks (0x0000 = trip above level, 0xFFFF = trip below level)
+    volatile uint16_t counter[FLT_FAST_SIZE_MAX]; // Consecutive fault condition sample counters
+} FLT_FAST_ENGINE_t; // Fast fault check runtime object
+
 // Public Function Prototypes
 extern volatile uint16_t fault_check(volatile FAULT_OBJECT_t* fltobj);
+
+extern volatile uint16_t flt_engine_initialize(volatile FLT_ENGINE_t* engine, 
+                const FLT_DEFINITION_t* table, volatile uint16_t size, volatile uint16_t init_status);
+extern volatile uint16_t flt_engine_enable(volatile FLT_ENGINE_t* engine, volatile uint16_t index, volatile bool enable);
+extern volatile uint16_t flt_engine_execute(volatile FLT_ENGINE_t* engine);
+
+extern volatile uint16_t flt_fast_initialize(volatile FLT_FAST_ENGINE_t* engine, 
+                volatile uint16_t filter, volatile uint16_t blanking, volatile uint16_t blank_mask);
+extern volatile uint16_t flt_fast_define(volatile FLT_FAST_ENGINE_t* engine, volatile uint16_t index,
+                volatile uint16_t* source, volatile uint16_t level, volatile uint16_t polarity);
+extern volatile uint16_t flt_fast_clear(volatile FLT_FAST_ENGINE_t* engine, volatile uint16_t mask);
+extern uint16_t flt_fast_execute(volatile FLT_FAST_ENGINE_t* engine, bool blank);
     
 #ifdef	__cplusplus
 }
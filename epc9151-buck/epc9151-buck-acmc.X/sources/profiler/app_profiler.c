@@ -0,0 +1,476 @@
+/*
+ * File:   app_profiler.c
+ * Author: M91406
+ *
+ * Created on October 22, 2020, 3:48 PM
+ */
+
+#include <xc.h>
+#include <stddef.h>
+
+#include "app_profiler.h"
+#include "config/epc9151_r10_hwdescr.h"
+
+
+// Define profiler object
+volatile PROF_OBJECT_t profobj_Main;
+
+/* PRIVATE FUNCTION PROTOTYPES */
+static inline void prof_statistics_add(volatile PROF_STATISTICS_t* stat, uint16_t value, uint16_t shift);
+void prof_statistics_reset(volatile PROF_STATISTICS_t* stat);
+volatile uint16_t prof_utilisation(volatile uint32_t time, volatile uint16_t ticks, volatile uint16_t period);
+
+/* @@prof_isr_entry
+ * ********************************************************************************
+ * Summary:
+ * Captures the entry of the control interrupt
+ *
+ * Parameters:
+ *  volatile PROF_OBJECT_t* profobj: Pointer to profiler object
+ *
+ * Returns:
+ *  (none)
+ *
+ * Description:
+ * This function has to be called first thing in the control interrupt service
+ * routine. The reconstructed trigger grid is advanced by one nominal interrupt
+ * interval and the delay of the interrupt entry behind the grid is added to the
+ * latency statistics. When the interrupt entry is ahead of the grid, the grid
+ * is re-anchored to the recent entry. Grid points passed without interrupt entry
+ * are counted as missed trigger events.
+ *
+ * ********************************************************************************/
+
+void prof_isr_entry(volatile PROF_OBJECT_t* profobj)
+{
+    uint16_t _now=0, _exp=0;
+    int16_t _lat=0;
+
+    _now = TMR1;
+    profobj->isr_entry = _now;
+
+    if (!profobj->status.bits.enabled)
+        return;
+
+    // The first interrupt anchors the trigger grid
+    if (!profobj->status.bits.anchored)
+    {
+        profobj->isr_expected = _now;
+        profobj->status.bits.anchored = true;
+        return;
+    }
+
+    // Advance trigger grid by one nominal interrupt interval
+    _exp = profobj->isr_expected + profobj->interval;
+    if (_exp >= profobj->period) _exp -= profobj->period;
+
+    // Calculate delay of interrupt entry behind trigger grid considering Timer1 roll-over
+    _lat = (int16_t)(_now - _exp);
+    if (_lat < -(int16_t)(profobj->period >> 1)) _lat += profobj->period;
+    else if (_lat > (int16_t)(profobj->period >> 1)) _lat -= profobj->period;
+
+    if (_lat < 0)
+    {   // Interrupt entry ahead of the trigger grid: re-anchor grid
+        _exp = _now;
+        _lat = 0;
+    }
+
+    while ((uint16_t)_lat >= profobj->interval)
+    {   // Trigger grid points passed without interrupt entry
+        _exp += profobj->interval;
+        if (_exp >= profobj->period) _exp -= profobj->period;
+        _lat -= profobj->interval;
+        profobj->isr_missed++;
+    }
+
+    profobj->isr_expected = _exp;
+
+    prof_statistics_add(&profobj->latency, (uint16_t)_lat, PROF_HIST_LAT_SHIFT);
+
+    return;
+}
+
+/* @@prof_isr_exit
+ * ********************************************************************************
+ * Summary:
+ * Captures the exit of the control interrupt
+ *
+ * Parameters:
+ *  volatile PROF_OBJECT_t* profobj: Pointer to profiler object
+ *
+ * Returns:
+ *  (none)
+ *
+ * Description:
+ * This function has to be called last thing in the control interrupt service
+ * routine. The time since the most recent interrupt entry is added to the
+ * duration statistics.
+ *
+ * ********************************************************************************/
+
+void prof_isr_exit(volatile PROF_OBJECT_t* profobj)
+{
+    uint16_t _now=0, _dur=0;
+
+    _now = TMR1;
+
+    if (!profobj->status.bits.enabled)
+        return;
+
+    if (_now >= profobj->isr_entry) // Consider Timer1 roll-over
+        _dur = (_now - profobj->isr_entry);
+    else
+        _dur = (profobj->period - profobj->isr_entry) + _now;
+
+    prof_statistics_add(&profobj->duration, _dur, PROF_HIST_DUR_SHIFT);
+    profobj->isr_count++;
+
+    return;
+}
+
+/* @@prof_update
+ * ********************************************************************************
+ * Summary:
+ * Updates the averaging window of the profiler
+ *
+ * Parameters:
+ *  volatile PROF_OBJECT_t* profobj: Pointer to profiler object
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * This function is called by the scheduler every scheduler tick. Interrupt time,
+ * latency sum and number of interrupts since the most recent tick are added to
+ * the active averaging window. At the end of each window, mean values and CPU
+ * utilisation of the control interrupt and the scheduler tiers are calculated.
+ * The window length is limited by the number of interrupts per window, which
+ * has to stay below 65536.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t prof_update(volatile PROF_OBJECT_t* profobj)
+{
+    volatile uint16_t _i=0, _t=0;
+    volatile uint16_t _value=0, _load=0;
+    volatile bool _saturated=false;
+    volatile PROF_WINDOW_t* _win;
+
+    if (profobj == NULL) return(0);
+    if (!profobj->status.bits.enabled) return(1);
+
+    _win = &profobj->window;
+
+    // Add interrupt statistics of the recent tick to the window
+    _value = profobj->duration.sum;
+    _win->isr_time += (uint16_t)(_value - _win->isr_time_prev);
+    _win->isr_time_prev = _value;
+
+    _value = profobj->latency.sum;
+    _win->lat_time += (uint16_t)(_value - _win->lat_time_prev);
+    _win->lat_time_prev = _value;
+
+    _value = profobj->isr_count;
+    _win->isr_count += (uint16_t)(_value - _win->isr_count_prev);
+    _win->isr_count_prev = _value;
+
+    if (++_win->ticks < PROFILER_WINDOW_TICKS)
+        return(1);
+
+    // Averaging window complete: calculate mean values
+    if (_win->isr_count > 0)
+    {
+        profobj->duration.mean = __builtin_divud(_win->isr_time, _win->isr_count);
+        profobj->latency.mean = __builtin_divud(_win->lat_time, _win->isr_count);
+    }
+
+    // Calculate CPU utilisation
+    profobj->load.isr = prof_utilisation(_win->isr_time, _win->ticks, profobj->period);
+    _load = profobj->load.isr;
+
+    if (profobj->scheduler != NULL)
+    {
+        for (_t=0; _t<SCHED_TIER_COUNT; _t++)
+        {
+            profobj->load.tier[_t] = prof_utilisation(profobj->scheduler->tier[_t].busy, _win->ticks, profobj->period);
+            profobj->scheduler->tier[_t].busy = 0;
+            _load += profobj->load.tier[_t];
+        }
+    }
+
+    profobj->load.cpu = _load;
+    if (_load > profobj->load.cpu_max)
+        profobj->load.cpu_max = _load;
+
+    // Scale down histograms before the bins saturate
+    for (_i=0; _i<PROF_HIST_BINS; _i++)
+    {
+        if ((profobj->duration.hist[_i] & 0xF0000000) || (profobj->latency.hist[_i] & 0xF0000000))
+            _saturated = true;
+    }
+    if (_saturated)
+    {
+        for (_i=0; _i<PROF_HIST_BINS; _i++)
+        {
+            profobj->duration.hist[_i] >>= 1;
+            profobj->latency.hist[_i] >>= 1;
+        }
+    }
+
+    // Start next averaging window
+    _win->ticks = 0;
+    _win->isr_time = 0;
+    _win->lat_time = 0;
+    _win->isr_count = 0;
+
+    profobj->windows++;
+    profobj->status.bits.valid = true;
+
+    return(1);
+}
+
+/* @@prof_reset
+ * ********************************************************************************
+ * Summary:
+ * Resets min/max values, histograms and counters of the profiler
+ *
+ * Parameters:
+ *  volatile PROF_OBJECT_t* profobj: Pointer to profiler object
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * The trigger grid is re-anchored by the next control interrupt. Mean values
+ * and utilisation values are updated with the next completed window.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t prof_reset(volatile PROF_OBJECT_t* profobj)
+{
+    if (profobj == NULL) return(0);
+
+    prof_statistics_reset(&profobj->duration);
+    prof_statistics_reset(&profobj->latency);
+
+    profobj->isr_missed = 0;
+    profobj->load.cpu_max = 0;
+    profobj->status.bits.anchored = false;
+
+    return(1);
+}
+
+/* @@prof_read_page
+ * ********************************************************************************
+ * Summary:
+ * Copies one data page of profiler results into a buffer
+ *
+ * Parameters:
+ *  volatile PROF_OBJECT_t* profobj: Pointer to profiler object
+ *  volatile uint16_t page: Data page index
+ *  volatile uint16_t* buffer: Pointer to buffer of 8 words
+ *
+ * Returns:
+ *  1: success
+ *  0: error (invalid page index)
+ *
+ * Description:
+ * Data pages:
+ *  0: ISR duration min/max/mean, ISR latency min/max/mean, missed triggers, windows
+ *  1: CPU utilisation total/max/ISR/fast tier/medium tier/slow tier, scheduler overruns, status
+ *  2...5: ISR duration histogram bins (4 bins of 32 bit per page, low word first)
+ *  6...9: ISR latency histogram bins (4 bins of 32 bit per page, low word first)
+ *
+ * ********************************************************************************/
+
+volatile uint16_t prof_read_page(volatile PROF_OBJECT_t* profobj, volatile uint16_t page, volatile uint16_t* buffer)
+{
+    volatile uint16_t _i=0, _t=0, _bin=0;
+    volatile PROF_STATISTICS_t* _stat;
+
+    if ((profobj == NULL) || (buffer == NULL)) return(0);
+    if (page >= PROF_PAGE_COUNT) return(0);
+
+    if (page == PROF_PAGE_SUMMARY)
+    {
+        buffer[0] = profobj->duration.minimum;
+        buffer[1] = profobj->duration.maximum;
+        buffer[2] = profobj->duration.mean;
+        buffer[3] = profobj->latency.minimum;
+        buffer[4] = profobj->latency.maximum;
+        buffer[5] = profobj->latency.mean;
+        buffer[6] = profobj->isr_missed;
+        buffer[7] = profobj->windows;
+    }
+    else if (page == PROF_PAGE_LOAD)
+    {
+        buffer[0] = profobj->load.cpu;
+        buffer[1] = profobj->load.cpu_max;
+        buffer[2] = profobj->load.isr;
+        buffer[3] = profobj->load.tier[SCHED_TIER_FAST];
+        buffer[4] = profobj->load.tier[SCHED_TIER_MEDIUM];
+        buffer[5] = profobj->load.tier[SCHED_TIER_SLOW];
+        buffer[6] = 0;
+        if (profobj->scheduler != NULL)
+        {
+            for (_t=0; _t<SCHED_TIER_COUNT; _t++)
+                buffer[6] += profobj->scheduler->tier[_t].overruns;
+        }
+        buffer[7] = profobj->status.value;
+    }
+    else
+    {
+        if (page < PROF_PAGE_HIST_LAT)
+        {
+            _stat = &profobj->duration;
+            _bin = ((page - PROF_PAGE_HIST_DUR) << 2);
+        }
+        else
+        {
+            _stat = &profobj->latency;
+            _bin = ((page - PROF_PAGE_HIST_LAT) << 2);
+        }
+
+        for (_i=0; _i<4; _i++)
+        {
+            buffer[(_i << 1)] = (uint16_t)(_stat->hist[_bin + _i] & 0xFFFF);
+            buffer[(_i << 1) + 1] = (uint16_t)(_stat->hist[_bin + _i] >> 16);
+        }
+    }
+
+    return(1);
+}
+
+/* @@prof_statistics_add
+ * ********************************************************************************
+ * Summary:
+ * Adds a value to min/max values, wrapping sum and histogram
+ *
+ * Parameters:
+ *  volatile PROF_STATISTICS_t* stat: Pointer to statistics object
+ *  uint16_t value: Measured time in Timer1 counts
+ *  uint16_t shift: Histogram bin width = 2^shift Timer1 counts
+ *
+ * Returns:
+ *  (none)
+ *
+ * Description:
+ * Called from the control interrupt. Values beyond the last histogram bin are
+ * collected in the last bin.
+ *
+ * ********************************************************************************/
+
+static inline void prof_statistics_add(volatile PROF_STATISTICS_t* stat, uint16_t value, uint16_t shift)
+{
+    uint16_t _bin=0;
+
+    if (value < stat->minimum) stat->minimum = value;
+    if (value > stat->maximum) stat->maximum = value;
+    stat->sum += value;
+
+    _bin = (value >> shift);
+    if (_bin >= PROF_HIST_BINS) _bin = (PROF_HIST_BINS - 1);
+    stat->hist[_bin]++;
+
+    return;
+}
+
+void prof_statistics_reset(volatile PROF_STATISTICS_t* stat)
+{
+    volatile uint16_t _i=0;
+
+    stat->minimum = 0xFFFF;
+    stat->maximum = 0;
+
+    for (_i=0; _i<PROF_HIST_BINS; _i++)
+        stat->hist[_i] = 0;
+
+    return;
+}
+
+/* @@prof_utilisation
+ * ********************************************************************************
+ * Summary:
+ * Calculates the CPU utilisation of a time accumulated over an averaging window
+ *
+ * Parameters:
+ *  volatile uint32_t time: Accumulated time in Timer1 counts
+ *  volatile uint16_t ticks: Number of scheduler ticks of the window
+ *  volatile uint16_t period: Scheduler tick period in Timer1 counts
+ *
+ * Returns:
+ *  CPU utilisation in 0.01 %
+ *
+ * Description:
+ * The accumulated time is first averaged per scheduler tick and then related
+ * to the scheduler tick period.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t prof_utilisation(volatile uint32_t time, volatile uint16_t ticks, volatile uint16_t period)
+{
+    volatile uint16_t _per_tick=0;
+
+    if ((ticks == 0) || (period == 0)) return(0);
+
+    if ((time >> 16) >= ticks) return(10000); // Result beyond 16 bit
+
+    _per_tick = __builtin_divud(time, ticks); // Average Timer1 counts per scheduler tick
+    if (_per_tick >= period) return(10000);
+
+    return(__builtin_divud(__builtin_muluu(_per_tick, 10000), period));
+}
+
+
+volatile uint16_t appProfiler_Initialize(void)
+{
+    // Initialize profiler object
+    profobj_Main.status.value = 0;
+    profobj_Main.period = (MAIN_EXEC_PER + 1);
+    profobj_Main.interval = PROFILER_ISR_INTERVAL;
+    profobj_Main.isr_entry = 0;
+    profobj_Main.isr_expected = 0;
+    profobj_Main.isr_count = 0;
+    profobj_Main.duration.sum = 0;
+    profobj_Main.duration.mean = 0;
+    profobj_Main.latency.sum = 0;
+    profobj_Main.latency.mean = 0;
+    profobj_Main.load.cpu = 0;
+    profobj_Main.load.isr = 0;
+    profobj_Main.windows = 0;
+    profobj_Main.scheduler = &schedobj_Main;
+
+    prof_reset(&profobj_Main);
+
+    // Reset averaging window
+    profobj_Main.window.ticks = 0;
+    profobj_Main.window.isr_time = 0;
+    profobj_Main.window.lat_time = 0;
+    profobj_Main.window.isr_count = 0;
+    profobj_Main.window.isr_time_prev = 0;
+    profobj_Main.window.lat_time_prev = 0;
+    profobj_Main.window.isr_count_prev = 0;
+
+    #if (CPU_PROFILER_ENABLE == true)
+    profobj_Main.status.bits.enabled = true; // Enable profiler
+    #endif
+
+    return(1);
+}
+
+volatile uint16_t appProfiler_Execute(void)
+{
+    return(prof_update(&profobj_Main));
+}
+
+volatile uint16_t appProfiler_Dispose(void)
+{
+    profobj_Main.status.value = 0;
+    profobj_Main.scheduler = NULL;
+
+    return(1);
+}
+
+// END OF FILE
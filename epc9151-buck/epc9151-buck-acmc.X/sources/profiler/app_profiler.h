@@ -0,0 +1,156 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software
+ * and any derivatives exclusively with Microchip products.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+ * TERMS.
+ */
+
+/*
+ * File:   app_profiler.h
+ * Author: M91406
+ * Comments: CPU load and control interrupt latency profiler application layer API
+ * Revision history:
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef APPLICATION_LAYER_PROFILER_HEADER_H
+#define	APPLICATION_LAYER_PROFILER_HEADER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+#include "scheduler/app_scheduler.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!PROF_OBJECT_t
+ * ***************************************************************************************************
+ * Summary:
+ * CPU load and control interrupt latency profiler data object
+ *
+ * Description:
+ * Timer1 (scheduler time base, 1 count = 1 CPU cycle) is sampled at entry and exit of the control
+ * interrupt. The interrupt captures duration and latency of every call in min/max values and
+ * histograms. Timer1 counts spent in the interrupt are accumulated in a wrapping 16-bit sum
+ * (duration.sum), which is read by the profiler task every scheduler tick and by the scheduler at
+ * task boundaries to separate interrupt time from task execution time.
+ *
+ * The PWM time base cannot be read back. The trigger instant of the control interrupt is therefore
+ * reconstructed from a grid of nominal interrupt intervals (PROFILER_ISR_INTERVAL) anchored to the
+ * earliest observed interrupt entry. The latency is the delay of the interrupt entry behind this
+ * grid, i.e. the latency on top of the constant ADC conversion and interrupt vectoring delay.
+ * Trigger events without interrupt entry are counted as missed.
+ *
+ * Mean values and CPU utilisation are calculated over averaging windows of PROFILER_WINDOW_PERIOD.
+ * Utilisation values are given in 0.01 % of the CPU time. Tier utilisation values exclude the
+ * time spent in the control interrupt while tasks of the tier have been executed.
+ *
+ * *************************************************************************************************** */
+
+#define PROF_HIST_BINS      16U  // Number of histogram bins (last bin collects all values beyond)
+#define PROF_HIST_DUR_SHIFT 4U   // Duration histogram bin width = 2^n Timer1 counts (16 = 160 ns)
+#define PROF_HIST_LAT_SHIFT 3U   // Latency histogram bin width = 2^n Timer1 counts (8 = 80 ns)
+
+#define PROF_PAGE_SUMMARY   0U   // Data page: interrupt duration and latency
+#define PROF_PAGE_LOAD      1U   // Data page: CPU utilisation
+#define PROF_PAGE_HIST_DUR  2U   // Data pages 2...5: interrupt duration histogram (4 bins per page)
+#define PROF_PAGE_HIST_LAT  6U   // Data pages 6...9: interrupt latency histogram (4 bins per page)
+#define PROF_PAGE_COUNT     10U  // Number of data pages
+#define PROF_PAGE_RESET     0xFFU // Command: reset statistics
+
+typedef union{
+
+	struct {
+		volatile bool anchored : 1;     // Bit 0: Flag bit indicating that the trigger grid has been anchored
+		volatile bool valid : 1;        // Bit 1: Flag bit indicating that at least one averaging window has been completed
+		volatile unsigned : 6;			// Bit <7:2>: (reserved)
+		volatile unsigned : 7;			// Bit <14:8> (reserved)
+		volatile bool enabled : 1;      // Bit 15: Control bit enabling/disabling the profiler
+	} __attribute__((packed)) bits; // Profiler object status bit field for single bit access
+
+	volatile uint16_t value;		// Profiler object status word
+
+} PROF_OBJECT_STATUS_t;	// Profiler object status
+
+typedef struct {
+    volatile uint16_t minimum;      // Minimum value in Timer1 counts
+    volatile uint16_t maximum;      // Maximum value in Timer1 counts
+    volatile uint16_t mean;         // Mean value of the most recent averaging window in Timer1 counts
+    volatile uint16_t sum;          // Wrapping sum of all values in Timer1 counts
+    volatile uint32_t hist[PROF_HIST_BINS]; // Histogram
+} PROF_STATISTICS_t;  // Statistics of a measured time
+
+typedef struct {
+    volatile uint16_t ticks;        // Number of scheduler ticks of the active window
+    volatile uint32_t isr_time;     // Interrupt time of the active window in Timer1 counts
+    volatile uint32_t lat_time;     // Sum of interrupt latencies of the active window in Timer1 counts
+    volatile uint16_t isr_count;    // Number of interrupts of the active window
+    volatile uint16_t isr_time_prev; // Interrupt time counter at the most recent tick
+    volatile uint16_t lat_time_prev; // Latency sum counter at the most recent tick
+    volatile uint16_t isr_count_prev; // Interrupt counter at the most recent tick
+} PROF_WINDOW_t;  // Averaging window
+
+typedef struct {
+    volatile uint16_t cpu;          // Total CPU utilisation (control interrupt and all tiers)
+    volatile uint16_t cpu_max;      // Maximum total CPU utilisation
+    volatile uint16_t isr;          // CPU utilisation of the control interrupt
+    volatile uint16_t tier[SCHED_TIER_COUNT]; // CPU utilisation of the scheduler tiers
+} PROF_LOAD_t;  // CPU utilisation in 0.01 %
+
+typedef struct {
+	volatile PROF_OBJECT_STATUS_t status; // Status word of the profiler object
+    volatile uint16_t period;       // Timer1 period in Timer1 counts
+    volatile uint16_t interval;     // Nominal control interrupt interval in Timer1 counts
+    volatile uint16_t isr_entry;    // Timer1 count at the most recent interrupt entry
+    volatile uint16_t isr_expected; // Timer1 count of the most recent reconstructed trigger instant
+    volatile uint16_t isr_count;    // Wrapping number of control interrupt calls
+    volatile uint16_t isr_missed;   // Number of trigger events without interrupt entry
+    volatile PROF_STATISTICS_t duration; // Control interrupt duration statistics
+    volatile PROF_STATISTICS_t latency;  // Control interrupt latency statistics
+    volatile PROF_LOAD_t load;      // CPU utilisation of the most recent averaging window
+    volatile PROF_WINDOW_t window;  // Active averaging window
+    volatile uint16_t windows;      // Number of completed averaging windows
+    volatile SCHED_OBJECT_t* scheduler; // Pointer to the profiled scheduler object
+} PROF_OBJECT_t;
+
+// Public Function Prototypes
+extern void prof_isr_entry(volatile PROF_OBJECT_t* profobj);
+extern void prof_isr_exit(volatile PROF_OBJECT_t* profobj);
+extern volatile uint16_t prof_update(volatile PROF_OBJECT_t* profobj);
+extern volatile uint16_t prof_reset(volatile PROF_OBJECT_t* profobj);
+extern volatile uint16_t prof_read_page(volatile PROF_OBJECT_t* profobj, volatile uint16_t page, volatile uint16_t* buffer);
+
+// Public Variable Declaration
+extern volatile PROF_OBJECT_t profobj_Main;
+
+// PUBLIC FUNCTION PROTOTYPE DECLARATIONS
+extern volatile uint16_t appProfiler_Initialize(void);
+extern volatile uint16_t appProfiler_Execute(void);
+extern volatile uint16_t appProfiler_Dispose(void);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_PROFILER_HEADER_H */
+
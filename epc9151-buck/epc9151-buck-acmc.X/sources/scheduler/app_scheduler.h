@@ -0,0 +1,143 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software
+ * and any derivatives exclusively with Microchip products.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+ * TERMS.
+ */
+
+/*
+ * File:   app_scheduler.h
+ * Author: M91406
+ * Comments: multi-tier cooperative task scheduler application layer API
+ * Revision history:
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef APPLICATION_LAYER_SCHEDULER_HEADER_H
+#define	APPLICATION_LAYER_SCHEDULER_HEADER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!SCHED_OBJECT_t
+ * ***************************************************************************************************
+ * Summary:
+ * Multi-tier cooperative task scheduler data objects
+ *
+ * Description:
+ * The scheduler is driven by Timer1, which overruns every MAIN_EXECUTION_PERIOD (scheduler tick).
+ * The Timer1 interrupt counts the Timer1 periods in the scheduler time base. Between scheduler
+ * ticks the CPU is put into Idle mode and woken up by the next interrupt.
+ * Tasks are assigned to one of three tiers (fast = every tick, medium and slow = every n-th tick).
+ * Each task is executed every <period> slots of its tier, in the scheduler tick <offset> within
+ * the tier slot. Offsets are used to spread tasks of slower tiers across different scheduler ticks.
+ *
+ * All due tasks have to complete within the scheduler tick they have been started in. The
+ * execution time of each task is captured in Timer1 counts (TMR1). When the time base has been
+ * advanced after a task has been executed, the task and its tier have missed their slot and an
+ * overrun is counted. Scheduler ticks passed without execution are counted as lost ticks.
+ *
+ * *************************************************************************************************** */
+
+#define SCHED_TASKS_MAX     8U   // Maximum number of tasks
+
+typedef enum {
+    SCHED_TIER_FAST = 0,    // Fast tier: executed every scheduler tick
+    SCHED_TIER_MEDIUM = 1,  // Medium tier: executed every SCHED_TIER_MED_DIV scheduler ticks
+    SCHED_TIER_SLOW = 2     // Slow tier: executed every SCHED_TIER_SLOW_DIV scheduler ticks
+} SCHED_TIER_e;  // Scheduler tiers in order of priority
+
+#define SCHED_TIER_COUNT    3U   // Number of scheduler tiers
+
+typedef union{
+
+	struct {
+		volatile bool overrun : 1;      // Bit 0: Flag bit indicating that at least one tier has missed its slot (cleared by user)
+		volatile bool task_error : 1;   // Bit 1: Flag bit indicating that at least one task has returned an error (cleared by user)
+		volatile unsigned : 6;			// Bit <7:2>: (reserved)
+		volatile unsigned : 7;			// Bit <14:8> (reserved)
+		volatile bool enabled : 1;      // Bit 15: Control bit enabling/disabling the scheduler
+	} __attribute__((packed)) bits; // Scheduler object status bit field for single bit access
+
+	volatile uint16_t value;		// Scheduler object status word
+
+} SCHED_OBJECT_STATUS_t;	// Scheduler object status
+
+typedef struct {
+    volatile uint16_t (*execute)(void); // Pointer to task function
+    volatile SCHED_TIER_e tier;     // Scheduler tier this task is assigned to
+    volatile uint16_t period;       // Execution period in slots of the assigned tier
+    volatile uint16_t offset;       // Scheduler tick within the tier slot this task is executed in
+    volatile uint16_t counter;      // Tier slot counter
+    volatile uint16_t exec_time;    // Most recent execution time in Timer1 counts
+    volatile uint16_t exec_time_max; // Maximum execution time in Timer1 counts
+    volatile uint16_t overruns;     // Number of missed scheduler ticks caused by this task
+    volatile uint16_t errors;       // Number of error returns of this task
+} SCHED_TASK_t;  // Scheduler task
+
+typedef struct {
+    volatile uint16_t divider;      // Number of scheduler ticks per tier slot
+    volatile uint16_t tick;         // Scheduler tick within the active tier slot
+    volatile uint16_t load;         // Timer1 counts consumed by this tier during the most recent scheduler tick
+    volatile uint16_t load_max;     // Maximum Timer1 counts consumed by this tier during one scheduler tick
+    volatile uint16_t overruns;     // Number of missed slots of this tier
+    volatile uint32_t busy;         // Accumulated task execution time excluding interrupt time in Timer1 counts (cleared by user)
+} SCHED_TIER_t;  // Scheduler tier
+
+typedef struct {
+	volatile SCHED_OBJECT_STATUS_t status; // Status word of the scheduler object
+    volatile uint32_t ticks;        // Number of executed scheduler ticks
+    volatile uint16_t timebase;     // Number of Timer1 periods (incremented by Timer1 interrupt)
+    volatile uint16_t tick_id;      // Time base value of the active scheduler tick
+    volatile uint16_t ticks_lost;   // Number of scheduler ticks passed without execution
+    volatile uint16_t period;       // Scheduler tick period in Timer1 counts
+    volatile uint16_t count;        // Number of registered tasks
+    volatile uint16_t* ptrIsrTime;  // Pointer to wrapping sum of interrupt time in Timer1 counts (optional)
+    volatile SCHED_TIER_t tier[SCHED_TIER_COUNT]; // Scheduler tiers
+    volatile SCHED_TASK_t task[SCHED_TASKS_MAX];  // Task list in order of priority
+} SCHED_OBJECT_t;
+
+// Public Function Prototypes
+extern volatile uint16_t sched_add_task(volatile SCHED_OBJECT_t* schedobj, volatile uint16_t (*task)(void),
+                volatile SCHED_TIER_e tier, volatile uint16_t period, volatile uint16_t offset);
+extern volatile uint16_t sched_wait(volatile SCHED_OBJECT_t* schedobj);
+extern volatile uint16_t sched_execute(volatile SCHED_OBJECT_t* schedobj);
+
+// Public Variable Declaration
+extern volatile SCHED_OBJECT_t schedobj_Main;
+
+// PUBLIC FUNCTION PROTOTYPE DECLARATIONS
+extern volatile uint16_t appScheduler_Initialize(void);
+extern volatile uint16_t appScheduler_Wait(void);
+extern volatile uint16_t appScheduler_Execute(void);
+extern volatile uint16_t appScheduler_Dispose(void);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_SCHEDULER_HEADER_H */
+
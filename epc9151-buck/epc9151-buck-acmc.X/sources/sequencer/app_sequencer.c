@@ -0,0 +1,313 @@
+/*
+ * File:   app_sequencer.c
+ * Author: M91406
+ *
+ * Created on October 19, 2020, 2:05 PM
+ */
+
+#include <stddef.h>
+
+#include "app_sequencer.h"
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/app_power_control.h"
+
+
+// Define sequencer object
+volatile SEQ_OBJECT_t seqobj_Buck;
+
+/* PRIVATE FUNCTION PROTOTYPES */
+void seq_apply_point(volatile SEQ_OBJECT_t* seqobj);
+void seq_release_limit(void);
+
+/* @@seq_load_point
+ * ********************************************************************************
+ * Summary:
+ * Writes one setpoint into the profile table
+ * 
+ * Parameters:
+ *  volatile SEQ_OBJECT_t* seqobj: Pointer to sequencer object
+ *  volatile uint16_t index: Table index of the setpoint
+ *  volatile uint16_t time: Dwell time in sequencer ticks
+ *  volatile uint16_t v_ref: Output voltage reference
+ *  volatile uint16_t i_limit: Output current limit (0 = no change)
+ * 
+ * Returns:
+ *  1: success
+ *  0: error (invalid index or profile is running)
+ * 
+ * Description:
+ * Setpoints can only be loaded while the profile is not being executed.
+ * 
+ * ********************************************************************************/
+
+volatile uint16_t seq_load_point(volatile SEQ_OBJECT_t* seqobj, volatile uint16_t index, 
+                volatile uint16_t time, volatile uint16_t v_ref, volatile uint16_t i_limit)
+{
+    if (seqobj == NULL) return(0);
+    if ((index >= SEQ_POINTS_MAX) || (seqobj->status.bits.running)) return(0);
+    
+    seqobj->point[index].time = time;
+    seqobj->point[index].v_ref = v_ref;
+    seqobj->point[index].i_limit = i_limit;
+    
+    return(1);
+}
+
+/* @@seq_start
+ * ********************************************************************************
+ * Summary:
+ * Starts execution of the uploaded profile
+ * 
+ * Parameters:
+ *  volatile SEQ_OBJECT_t* seqobj: Pointer to sequencer object
+ *  volatile uint16_t count: Number of setpoints to be executed
+ *  volatile bool loop: Profile will be repeated until stopped when set
+ * 
+ * Returns:
+ *  1: success
+ *  0: error
+ * 
+ * Description:
+ * The first setpoint is applied as soon as the power converter is online.
+ * 
+ * ********************************************************************************/
+
+volatile uint16_t seq_start(volatile SEQ_OBJECT_t* seqobj, volatile uint16_t count, volatile bool loop)
+{
+    if (seqobj == NULL) return(0);
+    if ((count == 0) || (count > SEQ_POINTS_MAX) || (!seqobj->status.bits.enabled)) return(0);
+    
+    seqobj->status.bits.running = false;   // Hold sequencer while parameters are changed
+    
+    seqobj->count = count;
+    seqobj->index = 0;
+    seqobj->counter = 0;
+    seqobj->prescaler_counter = 0;
+    seqobj->loops = 0;
+    
+    seqobj->status.bits.loop = loop;
+    seqobj->status.bits.complete = false;
+    seqobj->status.bits.aborted = false;
+    seqobj->status.bits.applied = false;
+    seqobj->status.bits.running = true;    // Start profile execution
+    
+    return(1);
+}
+
+/* @@seq_stop
+ * ********************************************************************************
+ * Summary:
+ * Stops execution of the profile
+ * 
+ * Parameters:
+ *  volatile SEQ_OBJECT_t* seqobj: Pointer to sequencer object
+ * 
+ * Returns:
+ *  1: success
+ *  0: error
+ * 
+ * Description:
+ * The most recent voltage reference is kept, the current limit is released.
+ * 
+ * ********************************************************************************/
+
+volatile uint16_t seq_stop(volatile SEQ_OBJECT_t* seqobj)
+{
+    if (seqobj == NULL) return(0);
+    
+    if (seqobj->status.bits.running)
+        seq_release_limit();
+    
+    seqobj->status.bits.running = false;
+    seqobj->status.bits.applied = false;
+    
+    return(1);
+}
+
+/* @@seq_check
+ * ********************************************************************************
+ * Summary:
+ * Executes the profile sequencer
+ * 
+ * Parameters:
+ *  volatile SEQ_OBJECT_t* seqobj: Pointer to sequencer object
+ * 
+ * Returns:
+ *  1: success
+ *  0: error
+ * 
+ * Description:
+ * This function is called by the scheduler at a fixed rate. Setpoints are only
+ * applied while the power converter is online. When the converter drops out of
+ * ONLINE state while a profile is executed (e.g. due to a fault condition), the 
+ * profile is aborted.
+ * 
+ * ********************************************************************************/
+
+volatile uint16_t seq_check(volatile SEQ_OBJECT_t* seqobj)
+{
+    // If the sequencer object is not initialized, exit here with error
+    if (seqobj == NULL)
+        return(0);
+    
+    // If sequencer is disabled or idle, exit here
+    if ((!seqobj->status.bits.enabled) || (!seqobj->status.bits.running))
+        return(1);
+    
+    // Setpoints are only applied while the converter is in regulation
+    if (buck.mode != BUCK_STATE_ONLINE)
+    {
+        if (seqobj->status.bits.applied)
+        {   // Converter has left regulation during profile execution
+            seqobj->status.bits.running = false;
+            seqobj->status.bits.applied = false;
+            seqobj->status.bits.aborted = true;
+        }
+        return(1);
+    }
+    
+    // Apply active setpoint
+    if (!seqobj->status.bits.applied)
+    {
+        seq_apply_point(seqobj);
+        seqobj->status.bits.applied = true;
+        seqobj->counter = 0;
+        seqobj->prescaler_counter = 0;
+    }
+    
+    // Divide scheduler calls down to sequencer ticks
+    if (++seqobj->prescaler_counter < seqobj->prescaler)
+        return(1);
+    seqobj->prescaler_counter = 0;
+    
+    // Check if dwell time of active setpoint has expired
+    if (++seqobj->counter < seqobj->point[seqobj->index].time)
+        return(1);
+    
+    // Step to next setpoint
+    seqobj->status.bits.applied = false;
+    
+    if (++seqobj->index >= seqobj->count)
+    {
+        seqobj->index = 0;
+        seqobj->loops++;
+        
+        if (!seqobj->status.bits.loop)
+        {   // Profile complete: keep last voltage reference, release current limit
+            seq_release_limit();
+            seqobj->status.bits.running = false;
+            seqobj->status.bits.complete = true;
+        }
+    }
+    
+    return(1);
+}
+
+/* @@seq_apply_point
+ * ********************************************************************************
+ * Summary:
+ * Applies the active setpoint to the power controller
+ * 
+ * Parameters:
+ *  volatile SEQ_OBJECT_t* seqobj: Pointer to sequencer object
+ * 
+ * Returns:
+ *  (none)
+ * 
+ * Description:
+ * The voltage reference is handed to the power controller as user reference.
+ * The state machine will tune into the new level. The current limit is clamped 
+ * to the maximum current reference of the voltage loop output.
+ * 
+ * ********************************************************************************/
+
+void seq_apply_point(volatile SEQ_OBJECT_t* seqobj)
+{
+    volatile SEQ_POINT_t* _pt;
+    
+    _pt = &seqobj->point[seqobj->index];
+    
+    buck.set_values.v_ref = _pt->v_ref; // Set new user reference
+    
+    if (_pt->i_limit == 0) // No current limit change requested
+        return;
+    
+    if (_pt->i_limit < buck.v_loop.maximum)
+        buck.v_loop.controller->Limits.MaxOutput = _pt->i_limit;
+    else
+        buck.v_loop.controller->Limits.MaxOutput = buck.v_loop.maximum;
+    
+    return;
+}
+
+/* @@seq_release_limit
+ * ********************************************************************************
+ * Summary:
+ * Restores the nominal current limit of the voltage loop
+ * 
+ * Parameters:
+ *  (none)
+ * 
+ * Returns:
+ *  (none)
+ * 
+ * Description:
+ * The current limit is only restored while the converter is online. In all 
+ * other states the limit is under control of the power controller state machine.
+ * 
+ * ********************************************************************************/
+
+void seq_release_limit(void)
+{
+    if (buck.mode == BUCK_STATE_ONLINE)
+        buck.v_loop.controller->Limits.MaxOutput = buck.v_loop.maximum;
+    
+    return;
+}
+
+
+volatile uint16_t appSequencer_Initialize(void) 
+{
+    volatile uint16_t _i=0;
+    
+    // Initialize buck sequencer object
+    seqobj_Buck.status.value = 0;
+    seqobj_Buck.count = 0;
+    seqobj_Buck.index = 0;
+    seqobj_Buck.counter = 0;
+    seqobj_Buck.loops = 0;
+    seqobj_Buck.prescaler = SEQUENCER_TICK_SCALER;
+    seqobj_Buck.prescaler_counter = 0;
+    
+    for (_i=0; _i<SEQ_POINTS_MAX; _i++) // Clear profile table
+    {
+        seqobj_Buck.point[_i].time = 0;
+        seqobj_Buck.point[_i].v_ref = 0;
+        seqobj_Buck.point[_i].i_limit = 0;
+    }
+    
+    seqobj_Buck.status.bits.enabled = true;    // Enable sequencer
+
+    return(1);
+}
+
+volatile uint16_t appSequencer_Dispose(void) 
+{
+    volatile uint16_t fres=1;
+    
+    fres &= seq_stop(&seqobj_Buck);
+    seqobj_Buck.status.bits.enabled = false;   // Disable sequencer
+    
+    return(fres);
+}
+
+
+volatile uint16_t appSequencer_Execute(void) 
+{
+    volatile uint16_t fres=1;
+    
+    // Call sequencer
+    fres &= seq_check(&seqobj_Buck);
+ 
+    return (fres);
+}
@@ -0,0 +1,103 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/*
+ * File:   app_settings.h
+ * Author: M91406
+ * Comments: non-volatile settings application layer API
+ * Revision history:
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef APPLICATION_LAYER_SETTINGS_HEADER_H
+#define	APPLICATION_LAYER_SETTINGS_HEADER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+#include "settings/drivers/drv_nvm.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!SETTINGS_OBJECT_t
+ * ***************************************************************************************************
+ * Summary:
+ * Non-volatile settings data object
+ *
+ * Description:
+ * Settings are stored in the flash page reserved by the NVM driver as a log of records. Each record
+ * occupies one pair of words: the first word holds the record tag (upper byte) and the module 
+ * address (lower byte), the second word the inverted first word. Records are appended to the log,
+ * so the page is only erased when it is full. During initialization the last valid record before
+ * the first erased word pair is loaded. When no valid record is found, the default address 
+ * UART_ADDRESS_DEFAULT is used.
+ *
+ * Since the CPU stalls while the flash is erased or programmed, settings are only stored while the 
+ * power converter is not running.
+ *
+ * *************************************************************************************************** */
+
+#define SETTINGS_RECORD_TAG     0xA5U   // Tag in the upper byte of the first word of each record
+#define SETTINGS_RECORD_WORDS   2U      // Number of words per record
+#define SETTINGS_RECORDS        (NVM_PAGE_WORDS / SETTINGS_RECORD_WORDS) // Number of records per flash page
+
+typedef union{
+
+	struct {
+		volatile bool valid : 1;        // Bit 0: Flag bit indicating that the settings have been loaded from flash
+		volatile unsigned : 7;			// Bit <7:1>: (reserved)
+		volatile unsigned : 7;			// Bit <14:8> (reserved)
+		volatile bool enabled : 1;      // Bit 15: Control bit enabling/disabling writes to flash
+	} __attribute__((packed)) bits; // Settings object status bit field for single bit access
+
+	volatile uint16_t value;		// Settings object status word
+
+} SETTINGS_OBJECT_STATUS_t;	// Settings object status
+
+typedef struct {
+	volatile SETTINGS_OBJECT_STATUS_t status; // Status word of this settings object
+    volatile uint16_t address;      // Module address on the shared serial bus
+    volatile uint16_t next;         // Index of the next free record in the flash page
+    volatile uint16_t writes;       // Number of records written since startup
+} SETTINGS_OBJECT_t;
+
+// Public Function Prototypes
+extern volatile uint16_t settings_load(volatile SETTINGS_OBJECT_t* settings);
+extern volatile uint16_t settings_set_address(volatile SETTINGS_OBJECT_t* settings, volatile uint16_t address);
+
+// Public Variable Declaration
+extern volatile SETTINGS_OBJECT_t settingsobj_Buck;
+
+// PUBLIC FUNCTION PROTOTYPE DECLARATIONS
+extern volatile uint16_t appSettings_Initialize(void);
+extern volatile uint16_t appSettings_Dispose(void);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_SETTINGS_HEADER_H */
@@ -0,0 +1,74 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/* 
+ * File:   drv_nvm.h
+ * Author: M91406
+ * Comments: Flash self-programming driver of the settings page
+ * Revision history: 
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.  
+#ifndef NVM_DRIVER_H
+#define	NVM_DRIVER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.  
+#include <stdint.h> // include standard integer types 
+#include <stdbool.h> // include standard boolean types  
+#include <stddef.h> // include standard definitions  
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!NVM Settings Page
+ * ***************************************************************************************************
+ * Summary:
+ * One flash page reserved for non-volatile settings
+ * 
+ * Description:
+ * The driver reserves one erase page of program memory (NVM_PAGE_WORDS instruction words) which is
+ * placed by the linker. Only the lower 16 bits of each instruction word are used. Words are 
+ * addressed by their index within the page. The flash is programmed in pairs of instruction words
+ * (double-word programming) and erased page-wise. Erased words read 0xFFFF.
+ * 
+ * The CPU stalls while the flash is erased or programmed (single panel flash). Interrupts are not
+ * executed during this time, so the page must not be written while the power converter is running.
+ * 
+ * The page is not loaded by the programmer (noload), so it is erased when the device is programmed
+ * unless the program memory range of the page is preserved in the programmer settings.
+ * 
+ * *************************************************************************************************** */
+
+#define NVM_PAGE_WORDS          1024U   // Number of instruction words per flash erase page
+    
+// Public Function Prototypes
+extern uint16_t nvm_read(volatile uint16_t index);
+extern volatile uint16_t nvm_write_pair(volatile uint16_t index, volatile uint16_t word0, volatile uint16_t word1);
+extern volatile uint16_t nvm_erase(void);
+    
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* NVM_DRIVER_H */
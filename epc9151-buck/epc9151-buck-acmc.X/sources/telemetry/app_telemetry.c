@@ -0,0 +1,345 @@
+/*
+ * File:   app_telemetry.c
+ * Author: M91406
+ *
+ * Created on November 25, 2020, 10:10 AM
+ */
+
+#include <stddef.h>
+
+#include "app_telemetry.h"
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/app_power_control.h"
+#include "fault_handler/app_faults.h"
+
+
+// Define telemetry object
+volatile TELEM_OBJECT_t telemobj_Buck;
+
+// Telemetry channel table (addresses of the variables selectable by channel ID)
+volatile uint16_t* const telem_channel_table[TELEM_CH_COUNT] = {
+    &buck.data.v_out,               // TELEM_CH_V_OUT
+    &buck.data.v_in,                // TELEM_CH_V_IN
+    &buck.data.i_sns[0],            // TELEM_CH_I_SNS1
+    &buck.data.i_sns[1],            // TELEM_CH_I_SNS2
+    &buck.data.i_out,               // TELEM_CH_I_OUT
+    &buck.data.temp,                // TELEM_CH_TEMP
+    &buck.set_values.v_ref,         // TELEM_CH_V_REF
+    &buck.v_loop.reference,         // TELEM_CH_V_LOOP_REF
+    &buck.i_loop[0].reference,      // TELEM_CH_V_LOOP_OUT1
+    &buck.i_loop[1].reference,      // TELEM_CH_V_LOOP_OUT2
+    &BUCK_PWM1_PDC,                 // TELEM_CH_I_LOOP1_OUT
+    &BUCK_PWM2_PDC,                 // TELEM_CH_I_LOOP2_OUT
+    (volatile uint16_t*)&buck.mode, // TELEM_CH_MODE
+    &buck.status.value,             // TELEM_CH_STATUS
+    &fltengine_Buck.status,         // TELEM_CH_FAULT_STATUS
+    &fltengine_Buck.active,         // TELEM_CH_FAULT_ACTIVE
+    &telemobj_Buck.sat_count[0],    // TELEM_CH_V_LOOP_SAT
+    &telemobj_Buck.sat_count[1],    // TELEM_CH_I_LOOP1_SAT
+    &telemobj_Buck.sat_count[2]     // TELEM_CH_I_LOOP2_SAT
+};
+
+/* @@telem_sample
+ * ********************************************************************************
+ * Summary:
+ * Updates the saturation counters and samples the selected channels
+ *
+ * Parameters:
+ *  volatile TELEM_OBJECT_t* telem: Pointer to telemetry object
+ *
+ * Returns:
+ *  (none)
+ *
+ * Description:
+ * This function is called by the control interrupt after the control loops
+ * have been updated. The saturation counters are updated every control cycle
+ * while the respective loop is enabled. While the stream is running, every
+ * n-th call samples all selected channels into the active block. Completed
+ * blocks are handed over to the communication task by setting their ready
+ * flag. When the next block has not been transmitted yet, the sample is
+ * dropped.
+ *
+ * ********************************************************************************/
+
+void telem_sample(volatile TELEM_OBJECT_t* telem)
+{
+    uint16_t _i=0, _idx=0, _blk=0;
+    volatile NPNZ16b_t* _loop;
+    int16_t _out=0;
+
+    if (!telem->status.bits.enabled) return;
+
+    // Count control cycles with clamped loop output
+    for (_i=0; _i<TELEM_LOOPS; _i++)
+    {
+        _loop = telem->loop[_i];
+        if (!_loop->status.bits.enabled) continue;
+        _out = (int16_t)(*_loop->Ports.Target.ptrAddress);
+        if ((_out >= _loop->Limits.MaxOutput) || (_out <= _loop->Limits.MinOutput))
+            telem->sat_count[_i]++;
+    }
+
+    if (!telem->status.bits.running) return;
+
+    // Decimation
+    if (++telem->dec_counter < telem->decimation) return;
+    telem->dec_counter = 0;
+    telem->sample_index++;
+
+    _blk = telem->fill_block;
+    if (telem->ready[_blk])
+    {
+        telem->dropped++; // block is still waiting for transmission
+        return;
+    }
+
+    _idx = telem->fill_index;
+    if (_idx == 0)
+        telem->first_sample[_blk] = telem->sample_index;
+
+    for (_i=0; _i<telem->channels; _i++)
+    { telem->block[_blk][_idx++] = *telem->source[_i]; }
+
+    // Hand over completed block and continue in the other block
+    if (_idx >= telem->block_words)
+    {
+        telem->ready[_blk] = true;
+        telem->fill_block = (_blk ^ 1);
+        _idx = 0;
+    }
+
+    telem->fill_index = _idx;
+
+    return;
+}
+
+/* @@telem_min_decimation
+ * ********************************************************************************
+ * Summary:
+ * Returns the minimum decimation which can be streamed continuously
+ *
+ * Parameters:
+ *  volatile uint16_t channels: Number of channels
+ *
+ * Returns:
+ *  Minimum number of control cycles per sample
+ *
+ * Description:
+ * The sample rate is limited by the UART bandwidth available for telemetry
+ * (TELEM_LINK_BYTE_RATE) incl. frame header, CRC and encoding overhead.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t telem_min_decimation(volatile uint16_t channels)
+{
+    volatile uint32_t _samples=0;
+    volatile uint32_t _frame_bytes=0;
+
+    if ((channels == 0) || (channels > TELEM_CHANNELS_MAX)) return(0xFFFF);
+
+    _samples = (TELEM_BLOCK_WORDS / channels);
+    _frame_bytes = (FRAME_HEADER_SIZE + TELEM_HEADER_SIZE + (2 * channels * _samples) + FRAME_CRC_SIZE + 2);
+
+    return((uint16_t)(((TELEM_SAMPLE_FREQUENCY * _frame_bytes) / (TELEM_LINK_BYTE_RATE * _samples)) + 1));
+}
+
+/* @@telem_configure
+ * ********************************************************************************
+ * Summary:
+ * Selects the channels and the decimation of the telemetry stream
+ *
+ * Parameters:
+ *  volatile TELEM_OBJECT_t* telem: Pointer to telemetry object
+ *  volatile uint16_t decimation: Number of control cycles per sample
+ *  volatile uint16_t channels: Number of channels
+ *  volatile uint8_t* channel: Array of channel IDs
+ *
+ * Returns:
+ *  1: success
+ *  0: error (invalid channel ID, number of channels or decimation)
+ *
+ * Description:
+ * A running stream is stopped. Decimations below the minimum decimation are
+ * rejected since they cannot be transmitted continuously.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t telem_configure(volatile TELEM_OBJECT_t* telem, volatile uint16_t decimation,
+                volatile uint16_t channels, volatile uint8_t* channel)
+{
+    volatile uint16_t _i=0;
+
+    if ((telem == NULL) || (channel == NULL)) return(0);
+    if ((channels == 0) || (channels > TELEM_CHANNELS_MAX)) return(0);
+    if (decimation < telem_min_decimation(channels)) return(0);
+    for (_i=0; _i<channels; _i++)
+    { if (channel[_i] >= TELEM_CH_COUNT) return(0); }
+
+    telem_stop(telem);
+
+    for (_i=0; _i<channels; _i++)
+    {
+        telem->channel[_i] = channel[_i];
+        telem->source[_i] = telem_channel_table[channel[_i]];
+    }
+    telem->channels = channels;
+    telem->samples = (TELEM_BLOCK_WORDS / channels);
+    telem->block_words = (telem->samples * channels);
+    telem->decimation = decimation;
+
+    return(1);
+}
+
+/* @@telem_start
+ * ********************************************************************************
+ * Summary:
+ * Starts the telemetry stream
+ *
+ * Parameters:
+ *  volatile TELEM_OBJECT_t* telem: Pointer to telemetry object
+ *
+ * Returns:
+ *  1: success
+ *  0: error (stream not configured)
+ *
+ * Description:
+ * Both blocks are emptied and the sample index is reset before sampling is
+ * started.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t telem_start(volatile TELEM_OBJECT_t* telem)
+{
+    if (telem == NULL) return(0);
+    if ((telem->channels == 0) || (!telem->status.bits.enabled)) return(0);
+
+    telem->status.bits.running = false;
+
+    telem->dec_counter = 0;
+    telem->sample_index = 0;
+    telem->dropped = 0;
+    telem->fill_block = 0;
+    telem->fill_index = 0;
+    telem->send_block = 0;
+    telem->ready[0] = false;
+    telem->ready[1] = false;
+
+    telem->status.bits.running = true;
+
+    return(1);
+}
+
+/* @@telem_stop
+ * ********************************************************************************
+ * Summary:
+ * Stops the telemetry stream
+ *
+ * Parameters:
+ *  volatile TELEM_OBJECT_t* telem: Pointer to telemetry object
+ *
+ * Returns:
+ *  1: success
+ *  0: error
+ *
+ * Description:
+ * Blocks not transmitted yet are discarded.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t telem_stop(volatile TELEM_OBJECT_t* telem)
+{
+    if (telem == NULL) return(0);
+
+    telem->status.bits.running = false;
+    telem->ready[0] = false;
+    telem->ready[1] = false;
+
+    return(1);
+}
+
+/* @@telem_read_block
+ * ********************************************************************************
+ * Summary:
+ * Copies the next completed block into a stream frame payload
+ *
+ * Parameters:
+ *  volatile TELEM_OBJECT_t* telem: Pointer to telemetry object
+ *  volatile uint8_t* dst: Pointer to payload buffer (FRAME_PAYLOAD_MAX bytes)
+ *
+ * Returns:
+ *  Number of payload bytes (0 = no block ready)
+ *
+ * Description:
+ * Payload format: status (0), number of samples, sample index of the first
+ * sample (16 bit), followed by the samples (channel values in the order of
+ * selection, 16 bit each). The block is released for the control interrupt
+ * after it has been copied.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t telem_read_block(volatile TELEM_OBJECT_t* telem, volatile uint8_t* dst)
+{
+    volatile uint16_t _i=0;
+    volatile uint16_t _blk=0;
+    volatile uint16_t _size=TELEM_HEADER_SIZE;
+
+    if ((telem == NULL) || (dst == NULL)) return(0);
+
+    _blk = telem->send_block;
+    if (!telem->ready[_blk]) return(0);
+
+    dst[0] = 0;
+    dst[1] = (uint8_t)telem->samples;
+    dst[2] = (telem->first_sample[_blk] & 0xFF);
+    dst[3] = (telem->first_sample[_blk] >> 8);
+
+    for (_i=0; _i<telem->block_words; _i++)
+    {
+        dst[_size++] = (telem->block[_blk][_i] & 0xFF);
+        dst[_size++] = (telem->block[_blk][_i] >> 8);
+    }
+
+    telem->send_block = (_blk ^ 1);
+    telem->ready[_blk] = false; // Release block
+
+    return(_size);
+}
+
+
+volatile uint16_t appTelemetry_Initialize(void)
+{
+    volatile uint16_t retval=1;
+    volatile uint16_t _i=0;
+
+    // Initialize buck telemetry object
+    telemobj_Buck.status.value = 0;
+    telemobj_Buck.decimation = 0;
+    telemobj_Buck.channels = 0;
+    telemobj_Buck.samples = 0;
+    telemobj_Buck.block_words = 0;
+    retval &= telem_stop(&telemobj_Buck);
+
+    // Monitor voltage loop and both current loops for saturation
+    telemobj_Buck.loop[0] = buck.v_loop.controller;
+    telemobj_Buck.loop[1] = buck.i_loop[0].controller;
+    telemobj_Buck.loop[2] = buck.i_loop[1].controller;
+    for (_i=0; _i<TELEM_LOOPS; _i++)
+    {
+        if (telemobj_Buck.loop[_i] == NULL) retval = 0;
+        telemobj_Buck.sat_count[_i] = 0;
+    }
+
+    telemobj_Buck.status.bits.enabled = (bool)(TELEMETRY_ENABLE && retval); // Enable telemetry sampling
+
+    return(retval);
+}
+
+volatile uint16_t appTelemetry_Dispose(void)
+{
+    volatile uint16_t fres=1;
+
+    telemobj_Buck.status.bits.enabled = false;   // Disable telemetry sampling
+    fres &= telem_stop(&telemobj_Buck);
+
+    return(fres);
+}
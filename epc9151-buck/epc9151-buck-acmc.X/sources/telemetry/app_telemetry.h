@@ -0,0 +1,166 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/*
+ * File:   app_telemetry.h
+ * Author: M91406
+ * Comments: telemetry streaming application layer API
+ * Revision history:
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef APPLICATION_LAYER_TELEMETRY_HEADER_H
+#define	APPLICATION_LAYER_TELEMETRY_HEADER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include <stdint.h> // include standard integer data types
+#include <stdbool.h> // include standard boolean data types
+#include <stddef.h> // include standard definition data types
+
+#include "uart/drivers/drv_frame.h"
+#include "pwr_control/drivers/npnz16b.h"
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!TELEM_CHANNEL_e
+ * ***************************************************************************************************
+ * Summary:
+ * Telemetry channel IDs
+ *
+ * Description:
+ * Each channel ID selects one 16-bit variable of the power converter which can be added to the
+ * telemetry stream. Loop outputs are the current references (voltage loop) and the PWM duty 
+ * cycles (current loops). Saturation counters count the control cycles in which the loop 
+ * output has been clamped at its minimum or maximum limit.
+ *
+ * *************************************************************************************************** */
+
+typedef enum {
+    TELEM_CH_V_OUT          = 0,  // output voltage (ADC ticks)
+    TELEM_CH_V_IN           = 1,  // input voltage (ADC ticks)
+    TELEM_CH_I_SNS1         = 2,  // phase #1 current (ADC ticks)
+    TELEM_CH_I_SNS2         = 3,  // phase #2 current (ADC ticks)
+    TELEM_CH_I_OUT          = 4,  // common output current (ADC ticks)
+    TELEM_CH_TEMP           = 5,  // board temperature (ADC ticks)
+    TELEM_CH_V_REF          = 6,  // user voltage reference
+    TELEM_CH_V_LOOP_REF     = 7,  // voltage loop reference (trajectory output)
+    TELEM_CH_V_LOOP_OUT1    = 8,  // voltage loop output = phase #1 current reference
+    TELEM_CH_V_LOOP_OUT2    = 9,  // voltage loop output = phase #2 current reference
+    TELEM_CH_I_LOOP1_OUT    = 10, // phase #1 current loop output = PWM duty cycle
+    TELEM_CH_I_LOOP2_OUT    = 11, // phase #2 current loop output = PWM duty cycle
+    TELEM_CH_MODE           = 12, // converter state machine state
+    TELEM_CH_STATUS         = 13, // converter status word
+    TELEM_CH_FAULT_STATUS   = 14, // bit mask of tripped faults
+    TELEM_CH_FAULT_ACTIVE   = 15, // bit mask of immediate fault conditions
+    TELEM_CH_V_LOOP_SAT     = 16, // voltage loop saturation counter
+    TELEM_CH_I_LOOP1_SAT    = 17, // phase #1 current loop saturation counter
+    TELEM_CH_I_LOOP2_SAT    = 18, // phase #2 current loop saturation counter
+    TELEM_CH_COUNT          = 19  // number of available channels
+} TELEM_CHANNEL_e;
+
+#define TELEM_CHANNELS_MAX      8U  // Maximum number of channels per stream
+#define TELEM_LOOPS             3U  // Number of monitored control loops (saturation counters)
+#define TELEM_HEADER_SIZE       4U  // Stream frame payload header (status, samples, first sample index)
+#define TELEM_BLOCK_WORDS       ((FRAME_PAYLOAD_MAX - TELEM_HEADER_SIZE) / 2U) // Data words per stream frame
+
+#define TELEM_CMD_STOP          0U  // Command: stop stream
+#define TELEM_CMD_START         1U  // Command: start stream
+#define TELEM_CMD_START_POLLED  2U  // Command: start stream, blocks are sent on request only (shared bus)
+
+/*!TELEM_OBJECT_t
+ * ***************************************************************************************************
+ * Summary:
+ * Telemetry stream data object
+ *
+ * Description:
+ * The control interrupt samples the selected channels every n-th control cycle (decimation) and 
+ * packs the samples into one of two data blocks (double buffer). Each block holds as many complete
+ * samples as fit into one stream frame. A completed block is marked ready and sampling continues
+ * in the other block, while the communication task transmits the ready block. If the other block
+ * has not been transmitted yet, samples are dropped. All samples are numbered by a free-running
+ * sample index, so the receiver can detect and time-align gaps.
+ *
+ * The ready flags are handshake flags: they are only set by the control interrupt and only 
+ * cleared by the communication task.
+ *
+ * *************************************************************************************************** */
+
+typedef union{
+
+	struct {
+		volatile bool running : 1;      // Bit 0: Flag bit indicating that the stream is running
+		volatile unsigned : 7;			// Bit <7:1>: (reserved)
+		volatile unsigned : 7;			// Bit <14:8> (reserved)
+		volatile bool enabled : 1;      // Bit 15: Control bit enabling/disabling telemetry sampling
+	} __attribute__((packed)) bits; // Telemetry object status bit field for single bit access
+
+	volatile uint16_t value;		// Telemetry object status word
+
+} TELEM_OBJECT_STATUS_t;	// Telemetry object status
+
+typedef struct {
+	volatile TELEM_OBJECT_STATUS_t status; // Status word of this telemetry object
+    volatile uint16_t decimation;   // Number of control cycles per sample
+    volatile uint16_t dec_counter;  // Control cycle counter (read only)
+    volatile uint16_t channels;     // Number of selected channels
+    volatile uint16_t samples;      // Number of samples per block
+    volatile uint16_t block_words;  // Number of data words per block (channels x samples)
+    volatile uint16_t* source[TELEM_CHANNELS_MAX]; // Pointers to the selected channel variables
+    volatile uint8_t channel[TELEM_CHANNELS_MAX]; // Selected channel IDs
+    volatile uint16_t sample_index; // Free-running index of the most recent sample
+    volatile uint16_t dropped;      // Number of samples dropped because no block was available
+    volatile uint16_t fill_block;   // Block being filled by the control interrupt
+    volatile uint16_t fill_index;   // Next data word to be written in the active block
+    volatile uint16_t send_block;   // Block to be transmitted next by the communication task
+    volatile uint16_t ready[2];     // Handshake flags of blocks waiting for transmission
+    volatile uint16_t first_sample[2]; // Sample index of the first sample of each block
+    volatile uint16_t block[2][TELEM_BLOCK_WORDS]; // Double buffer
+    volatile NPNZ16b_t* loop[TELEM_LOOPS]; // Control loops monitored for saturation
+    volatile uint16_t sat_count[TELEM_LOOPS]; // Free-running saturation counters
+} TELEM_OBJECT_t;
+
+// Public Function Prototypes
+extern void telem_sample(volatile TELEM_OBJECT_t* telem);
+extern volatile uint16_t telem_configure(volatile TELEM_OBJECT_t* telem, volatile uint16_t decimation, 
+                volatile uint16_t channels, volatile uint8_t* channel);
+extern volatile uint16_t telem_min_decimation(volatile uint16_t channels);
+extern volatile uint16_t telem_start(volatile TELEM_OBJECT_t* telem);
+extern volatile uint16_t telem_stop(volatile TELEM_OBJECT_t* telem);
+extern volatile uint16_t telem_read_block(volatile TELEM_OBJECT_t* telem, volatile uint8_t* dst);
+
+// Public Variable Declaration
+extern volatile TELEM_OBJECT_t telemobj_Buck;
+extern volatile uint16_t* const telem_channel_table[TELEM_CH_COUNT];
+
+// PUBLIC FUNCTION PROTOTYPE DECLARATIONS
+extern volatile uint16_t appTelemetry_Initialize(void);
+extern volatile uint16_t appTelemetry_Dispose(void);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* APPLICATION_LAYER_TELEMETRY_HEADER_H */
@@ -0,0 +1,285 @@
+/*
+ * File:   app_params.c
+ * Author: M91406
+ *
+ * Created on November 28, 2020, 9:40 AM
+ */
+
+#include <stddef.h>
+
+#include "app_params.h"
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/app_power_control.h"
+#include "fault_handler/app_faults.h"
+
+
+// Active coefficient sets of the control loops (defined in the DCLD generated controller sources)
+extern volatile struct V_LOOP_CONTROL_LOOP_COEFFICIENTS_s v_loop_coefficients;
+extern volatile struct I_LOOP_1_CONTROL_LOOP_COEFFICIENTS_s i_loop_1_coefficients;
+extern volatile struct I_LOOP_2_CONTROL_LOOP_COEFFICIENTS_s i_loop_2_coefficients;
+
+// Define parameter object
+volatile PARAM_OBJECT_t paramobj_Buck;
+
+// Parameter registry (index = parameter ID). The DSP only multiplies the low word 
+// (Q15) of each 32-bit coefficient entry, so coefficients are registered as 16-bit words.
+const PARAM_DEFINITION_t paramdef_Buck[] = {
+    
+    // Voltage loop coefficients and output clamping (current reference per phase)
+    { "v_loop.A1", (volatile uint16_t*)&v_loop_coefficients.ACoefficients[0], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "v_loop.A2", (volatile uint16_t*)&v_loop_coefficients.ACoefficients[1], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "v_loop.B0", (volatile uint16_t*)&v_loop_coefficients.BCoefficients[0], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "v_loop.B1", (volatile uint16_t*)&v_loop_coefficients.BCoefficients[1], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "v_loop.B2", (volatile uint16_t*)&v_loop_coefficients.BCoefficients[2], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "v_loop.Limits.MinOutput", (volatile uint16_t*)&v_loop.Limits.MinOutput, PARAM_TYPE_I16, -(int32_t)BUCK_ISNS_REF_MAX, 0 },
+    { "v_loop.Limits.MaxOutput", (volatile uint16_t*)&v_loop.Limits.MaxOutput, PARAM_TYPE_I16, 0, BUCK_ISNS_REF_MAX },
+    
+    // Current loop coefficients and output clamping (duty cycle)
+    { "i_loop_1.A1", (volatile uint16_t*)&i_loop_1_coefficients.ACoefficients[0], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "i_loop_1.A2", (volatile uint16_t*)&i_loop_1_coefficients.ACoefficients[1], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "i_loop_1.B0", (volatile uint16_t*)&i_loop_1_coefficients.BCoefficients[0], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "i_loop_1.B1", (volatile uint16_t*)&i_loop_1_coefficients.BCoefficients[1], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "i_loop_1.B2", (volatile uint16_t*)&i_loop_1_coefficients.BCoefficients[2], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "i_loop_1.Limits.MinOutput", (volatile uint16_t*)&i_loop_1.Limits.MinOutput, PARAM_TYPE_I16, BUCK_PWM_DC_MIN, BUCK_PWM_DC_MAX },
+    { "i_loop_1.Limits.MaxOutput", (volatile uint16_t*)&i_loop_1.Limits.MaxOutput, PARAM_TYPE_I16, BUCK_PWM_DC_MIN, BUCK_PWM_DC_MAX },
+    { "i_loop_2.A1", (volatile uint16_t*)&i_loop_2_coefficients.ACoefficients[0], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "i_loop_2.A2", (volatile uint16_t*)&i_loop_2_coefficients.ACoefficients[1], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "i_loop_2.B0", (volatile uint16_t*)&i_loop_2_coefficients.BCoefficients[0], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "i_loop_2.B1", (volatile uint16_t*)&i_loop_2_coefficients.BCoefficients[1], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "i_loop_2.B2", (volatile uint16_t*)&i_loop_2_coefficients.BCoefficients[2], PARAM_TYPE_I16, INT16_MIN, INT16_MAX },
+    { "i_loop_2.Limits.MinOutput", (volatile uint16_t*)&i_loop_2.Limits.MinOutput, PARAM_TYPE_I16, BUCK_PWM_DC_MIN, BUCK_PWM_DC_MAX },
+    { "i_loop_2.Limits.MaxOutput", (volatile uint16_t*)&i_loop_2.Limits.MaxOutput, PARAM_TYPE_I16, BUCK_PWM_DC_MIN, BUCK_PWM_DC_MAX },
+    
+    // Soft-start ramps (reference increment per state machine call, max. 8 times the design value of at least 1)
+    { "startup.v_ramp.ref_inc_step", &buck.startup.v_ramp.ref_inc_step, PARAM_TYPE_U16, 1, (8L * ((BUCK_VREF_STEP > 0) ? BUCK_VREF_STEP : 1)) },
+    { "startup.i_ramp.ref_inc_step", &buck.startup.i_ramp.ref_inc_step, PARAM_TYPE_U16, 1, (8L * ((BUCK_IREF_STEP > 0) ? BUCK_IREF_STEP : 1)) },
+    
+    // Load current estimate of pre-biased ACMC starts (0 = no pre-charge of the current reference)
+    { "startup.i_load", &buck.startup.i_load, PARAM_TYPE_U16, 0, BUCK_ISNS_REF_MAX },
+    
+    // Fault thresholds of the fault engine (trip levels can only be tightened, trip and reset level have to keep their order)
+    { "flt.ovlo.trip_level", &fltengine_Buck.trip_level[FLT_BUCK_OVLO], PARAM_TYPE_U16, 0, BUCK_VIN_OVLO_TRIP, PARAM_ORDER_ABOVE_NEXT },
+    { "flt.ovlo.reset_level", &fltengine_Buck.reset_level[FLT_BUCK_OVLO], PARAM_TYPE_U16, 0, BUCK_VIN_OVLO_TRIP },
+    { "flt.ocp.trip_level", &fltengine_Buck.trip_level[FLT_BUCK_OCP], PARAM_TYPE_U16, 0, BUCK_ISNS_OCL, PARAM_ORDER_ABOVE_NEXT },
+    { "flt.ocp.reset_level", &fltengine_Buck.reset_level[FLT_BUCK_OCP], PARAM_TYPE_U16, 0, BUCK_ISNS_OCL },
+    { "flt.uvlo.trip_level", &fltengine_Buck.trip_level[FLT_BUCK_UVLO], PARAM_TYPE_U16, BUCK_VIN_UVLO_TRIP, ADC_VALUE_MAX, PARAM_ORDER_BELOW_NEXT },
+    { "flt.uvlo.reset_level", &fltengine_Buck.reset_level[FLT_BUCK_UVLO], PARAM_TYPE_U16, BUCK_VIN_UVLO_TRIP, ADC_VALUE_MAX },
+    { "flt.regerr.trip_level", &fltengine_Buck.trip_level[FLT_BUCK_REGERR], PARAM_TYPE_U16, 0, BUCK_VOUT_DEV_TRIP, PARAM_ORDER_ABOVE_NEXT },
+    { "flt.regerr.reset_level", &fltengine_Buck.reset_level[FLT_BUCK_REGERR], PARAM_TYPE_U16, 0, BUCK_VOUT_DEV_TRIP },
+    { "flt.ocp1.trip_level", &fltengine_Buck.trip_level[FLT_BUCK_OCP1], PARAM_TYPE_U16, 0, BUCK_ISNS_PHASE_OCL, PARAM_ORDER_ABOVE_NEXT },
+    { "flt.ocp1.reset_level", &fltengine_Buck.reset_level[FLT_BUCK_OCP1], PARAM_TYPE_U16, 0, BUCK_ISNS_PHASE_OCL },
+    { "flt.ocp2.trip_level", &fltengine_Buck.trip_level[FLT_BUCK_OCP2], PARAM_TYPE_U16, 0, BUCK_ISNS_PHASE_OCL, PARAM_ORDER_ABOVE_NEXT },
+    { "flt.ocp2.reset_level", &fltengine_Buck.reset_level[FLT_BUCK_OCP2], PARAM_TYPE_U16, 0, BUCK_ISNS_PHASE_OCL },
+    { "flt.imbal.trip_level", &fltengine_Buck.trip_level[FLT_BUCK_IMBAL], PARAM_TYPE_U16, 0, BUCK_ISNS_IMBAL, PARAM_ORDER_ABOVE_NEXT },
+    { "flt.imbal.reset_level", &fltengine_Buck.reset_level[FLT_BUCK_IMBAL], PARAM_TYPE_U16, 0, BUCK_ISNS_IMBAL }
+    
+};
+
+/* PRIVATE FUNCTION PROTOTYPES */
+static int32_t param_value(volatile PARAM_OBJECT_t* params, volatile uint16_t count,
+                volatile uint16_t* id, volatile uint16_t* value, uint16_t pid);
+
+static int32_t param_value(volatile PARAM_OBJECT_t* params, volatile uint16_t count,
+                volatile uint16_t* id, volatile uint16_t* value, uint16_t pid)
+{
+    uint16_t _i=0;
+    uint16_t _raw=0;
+
+    // Value written by this request, present value otherwise
+    _raw = *params->table[pid].address;
+    for (_i=0; _i<count; _i++)
+    { if (id[_i] == pid) _raw = value[_i]; }
+
+    if (params->table[pid].type == PARAM_TYPE_I16)
+        return((int16_t)_raw);
+    else
+        return(_raw);
+}
+
+/* @@param_apply
+ * ********************************************************************************
+ * Summary:
+ * Writes the staged parameter values
+ *
+ * Parameters:
+ *  volatile PARAM_OBJECT_t* params: Pointer to parameter object
+ *
+ * Returns:
+ *  (none)
+ *
+ * Description:
+ * This function is called by the control interrupt after all other functions
+ * of the control cycle have been executed. All values of a staged set are
+ * written within the same call, so the control loops, the fault engine and 
+ * the state machine never see a partially written set. 
+ *
+ * ********************************************************************************/
+
+void param_apply(volatile PARAM_OBJECT_t* params)
+{
+    uint16_t _i=0;
+
+    if (!params->status.bits.pending) return;
+
+    for (_i=0; _i<params->count; _i++)
+    { *params->table[params->id[_i]].address = params->value[_i]; }
+
+    params->applied++;
+    params->status.bits.pending = false; // Release staging buffer
+
+    return;
+}
+
+/* @@param_definition
+ * ********************************************************************************
+ * Summary:
+ * Returns the registry entry of a parameter
+ *
+ * Parameters:
+ *  volatile PARAM_OBJECT_t* params: Pointer to parameter object
+ *  volatile uint16_t id: Parameter ID
+ *
+ * Returns:
+ *  Pointer to the parameter definition (NULL = unknown parameter ID)
+ *
+ * ********************************************************************************/
+
+const PARAM_DEFINITION_t* param_definition(volatile PARAM_OBJECT_t* params, volatile uint16_t id)
+{
+    if (params == NULL) return(NULL);
+    if (id >= params->size) return(NULL);
+
+    return(&params->table[id]);
+}
+
+/* @@param_read
+ * ********************************************************************************
+ * Summary:
+ * Reads the current value of a parameter
+ *
+ * Parameters:
+ *  volatile PARAM_OBJECT_t* params: Pointer to parameter object
+ *  volatile uint16_t id: Parameter ID
+ *  volatile uint16_t* value: Pointer to the variable receiving the value
+ *
+ * Returns:
+ *  1: success
+ *  0: error (unknown parameter ID)
+ *
+ * ********************************************************************************/
+
+volatile uint16_t param_read(volatile PARAM_OBJECT_t* params, volatile uint16_t id, volatile uint16_t* value)
+{
+    const PARAM_DEFINITION_t* _def;
+
+    if (value == NULL) return(0);
+    _def = param_definition(params, id);
+    if (_def == NULL) return(0);
+
+    *value = *_def->address;
+
+    return(1);
+}
+
+/* @@param_write
+ * ********************************************************************************
+ * Summary:
+ * Stages a set of parameter values to be written by the control interrupt
+ *
+ * Parameters:
+ *  volatile PARAM_OBJECT_t* params: Pointer to parameter object
+ *  volatile uint16_t count: Number of values
+ *  volatile uint16_t* id: Array of parameter IDs
+ *  volatile uint16_t* value: Array of values
+ *
+ * Returns:
+ *  1: success
+ *  0: error (writes disabled, previous set not applied yet, unknown parameter
+ *     ID or value out of range)
+ *
+ * Description:
+ * All values are checked before the first one is staged. If any value is
+ * rejected, none of them is written. Parameters changed together (e.g. a 
+ * complete coefficient set or a trip level with its reset level) have to be 
+ * written in one call to be applied in the same control cycle. Values of 
+ * parameter pairs with a declared order (trip and reset levels) are 
+ * rejected when the resulting pair would violate this order.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t param_write(volatile PARAM_OBJECT_t* params, volatile uint16_t count,
+                volatile uint16_t* id, volatile uint16_t* value)
+{
+    volatile uint16_t _i=0, _pid=0;
+    const PARAM_DEFINITION_t* _def;
+    volatile int32_t _value=0, _next=0;
+
+    if ((params == NULL) || (id == NULL) || (value == NULL)) return(0);
+    if ((count == 0) || (count > PARAM_WRITE_MAX)) return(0);
+    if ((!params->status.bits.enabled) || (params->status.bits.pending)) return(0);
+
+    // Range check of all values
+    for (_i=0; _i<count; _i++)
+    {
+        _def = param_definition(params, id[_i]);
+        if (_def == NULL) return(0);
+
+        if (_def->type == PARAM_TYPE_I16)
+            _value = (int16_t)value[_i];
+        else
+            _value = value[_i];
+
+        if ((_value < _def->minimum) || (_value > _def->maximum)) return(0);
+    }
+
+    // Order check of parameter pairs (e.g. trip level above reset level)
+    for (_i=0; _i<count; _i++)
+    {
+        _pid = id[_i];
+        if ((_pid > 0) && (params->table[_pid - 1].order != PARAM_ORDER_NONE)) _pid--; // second entry of a pair
+        _def = &params->table[_pid];
+        if (_def->order == PARAM_ORDER_NONE) continue;
+        if ((_pid + 1) >= params->size) return(0);
+
+        _value = param_value(params, count, id, value, _pid);
+        _next = param_value(params, count, id, value, (_pid + 1));
+
+        if ((_def->order == PARAM_ORDER_ABOVE_NEXT) && (_value <= _next)) return(0);
+        if ((_def->order == PARAM_ORDER_BELOW_NEXT) && (_value >= _next)) return(0);
+    }
+
+    // Stage values and hand them over to the control interrupt
+    for (_i=0; _i<count; _i++)
+    {
+        params->id[_i] = id[_i];
+        params->value[_i] = value[_i];
+    }
+    params->count = count;
+    params->status.bits.pending = true;
+
+    return(1);
+}
+
+
+volatile uint16_t appParams_Initialize(void)
+{
+    volatile uint16_t retval=1;
+
+    // Initialize buck parameter object
+    paramobj_Buck.status.value = 0;
+    paramobj_Buck.table = paramdef_Buck;
+    paramobj_Buck.size = (sizeof(paramdef_Buck) / sizeof(paramdef_Buck[0]));
+    paramobj_Buck.count = 0;
+    paramobj_Buck.applied = 0;
+
+    paramobj_Buck.status.bits.enabled = (bool)PARAM_ACCESS_ENABLE; // Enable parameter writes
+
+    return(retval);
+}
+
+volatile uint16_t appParams_Dispose(void)
+{
+    paramobj_Buck.status.bits.enabled = false;   // Disable parameter writes
+
+    return(1);
+}
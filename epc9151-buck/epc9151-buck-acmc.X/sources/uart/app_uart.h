@@ -36,27 +36,142 @@
 #include <stdbool.h> // include standard boolean data types
 #include <stddef.h> // include standard definition data types
 
+#include "drivers/drv_uart.h"
+#include "drivers/drv_frame.h"
 
 
 #ifdef	__cplusplus
 extern "C" {
 #endif /* __cplusplus */
     
+#define UART_RESPONSE_MAX   FRAME_ENCODED_MAX  // Longest response to a single command in bytes (encoded frame incl. delimiter)
+#define PARAM_READ_MAX      16U // Maximum number of parameters read by a single request
+
+/*!PROTO_COMMAND_e
+ * ***************************************************************************************************
+ * Summary:
+ * Command codes of the binary communication protocol
+ * 
+ * Description:
+ * Every request frame is answered by a response frame with the same request ID and the command
+ * code of the request with PROTO_RESPONSE_FLAG set. The first payload byte of each response holds
+ * the status of the request (PROTO_STATUS_e), followed by the response data. 
+ * 
+ *  Command                 Request payload                     Response data
+ *  PROTO_CMD_GET_VERSION   (none)                              protocol version (8 bit), firmware version (3x 16 bit)
+ *  PROTO_CMD_READ_DATA     (none)                              data1...data4, converter state, converter status (6x 16 bit)
+ *  PROTO_CMD_DISCOVER      (none)                              module address, protocol version (2x 8 bit), 
+ *                                                              firmware version (3x 16 bit)
+ *  PROTO_CMD_SET_ADDRESS   address, persist (2x 8 bit)         address (8 bit)
+ *  PROTO_CMD_READ_UNITS    (none)                              v_in, v_out, v_ref in [mV], i_sns1, i_sns2, i_out in [mA],
+ *                                                              temperature in [0.1 degree C] (0x8000 = not available),
+ *                                                              converter state (8x 16 bit)
+ *  PROTO_CMD_SET_VREF      reference (16 bit)                  reference (16 bit)
+ *  PROTO_CMD_SET_VOUT      output voltage in [mV] (16 bit)     output voltage in [mV], reference (2x 16 bit)
+ *  PROTO_CMD_SEQ_LOAD      index, time, v_ref, i_limit (4x 16 bit) (none)
+ *  PROTO_CMD_SEQ_CONTROL   command, number of setpoints (2x 8 bit) (none)
+ *  PROTO_CMD_PROF_READ     page (8 bit, 0xFF = reset)          data page (8x 16 bit)
+ *  PROTO_CMD_FLOG_READ     entry, page (2x 8 bit, entry 0xFF = clear) data page (8x 16 bit)
+ *  PROTO_CMD_STREAM_CONFIG decimation (16 bit), channel IDs (1...8x 8 bit) samples per frame (8 bit), minimum decimation (16 bit)
+ *  PROTO_CMD_STREAM_CONTROL command (8 bit, 0 = stop, 1 = start, 2 = start polled)  
+ *                                                              sample index, dropped samples (2x 16 bit)
+ *  PROTO_CMD_STREAM_POLL   (none)                              next stream data block (see below, 0 samples = none ready)
+ *  PROTO_CMD_STATS_CONFIG  decimation (16 bit), window length (8 bit, 2^n samples), channel IDs (1...4x 8 bit)
+ *                                                              (none)
+ *  PROTO_CMD_STATS_READ    command (8 bit, 0 = read, 1 = read and restart window)
+ *                                                              statistics status, window number, samples per window,
+ *                                                              number of channels (4x 16 bit), per channel: minimum,
+ *                                                              maximum, mean, RMS, AC RMS, ripple (6x 16 bit)
+ *  PROTO_CMD_CAPTURE_CONFIG decimation, pre-trigger samples (2x 16 bit), trigger source, trigger channel 
+ *                          (2x 8 bit), trigger level (16 bit), channel IDs (1...4x 8 bit)   buffer depth in samples (16 bit)
+ *  PROTO_CMD_CAPTURE_CONTROL command (8 bit, 0 = stop, 1 = arm, 2 = force trigger, 3 = status only)
+ *                                                              capture status, trigger cause, number of samples,
+ *                                                              number of channels, pre-trigger samples (5x 16 bit)
+ *  PROTO_CMD_CAPTURE_READ  page (8 bit)                        data page (16x 16 bit)
+ *  PROTO_CMD_PARAM_INFO    parameter ID (8 bit)                number of parameters, data type (2x 8 bit), minimum,
+ *                                                              maximum, value (3x 16 bit), name (characters)
+ *  PROTO_CMD_PARAM_READ    parameter IDs (1...16x 8 bit)       values (16 bit each)
+ *  PROTO_CMD_PARAM_WRITE   parameter ID (8 bit) and value (16 bit), 1...8x   number of applied parameter sets (16 bit)
+ *  PROTO_CMD_PMBUS_WRITE   PMBus command code, data (0...2x 8 bit) (none)
+ *  PROTO_CMD_PMBUS_READ    PMBus command code (8 bit)          data (1...2x 8 bit)
+ * 
+ * While the telemetry stream is running, stream data frames are sent without request using request
+ * ID 0 and command code PROTO_CMD_STREAM_DATA with PROTO_RESPONSE_FLAG set. Their payload holds the
+ * status, the number of samples, the sample index of the first sample (16 bit) and the samples 
+ * (selected channels in the order of selection, 16 bit each). Requests are answered in between.
+ * 
+ * Several modules can share one serial bus (e.g. RS-485 half-duplex). Each module only executes
+ * requests addressed to its own address, to FRAME_ADDRESS_BROADCAST or to FRAME_ADDRESS_ANY and 
+ * ignores all response frames. Broadcast requests (e.g. PROTO_CMD_SET_VREF, PROTO_CMD_SEQ_CONTROL,
+ * PROTO_CMD_PARAM_WRITE, PROTO_CMD_PMBUS_WRITE) are never answered. Responses to requests addressed
+ * to FRAME_ADDRESS_ANY are delayed by (address x UART_SLOT_PERIOD), so the responses of all modules
+ * are sent in separate time slots. This way PROTO_CMD_DISCOVER finds all modules on the bus. Since 
+ * only one module may transmit at a time, the telemetry stream of modules sharing a bus is started 
+ * in polled mode and the host requests stream blocks by PROTO_CMD_STREAM_POLL from one module 
+ * after the other. PROTO_CMD_SET_ADDRESS changes the address of a single module (the response is 
+ * still sent using the previous address). When persist is non-zero, the new address is stored in flash, 
+ * which is only accepted while the power converter is not running.
+ * 
+ * PROTO_CMD_STATS_READ returns the statistics of the most recent completed window of the running 
+ * statistics (see telemetry/app_stats.h). All channels are taken from the same window. Channel
+ * results are only appended once a window has been completed since the last PROTO_CMD_STATS_CONFIG.
+ * 
+ * PROTO_CMD_READ_UNITS and PROTO_CMD_SET_VOUT use engineering units. Conversions are done by the
+ * converter (see units/app_units.h), currents are signed and compensated by the calibrated current 
+ * sense offsets. PROTO_CMD_SET_VOUT returns the output voltage of the applied reference, which may
+ * differ from the request by the resolution of the reference.
+ * 
+ * PMBus transactions are tunneled through PROTO_CMD_PMBUS_WRITE/PROTO_CMD_PMBUS_READ. Invalid
+ * PMBus commands or data are rejected and reported in STATUS_CML.
+ * 
+ * *************************************************************************************************** */
+
 typedef enum {
-    BUCK_VOLTAGE_REG    = 0,  // buck mode, voltage regulation
-    BUCK_CURRENT_REG    = 1,  // buck mode, constant current output (no voltage regulation)
-    BOOST_VOLTAGE_REG   = 2,  // boost mode, voltage regulation
-    BOOST_CURRENT_REG   = 3,  // boost mode, constant current output (no voltage regulation)
-} MODE_COMMAND_e;
+    PROTO_CMD_GET_VERSION   = 0x01, // read protocol and firmware version
+    PROTO_CMD_READ_DATA     = 0x02, // read snapshot of monitored converter data
+    PROTO_CMD_DISCOVER      = 0x03, // read module address and version (answered in the time slot of the module)
+    PROTO_CMD_SET_ADDRESS   = 0x04, // set module address on the shared bus (optionally stored in flash)
+    PROTO_CMD_READ_UNITS    = 0x05, // read snapshot of converter data in engineering units
+    PROTO_CMD_SET_VREF      = 0x10, // set output voltage reference
+    PROTO_CMD_SET_VOUT      = 0x11, // set output voltage reference in engineering units
+    PROTO_CMD_SEQ_LOAD      = 0x20, // sequencer, load single setpoint into profile table
+    PROTO_CMD_SEQ_CONTROL   = 0x21, // sequencer, start/stop profile execution
+    PROTO_CMD_PROF_READ     = 0x30, // profiler, read data page or reset statistics
+    PROTO_CMD_FLOG_READ     = 0x31, // fault log, read data page of a log entry or clear log
+    PROTO_CMD_STREAM_CONFIG = 0x40, // telemetry, select channels and decimation
+    PROTO_CMD_STREAM_CONTROL = 0x41, // telemetry, start/stop stream
+    PROTO_CMD_STREAM_DATA   = 0x42, // telemetry, stream data frame (sent by the converter only)
+    PROTO_CMD_STREAM_POLL   = 0x43, // telemetry, read next stream data block (polled mode)
+    PROTO_CMD_STATS_CONFIG  = 0x44, // running statistics, select channels, decimation and window length
+    PROTO_CMD_STATS_READ    = 0x45, // running statistics, read results of the most recent window
+    PROTO_CMD_CAPTURE_CONFIG = 0x50, // triggered capture, select channels, decimation and trigger
+    PROTO_CMD_CAPTURE_CONTROL = 0x51, // triggered capture, arm/stop capture or force trigger
+    PROTO_CMD_CAPTURE_READ  = 0x52, // triggered capture, read data page of completed capture
+    PROTO_CMD_PARAM_INFO    = 0x60, // parameter registry, read name, data type, range and value of a parameter
+    PROTO_CMD_PARAM_READ    = 0x61, // parameter registry, read values of a list of parameters
+    PROTO_CMD_PARAM_WRITE   = 0x62, // parameter registry, write a set of parameters in the same control cycle
+    PROTO_CMD_PMBUS_WRITE   = 0x70, // PMBus command layer, write transaction (incl. send byte)
+    PROTO_CMD_PMBUS_READ    = 0x71  // PMBus command layer, read transaction
+} PROTO_COMMAND_e;
+
+#define PROTO_RESPONSE_FLAG     0x80U // Command code flag marking a response frame
+
+typedef enum {
+    PROTO_STATUS_OK         = 0x00, // request has been executed
+    PROTO_STATUS_UNKNOWN    = 0x01, // command code is not supported
+    PROTO_STATUS_LENGTH     = 0x02, // payload length does not match the command
+    PROTO_STATUS_REJECTED   = 0x03  // request parameters are invalid or request cannot be executed
+} PROTO_STATUS_e;
 
 typedef union{
 
 	struct {
-		volatile bool rx_status : 1;         // Bit 0: Flag bit indicating if data receiving has been completed
+		volatile bool rx_status : 1;         // Bit 0: Flag bit indicating that a complete request frame is waiting for execution
 		volatile bool rx_active : 1;         // Bit 1: Flag bit indicating if data receiving is in process
-		volatile bool tx_status : 1;         // Bit 0: Flag bit indicating if data transmitting has been completed
-		volatile bool tx_active : 1;         // Bit 1: Flag bit indicating if data transmitting is in process
-		volatile unsigned : 4;					// Bit <7:4>: (reserved)
+		volatile bool tx_status : 1;         // Bit 2: Flag bit indicating if data transmitting has been completed (bus driver may be released)
+		volatile bool tx_active : 1;         // Bit 3: Flag bit indicating if data is waiting in the transmit buffer
+		volatile bool stream_polled : 1;     // Bit 4: Flag bit indicating that stream blocks are only sent on request
+		volatile unsigned : 3;					// Bit <7:5>: (reserved)
 //		volatile FLT_COMPARE_TYPE_e type: 3;	// Bit <10:8>: Fault check comparison type control bits
 		volatile unsigned : 7;					// Bit <14:8> (reserved)
 		volatile bool enabled : 1;              // Bit 15: Control bit enabling/disabling monitoring of the fault object
@@ -68,27 +183,31 @@ typedef union{
 
 typedef struct {
 	volatile UART_OBJECT_STATUS_t status; // Status word of this uart object
-    volatile MODE_COMMAND_e mode;   // Request operation mode
+    volatile UART_DRIVER_t* driver; // Pointer to uart driver object (transmit and receive ring buffers)
 	volatile uint16_t* data1;       // Pointer to the 1st variable for transmitting
 	volatile uint16_t* data2;       // Pointer to the 2nd variable for transmitting
 	volatile uint16_t* data3;       // Pointer to the 3rd variable for transmitting    
 	volatile uint16_t* data4;       // Pointer to the 4th variable for transmitting
 
-	volatile uint8_t tx_data[16];   // Encoded data for transmission
-    volatile uint8_t rx_data[4];    // Encoded received data
-    volatile uint8_t rx_checksum;   // Calculated received data checksum
-    
-    volatile uint16_t rx_decoded;   // Decoded rx data value
-	volatile uint16_t counter;		// TX/RX byte counter (for more than 1 byte)
+    volatile FRAME_RECEIVER_t rx_frame; // Request frame receiver (decoded request frame)
+    volatile uint16_t rx_length;    // Length of the request frame waiting for execution
+    volatile uint16_t rx_ignored;   // Number of frames ignored (addressed to other modules or response frames)
+    volatile uint16_t address;      // Module address on the shared serial bus
+    volatile uint16_t tx_delay;     // Number of task calls until the scheduled response is sent (0 = none)
+    volatile uint16_t tx_length;    // Length of the scheduled encoded response
+	volatile uint8_t tx_frame[FRAME_RAW_MAX];   // Response frame before encoding
+	volatile uint8_t tx_data[FRAME_ENCODED_MAX]; // Encoded response frame for transmission
+    volatile uint16_t tx_frames;    // Number of response frames sent
+    volatile uint16_t tx_stream;    // Number of stream data frames sent
 
 } UART_OBJECT_t;
 
 // Public Function Prototypes
-extern volatile uint16_t uart_calc_checksum(volatile UART_OBJECT_t* uartobj);
 extern volatile uint16_t uart_check(volatile UART_OBJECT_t* uartobj);
 
 // Public Variable Declaration
 extern volatile UART_OBJECT_t uartobj_Buck;
+extern volatile UART_DRIVER_t uartdrv_Buck;
 
 
 // PUBLIC FUNCTION PROTOTYPE DECLARATIONS
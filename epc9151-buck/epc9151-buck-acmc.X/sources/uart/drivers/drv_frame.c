@@ -0,0 +1,291 @@
+/*
+ * File:   drv_frame.c
+ * Author: M91406
+ *
+ * Created on November 23, 2020, 9:40 AM
+ */
+
+
+#include <stddef.h>
+#include "drv_frame.h"
+
+// CRC-16/CCITT nibble table (polynomial 0x1021), requires 32 bytes of program memory only
+const uint16_t frame_crc_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/*!frame_crc16()
+ *****************************************************************************
+ * Function:	 uint16_t frame_crc16(volatile uint8_t* data, volatile uint16_t length)
+ * Arguments:	 uint8_t* data, uint16_t length
+ * Return Value: Unsigned Integer (CRC)
+ *
+ * Summary:
+ * Calculates the CRC-16/CCITT-FALSE of a data block
+ *
+ * Description:
+ * The CRC is calculated nibble by nibble using a 16-entry look-up table.
+ * Polynomial 0x1021, initial value 0xFFFF, no reflection, no final XOR.
+ *
+ *****************************************************************************/
+
+uint16_t frame_crc16(volatile uint8_t* data, volatile uint16_t length)
+{
+    uint16_t _crc=0xFFFF;
+    uint16_t _i=0;
+
+    for (_i=0; _i<length; _i++)
+    {
+        _crc = (uint16_t)(_crc << 4) ^ frame_crc_table[(_crc >> 12) ^ (data[_i] >> 4)];
+        _crc = (uint16_t)(_crc << 4) ^ frame_crc_table[(_crc >> 12) ^ (data[_i] & 0x0F)];
+    }
+
+    return(_crc);
+}
+
+/*!frame_cobs_encode()
+ *****************************************************************************
+ * Function:	 uint16_t frame_cobs_encode(volatile uint8_t* src, volatile uint16_t length,
+ *                  volatile uint8_t* dst)
+ * Arguments:	 uint8_t* src, uint16_t length, uint8_t* dst
+ * Return Value: Unsigned Integer (number of encoded bytes)
+ *
+ * Summary:
+ * Encodes a data block using Consistent Overhead Byte Stuffing
+ *
+ * Description:
+ * Every zero byte of the source is replaced by the distance to the next
+ * zero byte. The encoded block does not contain any zero byte and is one
+ * byte longer per started 254 source bytes. The frame delimiter is not
+ * appended. Source and destination must not overlap.
+ *
+ *****************************************************************************/
+
+uint16_t frame_cobs_encode(volatile uint8_t* src, volatile uint16_t length, volatile uint8_t* dst)
+{
+    uint16_t _i=0;
+    uint16_t _j=1;
+    uint16_t _code_index=0;
+    uint8_t _code=1;
+
+    for (_i=0; _i<length; _i++)
+    {
+        if (src[_i] == 0)
+        {
+            dst[_code_index] = _code;
+            _code_index = _j++;
+            _code = 1;
+        }
+        else
+        {
+            dst[_j++] = src[_i];
+            _code++;
+            if (_code == 0xFF)
+            {
+                dst[_code_index] = _code;
+                _code_index = _j++;
+                _code = 1;
+            }
+        }
+    }
+
+    dst[_code_index] = _code;
+
+    return(_j);
+}
+
+/*!frame_cobs_decode()
+ *****************************************************************************
+ * Function:	 uint16_t frame_cobs_decode(volatile uint8_t* src, volatile uint16_t length,
+ *                  volatile uint8_t* dst)
+ * Arguments:	 uint8_t* src, uint16_t length, uint8_t* dst
+ * Return Value: Unsigned Integer (number of decoded bytes, 0=invalid encoding)
+ *
+ * Summary:
+ * Decodes a data block encoded with Consistent Overhead Byte Stuffing
+ *
+ * Description:
+ * The encoded block must not include the frame delimiter. Since the write
+ * index never overtakes the read index, source and destination may be the
+ * same buffer (in-place decoding).
+ *
+ *****************************************************************************/
+
+uint16_t frame_cobs_decode(volatile uint8_t* src, volatile uint16_t length, volatile uint8_t* dst)
+{
+    uint16_t _i=0;
+    uint16_t _j=0;
+    uint8_t _code=0;
+    uint8_t _k=0;
+
+    while (_i < length)
+    {
+        _code = src[_i++];
+        if (_code == 0) return(0); // zero bytes are not allowed inside a frame
+
+        for (_k=1; _k<_code; _k++)
+        {
+            if (_i >= length) return(0); // block ends before the announced zero byte
+            dst[_j++] = src[_i++];
+        }
+
+        if ((_code < 0xFF) && (_i < length))
+            dst[_j++] = 0;
+    }
+
+    return(_j);
+}
+
+/*!frame_receiver_initialize()
+ *****************************************************************************
+ * Function:	 uint16_t frame_receiver_initialize(volatile FRAME_RECEIVER_t* rx)
+ * Arguments:	 FRAME_RECEIVER_t* rx
+ * Return Value: Unsigned Integer (1=success, 0=failure)
+ *
+ * Summary:
+ * Resets a frame receiver object and its error counters
+ *
+ * Description:
+ * Bytes received before the first delimiter are discarded, since the
+ * receiver may have been started in the middle of a frame.
+ *
+ *****************************************************************************/
+
+uint16_t frame_receiver_initialize(volatile FRAME_RECEIVER_t* rx)
+{
+    if (rx == NULL) return(0);
+
+    rx->count = 0;
+    rx->discard = true;
+    rx->frames = 0;
+    rx->crc_errors = 0;
+    rx->format_errors = 0;
+    rx->overflows = 0;
+
+    return(1);
+}
+
+/*!frame_receive()
+ *****************************************************************************
+ * Function:	 uint16_t frame_receive(volatile FRAME_RECEIVER_t* rx, volatile uint8_t byte)
+ * Arguments:	 FRAME_RECEIVER_t* rx, uint8_t byte
+ * Return Value: Unsigned Integer (length of valid frame, 0=no frame completed)
+ *
+ * Summary:
+ * Adds one received byte to the frame receiver
+ *
+ * Description:
+ * When a frame delimiter completes a frame, the frame is decoded in place
+ * and validated. If the frame is valid, the decoded frame is available in
+ * the receiver buffer and its length (header, payload and CRC) is returned.
+ * The buffer contents remain valid until the next byte is added. Invalid
+ * frames are counted and dropped. Consecutive delimiters are ignored.
+ *
+ *****************************************************************************/
+
+uint16_t frame_receive(volatile FRAME_RECEIVER_t* rx, volatile uint8_t byte)
+{
+    uint16_t _count=0;
+    uint16_t _length=0;
+    uint16_t _crc=0;
+
+    if (byte == FRAME_DELIMITER)
+    {
+        _count = rx->count;
+        rx->count = 0;
+
+        if (rx->discard)
+        {
+            rx->discard = false;
+            return(0);
+        }
+        if (_count == 0)
+            return(0);
+
+        // Decode frame in place and check frame format
+        _length = frame_cobs_decode(rx->buffer, _count, rx->buffer);
+        if ((_length < (FRAME_HEADER_SIZE + FRAME_CRC_SIZE)) ||
+            (rx->buffer[FRAME_OFS_LENGTH] != (_length - FRAME_HEADER_SIZE - FRAME_CRC_SIZE)) ||
+            (rx->buffer[FRAME_OFS_VERSION] != FRAME_PROTOCOL_VERSION))
+        {
+            rx->format_errors++;
+            return(0);
+        }
+
+        // Check CRC
+        _crc = frame_crc16(rx->buffer, (_length - FRAME_CRC_SIZE));
+        if ((rx->buffer[_length - 2] != (_crc & 0xFF)) ||
+            (rx->buffer[_length - 1] != (_crc >> 8)))
+        {
+            rx->crc_errors++;
+            return(0);
+        }
+
+        rx->frames++;
+        return(_length);
+    }
+
+    if (rx->discard)
+        return(0);
+
+    if (rx->count >= FRAME_ENCODED_MAX)
+    {
+        // Frame too long, drop bytes up to the next delimiter
+        rx->overflows++;
+        rx->discard = true;
+        rx->count = 0;
+        return(0);
+    }
+
+    rx->buffer[rx->count++] = byte;
+
+    return(0);
+}
+
+/*!frame_encode()
+ *****************************************************************************
+ * Function:	 uint16_t frame_encode(volatile uint8_t* frame, volatile uint8_t address,
+ *                  volatile uint8_t request_id, volatile uint8_t command, 
+ *                  volatile uint16_t length, volatile uint8_t* dst)
+ * Arguments:	 uint8_t* frame, uint8_t address, uint8_t request_id, uint8_t command, 
+ *               uint16_t length, uint8_t* dst
+ * Return Value: Unsigned Integer (number of encoded bytes incl. delimiter, 0=failure)
+ *
+ * Summary:
+ * Completes and encodes a frame for transmission
+ *
+ * Description:
+ * The payload has to be placed in the frame buffer at FRAME_OFS_PAYLOAD by
+ * the caller. The frame header and the CRC are added to the frame buffer,
+ * which therefore must provide FRAME_RAW_MAX bytes. The encoded frame incl.
+ * frame delimiter is written to the destination buffer, which must provide
+ * FRAME_ENCODED_MAX bytes.
+ *
+ *****************************************************************************/
+
+uint16_t frame_encode(volatile uint8_t* frame, volatile uint8_t address, volatile uint8_t request_id,
+                volatile uint8_t command, volatile uint16_t length, volatile uint8_t* dst)
+{
+    uint16_t _crc=0;
+    uint16_t _size=0;
+
+    if ((frame == NULL) || (dst == NULL)) return(0);
+    if (length > FRAME_PAYLOAD_MAX) return(0);
+
+    frame[FRAME_OFS_VERSION] = FRAME_PROTOCOL_VERSION;
+    frame[FRAME_OFS_ADDRESS] = address;
+    frame[FRAME_OFS_REQUEST_ID] = request_id;
+    frame[FRAME_OFS_COMMAND] = command;
+    frame[FRAME_OFS_LENGTH] = (uint8_t)length;
+
+    _size = (FRAME_HEADER_SIZE + length);
+    _crc = frame_crc16(frame, _size);
+    frame[_size++] = (_crc & 0xFF);
+    frame[_size++] = (_crc >> 8);
+
+    _size = frame_cobs_encode(frame, _size, dst);
+    dst[_size++] = FRAME_DELIMITER;
+
+    return(_size);
+}
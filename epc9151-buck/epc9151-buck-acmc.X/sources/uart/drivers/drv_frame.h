@@ -0,0 +1,128 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/* 
+ * File:   drv_frame.h
+ * Author: M91406
+ * Comments: COBS framing and CRC-16 codec of the binary communication protocol
+ * Revision history: 
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.  
+#ifndef FRAME_CODEC_DRIVER_H
+#define	FRAME_CODEC_DRIVER_H
+
+#include <stdint.h> // include standard integer types 
+#include <stdbool.h> // include standard boolean types  
+#include <stddef.h> // include standard definitions  
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!Frame Format
+ * ***************************************************************************************************
+ * Summary:
+ * Binary frame format of the communication protocol
+ * 
+ * Description:
+ * Each frame consists of a five byte header, the payload and a CRC-16 over header and payload:
+ * 
+ *   [version] [address] [request ID] [command] [payload length] [payload ...] [CRC low] [CRC high]
+ * 
+ * Request frames carry the address of the destination module, response frames the address of the
+ * responding module. Thus several modules can share one serial bus:
+ * 
+ *   FRAME_ADDRESS_BROADCAST: request executed by all modules, never answered
+ *   FRAME_ADDRESS_ANY:       request executed and answered by every module, each response is 
+ *                            delayed by a time slot proportional to the address of the module
+ * 
+ * The CRC is calculated as CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF). All 
+ * multi-byte values are transmitted in little endian byte order. The complete frame is encoded
+ * using Consistent Overhead Byte Stuffing (COBS), which removes all zero bytes, and is terminated
+ * by a single zero byte. Thus the receiver re-synchronizes at the next delimiter after any lost 
+ * or corrupted byte.
+ * 
+ * This codec does not access any device registers and is also compiled by the host tools.
+ * 
+ * *************************************************************************************************** */
+
+#define FRAME_PROTOCOL_VERSION  0x02U   // Protocol version of this frame format
+
+#define FRAME_OFS_VERSION       0U      // Header offset of protocol version
+#define FRAME_OFS_ADDRESS       1U      // Header offset of module address (destination or source)
+#define FRAME_OFS_REQUEST_ID    2U      // Header offset of request ID (echoed in response)
+#define FRAME_OFS_COMMAND       3U      // Header offset of command code
+#define FRAME_OFS_LENGTH        4U      // Header offset of payload length
+#define FRAME_OFS_PAYLOAD       5U      // Offset of first payload byte
+
+#define FRAME_HEADER_SIZE       5U      // Number of header bytes
+#define FRAME_CRC_SIZE          2U      // Number of CRC bytes
+#define FRAME_PAYLOAD_MAX       64U     // Maximum number of payload bytes
+#define FRAME_RAW_MAX           (FRAME_HEADER_SIZE + FRAME_PAYLOAD_MAX + FRAME_CRC_SIZE) // Maximum frame size before encoding
+#define FRAME_ENCODED_MAX       (FRAME_RAW_MAX + (FRAME_RAW_MAX / 254U) + 2U) // Maximum frame size after encoding incl. delimiter
+
+#define FRAME_DELIMITER         0x00U   // Frame delimiter
+
+#define FRAME_ADDRESS_BROADCAST 0x00U   // Request address of all modules (no response)
+#define FRAME_ADDRESS_MIN       0x01U   // Lowest module address
+#define FRAME_ADDRESS_MAX       0xF7U   // Highest module address (247)
+#define FRAME_ADDRESS_ANY       0xFFU   // Request address accepted by every module
+
+/*!FRAME_RECEIVER_t
+ * ***************************************************************************************************
+ * Summary:
+ * Frame receiver object
+ * 
+ * Description:
+ * The frame receiver collects encoded bytes up to the next frame delimiter, decodes the frame in 
+ * place and validates length, protocol version and CRC. Frames exceeding the maximum frame size
+ * are discarded up to the next delimiter.
+ * 
+ * *************************************************************************************************** */
+
+typedef struct {
+    volatile uint16_t count;        // Number of encoded bytes collected of the active frame
+    volatile bool discard;          // Flag indicating that bytes are discarded up to the next delimiter
+    volatile uint16_t frames;       // Number of valid frames received
+    volatile uint16_t crc_errors;   // Number of frames received with CRC error
+    volatile uint16_t format_errors; // Number of frames with invalid encoding, length or protocol version
+    volatile uint16_t overflows;    // Number of frames exceeding the maximum frame size
+    volatile uint8_t buffer[FRAME_ENCODED_MAX]; // Frame buffer (encoded frame, decoded in place)
+} FRAME_RECEIVER_t; // Frame receiver object
+
+// Public Function Prototypes
+extern uint16_t frame_crc16(volatile uint8_t* data, volatile uint16_t length);
+extern uint16_t frame_cobs_encode(volatile uint8_t* src, volatile uint16_t length, volatile uint8_t* dst);
+extern uint16_t frame_cobs_decode(volatile uint8_t* src, volatile uint16_t length, volatile uint8_t* dst);
+
+extern uint16_t frame_receiver_initialize(volatile FRAME_RECEIVER_t* rx);
+extern uint16_t frame_receive(volatile FRAME_RECEIVER_t* rx, volatile uint8_t byte);
+extern uint16_t frame_encode(volatile uint8_t* frame, volatile uint8_t address, volatile uint8_t request_id, 
+                volatile uint8_t command, volatile uint16_t length, volatile uint8_t* dst);
+    
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* FRAME_CODEC_DRIVER_H */
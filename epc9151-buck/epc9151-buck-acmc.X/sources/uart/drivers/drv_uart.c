@@ -0,0 +1,356 @@
+/*
+ * File:   drv_uart.c
+ * Author: M91406
+ *
+ * Created on November 18, 2020, 10:05 AM
+ */
+
+
+#include <xc.h>
+#include <stddef.h>
+#include "drv_uart.h"
+
+/*!uart_ring_initialize()
+ *****************************************************************************
+ * Function:	 uint16_t uart_ring_initialize(volatile UART_RING_BUFFER_t* ring,
+ *                  volatile uint8_t* data, volatile uint16_t size)
+ * Arguments:	 UART_RING_BUFFER_t* ring, uint8_t* data, uint16_t size
+ * Return Value: Unsigned Integer (1=success, 0=failure)
+ *
+ * Summary:
+ * Binds a data array to a ring buffer and empties the buffer
+ *
+ * Description:
+ * The size of the data array must be a power of two.
+ *
+ *****************************************************************************/
+
+volatile uint16_t uart_ring_initialize(volatile UART_RING_BUFFER_t* ring,
+                volatile uint8_t* data, volatile uint16_t size)
+{
+    if ((ring == NULL) || (data == NULL)) return(0);
+    if ((size == 0) || (size & (size - 1))) return(0);
+
+    ring->data = data;
+    ring->mask = (size - 1);
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overruns = 0;
+
+    return(1);
+}
+
+/*!uart_ring_count()
+ *****************************************************************************
+ * Function:	 uint16_t uart_ring_count(volatile UART_RING_BUFFER_t* ring)
+ * Arguments:	 UART_RING_BUFFER_t* ring
+ * Return Value: Unsigned Integer
+ *
+ * Summary:
+ * Returns the number of bytes stored in a ring buffer
+ *
+ * Description:
+ * Both indices are free-running, so their difference is valid across
+ * roll-overs. This function may be called by producer and consumer.
+ *
+ *****************************************************************************/
+
+uint16_t uart_ring_count(volatile UART_RING_BUFFER_t* ring)
+{
+    return((uint16_t)(ring->head - ring->tail));
+}
+
+/*!uart_ring_free()
+ *****************************************************************************
+ * Function:	 uint16_t uart_ring_free(volatile UART_RING_BUFFER_t* ring)
+ * Arguments:	 UART_RING_BUFFER_t* ring
+ * Return Value: Unsigned Integer
+ *
+ * Summary:
+ * Returns the number of bytes which can be added to a ring buffer
+ *
+ * Description:
+ * This function may be called by producer and consumer.
+ *
+ *****************************************************************************/
+
+uint16_t uart_ring_free(volatile UART_RING_BUFFER_t* ring)
+{
+    return((uint16_t)((ring->mask + 1) - (uint16_t)(ring->head - ring->tail)));
+}
+
+/*!uart_ring_put()
+ *****************************************************************************
+ * Function:	 bool uart_ring_put(volatile UART_RING_BUFFER_t* ring, uint8_t byte)
+ * Arguments:	 UART_RING_BUFFER_t* ring, uint8_t byte
+ * Return Value: Boolean (true=byte added, false=buffer full)
+ *
+ * Summary:
+ * Adds one byte to a ring buffer (producer side)
+ *
+ * Description:
+ * The byte is written before the head index is advanced, so the consumer
+ * never reads a slot which has not been written yet. When the buffer is full,
+ * the byte is dropped and the overrun counter is incremented.
+ *
+ *****************************************************************************/
+
+bool uart_ring_put(volatile UART_RING_BUFFER_t* ring, uint8_t byte)
+{
+    if ((uint16_t)(ring->head - ring->tail) > ring->mask)
+    {
+        ring->overruns++;
+        return(false);
+    }
+
+    ring->data[ring->head & ring->mask] = byte;
+    ring->head++;
+
+    return(true);
+}
+
+/*!uart_ring_get()
+ *****************************************************************************
+ * Function:	 bool uart_ring_get(volatile UART_RING_BUFFER_t* ring, volatile uint8_t* byte)
+ * Arguments:	 UART_RING_BUFFER_t* ring, uint8_t* byte
+ * Return Value: Boolean (true=byte read, false=buffer empty)
+ *
+ * Summary:
+ * Removes one byte from a ring buffer (consumer side)
+ *
+ * Description:
+ * The byte is read before the tail index is advanced, so the producer never
+ * overwrites a slot which has not been read yet.
+ *
+ *****************************************************************************/
+
+bool uart_ring_get(volatile UART_RING_BUFFER_t* ring, volatile uint8_t* byte)
+{
+    if (ring->head == ring->tail)
+        return(false);
+
+    *byte = ring->data[ring->tail & ring->mask];
+    ring->tail++;
+
+    return(true);
+}
+
+/*!uart_driver_initialize()
+ *****************************************************************************
+ * Function:	 uint16_t uart_driver_initialize(volatile UART_DRIVER_t* driver)
+ * Arguments:	 UART_DRIVER_t* driver
+ * Return Value: Unsigned Integer (1=success, 0=failure)
+ *
+ * Summary:
+ * Initializes the ring buffers and error counters of a UART driver object
+ *
+ * Description:
+ * The transmit interrupt is disabled until data is written. Interrupt
+ * priorities and the receive interrupt are configured by the application.
+ *
+ *****************************************************************************/
+
+volatile uint16_t uart_driver_initialize(volatile UART_DRIVER_t* driver)
+{
+    volatile uint16_t retval=1;
+
+    if (driver == NULL) return(0);
+
+    _U1TXIE = 0;
+
+    retval &= uart_ring_initialize(&driver->rx, &driver->rx_data[0], UART_RX_BUFFER_SIZE);
+    retval &= uart_ring_initialize(&driver->tx, &driver->tx_data[0], UART_TX_BUFFER_SIZE);
+    driver->rx_overflows = 0;
+    driver->rx_errors = 0;
+
+    return(retval);
+}
+
+/*!uart_read()
+ *****************************************************************************
+ * Function:	 uint16_t uart_read(volatile UART_DRIVER_t* driver, volatile uint8_t* byte)
+ * Arguments:	 UART_DRIVER_t* driver, uint8_t* byte
+ * Return Value: Unsigned Integer (1=byte read, 0=no data available)
+ *
+ * Summary:
+ * Reads one received byte from the receive ring buffer
+ *
+ * Description:
+ * Non-blocking. Must only be called by a single consumer.
+ *
+ *****************************************************************************/
+
+volatile uint16_t uart_read(volatile UART_DRIVER_t* driver, volatile uint8_t* byte)
+{
+    return((uint16_t)uart_ring_get(&driver->rx, byte));
+}
+
+/*!uart_write()
+ *****************************************************************************
+ * Function:	 uint16_t uart_write(volatile UART_DRIVER_t* driver,
+ *                  volatile uint8_t* data, volatile uint16_t length)
+ * Arguments:	 UART_DRIVER_t* driver, uint8_t* data, uint16_t length
+ * Return Value: Unsigned Integer (1=data queued, 0=not enough space)
+ *
+ * Summary:
+ * Queues a block of data for transmission
+ *
+ * Description:
+ * Non-blocking. The block is either queued completely or not at all, so
+ * frames are never truncated. The transmit interrupt is enabled after the
+ * data has been queued. Since the transmit interrupt can only disable
+ * itself when it has found the buffer empty, there is no race with the
+ * interrupt service routine. Must only be called by a single producer.
+ *
+ *****************************************************************************/
+
+volatile uint16_t uart_write(volatile UART_DRIVER_t* driver, volatile uint8_t* data, volatile uint16_t length)
+{
+    volatile uint16_t _i=0;
+
+    if ((driver == NULL) || (data == NULL)) return(0);
+    if (uart_ring_free(&driver->tx) < length) return(0);
+
+    for (_i=0; _i<length; _i++)
+        uart_ring_put(&driver->tx, data[_i]);
+
+    _U1TXIE = 1; // (Re-)start transmission
+
+    return(1);
+}
+
+/*!uart_tx_free()
+ *****************************************************************************
+ * Function:	 uint16_t uart_tx_free(volatile UART_DRIVER_t* driver)
+ * Arguments:	 UART_DRIVER_t* driver
+ * Return Value: Unsigned Integer
+ *
+ * Summary:
+ * Returns the number of bytes which can be queued for transmission
+ *
+ * Description:
+ *
+ *****************************************************************************/
+
+volatile uint16_t uart_tx_free(volatile UART_DRIVER_t* driver)
+{
+    return(uart_ring_free(&driver->tx));
+}
+
+/*!uart_tx_pending()
+ *****************************************************************************
+ * Function:	 uint16_t uart_tx_pending(volatile UART_DRIVER_t* driver)
+ * Arguments:	 UART_DRIVER_t* driver
+ * Return Value: Unsigned Integer
+ *
+ * Summary:
+ * Returns the number of bytes waiting for transmission
+ *
+ * Description:
+ * Bytes already moved into the transmit FIFO are not included.
+ *
+ *****************************************************************************/
+
+volatile uint16_t uart_tx_pending(volatile UART_DRIVER_t* driver)
+{
+    return(uart_ring_count(&driver->tx));
+}
+
+/*!uart_tx_idle()
+ *****************************************************************************
+ * Function:	 uint16_t uart_tx_idle(volatile UART_DRIVER_t* driver)
+ * Arguments:	 UART_DRIVER_t* driver
+ * Return Value: Unsigned Integer (1=idle, 0=transmitting)
+ *
+ * Summary:
+ * Returns if all bytes have been shifted out
+ *
+ * Description:
+ * The transmitter is idle when the transmit ring buffer is empty and the 
+ * transmit shift register has been emptied. On half-duplex buses (RS-485)
+ * the bus driver may be released only then.
+ *
+ *****************************************************************************/
+
+volatile uint16_t uart_tx_idle(volatile UART_DRIVER_t* driver)
+{
+    return((uint16_t)((uart_ring_count(&driver->tx) == 0) && (U1STAbits.TRMT)));
+}
+
+/*!uart_rx_service()
+ *****************************************************************************
+ * Function:	 void uart_rx_service(volatile UART_DRIVER_t* driver)
+ * Arguments:	 UART_DRIVER_t* driver
+ * Return Value: (none)
+ *
+ * Summary:
+ * Moves all received bytes from the receive FIFO into the receive ring buffer
+ *
+ * Description:
+ * This function has to be called by the UART receive interrupt service
+ * routine. A receive FIFO overflow is cleared to resume reception. Bytes
+ * received with framing error are discarded. When the ring buffer is full,
+ * bytes are dropped and counted by the ring buffer overrun counter.
+ *
+ *****************************************************************************/
+
+void uart_rx_service(volatile UART_DRIVER_t* driver)
+{
+    volatile uint8_t _byte=0;
+
+    if (U1STAbits.OERR)
+    {
+        U1STAbits.OERR = 0;
+        driver->rx_overflows++;
+    }
+
+    while (!U1STAHbits.URXBE)
+    {
+        if (U1STAbits.FERR)
+        {
+            _byte = U1RXREG; // Discard byte with framing error
+            driver->rx_errors++;
+        }
+        else
+        {
+            _byte = U1RXREG;
+            uart_ring_put(&driver->rx, _byte);
+        }
+    }
+
+    _U1RXIF = 0;
+
+    return;
+}
+
+/*!uart_tx_service()
+ *****************************************************************************
+ * Function:	 void uart_tx_service(volatile UART_DRIVER_t* driver)
+ * Arguments:	 UART_DRIVER_t* driver
+ * Return Value: (none)
+ *
+ * Summary:
+ * Refills the transmit FIFO from the transmit ring buffer
+ *
+ * Description:
+ * This function has to be called by the UART transmit interrupt service
+ * routine. The transmit FIFO is filled until it is full or the ring buffer
+ * is empty. When the ring buffer is empty, the transmit interrupt is
+ * disabled until new data is queued by uart_write().
+ *
+ *****************************************************************************/
+
+void uart_tx_service(volatile UART_DRIVER_t* driver)
+{
+    volatile uint8_t _byte=0;
+
+    while ((!U1STAHbits.UTXBF) && (uart_ring_get(&driver->tx, &_byte)))
+        U1TXREG = _byte;
+
+    if (uart_ring_count(&driver->tx) == 0)
+        _U1TXIE = 0;
+
+    _U1TXIF = 0;
+
+    return;
+}
@@ -0,0 +1,120 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software 
+ * and any derivatives exclusively with Microchip products. 
+ * 
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER 
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED 
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A 
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION 
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION. 
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS 
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE 
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS 
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF 
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE 
+ * TERMS. 
+ */
+
+/* 
+ * File:   drv_uart.h
+ * Author: M91406
+ * Comments: Interrupt driven UART driver with transmit and receive ring buffers
+ * Revision history: 
+ * 1.0  initial release
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.  
+#ifndef UART_DRIVER_H
+#define	UART_DRIVER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.  
+#include <stdint.h> // include standard integer types 
+#include <stdbool.h> // include standard boolean types  
+#include <stddef.h> // include standard definitions  
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!UART_RING_BUFFER_t
+ * ***************************************************************************************************
+ * Summary:
+ * Lock-free single-producer/single-consumer byte ring buffer
+ * 
+ * Description:
+ * The head index is only written by the producer, the tail index is only written by the consumer.
+ * Both indices are free-running 16-bit counters, which are masked when the data array is accessed.
+ * Fill level and free space are derived from the difference of both indices. Since 16-bit writes
+ * are atomic, no interrupt locks are required as long as each index has a single writer. The 
+ * buffer size must be a power of two.
+ * 
+ * Receive buffer:  producer = receive interrupt, consumer = protocol layer
+ * Transmit buffer: producer = protocol layer, consumer = transmit interrupt
+ * 
+ * *************************************************************************************************** */
+
+#define UART_RX_BUFFER_SIZE     128U // Size of the receive ring buffer in bytes (power of two, >= bytes received per task period)
+#define UART_TX_BUFFER_SIZE     256U // Size of the transmit ring buffer in bytes (power of two)
+
+#if ((UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)) || (UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1)))
+  #error "UART ring buffer sizes must be powers of two"
+#endif
+
+typedef struct {
+    volatile uint16_t head;         // Write index (written by producer only)
+    volatile uint16_t tail;         // Read index (written by consumer only)
+    volatile uint16_t mask;         // Index mask (buffer size - 1)
+    volatile uint16_t overruns;     // Number of bytes dropped because the buffer was full
+    volatile uint8_t* data;         // Pointer to data array
+} UART_RING_BUFFER_t; // Ring buffer object
+
+/*!UART_DRIVER_t
+ * ***************************************************************************************************
+ * Summary:
+ * UART driver object
+ * 
+ * Description:
+ * The receive interrupt moves all bytes from the receive FIFO into the receive ring buffer. The 
+ * transmit interrupt refills the transmit FIFO from the transmit ring buffer and is disabled when
+ * the ring buffer has been emptied. Writing to the transmit ring buffer re-enables the transmit
+ * interrupt. Protocol layers only access the ring buffers and never the UART registers.
+ * 
+ * *************************************************************************************************** */
+
+typedef struct {
+    volatile UART_RING_BUFFER_t rx; // Receive ring buffer
+    volatile UART_RING_BUFFER_t tx; // Transmit ring buffer
+    volatile uint16_t rx_overflows; // Number of receive FIFO overflows (bytes lost in hardware)
+    volatile uint16_t rx_errors;    // Number of bytes received with framing error
+    volatile uint8_t rx_data[UART_RX_BUFFER_SIZE]; // Receive ring buffer data array
+    volatile uint8_t tx_data[UART_TX_BUFFER_SIZE]; // Transmit ring buffer data array
+} UART_DRIVER_t; // UART driver object
+
+// Public Function Prototypes
+extern volatile uint16_t uart_ring_initialize(volatile UART_RING_BUFFER_t* ring, 
+                volatile uint8_t* data, volatile uint16_t size);
+extern uint16_t uart_ring_count(volatile UART_RING_BUFFER_t* ring);
+extern uint16_t uart_ring_free(volatile UART_RING_BUFFER_t* ring);
+extern bool uart_ring_put(volatile UART_RING_BUFFER_t* ring, uint8_t byte);
+extern bool uart_ring_get(volatile UART_RING_BUFFER_t* ring, volatile uint8_t* byte);
+
+extern volatile uint16_t uart_driver_initialize(volatile UART_DRIVER_t* driver);
+extern volatile uint16_t uart_read(volatile UART_DRIVER_t* driver, volatile uint8_t* byte);
+extern volatile uint16_t uart_write(volatile UART_DRIVER_t* driver, volatile uint8_t* data, volatile uint16_t length);
+extern volatile uint16_t uart_tx_free(volatile UART_DRIVER_t* driver);
+extern volatile uint16_t uart_tx_pending(volatile UART_DRIVER_t* driver);
+extern volatile uint16_t uart_tx_idle(volatile UART_DRIVER_t* driver);
+
+extern void uart_rx_service(volatile UART_DRIVER_t* driver);
+extern void uart_tx_service(volatile UART_DRIVER_t* driver);
+    
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* UART_DRIVER_H */
@@ -0,0 +1,157 @@
+/*
+ * File:   app_units.c
+ * Author: M91406
+ *
+ * Created on December 1, 2020, 10:20 AM
+ */
+
+#include <stddef.h>
+
+#include "app_units.h"
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/app_power_control.h"
+
+
+/* PRIVATE FUNCTION PROTOTYPES */
+static inline uint16_t units_saturate_u16(uint32_t value);
+static inline int16_t units_saturate_s16(int32_t value);
+
+static inline uint16_t units_saturate_u16(uint32_t value)
+{
+    return((value > 0xFFFF) ? 0xFFFF : (uint16_t)value);
+}
+
+static inline int16_t units_saturate_s16(int32_t value)
+{
+    if (value > INT16_MAX) return(INT16_MAX);
+    if (value < INT16_MIN) return(INT16_MIN);
+    return((int16_t)value);
+}
+
+/* @@units_vin_mv
+ * ********************************************************************************
+ * Summary:
+ * Converts an input voltage feedback value into millivolts
+ *
+ * Parameters:
+ *  uint16_t ticks: Input voltage feedback in ADC ticks (offset removed)
+ *
+ * Returns:
+ *  Input voltage in [mV] (saturated at 65535 mV)
+ *
+ * ********************************************************************************/
+
+uint16_t units_vin_mv(uint16_t ticks)
+{
+    return(units_saturate_u16(__builtin_muluu(ticks, UNITS_VIN_FACTOR) >> UNITS_VIN_SHIFT));
+}
+
+/* @@units_vout_mv
+ * ********************************************************************************
+ * Summary:
+ * Converts an output voltage feedback value or reference into millivolts
+ *
+ * Parameters:
+ *  uint16_t ticks: Output voltage feedback or reference in ADC ticks (offset removed)
+ *
+ * Returns:
+ *  Output voltage in [mV] (saturated at 65535 mV)
+ *
+ * ********************************************************************************/
+
+uint16_t units_vout_mv(uint16_t ticks)
+{
+    return(units_saturate_u16(__builtin_muluu(ticks, UNITS_VOUT_FACTOR) >> UNITS_VOUT_SHIFT));
+}
+
+/* @@units_isns_ma
+ * ********************************************************************************
+ * Summary:
+ * Converts a phase current feedback value into milliamps
+ *
+ * Parameters:
+ *  uint16_t ticks: Phase current feedback in ADC ticks
+ *  uint16_t offset: Zero-current feedback offset in ADC ticks
+ *
+ * Returns:
+ *  Phase current in [mA], negative in reverse direction
+ *
+ * Description:
+ * The offset determined by the current sense calibration is available in 
+ * the feedback_offset of the current loop of each phase.
+ *
+ * ********************************************************************************/
+
+int16_t units_isns_ma(uint16_t ticks, uint16_t offset)
+{
+    volatile int16_t _signed = (int16_t)(ticks - offset);
+    
+    return(units_saturate_s16(__builtin_mulsu(_signed, UNITS_ISNS_FACTOR) >> UNITS_ISNS_SHIFT));
+}
+
+/* @@units_vref_ticks
+ * ********************************************************************************
+ * Summary:
+ * Converts an output voltage in millivolts into a reference value
+ *
+ * Parameters:
+ *  uint16_t millivolts: Output voltage in [mV]
+ *
+ * Returns:
+ *  Output voltage reference in ADC ticks
+ *
+ * Description:
+ * The result is not limited. Callers have to compare it against 
+ * UNITS_VREF_MAX before applying it as reference.
+ *
+ * ********************************************************************************/
+
+uint16_t units_vref_ticks(uint16_t millivolts)
+{
+    return(units_saturate_u16(__builtin_muluu(millivolts, UNITS_VREF_FACTOR) >> UNITS_VREF_SHIFT));
+}
+
+/* @@units_read
+ * ********************************************************************************
+ * Summary:
+ * Captures a snapshot of the most recent converter data in engineering units
+ *
+ * Parameters:
+ *  UNITS_DATA_t* data: Pointer to data snapshot
+ *
+ * Returns:
+ *  0: failure
+ *  1: success
+ *
+ * Description:
+ * Feedback offsets are subtracted before the conversion. Phase currents use 
+ * the calibrated offsets of the current loops, so they read zero without load
+ * once the current sense calibration has been completed.
+ *
+ * ********************************************************************************/
+
+volatile uint16_t units_read(UNITS_DATA_t* data)
+{
+    volatile int32_t _i_out=0;
+    volatile uint16_t _i=0;
+    
+    if (data == NULL) return(0);
+
+    data->v_in = units_vin_mv((buck.data.v_in > (uint16_t)buck.feedback.ad_vin.scaling.offset) ?
+                    (buck.data.v_in - (uint16_t)buck.feedback.ad_vin.scaling.offset) : 0);
+    data->v_out = units_vout_mv((buck.data.v_out > buck.v_loop.feedback_offset) ?
+                    (buck.data.v_out - buck.v_loop.feedback_offset) : 0);
+    data->v_ref = units_vout_mv(buck.set_values.v_ref);
+    
+    for (_i=0; _i<2; _i++)
+    {
+        data->i_sns[_i] = units_isns_ma(buck.data.i_sns[_i], buck.i_loop[_i].feedback_offset);
+        _i_out += data->i_sns[_i];
+    }
+    data->i_out = units_saturate_s16(_i_out);
+    data->temp = UNITS_TEMP_INVALID; // No temperature sensor assigned
+
+    return(1);
+}
+
+// end of file
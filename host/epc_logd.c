@@ -0,0 +1,696 @@
+/*
+ * File:   epc_logd.c
+ * Author: M91406
+ *
+ * Created on November 27, 2020, 2:40 PM
+ *
+ * Telemetry logger streaming one or more EPC9151 modules into a binary log:
+ *
+ *   epc_logd [-b baudrate] [-c channels] [-d decimation] [-f control_hz] [-o file] [-s seconds]
+ *            device[@address] [device[@address]...]
+ *   epc_logd -x file [-m module]
+ *
+ *   -c channels    comma separated telemetry channel IDs (default 0,2,3)
+ *   -d decimation  control cycles per sample (default: minimum for the number of channels)
+ *   -f control_hz  control interrupt frequency of the modules (default 500000)
+ *   -o file        binary log file (default epc_log.bin)
+ *   -s seconds     recording time (default 0 = until SIGINT/SIGTERM)
+ *   -x file        export binary log as CSV to stdout, all modules merged in time order
+ *   -m module      export a single module with one column per channel
+ *
+ * Modules given as device@address share one serial bus (e.g. RS-485). Their streams are 
+ * started in polled mode and the logger requests the stream blocks from one module after the
+ * other, so only one module transmits at a time. Without decimation option, the decimation
+ * of these modules is raised until all modules of the bus can be polled in time.
+ *
+ * Log file format (little endian):
+ *
+ *   File header:   "EPCL", version (16 bit), number of modules (16 bit)
+ *   Module header: device name (32 bytes), number of channels (8 bit), channel IDs (8x 8 bit),
+ *                  reserved (8 bit), decimation (16 bit), sample period in [ns] (double)
+ *   Block:         "EPCB", module (16 bit), number of samples n (16 bit), sample number of the
+ *                  first sample (64 bit), time of the first sample in [ns] since the epoch
+ *                  (64 bit), followed by one column of n samples (16 bit) per channel
+ *
+ * Each block holds consecutive samples of one module. Lost samples start a new block.
+ * Sample times are aligned across modules by estimating the time offset of each module
+ * clock from the arrival time of its frames (minimum latency estimate, see logd_align()).
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include "epc_proto.h"
+#include "epc_serial.h"
+
+#define LOGD_MODULES_MAX    16      // maximum number of modules
+#define LOGD_CHANNELS_MAX   8       // maximum number of channels per module (TELEM_CHANNELS_MAX)
+#define LOGD_BLOCK_SAMPLES  1024    // maximum number of samples per block
+#define LOGD_FILE_VERSION   1
+#define LOGD_DRIFT_PPM      100.0   // maximum clock drift between module and host
+#define LOGD_POLL_NS        3.0e6   // worst case round trip of one stream poll (uart task period, frame transmission, adapter latency)
+#define LOGD_FRAME_BYTES(ch, n) (FRAME_HEADER_SIZE + 4 + (2 * (ch) * (n)) + FRAME_CRC_SIZE + 2) // encoded frame size estimate
+
+static const char* logd_channel_name[] = {
+    "v_out", "v_in", "i_sns1", "i_sns2", "i_out", "temp", "v_ref", "v_loop_ref",
+    "v_loop_out1", "v_loop_out2", "i_loop1_out", "i_loop2_out", "mode", "status",
+    "fault_status", "fault_active", "v_loop_sat", "i_loop1_sat", "i_loop2_sat"
+};
+#define LOGD_CHANNEL_COUNT  (sizeof(logd_channel_name) / sizeof(logd_channel_name[0]))
+
+/*!LOGD_MODULE_t
+ * Recording state of one module
+ */
+typedef struct {
+    EPC_LINK_t* link;           // serial link (shared by all modules of a bus)
+    const char* device;         // device name (incl. address)
+    int address;                // module address on a shared bus (-1 = point-to-point, stream not polled)
+    int index;                  // module number in the log file
+    uint16_t decimation;        // control cycles per sample
+    double period_ns;           // sample period in [ns]
+    double frame_ns;            // transmission time of one stream frame in [ns]
+    bool synchronized;          // first stream frame has been received
+    uint16_t next_index;        // expected sample index of the next frame (16 bit, module)
+    uint64_t next_sample;       // expected sample number of the next frame (unwrapped)
+    double offset_ns;           // estimated host time of sample number 0
+    int64_t last_rx_ns;         // arrival time of the previous frame
+    uint64_t samples;           // number of samples received
+    uint64_t lost;              // number of samples lost (module or link)
+    uint64_t block_first;       // sample number of the first sample in the block buffer
+    uint16_t block_count;       // number of samples in the block buffer
+    uint16_t block[LOGD_CHANNELS_MAX][LOGD_BLOCK_SAMPLES]; // block buffer (columns)
+} LOGD_MODULE_t;
+
+typedef struct {
+    FILE* file;                 // binary log
+    int channels;               // number of channels (all modules)
+    uint8_t channel[LOGD_CHANNELS_MAX]; // channel IDs
+    int64_t realtime_offset_ns; // CLOCK_REALTIME - CLOCK_MONOTONIC
+    double control_hz;          // control interrupt frequency
+    uint32_t baudrate;          // link baud rate
+} LOGD_CONTEXT_t;
+
+static LOGD_CONTEXT_t logd;
+static volatile sig_atomic_t logd_stop = 0;
+
+static void logd_signal(int signal)
+{
+    (void)signal;
+    logd_stop = 1;
+}
+
+static int64_t logd_time_ns(clockid_t clock)
+{
+    struct timespec _ts;
+
+    clock_gettime(clock, &_ts);
+    return(((int64_t)_ts.tv_sec * 1000000000LL) + _ts.tv_nsec);
+}
+
+static void logd_put(uint8_t* dst, uint64_t value, int bytes)
+{
+    int _i=0;
+
+    for (_i=0; _i<bytes; _i++)
+        dst[_i] = (uint8_t)(value >> (8 * _i));
+}
+
+static uint64_t logd_get(const uint8_t* src, int bytes)
+{
+    uint64_t _value=0;
+    int _i=0;
+
+    for (_i=0; _i<bytes; _i++)
+        _value |= ((uint64_t)src[_i] << (8 * _i));
+    return(_value);
+}
+
+/*!logd_write_block()
+ *****************************************************************************
+ * Summary:
+ * Writes the block buffer of a module to the log file
+ *
+ * Description:
+ * The time of the first sample is calculated with the most recent offset
+ * estimate, which is at least as accurate as the estimate available when the
+ * samples were received.
+ *
+ *****************************************************************************/
+
+static void logd_write_block(LOGD_MODULE_t* module)
+{
+    uint8_t _header[24];
+    uint8_t _column[2 * LOGD_BLOCK_SAMPLES];
+    int64_t _time=0;
+    int _c=0, _s=0;
+
+    if ((module->block_count == 0) || (logd.file == NULL))
+        return;
+
+    _time = (int64_t)(module->offset_ns + ((double)module->block_first * module->period_ns)) +
+            logd.realtime_offset_ns;
+
+    memcpy(_header, "EPCB", 4);
+    logd_put(&_header[4], (uint64_t)module->index, 2);
+    logd_put(&_header[6], module->block_count, 2);
+    logd_put(&_header[8], module->block_first, 8);
+    logd_put(&_header[16], (uint64_t)_time, 8);
+    fwrite(_header, 1, sizeof(_header), logd.file);
+
+    for (_c=0; _c<logd.channels; _c++)
+    {
+        for (_s=0; _s<module->block_count; _s++)
+            logd_put(&_column[2 * _s], module->block[_c][_s], 2);
+        fwrite(_column, 2, module->block_count, logd.file);
+    }
+
+    module->block_count = 0;
+}
+
+/*!logd_align()
+ *****************************************************************************
+ * Summary:
+ * Updates the time offset estimate of a module
+ *
+ * Description:
+ * A frame cannot arrive before its last sample has been taken and the frame
+ * has been transmitted. Each frame therefore provides an upper bound of the
+ * host time of sample number 0. The smallest bound is the best estimate;
+ * it is allowed to rise at the maximum clock drift rate, so the estimate
+ * follows slow drift between module and host clock.
+ *
+ *****************************************************************************/
+
+static void logd_align(LOGD_MODULE_t* module, uint64_t last_sample, int64_t rx_ns)
+{
+    double _bound = ((double)rx_ns - module->frame_ns - ((double)last_sample * module->period_ns));
+
+    if (module->last_rx_ns == 0)
+        module->offset_ns = _bound;
+    else
+        module->offset_ns += ((double)(rx_ns - module->last_rx_ns) * LOGD_DRIFT_PPM * 1.0e-6);
+
+    if (_bound < module->offset_ns)
+        module->offset_ns = _bound;
+    module->last_rx_ns = rx_ns;
+}
+
+static void logd_frame(const EPC_FRAME_t* frame, void* context)
+{
+    LOGD_MODULE_t* _module = (LOGD_MODULE_t*)context;
+    uint16_t _index=0;
+    uint16_t _gap=0;
+    int _samples=0;
+    int _s=0, _c=0;
+
+    if (((frame->command != (EPC_CMD_STREAM_DATA | EPC_RESPONSE_FLAG)) &&
+         (frame->command != (EPC_CMD_STREAM_POLL | EPC_RESPONSE_FLAG))) || (frame->length < 4))
+        return;
+
+    _samples = frame->payload[1];
+    _index = epc_get_u16(&frame->payload[2]);
+    if ((_samples == 0) || (frame->length < (4 + (2 * _samples * logd.channels))))
+        return;
+
+    // Unwrap sample index, start a new block after lost samples
+    if (!_module->synchronized)
+    {
+        _module->synchronized = true;
+        _module->next_sample = 0;
+    }
+    else if ((_gap = (uint16_t)(_index - _module->next_index)) != 0)
+    {
+        logd_write_block(_module);
+        _module->lost += _gap;
+        _module->next_sample += _gap;
+    }
+    _module->next_index = (uint16_t)(_index + _samples);
+
+    if (_module->block_count == 0)
+        _module->block_first = _module->next_sample;
+
+    for (_s=0; _s<_samples; _s++)
+    {
+        for (_c=0; _c<logd.channels; _c++)
+            _module->block[_c][_module->block_count] = epc_get_u16(&frame->payload[4 + (2 * ((_s * logd.channels) + _c))]);
+        if (++_module->block_count >= LOGD_BLOCK_SAMPLES)
+        {
+            logd_write_block(_module);
+            _module->block_first = (_module->next_sample + (uint64_t)_s + 1);
+        }
+    }
+
+    _module->next_sample += (uint64_t)_samples;
+    _module->samples += (uint64_t)_samples;
+    logd_align(_module, (_module->next_sample - 1), logd_time_ns(CLOCK_MONOTONIC));
+}
+
+static void logd_write_header(LOGD_MODULE_t* module, int count)
+{
+    uint8_t _header[8];
+    uint8_t _module[52];
+    int _m=0;
+
+    memcpy(_header, "EPCL", 4);
+    logd_put(&_header[4], LOGD_FILE_VERSION, 2);
+    logd_put(&_header[6], (uint64_t)count, 2);
+    fwrite(_header, 1, sizeof(_header), logd.file);
+
+    for (_m=0; _m<count; _m++)
+    {
+        memset(_module, 0, sizeof(_module));
+        strncpy((char*)_module, module[_m].device, 31);
+        _module[32] = (uint8_t)logd.channels;
+        memcpy(&_module[33], logd.channel, (size_t)logd.channels);
+        logd_put(&_module[42], module[_m].decimation, 2);
+        memcpy(&_module[44], &module[_m].period_ns, 8);
+        fwrite(_module, 1, sizeof(_module), logd.file);
+    }
+}
+
+/*!logd_export()
+ *****************************************************************************
+ * Summary:
+ * Exports a binary log file as CSV
+ *
+ * Description:
+ * All blocks are loaded into memory. Without module selection, the samples
+ * of all modules are merged in time order, one sample per line with time,
+ * module, sample number and channel values. With module selection, only the
+ * samples of this module are exported with named channel columns.
+ *
+ *****************************************************************************/
+
+typedef struct {
+    int64_t time_ns;
+    uint64_t sample;
+    uint16_t value[LOGD_CHANNELS_MAX];
+} LOGD_SAMPLE_t;
+
+typedef struct {
+    char device[33];
+    int channels;
+    uint8_t channel[LOGD_CHANNELS_MAX];
+    double period_ns;
+    LOGD_SAMPLE_t* sample;
+    size_t count;
+    size_t size;
+    size_t next;
+} LOGD_TRACK_t;
+
+static int logd_export(const char* filename, int select)
+{
+    LOGD_TRACK_t _track[LOGD_MODULES_MAX];
+    uint8_t _buffer[52];
+    uint8_t _column[2 * LOGD_BLOCK_SAMPLES];
+    LOGD_TRACK_t* _t;
+    LOGD_SAMPLE_t* _smp;
+    FILE* _file;
+    uint64_t _first=0;
+    int64_t _time=0;
+    int64_t _start=INT64_MAX;
+    int _modules=0;
+    int _m=0, _c=0, _n=0, _s=0, _best=0;
+
+    _file = fopen(filename, "rb");
+    if (_file == NULL)
+    {
+        perror(filename);
+        return(1);
+    }
+
+    if ((fread(_buffer, 1, 8, _file) != 8) || memcmp(_buffer, "EPCL", 4) ||
+        (logd_get(&_buffer[4], 2) != LOGD_FILE_VERSION) ||
+        ((_modules = (int)logd_get(&_buffer[6], 2)) > LOGD_MODULES_MAX))
+    {
+        fprintf(stderr, "%s: invalid log file\n", filename);
+        fclose(_file);
+        return(1);
+    }
+
+    memset(_track, 0, sizeof(_track));
+    for (_m=0; _m<_modules; _m++)
+    {
+        if (fread(_buffer, 1, 52, _file) != 52)
+            break;
+        memcpy(_track[_m].device, _buffer, 32);
+        _track[_m].channels = _buffer[32];
+        if (_track[_m].channels > LOGD_CHANNELS_MAX)
+            _track[_m].channels = LOGD_CHANNELS_MAX;
+        memcpy(_track[_m].channel, &_buffer[33], LOGD_CHANNELS_MAX);
+        memcpy(&_track[_m].period_ns, &_buffer[44], 8);
+    }
+
+    // Load all blocks
+    while (fread(_buffer, 1, 24, _file) == 24)
+    {
+        if (memcmp(_buffer, "EPCB", 4) || ((_m = (int)logd_get(&_buffer[4], 2)) >= _modules))
+        {
+            fprintf(stderr, "%s: corrupted block\n", filename);
+            break;
+        }
+        _t = &_track[_m];
+        _n = (int)logd_get(&_buffer[6], 2);
+        _first = logd_get(&_buffer[8], 8);
+        _time = (int64_t)logd_get(&_buffer[16], 8);
+        if (_n > LOGD_BLOCK_SAMPLES)
+            break;
+
+        if ((_t->count + (size_t)_n) > _t->size)
+        {
+            _t->size = ((_t->count + (size_t)_n) * 2);
+            _t->sample = realloc(_t->sample, _t->size * sizeof(LOGD_SAMPLE_t));
+            if (_t->sample == NULL)
+            {
+                fprintf(stderr, "out of memory\n");
+                return(1);
+            }
+        }
+        for (_s=0; _s<_n; _s++)
+        {
+            _smp = &_t->sample[_t->count + (size_t)_s];
+            _smp->sample = (_first + (uint64_t)_s);
+            _smp->time_ns = (_time + (int64_t)((double)_s * _t->period_ns));
+        }
+        for (_c=0; _c<_t->channels; _c++)
+        {
+            if (fread(_column, 2, (size_t)_n, _file) != (size_t)_n)
+                break;
+            for (_s=0; _s<_n; _s++)
+                _t->sample[_t->count + (size_t)_s].value[_c] = (uint16_t)logd_get(&_column[2 * _s], 2);
+        }
+        _t->count += (size_t)_n;
+        if ((_n > 0) && (_time < _start))
+            _start = _time;
+    }
+    fclose(_file);
+
+    for (_m=0; _m<_modules; _m++)
+    {
+        printf("# module %d: %s, sample period %.1f ns, channels", _m, _track[_m].device, _track[_m].period_ns);
+        for (_c=0; _c<_track[_m].channels; _c++)
+            printf(" %s", (_track[_m].channel[_c] < LOGD_CHANNEL_COUNT) ?
+                logd_channel_name[_track[_m].channel[_c]] : "?");
+        printf(", %zu samples\n", _track[_m].count);
+    }
+    printf("# time in [s] relative to %.9f (epoch)\n", (double)_start * 1.0e-9);
+
+    if (select >= 0)
+    {
+        if (select >= _modules)
+            return(1);
+        _t = &_track[select];
+        printf("time,sample");
+        for (_c=0; _c<_t->channels; _c++)
+            printf(",%s", (_t->channel[_c] < LOGD_CHANNEL_COUNT) ? logd_channel_name[_t->channel[_c]] : "?");
+        printf("\n");
+        for (_t->next=0; _t->next<_t->count; _t->next++)
+        {
+            _smp = &_t->sample[_t->next];
+            printf("%.9f,%llu", (double)(_smp->time_ns - _start) * 1.0e-9, (unsigned long long)_smp->sample);
+            for (_c=0; _c<_t->channels; _c++)
+                printf(",%u", _smp->value[_c]);
+            printf("\n");
+        }
+    }
+    else
+    {
+        // Merge all modules in time order
+        printf("time,module,sample");
+        for (_c=0; (_modules > 0) && (_c<_track[0].channels); _c++)
+            printf(",value%d", _c + 1);
+        printf("\n");
+        while (1)
+        {
+            _best = -1;
+            for (_m=0; _m<_modules; _m++)
+            {
+                if (_track[_m].next >= _track[_m].count)
+                    continue;
+                if ((_best < 0) || (_track[_m].sample[_track[_m].next].time_ns <
+                                    _track[_best].sample[_track[_best].next].time_ns))
+                    _best = _m;
+            }
+            if (_best < 0)
+                break;
+
+            _t = &_track[_best];
+            _smp = &_t->sample[_t->next++];
+            printf("%.9f,%d,%llu", (double)(_smp->time_ns - _start) * 1.0e-9, _best, (unsigned long long)_smp->sample);
+            for (_c=0; _c<_t->channels; _c++)
+                printf(",%u", _smp->value[_c]);
+            printf("\n");
+        }
+    }
+
+    for (_m=0; _m<_modules; _m++)
+        free(_track[_m].sample);
+
+    return(0);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: epc_logd [-b baudrate] [-c channels] [-d decimation] [-f control_hz] [-o file] [-s seconds]\n"
+        "                device[@address] [device[@address]...]\n"
+        "       epc_logd -x file [-m module]\n");
+    exit(2);
+}
+
+int main(int argc, char** argv)
+{
+    static LOGD_MODULE_t _module[LOGD_MODULES_MAX];
+    static EPC_LINK_t _link[LOGD_MODULES_MAX];
+    const char* _device[LOGD_MODULES_MAX];
+    static char _name[LOGD_MODULES_MAX][64];
+    char* _at = NULL;
+    int _links=0;
+    int _shared=0;
+    int _polled=0;
+    double _poll=0.0;
+    int _l=0;
+    const char* _output = "epc_log.bin";
+    const char* _export = NULL;
+    char* _token = NULL;
+    uint8_t _req[FRAME_PAYLOAD_MAX];
+    uint8_t _rx[4096];
+    struct pollfd _pfd[LOGD_MODULES_MAX];
+    LOGD_MODULE_t* _stream[LOGD_MODULES_MAX];
+    int _streams=0;
+    EPC_FRAME_t _rsp;
+    int64_t _end=0;
+    uint16_t _decimation=0;
+    uint16_t _dropped=0;
+    ssize_t _n=0;
+    int _count=0;
+    int _select=-1;
+    int _status=0;
+    int _opt=0;
+    int _m=0;
+
+    memset(&logd, 0, sizeof(logd));
+    logd.channels = 3;
+    logd.channel[0] = 0;    // v_out
+    logd.channel[1] = 2;    // i_sns1
+    logd.channel[2] = 3;    // i_sns2
+    logd.control_hz = 500000.0;
+    logd.baudrate = EPC_SERIAL_BAUDRATE;
+
+    while ((_opt = getopt(argc, argv, "b:c:d:f:o:s:x:m:")) != -1)
+    {
+        switch (_opt)
+        {
+            case 'b': logd.baudrate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c':
+                logd.channels = 0;
+                for (_token = strtok(optarg, ","); (_token != NULL) && (logd.channels < LOGD_CHANNELS_MAX);
+                     _token = strtok(NULL, ","))
+                    logd.channel[logd.channels++] = (uint8_t)strtoul(_token, NULL, 0);
+                break;
+            case 'd': _decimation = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 'f': logd.control_hz = atof(optarg); break;
+            case 'o': _output = optarg; break;
+            case 's': _end = (int64_t)(atof(optarg) * 1.0e9); break;
+            case 'x': _export = optarg; break;
+            case 'm': _select = atoi(optarg); break;
+            default: usage();
+        }
+    }
+    argc -= optind;
+    argv += optind;
+
+    if (_export != NULL)
+        return(logd_export(_export, _select));
+
+    if ((argc < 1) || (argc > LOGD_MODULES_MAX) || (logd.channels == 0))
+        usage();
+    _count = argc;
+
+    signal(SIGINT, logd_signal);
+    signal(SIGTERM, logd_signal);
+
+    // Open links (once per device) and configure streams
+    for (_m=0; _m<_count; _m++)
+    {
+        _module[_m].device = argv[_m];
+        _module[_m].index = _m;
+        _module[_m].address = -1;
+        strncpy(_name[_m], argv[_m], (sizeof(_name[_m]) - 1));
+        if ((_at = strchr(_name[_m], '@')) != NULL)
+        {
+            *_at = 0;
+            _module[_m].address = (int)strtoul(&_at[1], NULL, 0);
+            if ((_module[_m].address < (int)FRAME_ADDRESS_MIN) || (_module[_m].address > (int)FRAME_ADDRESS_MAX))
+                usage();
+            _polled++;
+        }
+
+        for (_l=0; (_l<_links) && strcmp(_device[_l], _name[_m]); _l++);
+        if (_l == _links)
+        {
+            _status = epc_serial_open(_name[_m], logd.baudrate);
+            if (_status < 0)
+            {
+                perror(_name[_m]);
+                return(1);
+            }
+            epc_link_init(&_link[_l], _status);
+            _device[_l] = _name[_m];
+            _links++;
+        }
+        _module[_m].link = &_link[_l];
+    }
+
+    for (_m=0; _m<_count; _m++)
+    {
+        _module[_m].link->address = ((_module[_m].address < 0) ? FRAME_ADDRESS_ANY : (uint8_t)_module[_m].address);
+        for (_l=0, _shared=0; _l<_count; _l++)
+            _shared += (_module[_l].link == _module[_m].link);
+
+        epc_put_u16(&_req[0], _decimation);
+        memcpy(&_req[2], logd.channel, (size_t)logd.channels);
+        _status = epc_transact(_module[_m].link, EPC_CMD_STREAM_CONFIG, _req, (size_t)(2 + logd.channels), &_rsp, 200);
+        if ((_status == EPC_STATUS_REJECTED) && (_rsp.length >= 4) && (_decimation == 0))
+        {
+            // Use minimum decimation supported by the link, shared by all modules of a bus
+            epc_put_u16(&_req[0], (uint16_t)(epc_get_u16(&_rsp.payload[2]) * _shared));
+            if ((_module[_m].address >= 0) && (_rsp.payload[1] > 0))
+            {
+                // each module of the bus is polled once per poll round
+                _poll = ((double)_shared * LOGD_POLL_NS * logd.control_hz * 1.0e-9 / (double)_rsp.payload[1]) + 1.0;
+                if (_poll > (double)epc_get_u16(&_req[0]))
+                    epc_put_u16(&_req[0], (uint16_t)((_poll < 65535.0) ? _poll : 65535.0));
+            }
+            _status = epc_transact(_module[_m].link, EPC_CMD_STREAM_CONFIG, _req, (size_t)(2 + logd.channels), &_rsp, 200);
+        }
+        if (_status != EPC_STATUS_OK)
+        {
+            fprintf(stderr, "%s: stream configuration failed (%s)\n", argv[_m],
+                (_status < 0) ? "no response" : epc_status_text((uint8_t)_status));
+            return(1);
+        }
+
+        _module[_m].decimation = epc_get_u16(&_req[0]);
+        _module[_m].period_ns = ((double)_module[_m].decimation * 1.0e9 / logd.control_hz);
+        _module[_m].frame_ns = ((double)LOGD_FRAME_BYTES(logd.channels, _rsp.payload[1]) * 10.0e9 / (double)logd.baudrate);
+        fprintf(stderr, "%s: decimation %u, sample rate %.1f Hz, %u samples per frame%s\n", argv[_m],
+            _module[_m].decimation, (1.0e9 / _module[_m].period_ns), _rsp.payload[1],
+            ((_module[_m].address < 0) ? "" : ", polled"));
+    }
+
+    // Streams of point-to-point links are received by polling their ports
+    for (_m=0, _n=0; _m<_count; _m++)
+    {
+        if (_module[_m].address >= 0)
+            continue;
+        _pfd[_n].fd = _module[_m].link->fd;
+        _pfd[_n].events = POLLIN;
+        _stream[_n++] = &_module[_m];
+    }
+    _streams = (int)_n;
+
+    logd.file = fopen(_output, "wb");
+    if (logd.file == NULL)
+    {
+        perror(_output);
+        return(1);
+    }
+    logd_write_header(_module, _count);
+    logd.realtime_offset_ns = (logd_time_ns(CLOCK_REALTIME) - logd_time_ns(CLOCK_MONOTONIC));
+
+    for (_m=0; _m<_count; _m++)
+    {
+        _module[_m].link->address = ((_module[_m].address < 0) ? FRAME_ADDRESS_ANY : (uint8_t)_module[_m].address);
+        _req[0] = ((_module[_m].address < 0) ? 1 : 2); // start, start polled
+        if (epc_transact(_module[_m].link, EPC_CMD_STREAM_CONTROL, _req, 1, &_rsp, 200) != EPC_STATUS_OK)
+            fprintf(stderr, "%s: stream start failed\n", _module[_m].device);
+    }
+    if (_end > 0)
+        _end += logd_time_ns(CLOCK_MONOTONIC);
+
+    // Poll stream blocks of bus modules in turn and decode stream frames of all other modules
+    while ((!logd_stop) && ((_end == 0) || (logd_time_ns(CLOCK_MONOTONIC) < _end)))
+    {
+        for (_m=0; _m<_count; _m++)
+        {
+            if (_module[_m].address < 0)
+                continue;
+            // read both stream blocks of the module if ready
+            _module[_m].link->address = (uint8_t)_module[_m].address;
+            for (_l=0; _l<2; _l++)
+            {
+                if ((epc_transact(_module[_m].link, EPC_CMD_STREAM_POLL, NULL, 0, &_rsp, 50) != EPC_STATUS_OK) ||
+                    (_rsp.length < 4) || (_rsp.payload[1] == 0))
+                    break;
+                logd_frame(&_rsp, &_module[_m]);
+            }
+        }
+
+        _n = poll(_pfd, (nfds_t)_streams, ((_polled > 0) ? 0 : 100));
+        if (_n < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if ((_n == 0) && (_streams == 0))
+            usleep(1000); // no point-to-point streams, wait before next poll round
+
+        for (_m=0; _m<_streams; _m++)
+        {
+            if (!(_pfd[_m].revents & POLLIN))
+                continue;
+            _n = read(_pfd[_m].fd, _rx, sizeof(_rx));
+            if (_n > 0)
+                epc_decoder_feed(&_stream[_m]->link->decoder, _rx, (size_t)_n, logd_frame, _stream[_m]);
+        }
+    }
+
+    // Stop streams, flush block buffers and report statistics
+    for (_m=0; _m<_count; _m++)
+    {
+        _module[_m].link->address = ((_module[_m].address < 0) ? FRAME_ADDRESS_ANY : (uint8_t)_module[_m].address);
+        _req[0] = 0; // stop
+        _dropped = 0;
+        if (epc_transact(_module[_m].link, EPC_CMD_STREAM_CONTROL, _req, 1, &_rsp, 200) == EPC_STATUS_OK)
+            _dropped = epc_get_u16(&_rsp.payload[3]);
+        logd_write_block(&_module[_m]);
+
+        fprintf(stderr, "%s: %llu samples, %llu lost (%u dropped by module), %u invalid frames\n",
+            _module[_m].device, (unsigned long long)_module[_m].samples, (unsigned long long)_module[_m].lost,
+            _dropped, _module[_m].link->decoder.errors);
+    }
+    for (_l=0; _l<_links; _l++)
+        epc_serial_close(_link[_l].fd);
+    fclose(logd.file);
+
+    return(0);
+}
@@ -0,0 +1,329 @@
+/*
+ * File:   epc_pmbus.c
+ * Author: M91406
+ *
+ * Created on November 29, 2020, 4:40 PM
+ *
+ * PMBus system manager client of an EPC9151 module. Transactions are either
+ * tunneled through the UART protocol or executed on the I2C bus stand-in of 
+ * the firmware simulation:
+ *
+ *   epc_pmbus [-d device | -i socket] [-a address] [-m module] [-p] [-b baudrate] [-t timeout_ms] command [arguments]
+ *
+ *   -d device   UART port of the module (default /dev/ttyACM0)
+ *   -i socket   I2C bus stand-in of epc_sim
+ *   -a address  7-bit slave address on the I2C bus stand-in (default 0x40)
+ *   -m module   module address on a shared UART bus (0 = broadcast writes, default 255 = any)
+ *   -p          use packet error checking on the I2C bus stand-in
+ *
+ *   read-vin | read-vout | read-iout | read-temp     read measurement in engineering units
+ *   status                                          read and decode STATUS_WORD and STATUS_CML
+ *   operation [on|off]                              read or write OPERATION
+ *   vout [volts]                                    read or write VOUT_COMMAND
+ *   clear                                           CLEAR_FAULTS
+ *   read <code> <bytes> | write <code> [byte...]    raw transaction
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+
+#include "epc_proto.h"
+#include "epc_serial.h"
+
+#define PMBUS_OPERATION         0x01U
+#define PMBUS_CLEAR_FAULTS      0x03U
+#define PMBUS_VOUT_MODE         0x20U
+#define PMBUS_VOUT_COMMAND      0x21U
+#define PMBUS_STATUS_WORD       0x79U
+#define PMBUS_STATUS_CML        0x7EU
+#define PMBUS_READ_VIN          0x88U
+#define PMBUS_READ_VOUT         0x8BU
+#define PMBUS_READ_IOUT         0x8CU
+#define PMBUS_READ_TEMPERATURE_1 0x8DU
+
+typedef struct {
+    EPC_LINK_t link;        // UART protocol link (device)
+    int socket;             // I2C bus stand-in (socket), -1 = not used
+    uint8_t address;        // 7-bit slave address
+    bool pec;               // packet error checking
+    int timeout;            // response timeout in [ms]
+} PMBUS_MASTER_t;
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: epc_pmbus [-d device | -i socket] [-a address] [-m module] [-p] [-b baudrate] [-t timeout_ms] command [arguments]\n"
+        "  read-vin | read-vout | read-iout | read-temp | status | clear\n"
+        "  operation [on|off] | vout [volts] | read <code> <bytes> | write <code> [byte...]\n");
+    exit(2);
+}
+
+/*!smbus_pec()
+ *****************************************************************************
+ * Summary:
+ * Updates the SMBus packet error code (CRC-8, polynomial x^8 + x^2 + x + 1)
+ *****************************************************************************/
+
+static uint8_t smbus_pec(uint8_t pec, const uint8_t* data, size_t length)
+{
+    int _bit=0;
+
+    while (length--)
+    {
+        pec ^= *data++;
+        for (_bit=0; _bit<8; _bit++)
+            pec = ((pec & 0x80) ? (uint8_t)((pec << 1) ^ 0x07) : (uint8_t)(pec << 1));
+    }
+
+    return(pec);
+}
+
+/*!pmbus_transact()
+ *****************************************************************************
+ * Summary:
+ * Executes a PMBus write (read_length = 0) or read transaction
+ *
+ * Description:
+ * Returns the number of data bytes read, 0 for completed write transactions
+ * or -1 when the transaction has not been acknowledged.
+ *
+ *****************************************************************************/
+
+static int pmbus_transact(PMBUS_MASTER_t* pmb, uint8_t command, const uint8_t* data, 
+                size_t length, uint8_t* rx, size_t read_length)
+{
+    uint8_t _msg[16];
+    uint8_t _rsp[16];
+    uint8_t _addr=0;
+    uint8_t _pec=0;
+    EPC_FRAME_t _frame;
+    ssize_t _n=0;
+    int _status=0;
+
+    if (pmb->socket < 0)
+    {
+        // UART protocol tunnel
+        _msg[0] = command;
+        if (length > 0) memcpy(&_msg[1], data, length);
+        if (read_length == 0)
+            _status = epc_transact(&pmb->link, EPC_CMD_PMBUS_WRITE, _msg, (1 + length), &_frame, pmb->timeout);
+        else
+            _status = epc_transact(&pmb->link, EPC_CMD_PMBUS_READ, _msg, 1, &_frame, pmb->timeout);
+        if (_status != EPC_STATUS_OK) return(-1);
+        if (read_length == 0) return(0);
+        if ((size_t)(_frame.length - 1) != read_length) return(-1);
+        memcpy(rx, &_frame.payload[1], read_length);
+        return((int)read_length);
+    }
+
+    // I2C bus stand-in: [address][flags][write count][read count][command][data][PEC]
+    _msg[0] = pmb->address;
+    _msg[1] = (pmb->pec ? 0x01 : 0x00);
+    _msg[2] = (uint8_t)(1 + length);
+    _msg[3] = (uint8_t)(read_length + ((pmb->pec && read_length) ? 1 : 0));
+    _msg[4] = command;
+    if (length > 0) memcpy(&_msg[5], data, length);
+    _addr = (uint8_t)(pmb->address << 1);
+    _pec = smbus_pec(smbus_pec(0, &_addr, 1), &_msg[4], (1 + length));
+    if (pmb->pec && (read_length == 0))
+    {
+        _msg[5 + length] = _pec; // PEC of write transactions is sent by the master
+        _msg[2]++;
+    }
+
+    if (send(pmb->socket, _msg, (size_t)(4 + _msg[2]), 0) < 0) return(-1);
+    _n = recv(pmb->socket, _rsp, sizeof(_rsp), 0);
+    if ((_n < 1) || (_rsp[0] == 0)) return(-1);
+    if (read_length == 0) return(0);
+    if (_n != (1 + _msg[3])) return(-1);
+
+    if (pmb->pec)
+    {
+        _addr |= 1;
+        _pec = smbus_pec(smbus_pec(_pec, &_addr, 1), &_rsp[1], read_length);
+        if (_pec != _rsp[1 + read_length])
+        {
+            fprintf(stderr, "PEC error\n");
+            return(-1);
+        }
+    }
+    memcpy(rx, &_rsp[1], read_length);
+
+    return((int)read_length);
+}
+
+static double linear11(uint16_t value)
+{
+    int _exponent = (int16_t)value >> 11;
+    int _mantissa = ((int16_t)(value << 5)) >> 5;
+
+    return(ldexp((double)_mantissa, _exponent));
+}
+
+static int read_word(PMBUS_MASTER_t* pmb, uint8_t command, uint16_t* value)
+{
+    uint8_t _data[2];
+
+    if (pmbus_transact(pmb, command, NULL, 0, _data, 2) != 2) return(-1);
+    *value = (uint16_t)((_data[1] << 8) | _data[0]);
+    return(0);
+}
+
+static int vout_exponent(PMBUS_MASTER_t* pmb, int* exponent)
+{
+    uint8_t _mode=0;
+
+    if (pmbus_transact(pmb, PMBUS_VOUT_MODE, NULL, 0, &_mode, 1) != 1) return(-1);
+    if (_mode & 0xE0) return(-1); // only linear mode is supported
+    *exponent = ((int8_t)(_mode << 3)) >> 3;
+    return(0);
+}
+
+static void print_status(uint16_t status, uint8_t cml)
+{
+    static const char* const _names[16] = {
+        "NONE_OF_THE_ABOVE", "CML", "TEMPERATURE", "VIN_UV", "IOUT_OC", "VOUT_OV", "OFF", "BUSY",
+        "UNKNOWN", "OTHER", "FANS", "POWER_GOOD#", "MFR", "INPUT", "IOUT/POUT", "VOUT" };
+    int _i=0;
+
+    printf("STATUS_WORD 0x%04X", status);
+    for (_i=15; _i>=0; _i--)
+        if (status & (1U << _i)) printf(" %s", _names[_i]);
+    printf("\nSTATUS_CML  0x%02X%s%s%s\n", cml, (cml & 0x80) ? " INVALID_COMMAND" : "",
+        (cml & 0x40) ? " INVALID_DATA" : "", (cml & 0x20) ? " PEC_FAILED" : "");
+}
+
+int main(int argc, char** argv)
+{
+    const char* _device = "/dev/ttyACM0";
+    const char* _bus = NULL;
+    uint32_t _baudrate = EPC_SERIAL_BAUDRATE;
+    PMBUS_MASTER_t _pmb;
+    struct sockaddr_un _sa;
+    struct timeval _tv;
+    uint8_t _data[8];
+    uint16_t _value=0;
+    int _exponent=0;
+    uint8_t _module=FRAME_ADDRESS_ANY;
+    int _fd=-1;
+    int _opt=0;
+    int _status=0;
+    int _i=0;
+
+    memset(&_pmb, 0, sizeof(_pmb));
+    _pmb.socket = -1;
+    _pmb.address = 0x40;
+    _pmb.timeout = 100;
+
+    while ((_opt = getopt(argc, argv, "d:i:a:m:pb:t:")) != -1)
+    {
+        switch (_opt)
+        {
+            case 'd': _device = optarg; break;
+            case 'i': _bus = optarg; break;
+            case 'a': _pmb.address = (uint8_t)strtoul(optarg, NULL, 0); break;
+            case 'm': _module = (uint8_t)strtoul(optarg, NULL, 0); break;
+            case 'p': _pmb.pec = true; break;
+            case 'b': _baudrate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 't': _pmb.timeout = atoi(optarg); break;
+            default: usage();
+        }
+    }
+    argc -= optind;
+    argv += optind;
+    if (argc < 1)
+        usage();
+
+    if (_bus != NULL)
+    {
+        memset(&_sa, 0, sizeof(_sa));
+        _sa.sun_family = AF_UNIX;
+        strncpy(_sa.sun_path, _bus, (sizeof(_sa.sun_path) - 1));
+        _pmb.socket = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        if ((_pmb.socket < 0) || (connect(_pmb.socket, (struct sockaddr*)&_sa, sizeof(_sa)) < 0))
+        {
+            perror(_bus);
+            return(1);
+        }
+        _tv.tv_sec = (_pmb.timeout / 1000);
+        _tv.tv_usec = ((_pmb.timeout % 1000) * 1000);
+        setsockopt(_pmb.socket, SOL_SOCKET, SO_RCVTIMEO, &_tv, sizeof(_tv));
+    }
+    else
+    {
+        _fd = epc_serial_open(_device, _baudrate);
+        if (_fd < 0)
+        {
+            perror(_device);
+            return(1);
+        }
+        epc_link_init(&_pmb.link, _fd);
+        _pmb.link.address = _module;
+    }
+
+    if (!strcmp(argv[0], "read-vin") || !strcmp(argv[0], "read-iout") || !strcmp(argv[0], "read-temp")) {
+        _status = read_word(&_pmb, (argv[0][5] == 'v') ? PMBUS_READ_VIN : 
+                    ((argv[0][5] == 'i') ? PMBUS_READ_IOUT : PMBUS_READ_TEMPERATURE_1), &_value);
+        if (_status == 0)
+            printf("%.3f %s (0x%04X)\n", linear11(_value), (argv[0][5] == 'v') ? "V" : 
+                ((argv[0][5] == 'i') ? "A" : "degC"), _value);
+    } else if (!strcmp(argv[0], "read-vout") || (!strcmp(argv[0], "vout") && (argc == 1))) {
+        _status = vout_exponent(&_pmb, &_exponent);
+        if (_status == 0)
+            _status = read_word(&_pmb, (argv[0][0] == 'r') ? PMBUS_READ_VOUT : PMBUS_VOUT_COMMAND, &_value);
+        if (_status == 0)
+            printf("%.3f V (0x%04X)\n", ldexp((double)_value, _exponent), _value);
+    } else if (!strcmp(argv[0], "vout") && (argc == 2)) {
+        _status = vout_exponent(&_pmb, &_exponent);
+        _value = (uint16_t)lround(ldexp(atof(argv[1]), -_exponent));
+        _data[0] = (_value & 0xFF);
+        _data[1] = (_value >> 8);
+        if (_status == 0)
+            _status = pmbus_transact(&_pmb, PMBUS_VOUT_COMMAND, _data, 2, NULL, 0);
+    } else if (!strcmp(argv[0], "status") && (argc == 1)) {
+        _status = read_word(&_pmb, PMBUS_STATUS_WORD, &_value);
+        if (_status == 0)
+            _status = pmbus_transact(&_pmb, PMBUS_STATUS_CML, NULL, 0, _data, 1);
+        if (_status >= 0)
+            print_status(_value, _data[0]);
+    } else if (!strcmp(argv[0], "operation") && (argc == 1)) {
+        _status = pmbus_transact(&_pmb, PMBUS_OPERATION, NULL, 0, _data, 1);
+        if (_status >= 0)
+            printf("%s (0x%02X)\n", (_data[0] & 0x80) ? "on" : "off", _data[0]);
+    } else if (!strcmp(argv[0], "operation") && (argc == 2)) {
+        _data[0] = (!strcmp(argv[1], "on")) ? 0x80 : ((!strcmp(argv[1], "off")) ? 0x00 : 
+                    (uint8_t)strtoul(argv[1], NULL, 0));
+        _status = pmbus_transact(&_pmb, PMBUS_OPERATION, _data, 1, NULL, 0);
+    } else if (!strcmp(argv[0], "clear") && (argc == 1)) {
+        _status = pmbus_transact(&_pmb, PMBUS_CLEAR_FAULTS, NULL, 0, NULL, 0);
+    } else if (!strcmp(argv[0], "read") && (argc == 3)) {
+        _status = pmbus_transact(&_pmb, (uint8_t)strtoul(argv[1], NULL, 0), NULL, 0, 
+                    _data, (size_t)strtoul(argv[2], NULL, 0) & 0x07);
+        for (_i=0; _i<_status; _i++)
+            printf("%s0x%02X", (_i ? " " : ""), _data[_i]);
+        if (_status > 0) printf("\n");
+    } else if (!strcmp(argv[0], "write") && (argc >= 2) && (argc <= 4)) {
+        for (_i=2; _i<argc; _i++)
+            _data[_i - 2] = (uint8_t)strtoul(argv[_i], NULL, 0);
+        _status = pmbus_transact(&_pmb, (uint8_t)strtoul(argv[1], NULL, 0), _data, (size_t)(argc - 2), NULL, 0);
+    } else {
+        usage();
+    }
+
+    if (_pmb.socket >= 0) close(_pmb.socket);
+    if (_fd >= 0) epc_serial_close(_fd);
+
+    if (_status < 0)
+    {
+        fprintf(stderr, "transaction not acknowledged\n");
+        return(1);
+    }
+
+    return(0);
+}
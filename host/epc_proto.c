@@ -0,0 +1,318 @@
+/*
+ * File:   epc_proto.c
+ * Author: M91406
+ *
+ * Created on November 24, 2020, 1:15 PM
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "epc_proto.h"
+
+typedef struct {
+    uint8_t address;        // module address of the pending request
+    uint8_t request_id;     // request ID of the pending request
+    uint8_t command;        // expected response command code
+    EPC_FRAME_t* response;  // response buffer
+    bool received;          // flag indicating that the response has been received
+} EPC_PENDING_t;
+
+/*!epc_decoder_init()
+ *****************************************************************************
+ * Summary:
+ * Resets a stream decoder
+ *
+ * Description:
+ * Other than the firmware receiver, the host decoder does not wait for a
+ * first delimiter. A partial frame at the start of the stream fails the CRC
+ * check and is counted as error.
+ *
+ *****************************************************************************/
+
+void epc_decoder_init(EPC_DECODER_t* decoder)
+{
+    frame_receiver_initialize(&decoder->rx);
+    decoder->rx.discard = false;
+    decoder->frames = 0;
+    decoder->errors = 0;
+}
+
+/*!epc_decoder_feed()
+ *****************************************************************************
+ * Summary:
+ * Passes received bytes to the stream decoder
+ *
+ * Description:
+ * Each valid frame completed by the given bytes is passed to the callback
+ * function. Returns the number of valid frames.
+ *
+ *****************************************************************************/
+
+size_t epc_decoder_feed(EPC_DECODER_t* decoder, const uint8_t* data, size_t length,
+                EPC_FRAME_CALLBACK_t callback, void* context)
+{
+    EPC_FRAME_t _frame;
+    size_t _frames=0;
+    size_t _i=0;
+    uint16_t _length=0;
+    uint16_t _errors=0;
+
+    for (_i=0; _i<length; _i++)
+    {
+        _errors = (decoder->rx.crc_errors + decoder->rx.format_errors + decoder->rx.overflows);
+        _length = frame_receive(&decoder->rx, data[_i]);
+        if (_errors != (uint16_t)(decoder->rx.crc_errors + decoder->rx.format_errors + decoder->rx.overflows))
+            decoder->errors++;
+        if (_length == 0)
+            continue;
+
+        _frame.version = decoder->rx.buffer[FRAME_OFS_VERSION];
+        _frame.address = decoder->rx.buffer[FRAME_OFS_ADDRESS];
+        _frame.request_id = decoder->rx.buffer[FRAME_OFS_REQUEST_ID];
+        _frame.command = decoder->rx.buffer[FRAME_OFS_COMMAND];
+        _frame.length = decoder->rx.buffer[FRAME_OFS_LENGTH];
+        memcpy(_frame.payload, (const uint8_t*)&decoder->rx.buffer[FRAME_OFS_PAYLOAD], _frame.length);
+
+        decoder->frames++;
+        _frames++;
+        if (callback != NULL)
+            callback(&_frame, context);
+    }
+
+    return(_frames);
+}
+
+/*!epc_encode()
+ *****************************************************************************
+ * Summary:
+ * Encodes a request frame for transmission
+ *
+ * Description:
+ * A frame delimiter is sent ahead of the frame, which terminates any
+ * incomplete frame left in the receiver of the module (e.g. after a module
+ * reset). The destination buffer must provide FRAME_ENCODED_MAX + 1 bytes.
+ * Returns the number of bytes to be sent or 0 if the payload is too long.
+ *
+ *****************************************************************************/
+
+size_t epc_encode(uint8_t address, uint8_t request_id, uint8_t command, const uint8_t* payload,
+                size_t length, uint8_t* dst)
+{
+    uint8_t _frame[FRAME_RAW_MAX];
+
+    if (length > FRAME_PAYLOAD_MAX)
+        return(0);
+    if (length > 0)
+        memcpy(&_frame[FRAME_OFS_PAYLOAD], payload, length);
+
+    dst[0] = FRAME_DELIMITER;
+    return(1 + frame_encode(_frame, address, request_id, command, (uint16_t)length, &dst[1]));
+}
+
+void epc_link_init(EPC_LINK_t* link, int fd)
+{
+    link->fd = fd;
+    link->address = FRAME_ADDRESS_ANY;
+    link->request_id = 0;
+    link->timeouts = 0;
+    epc_decoder_init(&link->decoder);
+}
+
+static void epc_match_response(const EPC_FRAME_t* frame, void* context)
+{
+    EPC_PENDING_t* _pending = (EPC_PENDING_t*)context;
+
+    // Responses to earlier, timed-out requests and responses of other modules are dropped
+    if ((frame->request_id != _pending->request_id) || (frame->command != _pending->command))
+        return;
+    if ((_pending->address != FRAME_ADDRESS_ANY) && (frame->address != _pending->address))
+        return;
+
+    *_pending->response = *frame;
+    _pending->received = true;
+}
+
+static int64_t epc_time_ms(void)
+{
+    struct timespec _ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &_ts);
+    return(((int64_t)_ts.tv_sec * 1000) + (_ts.tv_nsec / 1000000));
+}
+
+/*!epc_send()
+ *****************************************************************************
+ * Summary:
+ * Sends a request without waiting for a response
+ *
+ * Description:
+ * The request is sent with a new request ID to the module address of the
+ * link. Returns 0 or a negative error code (EPC_ERR_xxx).
+ *
+ *****************************************************************************/
+
+int epc_send(EPC_LINK_t* link, uint8_t command, const uint8_t* payload, size_t length)
+{
+    uint8_t _buffer[FRAME_ENCODED_MAX + 1];
+    size_t _size=0;
+    size_t _sent=0;
+    ssize_t _n=0;
+
+    if ((link == NULL) || ((payload == NULL) && (length > 0)))
+        return(EPC_ERR_PARAM);
+
+    link->request_id++;
+    _size = epc_encode(link->address, link->request_id, command, payload, length, _buffer);
+    if (_size == 0)
+        return(EPC_ERR_PARAM);
+
+    while (_sent < _size)
+    {
+        _n = write(link->fd, &_buffer[_sent], (_size - _sent));
+        if (_n < 0)
+        {
+            if (errno == EINTR) continue;
+            return(EPC_ERR_IO);
+        }
+        _sent += (size_t)_n;
+    }
+
+    return(0);
+}
+
+/*!epc_receive()
+ *****************************************************************************
+ * Summary:
+ * Passes received frames to a callback until a deadline or a stop flag
+ *
+ *****************************************************************************/
+
+static int epc_receive(EPC_LINK_t* link, int64_t deadline, EPC_FRAME_CALLBACK_t callback, 
+                void* context, volatile bool* stop)
+{
+    uint8_t _rx[256];
+    struct pollfd _pfd;
+    ssize_t _n=0;
+    int _wait=0;
+
+    _pfd.fd = link->fd;
+    _pfd.events = POLLIN;
+
+    while ((stop == NULL) || (!*stop))
+    {
+        _wait = (int)(deadline - epc_time_ms());
+        _n = (_wait > 0) ? poll(&_pfd, 1, _wait) : 0;
+        if ((_n < 0) && (errno == EINTR))
+            continue;
+        if (_n <= 0)
+            return(EPC_ERR_TIMEOUT);
+
+        _n = read(link->fd, _rx, sizeof(_rx));
+        if (_n < 0)
+        {
+            if ((errno == EINTR) || (errno == EAGAIN)) continue;
+            return(EPC_ERR_IO);
+        }
+        epc_decoder_feed(&link->decoder, _rx, (size_t)_n, callback, context);
+    }
+
+    return(0);
+}
+
+/*!epc_transact()
+ *****************************************************************************
+ * Summary:
+ * Sends a request and waits for its response
+ *
+ * Description:
+ * Every request is sent with a new request ID. Only the response carrying
+ * this request ID (and the module address of the link, unless the link 
+ * addresses any module) is accepted. Broadcast requests are not answered, 
+ * their response is returned empty with status EPC_STATUS_OK right after 
+ * the request has been sent. Modules answer requests addressed to any module
+ * in the time slot of their address, so the timeout is extended by the slot
+ * of the highest address. Returns the request status of the response
+ * (EPC_STATUS_xxx) or a negative error code (EPC_ERR_xxx).
+ *
+ *****************************************************************************/
+
+int epc_transact(EPC_LINK_t* link, uint8_t command, const uint8_t* payload, size_t length,
+                EPC_FRAME_t* response, int timeout_ms)
+{
+    EPC_PENDING_t _pending;
+    int _result=0;
+
+    if ((link == NULL) || (response == NULL))
+        return(EPC_ERR_PARAM);
+
+    _result = epc_send(link, command, payload, length);
+    if (_result < 0)
+        return(_result);
+
+    if (link->address == FRAME_ADDRESS_BROADCAST)
+    {
+        memset(response, 0, sizeof(EPC_FRAME_t));
+        return(EPC_STATUS_OK);
+    }
+
+    _pending.address = link->address;
+    _pending.request_id = link->request_id;
+    _pending.command = (command | EPC_RESPONSE_FLAG);
+    _pending.response = response;
+    _pending.received = false;
+
+    if (link->address == FRAME_ADDRESS_ANY)
+        timeout_ms += (FRAME_ADDRESS_MAX * EPC_SLOT_MS);
+
+    _result = epc_receive(link, (epc_time_ms() + timeout_ms), epc_match_response, 
+                    &_pending, &_pending.received);
+    if (_result == EPC_ERR_TIMEOUT)
+        link->timeouts++;
+    if (_result < 0)
+        return(_result);
+
+    if (response->length == 0)
+        return(EPC_ERR_IO);
+
+    return(response->payload[0]);
+}
+
+/*!epc_listen()
+ *****************************************************************************
+ * Summary:
+ * Passes all frames received within the given time to a callback function
+ *
+ * Description:
+ * Used to collect the responses of several modules to a request sent to 
+ * FRAME_ADDRESS_ANY by epc_send() (e.g. EPC_CMD_DISCOVER). Returns 0 or a 
+ * negative error code (EPC_ERR_IO).
+ *
+ *****************************************************************************/
+
+int epc_listen(EPC_LINK_t* link, int duration_ms, EPC_FRAME_CALLBACK_t callback, void* context)
+{
+    int _result=0;
+
+    if (link == NULL)
+        return(EPC_ERR_PARAM);
+
+    _result = epc_receive(link, (epc_time_ms() + duration_ms), callback, context, NULL);
+
+    return((_result == EPC_ERR_TIMEOUT) ? 0 : _result);
+}
+
+const char* epc_status_text(uint8_t status)
+{
+    switch (status)
+    {
+        case EPC_STATUS_OK:         return("ok");
+        case EPC_STATUS_UNKNOWN:    return("unknown command");
+        case EPC_STATUS_LENGTH:     return("invalid payload length");
+        case EPC_STATUS_REJECTED:   return("rejected");
+        default:                    return("invalid status");
+    }
+}
@@ -0,0 +1,179 @@
+/* Microchip Technology Inc. and its subsidiaries.  You may use this software
+ * and any derivatives exclusively with Microchip products.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+ * PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+ * WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+ * INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+ * WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+ * BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS
+ * IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF
+ * ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+ * TERMS.
+ */
+
+/*
+ * File:   epc_proto.h
+ * Author: M91406
+ * Comments: host-side library of the EPC9151 binary communication protocol
+ * Revision history:
+ * 1.0  initial release
+ */
+
+#ifndef EPC_PROTOCOL_HOST_HEADER_H
+#define	EPC_PROTOCOL_HOST_HEADER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "drv_frame.h" // frame codec shared with the firmware
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!Command codes
+ * ***************************************************************************************************
+ * Summary:
+ * Command and status codes of the communication protocol
+ *
+ * Description:
+ * These codes have to match PROTO_COMMAND_e and PROTO_STATUS_e of the firmware (uart/app_uart.h).
+ * Responses carry the command code of the request with EPC_RESPONSE_FLAG set. The first payload
+ * byte of each response is the request status.
+ *
+ * *************************************************************************************************** */
+
+#define EPC_CMD_GET_VERSION     0x01U // read protocol and firmware version
+#define EPC_CMD_READ_DATA       0x02U // read snapshot of monitored converter data
+#define EPC_CMD_DISCOVER        0x03U // read module address and version (answered in the time slot of the module)
+#define EPC_CMD_SET_ADDRESS     0x04U // set module address on the shared bus (optionally stored in flash)
+#define EPC_CMD_READ_UNITS      0x05U // read snapshot of converter data in engineering units
+#define EPC_CMD_SET_VREF        0x10U // set output voltage reference
+#define EPC_CMD_SET_VOUT        0x11U // set output voltage reference in engineering units
+#define EPC_CMD_SEQ_LOAD        0x20U // sequencer, load single setpoint into profile table
+#define EPC_CMD_SEQ_CONTROL     0x21U // sequencer, start/stop profile execution
+#define EPC_CMD_PROF_READ       0x30U // profiler, read data page or reset statistics
+#define EPC_CMD_FLOG_READ       0x31U // fault log, read data page of a log entry or clear log
+#define EPC_CMD_STREAM_CONFIG   0x40U // telemetry, select channels and decimation
+#define EPC_CMD_STREAM_CONTROL  0x41U // telemetry, start/stop stream
+#define EPC_CMD_STREAM_DATA     0x42U // telemetry, stream data frame (sent by the module only, request ID 0)
+#define EPC_CMD_STREAM_POLL     0x43U // telemetry, read next stream data block (polled mode)
+#define EPC_CMD_STATS_CONFIG    0x44U // running statistics, select channels, decimation and window length
+#define EPC_CMD_STATS_READ      0x45U // running statistics, read results of the most recent window
+#define EPC_CMD_CAPTURE_CONFIG  0x50U // triggered capture, select channels, decimation and trigger
+#define EPC_CMD_CAPTURE_CONTROL 0x51U // triggered capture, arm/stop capture or force trigger
+#define EPC_CMD_CAPTURE_READ    0x52U // triggered capture, read data page of completed capture
+#define EPC_CMD_PARAM_INFO      0x60U // parameter registry, read name, data type, range and value of a parameter
+#define EPC_CMD_PARAM_READ      0x61U // parameter registry, read values of a list of parameters
+#define EPC_CMD_PARAM_WRITE     0x62U // parameter registry, write a set of parameters in the same control cycle
+#define EPC_CMD_PMBUS_WRITE     0x70U // PMBus command layer, write transaction (incl. send byte)
+#define EPC_CMD_PMBUS_READ      0x71U // PMBus command layer, read transaction
+
+#define EPC_RESPONSE_FLAG       0x80U // command code flag marking a response frame
+
+#define EPC_STATUS_OK           0x00U // request has been executed
+#define EPC_STATUS_UNKNOWN      0x01U // command code is not supported
+#define EPC_STATUS_LENGTH       0x02U // payload length does not match the command
+#define EPC_STATUS_REJECTED     0x03U // request parameters are invalid or request cannot be executed
+
+#define EPC_SLOT_MS             3     // response time slot per module address in [ms] (UART_SLOT_PERIOD)
+
+#define EPC_ERR_TIMEOUT         (-1)  // no matching response received within timeout
+#define EPC_ERR_IO              (-2)  // read/write error of the communication port
+#define EPC_ERR_PARAM           (-3)  // invalid function argument
+
+/*!EPC_FRAME_t
+ * ***************************************************************************************************
+ * Summary:
+ * Decoded protocol frame
+ *
+ * *************************************************************************************************** */
+
+typedef struct {
+    uint8_t version;        // protocol version
+    uint8_t address;        // module address (destination of requests, source of responses)
+    uint8_t request_id;     // request ID (responses echo the ID of their request)
+    uint8_t command;        // command code
+    uint8_t length;         // number of payload bytes
+    uint8_t payload[FRAME_PAYLOAD_MAX]; // payload
+} EPC_FRAME_t;
+
+typedef void (*EPC_FRAME_CALLBACK_t)(const EPC_FRAME_t* frame, void* context);
+
+/*!EPC_DECODER_t
+ * ***************************************************************************************************
+ * Summary:
+ * Stream decoder
+ *
+ * Description:
+ * The decoder splits a received byte stream into frames, validates them and passes each valid
+ * frame to a callback function. Invalid frames are counted by the frame receiver object.
+ *
+ * *************************************************************************************************** */
+
+typedef struct {
+    FRAME_RECEIVER_t rx;    // frame receiver shared with the firmware
+    uint32_t frames;        // number of valid frames decoded
+    uint32_t errors;        // number of invalid frames dropped
+} EPC_DECODER_t;
+
+/*!EPC_LINK_t
+ * ***************************************************************************************************
+ * Summary:
+ * Request/response link to one module
+ *
+ * Description:
+ * Requests are sent to the module address of the link. FRAME_ADDRESS_ANY (default) addresses 
+ * the single module of a point-to-point link, FRAME_ADDRESS_BROADCAST all modules of a shared 
+ * bus without response.
+ *
+ * *************************************************************************************************** */
+
+typedef struct {
+    int fd;                 // file descriptor of the serial port
+    uint8_t address;        // module address of requests
+    uint8_t request_id;     // ID of the most recent request
+    EPC_DECODER_t decoder;  // response stream decoder
+    uint32_t timeouts;      // number of requests without response
+} EPC_LINK_t;
+
+// Public Function Prototypes
+extern void epc_decoder_init(EPC_DECODER_t* decoder);
+extern size_t epc_decoder_feed(EPC_DECODER_t* decoder, const uint8_t* data, size_t length,
+                EPC_FRAME_CALLBACK_t callback, void* context);
+extern size_t epc_encode(uint8_t address, uint8_t request_id, uint8_t command, const uint8_t* payload,
+                size_t length, uint8_t* dst);
+
+extern void epc_link_init(EPC_LINK_t* link, int fd);
+extern int epc_send(EPC_LINK_t* link, uint8_t command, const uint8_t* payload, size_t length);
+extern int epc_transact(EPC_LINK_t* link, uint8_t command, const uint8_t* payload, size_t length,
+                EPC_FRAME_t* response, int timeout_ms);
+extern int epc_listen(EPC_LINK_t* link, int duration_ms, EPC_FRAME_CALLBACK_t callback, void* context);
+
+extern const char* epc_status_text(uint8_t status);
+
+static inline uint16_t epc_get_u16(const uint8_t* src)
+{
+    return((uint16_t)src[0] | ((uint16_t)src[1] << 8));
+}
+
+static inline void epc_put_u16(uint8_t* dst, uint16_t value)
+{
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* EPC_PROTOCOL_HOST_HEADER_H */
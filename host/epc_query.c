@@ -0,0 +1,593 @@
+/*
+ * File:   epc_query.c
+ * Author: M91406
+ *
+ * Created on November 24, 2020, 3:30 PM
+ *
+ * Command line tool sending single requests to an EPC9151 module:
+ *
+ *   epc_query [-d device] [-b baudrate] [-t timeout_ms] [-a address] command [arguments]
+ *
+ *   -a address  module address on a shared bus (0 = broadcast, no response; 
+ *               default 255 = any module of a point-to-point link)
+ *
+ *   discover                        list all modules on the bus (address, version)
+ *   address <new> [persist]         set module address, persist stores it in flash
+ *   version                         read protocol and firmware version
+ *   read                            read converter data snapshot
+ *   units                           read converter data snapshot in engineering units
+ *   vref <ticks>                    set output voltage reference
+ *   vout <mV>                       set output voltage reference in millivolts
+ *   seq-load <index> <time> <v_ref> <i_limit>
+ *   seq <stop|run|loop> [points]    control setpoint profile sequencer
+ *   prof <page|reset>               read profiler data page
+ *   flog <entry> <page> | flog clear
+ *   stream <decimation> <samples> <channel> [channel...]
+ *                                   stream telemetry channels, one sample per line
+ *   stats config <decimation> <window_shift> <channel> [channel...]
+ *                                   select running statistics channels (window = 2^window_shift samples)
+ *   stats [restart]                 read min/max/mean/RMS/AC RMS/ripple of the most recent window,
+ *                                   restart discards the current window
+ *   capture config <decimation> <pre_trigger> <trigger> <trigger_channel> <level> <channel> [channel...]
+ *   capture <arm|stop|force|status>  control triggered capture
+ *   capture read                    read completed capture, one sample per line
+ *   param list                      list registered parameters with range and value
+ *   param get <name|id> [...]       read parameters
+ *   param set <name|id>=<value> [...]
+ *                                   write parameters (applied in the same control cycle)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include "epc_proto.h"
+#include "epc_serial.h"
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: epc_query [-d device] [-b baudrate] [-t timeout_ms] [-a address] command [arguments]\n"
+        "  discover | address <new> [persist]\n"
+        "  version | read | units | vref <ticks> | vout <mV>\n"
+        "  seq-load <index> <time> <v_ref> <i_limit>\n"
+        "  seq <stop|run|loop> [points] | prof <page|reset> | flog <entry> <page> | flog clear\n"
+        "  stream <decimation> <samples> <channel> [channel...]\n"
+        "  stats config <decimation> <window_shift> <channel> [channel...] | stats [restart]\n"
+        "  capture config <decimation> <pre_trigger> <trigger> <trigger_channel> <level> <channel> [channel...]\n"
+        "  capture <arm|stop|force|status> | capture read\n"
+        "  param list | param get <name|id> [...] | param set <name|id>=<value> [...]\n");
+    exit(2);
+}
+
+static void print_words(const EPC_FRAME_t* rsp, const char* title)
+{
+    int _i=0;
+
+    printf("%s:", title);
+    for (_i=1; (_i + 1)<rsp->length; _i+=2)
+        printf(" %5u", epc_get_u16(&rsp->payload[_i]));
+    printf("\n");
+}
+
+typedef struct {
+    int channels;           // number of selected channels
+    long remaining;         // number of samples still to be printed
+    uint16_t next_index;    // expected sample index of the next stream frame
+    bool synchronized;      // first stream frame has been received
+    uint32_t lost;          // number of samples lost on the link or in the module
+} STREAM_STATE_t;
+
+static void print_stream(const EPC_FRAME_t* frame, void* context)
+{
+    STREAM_STATE_t* _st = (STREAM_STATE_t*)context;
+    uint16_t _index=0;
+    int _samples=0;
+    int _s=0, _c=0;
+
+    if ((frame->command != (EPC_CMD_STREAM_DATA | EPC_RESPONSE_FLAG)) || (frame->length < 4))
+        return;
+
+    _samples = frame->payload[1];
+    _index = epc_get_u16(&frame->payload[2]);
+    if (frame->length < (4 + (2 * _samples * _st->channels)))
+        return;
+
+    if ((_st->synchronized) && (_index != _st->next_index))
+        _st->lost += (uint16_t)(_index - _st->next_index);
+    _st->synchronized = true;
+    _st->next_index = (uint16_t)(_index + _samples);
+
+    for (_s=0; (_s<_samples) && (_st->remaining > 0); _s++)
+    {
+        printf("%u", (uint16_t)(_index + _s));
+        for (_c=0; _c<_st->channels; _c++)
+            printf(" %u", epc_get_u16(&frame->payload[4 + (2 * ((_s * _st->channels) + _c))]));
+        printf("\n");
+        _st->remaining--;
+    }
+}
+
+static int run_stream(EPC_LINK_t* link, int argc, char** argv, int timeout)
+{
+    uint8_t _req[FRAME_PAYLOAD_MAX];
+    uint8_t _rx[256];
+    EPC_FRAME_t _rsp;
+    STREAM_STATE_t _st;
+    struct pollfd _pfd;
+    ssize_t _n=0;
+    int _status=0;
+    int _i=0;
+
+    memset(&_st, 0, sizeof(_st));
+    _st.channels = argc - 3;
+    _st.remaining = strtol(argv[2], NULL, 0);
+
+    epc_put_u16(&_req[0], (uint16_t)strtoul(argv[1], NULL, 0));
+    for (_i=0; _i<_st.channels; _i++)
+        _req[2 + _i] = (uint8_t)strtoul(argv[3 + _i], NULL, 0);
+
+    _status = epc_transact(link, EPC_CMD_STREAM_CONFIG, _req, (size_t)(2 + _st.channels), &_rsp, timeout);
+    if ((_status == EPC_STATUS_REJECTED) && (_rsp.length >= 4))
+        fprintf(stderr, "stream configuration rejected (minimum decimation %u)\n", epc_get_u16(&_rsp.payload[2]));
+    if (_status != EPC_STATUS_OK)
+        return(_status);
+
+    _req[0] = 1;
+    _status = epc_transact(link, EPC_CMD_STREAM_CONTROL, _req, 1, &_rsp, timeout);
+    if (_status != EPC_STATUS_OK)
+        return(_status);
+
+    _pfd.fd = link->fd;
+    _pfd.events = POLLIN;
+    while (_st.remaining > 0)
+    {
+        _n = poll(&_pfd, 1, timeout);
+        if (_n <= 0)
+            break;
+        _n = read(link->fd, _rx, sizeof(_rx));
+        if (_n <= 0)
+            break;
+        epc_decoder_feed(&link->decoder, _rx, (size_t)_n, print_stream, &_st);
+    }
+
+    _req[0] = 0;
+    _status = epc_transact(link, EPC_CMD_STREAM_CONTROL, _req, 1, &_rsp, timeout);
+    if (_status == EPC_STATUS_OK)
+        fprintf(stderr, "%u samples, %u dropped by module, %u lost in total\n", 
+            epc_get_u16(&_rsp.payload[1]), epc_get_u16(&_rsp.payload[3]), _st.lost);
+
+    return((_st.remaining > 0) ? EPC_ERR_TIMEOUT : _status);
+}
+
+static int read_capture(EPC_LINK_t* link, int timeout)
+{
+    uint8_t _req[2];
+    EPC_FRAME_t _rsp;
+    uint16_t _status=0;
+    int _channels=0, _pre=0, _words=0;
+    int _result=0;
+    int _w=0, _p=0;
+
+    _req[0] = 3; // status only
+    _result = epc_transact(link, EPC_CMD_CAPTURE_CONTROL, _req, 1, &_rsp, timeout);
+    if (_result != EPC_STATUS_OK)
+        return(_result);
+
+    _status = epc_get_u16(&_rsp.payload[1]);
+    _channels = epc_get_u16(&_rsp.payload[7]);
+    _pre = epc_get_u16(&_rsp.payload[9]);
+    _words = epc_get_u16(&_rsp.payload[5]) * _channels;
+    if (!(_status & 0x0004))
+    {
+        fprintf(stderr, "capture not complete (status 0x%04X)\n", _status);
+        return(EPC_STATUS_REJECTED);
+    }
+
+    // Page by page, one sample per line, sample number relative to the trigger sample
+    for (_p=0; (_p * 16) < _words; _p++)
+    {
+        _req[0] = (uint8_t)_p;
+        _result = epc_transact(link, EPC_CMD_CAPTURE_READ, _req, 1, &_rsp, timeout);
+        if (_result != EPC_STATUS_OK)
+            return(_result);
+
+        for (_w=0; (_w < 16) && (((_p * 16) + _w) < _words); _w++)
+        {
+            if ((((_p * 16) + _w) % _channels) == 0)
+                printf("%d", (((_p * 16) + _w) / _channels) - _pre);
+            printf(" %u", epc_get_u16(&_rsp.payload[1 + (_w << 1)]));
+            if ((((_p * 16) + _w) % _channels) == (_channels - 1))
+                printf("\n");
+        }
+    }
+
+    return(EPC_STATUS_OK);
+}
+
+#define PARAM_COUNT_MAX     256
+#define PARAM_SET_MAX       8   // parameters written in one request (PARAM_WRITE_MAX of the firmware)
+
+typedef struct {
+    char name[FRAME_PAYLOAD_MAX];   // parameter name
+    uint8_t type;                   // data type (0 = unsigned, 1 = signed)
+    uint16_t minimum;               // lowest valid value
+    uint16_t maximum;               // highest valid value
+    uint16_t value;                 // value when the registry was read
+} PARAM_INFO_t;
+
+static long param_value(const PARAM_INFO_t* info, uint16_t value)
+{
+    return((info->type == 1) ? (long)(int16_t)value : (long)value);
+}
+
+static int param_find(const PARAM_INFO_t* info, int count, const char* name)
+{
+    char* _end = NULL;
+    long _id = strtol(name, &_end, 0);
+    int _i=0;
+
+    if ((*_end == 0) && (_id >= 0) && (_id < count))
+        return((int)_id);
+    for (_i=0; _i<count; _i++)
+    { if (!strcmp(info[_i].name, name)) return(_i); }
+
+    fprintf(stderr, "unknown parameter %s\n", name);
+    return(-1);
+}
+
+/*!run_param()
+ *****************************************************************************
+ * Summary:
+ * Lists, reads or writes registered parameters
+ *
+ * Description:
+ * The registry (names, data types and ranges) is read from the module first,
+ * so parameters can be addressed by name. All values given to 'set' are 
+ * sent in one request and applied by the module in the same control cycle. 
+ * The written parameters are read back afterwards.
+ *
+ *****************************************************************************/
+
+static int run_param(EPC_LINK_t* link, int argc, char** argv, int timeout)
+{
+    static PARAM_INFO_t _info[PARAM_COUNT_MAX];
+    uint8_t _req[FRAME_PAYLOAD_MAX];
+    uint8_t _id[PARAM_SET_MAX];
+    EPC_FRAME_t _rsp;
+    char* _value = NULL;
+    int _count=1, _n=0;
+    int _result=0;
+    int _i=0;
+
+    if (argc < 2)
+        usage();
+
+    // Read registry
+    for (_i=0; _i<_count; _i++)
+    {
+        _req[0] = (uint8_t)_i;
+        _result = epc_transact(link, EPC_CMD_PARAM_INFO, _req, 1, &_rsp, timeout);
+        if (_result != EPC_STATUS_OK)
+            return(_result);
+        _count = _rsp.payload[1];
+        _info[_i].type = _rsp.payload[2];
+        _info[_i].minimum = epc_get_u16(&_rsp.payload[3]);
+        _info[_i].maximum = epc_get_u16(&_rsp.payload[5]);
+        _info[_i].value = epc_get_u16(&_rsp.payload[7]);
+        memcpy(_info[_i].name, &_rsp.payload[9], (size_t)(_rsp.length - 9));
+        _info[_i].name[_rsp.length - 9] = 0;
+    }
+
+    if (!strcmp(argv[1], "list"))
+    {
+        for (_i=0; _i<_count; _i++)
+            printf("%3d %-32s %6ld  [%ld...%ld]\n", _i, _info[_i].name, 
+                param_value(&_info[_i], _info[_i].value),
+                param_value(&_info[_i], _info[_i].minimum), param_value(&_info[_i], _info[_i].maximum));
+        return(EPC_STATUS_OK);
+    }
+
+    if ((argc - 2) > PARAM_SET_MAX)
+        usage();
+
+    for (_n=0; _n<(argc - 2); _n++)
+    {
+        _value = strchr(argv[_n + 2], '=');
+        if (!strcmp(argv[1], "set"))
+        {
+            if (_value == NULL) usage();
+            *_value++ = 0;
+        }
+        _i = param_find(_info, _count, argv[_n + 2]);
+        if (_i < 0)
+            return(EPC_STATUS_REJECTED);
+        _id[_n] = (uint8_t)_i;
+        if (!strcmp(argv[1], "set"))
+        {
+            _req[3 * _n] = _id[_n];
+            epc_put_u16(&_req[(3 * _n) + 1], (uint16_t)strtol(_value, NULL, 0));
+        }
+    }
+
+    if (!strcmp(argv[1], "set"))
+    {
+        _result = epc_transact(link, EPC_CMD_PARAM_WRITE, _req, (size_t)(3 * _n), &_rsp, timeout);
+        if (_result != EPC_STATUS_OK)
+            return(_result);
+        usleep(2000); // the staged set is applied within the next control cycle
+    }
+    else if (strcmp(argv[1], "get"))
+    {
+        usage();
+    }
+
+    _result = epc_transact(link, EPC_CMD_PARAM_READ, _id, (size_t)_n, &_rsp, timeout);
+    if (_result != EPC_STATUS_OK)
+        return(_result);
+    for (_i=0; _i<_n; _i++)
+        printf("%s %ld\n", _info[_id[_i]].name, 
+            param_value(&_info[_id[_i]], epc_get_u16(&_rsp.payload[1 + (_i << 1)])));
+
+    return(EPC_STATUS_OK);
+}
+
+static void print_module(const EPC_FRAME_t* frame, void* context)
+{
+    int* _count = (int*)context;
+
+    if ((frame->command != (EPC_CMD_DISCOVER | EPC_RESPONSE_FLAG)) || (frame->length < 9) ||
+        (frame->payload[0] != EPC_STATUS_OK))
+        return;
+
+    printf("address %3u: protocol %u, firmware %u.%u.%u\n", frame->payload[1], frame->payload[2],
+        epc_get_u16(&frame->payload[3]), epc_get_u16(&frame->payload[5]), epc_get_u16(&frame->payload[7]));
+    (*_count)++;
+}
+
+static int run_discover(EPC_LINK_t* link, int timeout)
+{
+    int _count=0;
+    int _status=0;
+
+    // every module answers in the time slot of its address
+    if (link->address == FRAME_ADDRESS_BROADCAST)
+        link->address = FRAME_ADDRESS_ANY;
+    _status = epc_send(link, EPC_CMD_DISCOVER, NULL, 0);
+    if (_status == 0)
+        _status = epc_listen(link, (((FRAME_ADDRESS_MAX + 1) * EPC_SLOT_MS) + timeout), print_module, &_count);
+    if (_status < 0)
+        return(_status);
+    if (_count == 0)
+        return(EPC_ERR_TIMEOUT);
+
+    printf("%d module(s) found\n", _count);
+    return(EPC_STATUS_OK);
+}
+
+int main(int argc, char** argv)
+{
+    const char* _device = "/dev/ttyACM0";
+    uint32_t _baudrate = EPC_SERIAL_BAUDRATE;
+    int _timeout = 100;
+    int _address = FRAME_ADDRESS_ANY;
+    unsigned long _value=0;
+    uint8_t _req[FRAME_PAYLOAD_MAX];
+    size_t _length=0;
+    uint8_t _cmd=0;
+    EPC_FRAME_t _rsp;
+    EPC_LINK_t _link;
+    int _opt=0;
+    int _fd=0;
+    int _status=0;
+    int _i=0;
+
+    while ((_opt = getopt(argc, argv, "d:b:t:a:")) != -1)
+    {
+        switch (_opt)
+        {
+            case 'd': _device = optarg; break;
+            case 'b': _baudrate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 't': _timeout = atoi(optarg); break;
+            case 'a': _address = (int)strtoul(optarg, NULL, 0); break;
+            default: usage();
+        }
+    }
+    argc -= optind;
+    argv += optind;
+    if ((argc < 1) || (_address < 0) || (_address > 0xFF))
+        usage();
+
+    if (!strcmp(argv[0], "discover") && (argc == 1)) {
+        _cmd = EPC_CMD_DISCOVER;
+    } else if (!strcmp(argv[0], "address") && (argc >= 2) && (argc <= 3)) {
+        _cmd = EPC_CMD_SET_ADDRESS;
+        _value = strtoul(argv[1], NULL, 0);
+        if ((_value < FRAME_ADDRESS_MIN) || (_value > FRAME_ADDRESS_MAX)) usage();
+        _req[0] = (uint8_t)_value;
+        _req[1] = ((argc > 2) && !strcmp(argv[2], "persist")) ? 1 : 0;
+        if ((argc > 2) && (_req[1] == 0)) usage();
+        _length = 2;
+    } else if (!strcmp(argv[0], "version") && (argc == 1)) {
+        _cmd = EPC_CMD_GET_VERSION;
+    } else if (!strcmp(argv[0], "read") && (argc == 1)) {
+        _cmd = EPC_CMD_READ_DATA;
+    } else if (!strcmp(argv[0], "units") && (argc == 1)) {
+        _cmd = EPC_CMD_READ_UNITS;
+    } else if (!strcmp(argv[0], "vout") && (argc == 2)) {
+        _cmd = EPC_CMD_SET_VOUT;
+        _value = strtoul(argv[1], NULL, 0);
+        if (_value > 0xFFFF) usage();
+        epc_put_u16(&_req[0], (uint16_t)_value);
+        _length = 2;
+    } else if (!strcmp(argv[0], "vref") && (argc == 2)) {
+        _cmd = EPC_CMD_SET_VREF;
+        epc_put_u16(&_req[0], (uint16_t)strtoul(argv[1], NULL, 0));
+        _length = 2;
+    } else if (!strcmp(argv[0], "seq-load") && (argc == 5)) {
+        _cmd = EPC_CMD_SEQ_LOAD;
+        for (_i=0; _i<4; _i++)
+            epc_put_u16(&_req[_i << 1], (uint16_t)strtoul(argv[_i + 1], NULL, 0));
+        _length = 8;
+    } else if (!strcmp(argv[0], "seq") && (argc >= 2)) {
+        _cmd = EPC_CMD_SEQ_CONTROL;
+        if (!strcmp(argv[1], "stop")) _req[0] = 0;
+        else if (!strcmp(argv[1], "run")) _req[0] = 1;
+        else if (!strcmp(argv[1], "loop")) _req[0] = 2;
+        else usage();
+        _req[1] = (argc > 2) ? (uint8_t)strtoul(argv[2], NULL, 0) : 0;
+        _length = 2;
+    } else if (!strcmp(argv[0], "prof") && (argc == 2)) {
+        _cmd = EPC_CMD_PROF_READ;
+        _req[0] = (!strcmp(argv[1], "reset")) ? 0xFF : (uint8_t)strtoul(argv[1], NULL, 0);
+        _length = 1;
+    } else if (!strcmp(argv[0], "flog") && (argc >= 2)) {
+        _cmd = EPC_CMD_FLOG_READ;
+        _req[0] = (!strcmp(argv[1], "clear")) ? 0xFF : (uint8_t)strtoul(argv[1], NULL, 0);
+        _req[1] = (argc > 2) ? (uint8_t)strtoul(argv[2], NULL, 0) : 0;
+        _length = 2;
+    } else if (!strcmp(argv[0], "stream") && (argc >= 4) && (argc <= (3 + 8))) {
+        _cmd = EPC_CMD_STREAM_DATA;
+    } else if (!strcmp(argv[0], "stats") && (argc >= 5) && (argc <= (4 + 4)) && !strcmp(argv[1], "config")) {
+        _cmd = EPC_CMD_STATS_CONFIG;
+        epc_put_u16(&_req[0], (uint16_t)strtoul(argv[2], NULL, 0));
+        _req[2] = (uint8_t)strtoul(argv[3], NULL, 0);
+        for (_i=4; _i<argc; _i++)
+            _req[_i - 1] = (uint8_t)strtoul(argv[_i], NULL, 0);
+        _length = (size_t)(argc - 1);
+    } else if (!strcmp(argv[0], "stats") && (argc <= 2)) {
+        _cmd = EPC_CMD_STATS_READ;
+        _req[0] = 0;
+        if ((argc == 2) && strcmp(argv[1], "restart")) usage();
+        if (argc == 2) _req[0] = 1;
+        _length = 1;
+    } else if (!strcmp(argv[0], "capture") && (argc >= 8) && (argc <= (7 + 4)) && !strcmp(argv[1], "config")) {
+        _cmd = EPC_CMD_CAPTURE_CONFIG;
+        epc_put_u16(&_req[0], (uint16_t)strtoul(argv[2], NULL, 0));
+        epc_put_u16(&_req[2], (uint16_t)strtoul(argv[3], NULL, 0));
+        _req[4] = (uint8_t)strtoul(argv[4], NULL, 0);
+        _req[5] = (uint8_t)strtoul(argv[5], NULL, 0);
+        epc_put_u16(&_req[6], (uint16_t)strtoul(argv[6], NULL, 0));
+        for (_i=7; _i<argc; _i++)
+            _req[_i + 1] = (uint8_t)strtoul(argv[_i], NULL, 0);
+        _length = (size_t)(argc + 1);
+    } else if (!strcmp(argv[0], "capture") && (argc == 2) && strcmp(argv[1], "read")) {
+        _cmd = EPC_CMD_CAPTURE_CONTROL;
+        if (!strcmp(argv[1], "stop")) _req[0] = 0;
+        else if (!strcmp(argv[1], "arm")) _req[0] = 1;
+        else if (!strcmp(argv[1], "force")) _req[0] = 2;
+        else if (!strcmp(argv[1], "status")) _req[0] = 3;
+        else usage();
+        _length = 1;
+    } else if (!strcmp(argv[0], "capture") && (argc == 2)) {
+        _cmd = EPC_CMD_CAPTURE_READ;
+    } else if (!strcmp(argv[0], "param") && (argc >= 2)) {
+        _cmd = EPC_CMD_PARAM_INFO;
+    } else {
+        usage();
+    }
+
+    _fd = epc_serial_open(_device, _baudrate);
+    if (_fd < 0)
+    {
+        perror(_device);
+        return(1);
+    }
+    epc_link_init(&_link, _fd);
+    _link.address = (uint8_t)_address;
+
+    if (_cmd == EPC_CMD_DISCOVER)
+        _status = run_discover(&_link, _timeout);
+    else if (_cmd == EPC_CMD_STREAM_DATA)
+        _status = run_stream(&_link, argc, argv, _timeout);
+    else if (_cmd == EPC_CMD_CAPTURE_READ)
+        _status = read_capture(&_link, _timeout);
+    else if (_cmd == EPC_CMD_PARAM_INFO)
+        _status = run_param(&_link, argc, argv, _timeout);
+    else
+        _status = epc_transact(&_link, _cmd, _req, _length, &_rsp, _timeout);
+    epc_serial_close(_fd);
+
+    if (_status == EPC_ERR_TIMEOUT) {
+        fprintf(stderr, "no response (%u invalid frames received)\n", _link.decoder.errors);
+        return(1);
+    } else if (_status < 0) {
+        fprintf(stderr, "communication error\n");
+        return(1);
+    } else if (_status != EPC_STATUS_OK) {
+        fprintf(stderr, "request failed: %s\n", epc_status_text((uint8_t)_status));
+        return(1);
+    }
+
+    if ((_link.address == FRAME_ADDRESS_BROADCAST) && (_cmd != EPC_CMD_DISCOVER))
+    {
+        printf("sent to all modules (broadcast)\n");
+        return(0);
+    }
+
+    switch (_cmd)
+    {
+        case EPC_CMD_GET_VERSION:
+            printf("protocol %u, firmware %u.%u.%u\n", _rsp.payload[1], epc_get_u16(&_rsp.payload[2]),
+                epc_get_u16(&_rsp.payload[4]), epc_get_u16(&_rsp.payload[6]));
+            break;
+        case EPC_CMD_READ_DATA:
+            printf("v_out %u, v_in %u, i_sns1 %u, i_sns2 %u, state %u, status 0x%04X\n",
+                epc_get_u16(&_rsp.payload[1]), epc_get_u16(&_rsp.payload[3]),
+                epc_get_u16(&_rsp.payload[5]), epc_get_u16(&_rsp.payload[7]),
+                epc_get_u16(&_rsp.payload[9]), epc_get_u16(&_rsp.payload[11]));
+            break;
+        case EPC_CMD_READ_UNITS:
+            printf("v_in %u mV, v_out %u mV, v_ref %u mV, i_sns1 %d mA, i_sns2 %d mA, i_out %d mA, ",
+                epc_get_u16(&_rsp.payload[1]), epc_get_u16(&_rsp.payload[3]), epc_get_u16(&_rsp.payload[5]),
+                (int16_t)epc_get_u16(&_rsp.payload[7]), (int16_t)epc_get_u16(&_rsp.payload[9]),
+                (int16_t)epc_get_u16(&_rsp.payload[11]));
+            if (epc_get_u16(&_rsp.payload[13]) == 0x8000U)
+                printf("temp n/a, ");
+            else
+                printf("temp %.1f C, ", ((int16_t)epc_get_u16(&_rsp.payload[13]) / 10.0));
+            printf("state %u\n", epc_get_u16(&_rsp.payload[15]));
+            break;
+        case EPC_CMD_SET_VREF:
+            printf("v_ref %u\n", epc_get_u16(&_rsp.payload[1]));
+            break;
+        case EPC_CMD_SET_VOUT:
+            printf("v_out %u mV (v_ref %u)\n", epc_get_u16(&_rsp.payload[1]), epc_get_u16(&_rsp.payload[3]));
+            break;
+        case EPC_CMD_SET_ADDRESS:
+            printf("address %u%s\n", _rsp.payload[1], (_req[1] ? " (stored)" : ""));
+            break;
+        case EPC_CMD_STATS_READ:
+            printf("status 0x%04X, window %u, %u samples per window\n", epc_get_u16(&_rsp.payload[1]),
+                epc_get_u16(&_rsp.payload[3]), epc_get_u16(&_rsp.payload[5]));
+            if (_rsp.length <= 9)
+                printf("no completed window\n");
+            for (_i=9; (_i + 12)<=_rsp.length; _i+=12)
+                printf("channel %d: min %u, max %u, mean %u, RMS %u, AC RMS %u, ripple %u\n", ((_i - 9) / 12),
+                    epc_get_u16(&_rsp.payload[_i]), epc_get_u16(&_rsp.payload[_i + 2]),
+                    epc_get_u16(&_rsp.payload[_i + 4]), epc_get_u16(&_rsp.payload[_i + 6]),
+                    epc_get_u16(&_rsp.payload[_i + 8]), epc_get_u16(&_rsp.payload[_i + 10]));
+            break;
+        case EPC_CMD_CAPTURE_CONFIG:
+            printf("depth %u samples\n", epc_get_u16(&_rsp.payload[1]));
+            break;
+        case EPC_CMD_CAPTURE_CONTROL:
+            printf("status 0x%04X, trigger cause %u, %u samples, %u channels, %u pre-trigger samples\n",
+                epc_get_u16(&_rsp.payload[1]), epc_get_u16(&_rsp.payload[3]), epc_get_u16(&_rsp.payload[5]),
+                epc_get_u16(&_rsp.payload[7]), epc_get_u16(&_rsp.payload[9]));
+            break;
+        case EPC_CMD_DISCOVER:
+        case EPC_CMD_STREAM_DATA:
+        case EPC_CMD_CAPTURE_READ:
+        case EPC_CMD_PARAM_INFO:
+            break;
+        default:
+            if (_rsp.length > 1) print_words(&_rsp, "page");
+            else printf("ok\n");
+            break;
+    }
+
+    return(0);
+}
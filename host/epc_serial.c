@@ -0,0 +1,68 @@
+/*
+ * File:   epc_serial.c
+ * Author: M91406
+ *
+ * Created on November 24, 2020, 2:05 PM
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <asm/termbits.h> // termios2 for arbitrary baud rates (must not be mixed with <termios.h>)
+
+#include "epc_serial.h"
+
+/*!epc_serial_open()
+ *****************************************************************************
+ * Summary:
+ * Opens a serial port in raw 8N1 mode at the given baud rate
+ *
+ * Description:
+ * The baud rate is set using the BOTHER flag, so any baud rate supported
+ * by the serial adapter can be used (e.g. 921600, 2000000, 3000000 baud).
+ * Pseudo terminals are accepted as well. Returns the file descriptor or -1.
+ *
+ *****************************************************************************/
+
+int epc_serial_open(const char* device, uint32_t baudrate)
+{
+    struct termios2 _tio;
+    int _fd=0;
+
+    _fd = open(device, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (_fd < 0)
+        return(-1);
+
+    if (ioctl(_fd, TCGETS2, &_tio) < 0)
+    {
+        close(_fd);
+        return(-1);
+    }
+
+    // Raw mode, 8 data bits, no parity, 1 stop bit, no flow control
+    _tio.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF | IXANY);
+    _tio.c_oflag &= ~OPOST;
+    _tio.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+    _tio.c_cflag &= ~(CSIZE | PARENB | CSTOPB | CRTSCTS | CBAUD);
+    _tio.c_cflag |= (CS8 | CLOCAL | CREAD | BOTHER);
+    _tio.c_ispeed = baudrate;
+    _tio.c_ospeed = baudrate;
+    _tio.c_cc[VMIN] = 0;
+    _tio.c_cc[VTIME] = 0;
+
+    if (ioctl(_fd, TCSETS2, &_tio) < 0)
+    {
+        close(_fd);
+        return(-1);
+    }
+
+    ioctl(_fd, TCFLSH, TCIOFLUSH); // drop stale data
+
+    return(_fd);
+}
+
+void epc_serial_close(int fd)
+{
+    if (fd >= 0)
+        close(fd);
+}
@@ -0,0 +1,27 @@
+/*
+ * File:   epc_serial.h
+ * Author: M91406
+ * Comments: serial port access of the host tools (Linux)
+ * Revision history:
+ * 1.0  initial release
+ */
+
+#ifndef EPC_SERIAL_HOST_HEADER_H
+#define	EPC_SERIAL_HOST_HEADER_H
+
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define EPC_SERIAL_BAUDRATE     921600U // default baud rate (UART_BAUDRATE of the firmware)
+
+extern int epc_serial_open(const char* device, uint32_t baudrate);
+extern void epc_serial_close(int fd);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* EPC_SERIAL_HOST_HEADER_H */
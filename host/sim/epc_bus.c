@@ -0,0 +1,289 @@
+/*
+ * File:   epc_bus.c
+ * Author: M91406
+ *
+ * Created on November 30, 2020, 1:45 PM
+ *
+ * Virtual half-duplex serial bus (RS-485 stand-in) connecting the host tools
+ * to several instances of the firmware simulation:
+ *
+ *   epc_bus [-l link] [-b baudrate] [-t seconds] socket
+ *
+ *   -l link     create a symbolic link to the pseudo terminal of the host (e.g. /tmp/epcbus)
+ *   -b baudrate baud rate of the bus (default 921600)
+ *   -t seconds  run time (default 0 = until terminated)
+ *   socket      UNIX socket the simulations connect to (epc_sim -B socket)
+ *
+ * The host tools open the pseudo terminal, each simulation connects to the
+ * socket (SOCK_SEQPACKET, one message per transmission). In steps of 1 ms all
+ * bytes sent by one participant are forwarded to all other participants. The
+ * bus is occupied by the sender for the transmission time of these bytes at
+ * the bus baud rate. When more than one participant sends in the same step or
+ * a participant sends while the bus is occupied by another participant, the
+ * transmissions collide: the bytes are corrupted, forwarded followed by a
+ * frame delimiter and counted as collision. The number of collisions is
+ * reported when the bus is terminated.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pty.h>
+#include <termios.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define BUS_TICK_NS         1000000L    // real time step in [ns]
+#define BUS_NODES_MAX       17          // host + 16 simulations
+#define BUS_STEP_BYTES      1024        // maximum number of bytes per participant and step
+
+/*!BUS_NODE_t
+ * Participant of the bus
+ */
+typedef struct {
+    int fd;                     // pseudo terminal master (host) or socket (simulation), -1 = unused
+    uint8_t data[BUS_STEP_BYTES]; // bytes sent in the current step
+    size_t length;              // number of bytes sent in the current step
+    unsigned long bytes;        // number of bytes sent
+} BUS_NODE_t;
+
+static volatile sig_atomic_t bus_stop = 0;
+
+static void bus_signal(int signal)
+{
+    (void)signal;
+    bus_stop = 1;
+}
+
+/*!bus_receive()
+ *****************************************************************************
+ * Summary:
+ * Collects the bytes sent by a participant in the current step
+ *
+ * Description:
+ * Returns false when the participant has disconnected.
+ *****************************************************************************/
+
+static int bus_receive(BUS_NODE_t* node)
+{
+    ssize_t _n=0;
+
+    node->length = 0;
+    while (node->length < BUS_STEP_BYTES)
+    {
+        _n = read(node->fd, &node->data[node->length], (BUS_STEP_BYTES - node->length));
+        if (_n > 0)
+        {
+            node->length += (size_t)_n;
+            continue;
+        }
+        if ((_n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)))
+            break;
+        if ((_n < 0) && (errno == EIO))
+            break; // pseudo terminal not opened by the host
+        return(0);
+    }
+
+    node->bytes += node->length;
+    return(1);
+}
+
+/*!bus_forward()
+ *****************************************************************************
+ * Summary:
+ * Sends bytes to all participants except the sender
+ *****************************************************************************/
+
+static void bus_forward(BUS_NODE_t* node, int sender, const uint8_t* data, size_t length)
+{
+    int _i=0;
+
+    for (_i=0; _i<BUS_NODES_MAX; _i++)
+    {
+        if ((_i == sender) || (node[_i].fd < 0))
+            continue;
+        if (_i == 0)
+            (void)!write(node[_i].fd, data, length);
+        else
+            send(node[_i].fd, data, length, MSG_NOSIGNAL);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    static BUS_NODE_t _node[BUS_NODES_MAX];
+    const char* _link = NULL;
+    const char* _bus = NULL;
+    double _baudrate = 921600.0;
+    long _run_time = 0;
+    long _tick = 0;
+    long _busy_until = 0;
+    int _busy_owner = -1;
+    unsigned long _collisions = 0;
+    unsigned long _transmissions = 0;
+    struct timespec _next;
+    struct termios _tio;
+    struct sockaddr_un _sa;
+    char _name[64];
+    int _slave = 0;
+    int _listen = -1;
+    int _fd = -1;
+    int _senders = 0;
+    int _sender = -1;
+    int _opt = 0;
+    int _i = 0;
+    size_t _b = 0;
+    uint8_t _delimiter = 0;
+
+    while ((_opt = getopt(argc, argv, "l:b:t:")) != -1)
+    {
+        switch (_opt)
+        {
+            case 'l': _link = optarg; break;
+            case 'b': _baudrate = atof(optarg); break;
+            case 't': _run_time = atol(optarg) * 1000; break;
+            default:
+                fprintf(stderr, "usage: epc_bus [-l link] [-b baudrate] [-t seconds] socket\n");
+                return(2);
+        }
+    }
+    if ((optind != (argc - 1)) || (_baudrate <= 0.0))
+    {
+        fprintf(stderr, "usage: epc_bus [-l link] [-b baudrate] [-t seconds] socket\n");
+        return(2);
+    }
+    _bus = argv[optind];
+
+    for (_i=0; _i<BUS_NODES_MAX; _i++)
+        _node[_i].fd = -1;
+
+    // Host side: pseudo terminal
+    if (openpty(&_node[0].fd, &_slave, _name, NULL, NULL) < 0)
+    {
+        perror("openpty");
+        return(1);
+    }
+    tcgetattr(_slave, &_tio);   // the slave stays open, so the master never reports a hang-up
+    cfmakeraw(&_tio);
+    tcsetattr(_slave, TCSANOW, &_tio);
+    fcntl(_node[0].fd, F_SETFL, O_NONBLOCK);
+    if (_link != NULL)
+    {
+        unlink(_link);
+        if (symlink(_name, _link) < 0)
+        {
+            perror(_link);
+            return(1);
+        }
+    }
+
+    // Simulation side: UNIX socket
+    memset(&_sa, 0, sizeof(_sa));
+    _sa.sun_family = AF_UNIX;
+    strncpy(_sa.sun_path, _bus, (sizeof(_sa.sun_path) - 1));
+    unlink(_bus);
+    _listen = socket(AF_UNIX, (SOCK_SEQPACKET | SOCK_NONBLOCK), 0);
+    if ((_listen < 0) || (bind(_listen, (struct sockaddr*)&_sa, sizeof(_sa)) < 0) ||
+        (listen(_listen, BUS_NODES_MAX) < 0))
+    {
+        perror(_bus);
+        return(1);
+    }
+    printf("%s\n", _name);
+    fflush(stdout);
+
+    signal(SIGINT, bus_signal);
+    signal(SIGTERM, bus_signal);
+    clock_gettime(CLOCK_MONOTONIC, &_next);
+
+    while ((!bus_stop) && ((_run_time == 0) || (_tick < _run_time)))
+    {
+        // Connect new simulations
+        while ((_fd = accept(_listen, NULL, NULL)) >= 0)
+        {
+            fcntl(_fd, F_SETFL, O_NONBLOCK);
+            for (_i=1; (_i<BUS_NODES_MAX) && (_node[_i].fd >= 0); _i++);
+            if (_i == BUS_NODES_MAX) { close(_fd); continue; }
+            _node[_i].fd = _fd;
+            _node[_i].bytes = 0;
+        }
+
+        // Collect the bytes sent by all participants in this step
+        _senders = 0;
+        for (_i=0; _i<BUS_NODES_MAX; _i++)
+        {
+            if (_node[_i].fd < 0)
+                continue;
+            if (!bus_receive(&_node[_i]))
+            {
+                close(_node[_i].fd); // simulation disconnected
+                _node[_i].fd = -1;
+                continue;
+            }
+            if (_node[_i].length > 0)
+            {
+                _senders++;
+                _sender = _i;
+            }
+        }
+
+        // Forward transmissions, corrupt colliding transmissions
+        if ((_senders > 1) || ((_senders == 1) && (_sender != _busy_owner) && (_tick < _busy_until)))
+        {
+            _collisions++;
+            for (_i=0; _i<BUS_NODES_MAX; _i++)
+            {
+                if ((_node[_i].fd < 0) || (_node[_i].length == 0))
+                    continue;
+                for (_b=0; _b<_node[_i].length; _b++)
+                    _node[_i].data[_b] ^= 0x55;
+                bus_forward(_node, _i, _node[_i].data, _node[_i].length);
+                bus_forward(_node, _i, &_delimiter, 1);
+                _busy_until = (_tick + 1 + (long)((_node[_i].length * 10.0 * 1000.0) / _baudrate));
+            }
+            _busy_owner = -1;
+        }
+        else if (_senders == 1)
+        {
+            _transmissions++;
+            bus_forward(_node, _sender, _node[_sender].data, _node[_sender].length);
+            _busy_until = (_tick + 1 + (long)((_node[_sender].length * 10.0 * 1000.0) / _baudrate));
+            _busy_owner = _sender;
+        }
+
+        // Wait for next step
+        _tick++;
+        _next.tv_nsec += BUS_TICK_NS;
+        if (_next.tv_nsec >= 1000000000L)
+        {
+            _next.tv_nsec -= 1000000000L;
+            _next.tv_sec++;
+        }
+        while ((clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &_next, NULL) == EINTR) && (!bus_stop));
+    }
+
+    fprintf(stderr, "bus: %lu transmissions, %lu collisions\n", _transmissions, _collisions);
+    for (_i=0; _i<BUS_NODES_MAX; _i++)
+    {
+        if (_node[_i].fd < 0)
+            continue;
+        fprintf(stderr, "bus: %s %d sent %lu bytes\n", ((_i == 0) ? "host" : "node"), _i, _node[_i].bytes);
+        close(_node[_i].fd);
+    }
+
+    if (_link != NULL)
+        unlink(_link);
+    unlink(_bus);
+    close(_listen);
+    close(_slave);
+
+    return((_collisions > 0) ? 3 : 0);
+}
@@ -0,0 +1,596 @@
+/*
+ * File:   epc_rack.c
+ * Author: M91406
+ *
+ * Created on December 4, 2020, 9:15 AM
+ *
+ * Converter driver instances of the firmware simulation (epc_sim -N count):
+ * the buck converter state machine (pwr_control/devices/dev_buck_converter.c)
+ * and the reference trajectory generator (dev_buck_ref_traj.c) are compiled
+ * from the firmware sources and executed on a rack of independent converter
+ * objects, each running on its own thread.
+ *
+ * Each module owns its BUCK_POWER_CONTROLLER_t object, controller objects,
+ * ADC result buffers, PWM duty cycle registers and an averaged model of the
+ * two-phase power stage. The controller objects are configured like the
+ * firmware does (app_power_control.c) but point to the buffers of their own
+ * module. The assembly control loops are replaced by PI controllers in C
+ * operating on the same controller object ports, limits and function pointers.
+ *
+ * The modules advance in real time in steps of 1 ms. Each step runs the
+ * control interrupt code SWITCHING_FREQUENCY/1000 times and the power control
+ * task (state machine) every MAIN_EXECUTION_PERIOD. Module k regulates to the
+ * nominal output voltage trimmed by ((k % 5) - 2) percent; its electronic load
+ * of (2 + k % 8) ampere is switched on by the POWER GOOD output of the module,
+ * so a state or reference shared between instances shows up in the summary
+ * printed when the rack is stopped.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/devices/dev_buck_typedef.h"
+#include "pwr_control/devices/dev_buck_converter.h"
+#include "epc_rack.h"
+
+#define RACK_TICK_NS            1000000L    // real time step in [ns]
+#define RACK_TASKS_PER_TICK     ((uint16_t)(1.0e-3 / MAIN_EXECUTION_PERIOD + 0.5)) // state machine calls per step
+#define RACK_CYCLES_PER_TASK    ((uint16_t)(SWITCHING_FREQUENCY * MAIN_EXECUTION_PERIOD + 0.5)) // control cycles per state machine call
+
+#define RACK_INDUCTANCE         2.2e-6      // phase inductance of the model in [H]
+#define RACK_CAPACITANCE        240.0e-6    // output capacitance of the model in [F]
+#define RACK_RESISTANCE         10.0e-3     // phase resistance of the model in [Ohm]
+#define RACK_DIODE_DROP         0.7         // body diode forward voltage while the PWM outputs are off in [V]
+
+/*!RACK_LOOP_t
+ *****************************************************************************
+ * Summary:
+ * PI controller operating on the ports of a controller object
+ *
+ * Description:
+ * The controller object is the first member, so the driver operates on it
+ * like on the controller objects of the firmware. The error is the signed
+ * difference between the reference and the source value minus its offset,
+ * both in ADC ticks, the output is clamped to the limits of the controller
+ * object and written to the primary and, if set, the alternate target.
+ *
+ *****************************************************************************/
+typedef struct {
+    volatile NPNZ16b_t npnz;    // controller object operated by the driver
+    double kp;                  // proportional gain in [output ticks/input tick]
+    double ki;                  // integral gain per control cycle in [output ticks/input tick]
+    double integral;            // integrator (control output history) in [output ticks]
+} RACK_LOOP_t;
+
+/*!RACK_MODULE_t
+ *****************************************************************************
+ * Summary:
+ * Converter driver instance with its peripherals and power stage model
+ *****************************************************************************/
+typedef struct {
+    uint16_t index;                     // module number in the rack
+    volatile BUCK_POWER_CONTROLLER_t buck; // converter object of this module
+    RACK_LOOP_t v_loop;                 // voltage loop controller
+    RACK_LOOP_t i_loop[2];              // phase current loop controllers
+    volatile uint16_t adc_vin;          // ADC result buffer input voltage
+    volatile uint16_t adc_vout;         // ADC result buffer output voltage
+    volatile uint16_t adc_isns[2];      // ADC result buffers phase currents
+    volatile uint16_t pdc[2];           // PWM duty cycle registers
+    volatile bool pwm_running;          // PWM module running
+    volatile bool pwm_outputs;          // PWM outputs enabled
+    volatile bool power_good;           // POWER GOOD output
+    double v_in;                        // input voltage in [V]
+    double v_out;                       // output voltage in [V]
+    double i_phase[2];                  // phase currents in [A]
+    double i_load;                      // electronic load current in [A] (on while POWER GOOD is set)
+    uint32_t noise;                     // noise generator state
+    pthread_t thread;                   // thread executing this module
+} RACK_MODULE_t;
+
+static RACK_MODULE_t rack[RACK_MODULES_MAX];
+static uint16_t rack_count = 0;
+static atomic_bool rack_stop_request = false;
+
+static const char* rack_state_names[BUCK_STATE_COUNT] = {
+    "INITIALIZE", "RESET", "STANDBY", "POWER_ON_DELAY", "LAUNCH_V_RAMP",
+    "V_RAMP_UP", "I_RAMP_UP", "PWRGOOD_DELAY", "ONLINE", "SUSPEND"
+};
+
+/*!rack_find()
+ *****************************************************************************
+ * Summary:
+ * Returns the module owning the given converter object (NULL if none)
+ *****************************************************************************/
+
+static RACK_MODULE_t* rack_find(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    uint16_t _i=0;
+
+    for (_i=0; _i<rack_count; _i++)
+    {
+        if (&rack[_i].buck == buckInstance)
+            return(&rack[_i]);
+    }
+    return(NULL);
+}
+
+/* Peripheral functions of the converter driver (pwr_control/drivers) */
+
+volatile uint16_t buckPWM_Start(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    RACK_MODULE_t* _module = rack_find(buckInstance);
+
+    if (_module == NULL) return(0);
+    _module->pdc[0] = buckInstance->sw_node[0].duty_ratio_init;
+    _module->pdc[1] = buckInstance->sw_node[1].duty_ratio_init;
+    _module->pwm_outputs = false; // PWM starts with all outputs disabled
+    _module->pwm_running = true;
+    return(1);
+}
+
+volatile uint16_t buckPWM_Stop(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    RACK_MODULE_t* _module = rack_find(buckInstance);
+
+    if (_module == NULL) return(0);
+    _module->pwm_outputs = false;
+    _module->pwm_running = false;
+    return(1);
+}
+
+volatile uint16_t buckPWM_Suspend(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    RACK_MODULE_t* _module = rack_find(buckInstance);
+
+    if (_module == NULL) return(0);
+    _module->pwm_outputs = false;
+    return(1);
+}
+
+volatile uint16_t buckPWM_Resume(volatile BUCK_POWER_CONTROLLER_t* buckInstance)
+{
+    RACK_MODULE_t* _module = rack_find(buckInstance);
+
+    if (_module == NULL) return(0);
+    _module->pwm_outputs = _module->pwm_running;
+    return((uint16_t)_module->pwm_running);
+}
+
+volatile uint16_t buckGPIO_Set(volatile BUCK_GPIO_INSTANCE_t* buckGPIOInstance)
+{
+    uint16_t _i=0;
+
+    for (_i=0; _i<rack_count; _i++)
+    {
+        if (&rack[_i].buck.gpio.PowerGood == buckGPIOInstance)
+        { rack[_i].power_good = true; return(1); }
+    }
+    return(0);
+}
+
+volatile uint16_t buckGPIO_Clear(volatile BUCK_GPIO_INSTANCE_t* buckGPIOInstance)
+{
+    uint16_t _i=0;
+
+    for (_i=0; _i<rack_count; _i++)
+    {
+        if (&rack[_i].buck.gpio.PowerGood == buckGPIOInstance)
+        { rack[_i].power_good = false; return(1); }
+    }
+    return(0);
+}
+
+volatile bool buckGPIO_GetPinState(volatile BUCK_GPIO_INSTANCE_t* buckGPIOInstance)
+{
+    (void)buckGPIOInstance;
+    return(true); // the external ENABLE input is not used by the modules
+}
+
+/* Control loop functions (stand-ins of the assembly routines v_loop_Update, etc.) */
+
+static volatile uint16_t rack_loop_Initialize(volatile NPNZ16b_t* controller)
+{
+    ((RACK_LOOP_t*)controller)->integral = 0.0;
+    return(1);
+}
+
+static void rack_loop_Reset(volatile NPNZ16b_t* controller)
+{
+    ((RACK_LOOP_t*)controller)->integral = 0.0;
+}
+
+static void rack_loop_Precharge(volatile NPNZ16b_t* controller,
+            volatile fractional ctrl_input, volatile fractional ctrl_output)
+{
+    (void)ctrl_input;
+    ((RACK_LOOP_t*)controller)->integral = (double)ctrl_output;
+}
+
+static void rack_loop_Update(volatile NPNZ16b_t* controller)
+{
+    RACK_LOOP_t* _loop = (RACK_LOOP_t*)controller;
+    double _min = (double)controller->Limits.MinOutput;
+    double _max = (double)controller->Limits.MaxOutput;
+    double _error = 0.0;
+    double _output = 0.0;
+    int16_t _input = 0;
+
+    if (!controller->status.bits.enabled) return;
+
+    _input = (int16_t)(*controller->Ports.Source.ptrAddress - (uint16_t)controller->Ports.Source.Offset);
+    _error = ((double)(int16_t)*controller->Ports.ptrControlReference - (double)_input);
+
+    // Integrator with anti-windup
+    _loop->integral += (_loop->ki * _error);
+    if (_loop->integral < _min) _loop->integral = _min;
+    else if (_loop->integral > _max) _loop->integral = _max;
+
+    _output = (_loop->integral + (_loop->kp * _error));
+    controller->status.bits.lower_saturation_event = (bool)(_output <= _min);
+    controller->status.bits.upper_saturation_event = (bool)(_output >= _max);
+    if (_output < _min) _output = _min;
+    else if (_output > _max) _output = _max;
+
+    *controller->Ports.Target.ptrAddress = (uint16_t)(int16_t)_output;
+    if (controller->Ports.AltTarget.ptrAddress != NULL)
+        *controller->Ports.AltTarget.ptrAddress = (uint16_t)(int16_t)_output;
+}
+
+static double rack_noise(RACK_MODULE_t* module, double amplitude)
+{
+    module->noise = (module->noise * 1664525U) + 1013904223U;
+    return(amplitude * (((double)(module->noise >> 8) / (double)(1U << 24)) - 0.5));
+}
+
+static uint16_t rack_ticks(double voltage)
+{
+    double _ticks = (voltage / ADC_GRAN);
+
+    if (_ticks < 0.0) return(0);
+    if (_ticks > ADC_VALUE_MAX) return(ADC_VALUE_MAX);
+    return((uint16_t)_ticks);
+}
+
+/*!rack_control_cycle()
+ *****************************************************************************
+ * Summary:
+ * Advances the power stage model by one switching period and runs the control
+ * interrupt code of the module
+ *
+ * Description:
+ * The switch node voltage of each phase is the duty ratio times the input
+ * voltage while the PWM outputs are enabled. While they are off, the phase
+ * currents decay through the body diodes. After the plant update the ADC
+ * result buffers are written and the control loops and the trajectory
+ * generator are executed like in _BUCK_VLOOP_Interrupt.
+ *
+ *****************************************************************************/
+
+static void rack_control_cycle(RACK_MODULE_t* module)
+{
+    const double _dt = (1.0 / SWITCHING_FREQUENCY);
+    volatile BUCK_POWER_CONTROLLER_t* _buck = &module->buck;
+    double _v_sw = 0.0;
+    double _i_out = 0.0;
+    uint16_t _i=0;
+
+    for (_i=0; _i<2; _i++)
+    {
+        if (module->pwm_outputs)
+        {
+            _v_sw = ((double)module->pdc[_i] / (double)_buck->sw_node[_i].period * module->v_in);
+            module->i_phase[_i] += ((_v_sw - module->v_out - (module->i_phase[_i] * RACK_RESISTANCE))
+                                    * _dt / RACK_INDUCTANCE);
+        }
+        else if (module->i_phase[_i] > 0.0)
+        {
+            module->i_phase[_i] -= ((module->v_out + RACK_DIODE_DROP) * _dt / RACK_INDUCTANCE);
+            if (module->i_phase[_i] < 0.0) module->i_phase[_i] = 0.0;
+        }
+        else if (module->i_phase[_i] < 0.0)
+        {
+            module->i_phase[_i] += ((module->v_in + RACK_DIODE_DROP - module->v_out) * _dt / RACK_INDUCTANCE);
+            if (module->i_phase[_i] > 0.0) module->i_phase[_i] = 0.0;
+        }
+        _i_out += module->i_phase[_i];
+    }
+    if ((module->power_good) && (module->v_out > 0.0))
+        _i_out -= module->i_load;
+    module->v_out += (_i_out * _dt / RACK_CAPACITANCE);
+    if (module->v_out < 0.0) module->v_out = 0.0;
+
+    // ADC conversions triggered by the PWM
+    module->adc_vin = rack_ticks((module->v_in + rack_noise(module, 0.2)) * BUCK_VIN_FEEDBACK_GAIN);
+    module->adc_vout = rack_ticks((module->v_out + rack_noise(module, 0.02)) * BUCK_VOUT_FEEDBACK_GAIN);
+    module->adc_isns[0] = rack_ticks(((module->i_phase[0] + rack_noise(module, 0.1)) *
+                            BUCK_ISNS_FEEDBACK_GAIN) + BUCK_ISNS1_FEEDBACK_OFFSET);
+    module->adc_isns[1] = rack_ticks(((module->i_phase[1] + rack_noise(module, 0.1)) *
+                            BUCK_ISNS_FEEDBACK_GAIN) + BUCK_ISNS2_FEEDBACK_OFFSET);
+    _buck->data.v_out = module->adc_vout; // data provider of the voltage loop
+
+    // Firmware code of the control interrupt
+    _buck->status.bits.adc_active = true;
+    _buck->v_loop.ctrl_Update(_buck->v_loop.controller);
+    _buck->i_loop[0].ctrl_Update(_buck->i_loop[0].controller);
+    _buck->i_loop[1].ctrl_Update(_buck->i_loop[1].controller);
+    buckTraj_Update(&_buck->v_traj);
+}
+
+/*!rack_execute()
+ *****************************************************************************
+ * Summary:
+ * Power control task of the module (see appPowerSupply_Execute)
+ *****************************************************************************/
+
+static void rack_execute(RACK_MODULE_t* module)
+{
+    volatile BUCK_POWER_CONTROLLER_t* _buck = &module->buck;
+
+    // Capture most recent samples
+    _buck->data.v_in = module->adc_vin;
+    _buck->data.i_sns[0] = module->adc_isns[0];
+    _buck->data.i_sns[1] = module->adc_isns[1];
+    _buck->data.i_out = (_buck->data.i_sns[0] + _buck->data.i_sns[1]);
+
+    // Check conditional parameters (the fault handler is not part of the rack)
+    _buck->status.bits.power_source_detected = (bool)
+        ((BUCK_VIN_UVLO_TRIP < _buck->data.v_in) && (_buck->data.v_in < BUCK_VIN_OVLO_TRIP));
+    _buck->status.bits.fault_active = false;
+
+    // Execute buck converter state machine
+    drv_BuckConverter_Execute(_buck);
+}
+
+/*!rack_loop_initialize()
+ *****************************************************************************
+ * Summary:
+ * Configures the controller object of a control loop of the module
+ * (see appPowerSupply_ControllerInitialize)
+ *****************************************************************************/
+
+static void rack_loop_initialize(volatile BUCK_LOOP_SETTINGS_t* settings, RACK_LOOP_t* loop,
+        volatile uint16_t* source, volatile uint16_t* target, volatile uint16_t* alt_target,
+        volatile uint16_t* reference)
+{
+    volatile NPNZ16b_t* _ctrl = &loop->npnz;
+
+    settings->controller = _ctrl;
+    settings->ctrl_Initialization = &rack_loop_Initialize;
+    settings->ctrl_Update = &rack_loop_Update;
+    settings->ctrl_Reset = &rack_loop_Reset;
+    settings->ctrl_Precharge = &rack_loop_Precharge;
+    settings->ctrl_Initialization(_ctrl);
+
+    _ctrl->Ports.Source.ptrAddress = source;
+    _ctrl->Ports.Source.Offset = (int16_t)settings->feedback_offset;
+    _ctrl->Ports.AltSource.ptrAddress = NULL;
+    _ctrl->Ports.Target.ptrAddress = target;
+    _ctrl->Ports.AltTarget.ptrAddress = alt_target;
+    _ctrl->Ports.ptrControlReference = reference;
+    _ctrl->Limits.MinOutput = settings->minimum;
+    _ctrl->Limits.MaxOutput = (int16_t)settings->maximum;
+    _ctrl->status.value = 0; // Keep controller disabled
+}
+
+/*!rack_initialize()
+ *****************************************************************************
+ * Summary:
+ * Initializes the converter object of a module (see appPowerSupply_Initialize)
+ *
+ * Description:
+ * The control loop gains are set for crossover frequencies of about 20 kHz
+ * (current loops) and 2 kHz (voltage loop) of the power stage model.
+ *
+ *****************************************************************************/
+
+static uint16_t rack_initialize(RACK_MODULE_t* module, uint16_t index)
+{
+    volatile BUCK_POWER_CONTROLLER_t* _buck = &module->buck;
+    uint16_t _i=0;
+    uint16_t retval=1;
+
+    memset(module, 0, sizeof(RACK_MODULE_t));
+    module->index = index;
+    module->v_in = BUCK_VIN_NOMINAL;
+    module->i_load = (2.0 + (double)(index % 8));
+    module->noise = (12345U + index);
+
+    // Converter object status and reference values
+    _buck->status.bits.cs_calib = false; // Current sense offsets of the model are exact
+    _buck->status.bits.autorun = true;
+    _buck->mode = BUCK_STATE_INITIALIZE;
+    _buck->set_values.control_mode = BUCK_CONTROL_MODE_ACMC;
+    _buck->set_values.i_ref = BUCK_ISNS_REF;
+    _buck->set_values.i_limit = BUCK_ISNS_REF_MAX;
+    _buck->set_values.v_ref = (uint16_t)(BUCK_VOUT_REF + ((int16_t)((index % 5) - 2) * (BUCK_VOUT_REF / 100)));
+    _buck->set_values.phases = BUCK_NO_OF_PHASES;
+
+    // Switch nodes, GPIOs and feedback scaling
+    for (_i=0; _i<2; _i++)
+    {
+        _buck->sw_node[_i].period = BUCK_PWM_PERIOD;
+        _buck->sw_node[_i].duty_ratio_min = BUCK_PWM_DC_MIN;
+        _buck->sw_node[_i].duty_ratio_init = BUCK_PWM_DC_MIN;
+        _buck->sw_node[_i].duty_ratio_max = BUCK_PWM_DC_MAX;
+    }
+    _buck->gpio.Enable.enabled = false;
+    _buck->gpio.PowerGood.enabled = true;
+    _buck->feedback.ad_vin.adc_buffer = &module->adc_vin;
+    _buck->feedback.ad_vin.scaling.factor = BUCK_VIN_NORM_FACTOR;
+    _buck->feedback.ad_vin.scaling.scaler = BUCK_VIN_NORM_SCALER;
+    _buck->feedback.ad_vin.scaling.offset = BUCK_VIN_OFFSET;
+    _buck->feedback.ad_vout.adc_buffer = &module->adc_vout;
+    _buck->feedback.ad_vout.scaling.factor = BUCK_VOUT_NORM_FACTOR;
+    _buck->feedback.ad_vout.scaling.scaler = BUCK_VOUT_NORM_SCALER;
+    _buck->feedback.ad_vout.scaling.offset = BUCK_VOUT_OFFSET;
+    _buck->feedback.ad_isns[0].adc_buffer = &module->adc_isns[0];
+    _buck->feedback.ad_isns[1].adc_buffer = &module->adc_isns[1];
+
+    // Startup settings
+    _buck->startup.power_on_delay.period = BUCK_POD;
+    _buck->startup.v_ramp.period = BUCK_VRAMP_PER;
+    _buck->startup.v_ramp.ref_inc_step = ((BUCK_VREF_STEP > 0) ? BUCK_VREF_STEP : 1);
+    _buck->startup.i_ramp.period = BUCK_IRAMP_PER;
+    _buck->startup.i_ramp.ref_inc_step = ((BUCK_IREF_STEP > 0) ? BUCK_IREF_STEP : 1);
+    _buck->startup.i_ramp.reference = BUCK_ISNS_REF;
+    _buck->startup.i_load = BUCK_ISNS_LOAD;
+    _buck->startup.power_good_delay.period = BUCK_PGD;
+    _buck->startup.power_good_delay.reference = _buck->set_values.v_ref;
+    _buck->v_traj.scaler = BUCK_TRAJ_SCALER;
+    _buck->v_traj.steps_per_tick = BUCK_TRAJ_STEPS;
+    retval &= buckTraj_Initialize(&_buck->v_traj);
+
+    // Control loops
+    _buck->v_loop.feedback_offset = BUCK_VOUT_OFFSET;
+    _buck->v_loop.reference = _buck->set_values.v_ref;
+    _buck->v_loop.minimum = (int16_t)(-BUCK_ISNS_REF_MAX);
+    _buck->v_loop.maximum = BUCK_ISNS_REF_MAX;
+    rack_loop_initialize(&_buck->v_loop, &module->v_loop, &module->adc_vout,
+            &_buck->i_loop[0].reference, &_buck->i_loop[1].reference, &_buck->set_values.v_ref);
+    module->v_loop.kp = 0.36;
+    module->v_loop.ki = 0.0014;
+
+    _buck->i_loop[0].feedback_offset = BUCK_ISNS1_OFFFSET;
+    _buck->i_loop[1].feedback_offset = BUCK_ISNS2_OFFFSET;
+    for (_i=0; _i<2; _i++)
+    {
+        _buck->i_loop[_i].reference = BUCK_ISNS_REF;
+        _buck->i_loop[_i].minimum = BUCK_PWM_DC_MIN;
+        _buck->i_loop[_i].maximum = BUCK_PWM_DC_MAX;
+        rack_loop_initialize(&_buck->i_loop[_i], &module->i_loop[_i], &module->adc_isns[_i],
+                &module->pdc[_i], NULL, &_buck->i_loop[_i].reference);
+        module->i_loop[_i].kp = 0.75;
+        module->i_loop[_i].ki = 0.019;
+    }
+
+    // Sequence peripheral startup and enable the converter
+    retval &= drv_BuckConverter_Initialize(_buck);
+    retval &= buckPWM_Start(_buck);
+    if (retval) _buck->status.bits.pwm_active = true;
+    _buck->status.bits.enabled = true;
+
+    return(retval);
+}
+
+/*!rack_thread()
+ *****************************************************************************
+ * Summary:
+ * Executes one module in real time until the rack is stopped
+ *****************************************************************************/
+
+static void* rack_thread(void* arg)
+{
+    RACK_MODULE_t* _module = (RACK_MODULE_t*)arg;
+    struct timespec _next;
+    uint16_t _t=0, _c=0;
+
+    clock_gettime(CLOCK_MONOTONIC, &_next);
+
+    while (!atomic_load(&rack_stop_request))
+    {
+        for (_t=0; _t<RACK_TASKS_PER_TICK; _t++)
+        {
+            for (_c=0; _c<RACK_CYCLES_PER_TASK; _c++)
+                rack_control_cycle(_module);
+            rack_execute(_module);
+        }
+
+        _next.tv_nsec += RACK_TICK_NS;
+        if (_next.tv_nsec >= 1000000000L)
+        {
+            _next.tv_nsec -= 1000000000L;
+            _next.tv_sec++;
+        }
+        while ((clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &_next, NULL) == EINTR) &&
+               (!atomic_load(&rack_stop_request)));
+    }
+
+    return(NULL);
+}
+
+/*!rack_start()
+ *****************************************************************************
+ * Summary:
+ * Initializes the given number of modules and starts their threads
+ *
+ * Returns:
+ * 0 on success, -1 if the number of modules is invalid or a module could
+ * not be started (modules started before keep running until rack_stop)
+ *****************************************************************************/
+
+int rack_start(uint16_t modules)
+{
+    uint16_t _i=0;
+
+    if ((modules == 0) || (modules > RACK_MODULES_MAX) || (rack_count != 0))
+        return(-1);
+
+    // All modules are registered before any thread starts, the peripheral
+    // functions look up the module of a converter object in this table
+    rack_count = modules;
+    for (_i=0; _i<modules; _i++)
+    {
+        if (!rack_initialize(&rack[_i], _i))
+        { rack_count = 0; return(-1); }
+    }
+
+    atomic_store(&rack_stop_request, false);
+    for (_i=0; _i<modules; _i++)
+    {
+        if (pthread_create(&rack[_i].thread, NULL, &rack_thread, &rack[_i]) != 0)
+        {
+            rack_count = _i;
+            return(-1);
+        }
+    }
+
+    return(0);
+}
+
+/*!rack_stop()
+ *****************************************************************************
+ * Summary:
+ * Stops all modules and prints the state of each module
+ *
+ * Returns:
+ * Number of modules which have not been in regulation (state ONLINE) when
+ * the rack was stopped
+ *****************************************************************************/
+
+int rack_stop(void)
+{
+    volatile BUCK_POWER_CONTROLLER_t* _buck;
+    uint16_t _i=0;
+    int _offline=0;
+
+    atomic_store(&rack_stop_request, true);
+    for (_i=0; _i<rack_count; _i++)
+        pthread_join(rack[_i].thread, NULL);
+
+    for (_i=0; _i<rack_count; _i++)
+    {
+        _buck = &rack[_i].buck;
+        printf("module %u: %-14s startup %6.1f ms  v_out %6.3f V (ref %6.3f V)  i_out %5.2f A (load %5.2f A)\n",
+            rack[_i].index,
+            ((_buck->mode < BUCK_STATE_COUNT) ? rack_state_names[_buck->mode] : "?"),
+            ((double)_buck->sm.startup_time * MAIN_EXECUTION_PERIOD * 1.0e+3),
+            rack[_i].v_out,
+            ((double)_buck->set_values.v_ref * ADC_GRAN / BUCK_VOUT_FEEDBACK_GAIN),
+            (rack[_i].i_phase[0] + rack[_i].i_phase[1]),
+            (rack[_i].power_good ? rack[_i].i_load : 0.0));
+        if (_buck->mode != BUCK_STATE_ONLINE)
+            _offline++;
+    }
+    fflush(stdout);
+    rack_count = 0;
+
+    return(_offline);
+}
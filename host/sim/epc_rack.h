@@ -0,0 +1,27 @@
+/*
+ * File:   epc_rack.h
+ * Author: M91406
+ * Comments: converter driver instances of the firmware simulation running on separate threads
+ * Revision history:
+ * 1.0  initial release
+ */
+
+#ifndef EPC_SIM_RACK_HEADER_H
+#define	EPC_SIM_RACK_HEADER_H
+
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define RACK_MODULES_MAX    16U // Maximum number of converter instances
+
+extern int rack_start(uint16_t modules);
+extern int rack_stop(void);
+
+#ifdef	__cplusplus
+}
+#endif /* __cplusplus */
+
+#endif	/* EPC_SIM_RACK_HEADER_H */
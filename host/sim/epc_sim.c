@@ -0,0 +1,624 @@
+/*
+ * File:   epc_sim.c
+ * Author: M91406
+ *
+ * Created on November 27, 2020, 10:30 AM
+ *
+ * Host-native build of the EPC9151 communication firmware serving a pseudo
+ * terminal. The UART protocol layer, telemetry stream, triggered capture,
+ * running statistics, parameter registry, PMBus command layer, engineering
+ * units, settings and setpoint sequencer are compiled from the firmware 
+ * sources; the power stage is replaced by a 
+ * simple behavioral model running at the control rate:
+ *
+ *   epc_sim [-l link | -B socket] [-a address] [-n file] [-i socket] [-b baudrate] 
+ *           [-L load_step_ms] [-F fault_ms] [-N modules] [-t seconds]
+ *
+ *   -l link     create a symbolic link to the pseudo terminal (e.g. /tmp/epc0)
+ *   -B socket   connect to the virtual serial bus of epc_bus instead of a pseudo terminal
+ *   -a address  module address used while no address has been stored (default UART_ADDRESS_DEFAULT)
+ *   -n file     file emulating the settings flash page (default: erased page in memory)
+ *   -i socket   serve the PMBus command layer on an I2C bus stand-in (UNIX socket)
+ *   -b baudrate baud rate emulated on the pseudo terminal (default UART_BAUDRATE)
+ *   -L ms       period of the simulated load steps (default 50 ms, 0 = off)
+ *   -F ms       trip an over current fault after the given time (default off)
+ *   -N modules  run the given number of converter driver instances on separate threads (see epc_rack.c)
+ *   -t seconds  run time (default 0 = until terminated)
+ *
+ * The model advances in real time in steps of 1 ms. Each step runs the control
+ * interrupt code SWITCHING_FREQUENCY/1000 times and the UART and sequencer tasks
+ * once, and transfers at most the number of bytes the emulated baud rate allows.
+ *
+ * Converter driver instances (-N) are executed independently of the behavioral
+ * model served on the UART. When the simulation terminates, the state of each
+ * instance is printed and the exit code is the number of instances which have
+ * not been in regulation.
+ *
+ * I2C bus stand-in: each SOCK_SEQPACKET message is one SMBus transaction of the
+ * bus master, [address][flags][write count][read count][write bytes], where the
+ * write bytes hold the command code and data. Flag bit 0 requests packet error
+ * checking: the master appends the PEC to write transactions and the slave to
+ * read transactions. The slave answers [ACK][read bytes], ACK is 0 when the 
+ * address, command or PEC is not acknowledged.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pty.h>
+#include <termios.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "config/epc9151_r10_hwdescr.h"
+#include "pwr_control/app_power_control.h"
+#include "fault_handler/app_faults.h"
+#include "fault_handler/app_fault_log.h"
+#include "profiler/app_profiler.h"
+#include "sequencer/app_sequencer.h"
+#include "telemetry/app_telemetry.h"
+#include "telemetry/app_capture.h"
+#include "telemetry/app_stats.h"
+#include "tuning/app_params.h"
+#include "pmbus/app_pmbus.h"
+#include "settings/app_settings.h"
+#include "uart/app_uart.h"
+
+#include "epc_rack.h"
+
+#define SIM_TICK_NS         1000000L    // real time step in [ns]
+#define SIM_CYCLES_PER_TICK ((uint32_t)(SWITCHING_FREQUENCY / 1000.0)) // control cycles per step
+#define SIM_PMBUS_ADDRESS   0x40        // 7-bit slave address on the I2C bus stand-in
+#define SIM_SMBUS_PEC       0x01        // transaction flag: packet error checking
+
+// Special function registers used by the firmware modules (see include/xc.h)
+volatile uint16_t U1RXREG, U1TXREG;
+volatile SIM_U1STA_BITS_t U1STAbits;
+volatile SIM_U1STAH_BITS_t U1STAHbits;
+volatile uint16_t _U1RXIE, _U1RXIF, _U1RXIP, _U1TXIE, _U1TXIF, _U1TXIP;
+volatile uint16_t PG2DC, PG4DC;
+
+// Firmware objects of modules not included in the simulation
+volatile BUCK_POWER_CONTROLLER_t buck;
+volatile FLT_ENGINE_t fltengine_Buck;
+volatile FLT_FAST_ENGINE_t fltfast_Buck;
+volatile PROF_OBJECT_t profobj_Main;
+volatile FLOG_OBJECT_t flogobj_Buck;
+
+// Control loop objects and coefficient sets (limits and targets only, the model does not use them)
+volatile struct NPNZ16b_s v_loop, i_loop_1, i_loop_2;
+volatile struct V_LOOP_CONTROL_LOOP_COEFFICIENTS_s v_loop_coefficients;
+volatile struct I_LOOP_1_CONTROL_LOOP_COEFFICIENTS_s i_loop_1_coefficients;
+volatile struct I_LOOP_2_CONTROL_LOOP_COEFFICIENTS_s i_loop_2_coefficients;
+
+// Fault thresholds of the fault definition table (the fault engine is not included,
+// its tunable level copies are initialized from this table at startup)
+const FLT_DEFINITION_t fltdef_Buck[FLT_BUCK_COUNT] = {
+    [FLT_BUCK_OVLO] = { .trip_level = BUCK_VIN_OVLO_TRIP, .reset_level = BUCK_VIN_OVLO_RELEASE },
+    [FLT_BUCK_OCP] = { .trip_level = BUCK_ISNS_OCL, .reset_level = BUCK_ISNS_OCL_RELEASE },
+    [FLT_BUCK_UVLO] = { .trip_level = BUCK_VIN_UVLO_TRIP, .reset_level = BUCK_VIN_UVLO_RELEASE },
+    [FLT_BUCK_REGERR] = { .trip_level = BUCK_VOUT_DEV_TRIP, .reset_level = BUCK_VOUT_DEV_RELEASE },
+    [FLT_BUCK_OCP1] = { .trip_level = BUCK_ISNS_PHASE_OCL, .reset_level = BUCK_ISNS_PHASE_OCL_RELEASE },
+    [FLT_BUCK_OCP2] = { .trip_level = BUCK_ISNS_PHASE_OCL, .reset_level = BUCK_ISNS_PHASE_OCL_RELEASE },
+    [FLT_BUCK_IMBAL] = { .trip_level = BUCK_ISNS_IMBAL, .reset_level = BUCK_ISNS_IMBAL_RELEASE }
+};
+static volatile sig_atomic_t sim_stop = 0;
+
+// Settings flash page (NVM driver), optionally backed by a file
+static uint16_t sim_nvm[NVM_PAGE_WORDS];
+static const char* sim_nvm_file = NULL;
+
+static void sim_nvm_save(void)
+{
+    FILE* _file;
+
+    if ((sim_nvm_file == NULL) || ((_file = fopen(sim_nvm_file, "wb")) == NULL))
+        return;
+    fwrite(sim_nvm, sizeof(uint16_t), NVM_PAGE_WORDS, _file);
+    fclose(_file);
+}
+
+uint16_t nvm_read(volatile uint16_t index)
+{ return((index < NVM_PAGE_WORDS) ? sim_nvm[index] : 0xFFFF); }
+
+volatile uint16_t nvm_write_pair(volatile uint16_t index, volatile uint16_t word0, volatile uint16_t word1)
+{
+    if ((index & 0x0001) || (index >= NVM_PAGE_WORDS)) return(0);
+    sim_nvm[index] &= word0; // programming clears bits only
+    sim_nvm[index + 1] &= word1;
+    sim_nvm_save();
+    return(1);
+}
+
+volatile uint16_t nvm_erase(void)
+{
+    memset(sim_nvm, 0xFF, sizeof(sim_nvm));
+    sim_nvm_save();
+    return(1);
+}
+
+// Profiler and fault log are not available in the simulation
+volatile uint16_t prof_reset(volatile PROF_OBJECT_t* profobj) { (void)profobj; return(0); }
+volatile uint16_t prof_read_page(volatile PROF_OBJECT_t* profobj, volatile uint16_t page, volatile uint16_t* buffer)
+{ (void)profobj; (void)page; (void)buffer; return(0); }
+volatile uint16_t flog_clear(volatile FLOG_OBJECT_t* flogobj) { (void)flogobj; return(0); }
+volatile uint16_t flog_read_page(volatile FLOG_OBJECT_t* flogobj, volatile uint16_t entry,
+                volatile uint16_t page, volatile uint16_t* buffer)
+{ (void)flogobj; (void)entry; (void)page; (void)buffer; return(0); }
+
+/*!SIM_PLANT_t
+ * Behavioral model of the two-phase buck converter in engineering units
+ */
+typedef struct {
+    double v_in;        // input voltage in [V]
+    double v_out;       // output voltage in [V]
+    double i_phase[2];  // phase currents in [A]
+    double i_load;      // load current in [A]
+    uint32_t noise;     // noise generator state
+} SIM_PLANT_t;
+
+/*!sim_smbus_pec()
+ *****************************************************************************
+ * Summary:
+ * Updates the SMBus packet error code (CRC-8, polynomial x^8 + x^2 + x + 1)
+ *****************************************************************************/
+
+static uint8_t sim_smbus_pec(uint8_t pec, const uint8_t* data, size_t length)
+{
+    uint16_t _bit=0;
+
+    while (length--)
+    {
+        pec ^= *data++;
+        for (_bit=0; _bit<8; _bit++)
+            pec = ((pec & 0x80) ? (uint8_t)((pec << 1) ^ 0x07) : (uint8_t)(pec << 1));
+    }
+
+    return(pec);
+}
+
+/*!sim_smbus_transaction()
+ *****************************************************************************
+ * Summary:
+ * Executes an SMBus transaction of the I2C bus stand-in on the PMBus command layer
+ *
+ * Description:
+ * Transactions without read bytes are write transactions (send byte, write 
+ * byte/word), transactions with read bytes are read transactions with 
+ * repeated start (read byte/word). Transactions failing the PEC are not 
+ * executed and reported in STATUS_CML.
+ *
+ *****************************************************************************/
+
+static size_t sim_smbus_transaction(const uint8_t* msg, size_t length, uint8_t* rsp)
+{
+    uint8_t _addr[2] = { 0, 0 };
+    uint8_t _pec = 0;
+    uint8_t _data[2] = { 0, 0 };
+    bool _use_pec = false;
+    size_t _write = 0;
+    size_t _read = 0;
+    size_t _n = 0;
+
+    rsp[0] = 0; // NACK
+    if ((length < 4) || (msg[0] != SIM_PMBUS_ADDRESS)) return(1);
+
+    _use_pec = (msg[1] & SIM_SMBUS_PEC);
+    _write = msg[2];
+    _read = msg[3];
+    if ((_write < 1) || (length != (4 + _write))) return(1);
+
+    _addr[0] = (uint8_t)(msg[0] << 1);          // address, write
+    _addr[1] = (uint8_t)((msg[0] << 1) | 1);    // address, read
+    _pec = sim_smbus_pec(0, &_addr[0], 1);
+
+    if (_read == 0)
+    {
+        if (_use_pec)
+        {
+            _write--;
+            if ((_write < 1) || (sim_smbus_pec(_pec, &msg[4], _write) != msg[4 + _write]))
+            {
+                pmbusobj_Buck.status_cml |= PMBUS_CML_PEC_FAILED;
+                return(1);
+            }
+        }
+        rsp[0] = (uint8_t)pmbus_write(&pmbusobj_Buck, msg[4], (volatile uint8_t*)&msg[5], (_write - 1));
+        return(1);
+    }
+
+    if (_write != 1) return(1); // read transactions only carry the command code
+
+    _n = pmbus_read(&pmbusobj_Buck, msg[4], _data);
+    if ((_n == 0) || (_read != (_n + (_use_pec ? 1 : 0)))) return(1);
+
+    rsp[0] = 1; // ACK
+    memcpy(&rsp[1], _data, _n);
+    if (_use_pec)
+    {
+        _pec = sim_smbus_pec(_pec, &msg[4], 1);
+        _pec = sim_smbus_pec(_pec, &_addr[1], 1);
+        rsp[1 + _n] = sim_smbus_pec(_pec, _data, _n);
+    }
+
+    return(1 + _read);
+}
+
+static double sim_noise(SIM_PLANT_t* plant, double amplitude)
+{
+    plant->noise = (plant->noise * 1664525U) + 1013904223U;
+    return(amplitude * (((double)(plant->noise >> 8) / (double)(1U << 24)) - 0.5));
+}
+
+static uint16_t sim_ticks(double voltage)
+{
+    double _ticks = (voltage / ADC_GRAN);
+
+    if (_ticks < 0.0) return(0);
+    if (_ticks > ADC_VALUE_MAX) return(ADC_VALUE_MAX);
+    return((uint16_t)_ticks);
+}
+
+/*!sim_control_cycle()
+ *****************************************************************************
+ * Summary:
+ * Advances the plant by one switching period and runs the control interrupt code
+ *
+ * Description:
+ * The voltage loop is modeled as first order response to the voltage
+ * reference, load steps cause an output voltage dip proportional to the
+ * current step. Phase currents follow the load current with a small
+ * imbalance. After the plant update the ADC results, loop outputs and duty
+ * cycles are written into the converter object as the control interrupt
+ * would, followed by the telemetry and capture functions of the firmware.
+ *
+ *****************************************************************************/
+
+static void sim_control_cycle(SIM_PLANT_t* plant)
+{
+    const double _dt = (1.0 / SWITCHING_FREQUENCY);
+    double _v_ref = 0.0;
+    double _duty = 0.0;
+    double _i_load = 0.0;
+    uint16_t _i=0;
+
+    if (buck.mode == BUCK_STATE_ONLINE) 
+        _i_load = plant->i_load; // no output current while the converter is off
+    _v_ref = ((double)buck.v_loop.reference * ADC_GRAN / BUCK_VOUT_FEEDBACK_GAIN);
+    plant->v_out += ((_v_ref - plant->v_out) * _dt / 200.0e-6);
+    plant->i_phase[0] += (((0.52 * _i_load) - plant->i_phase[0]) * _dt / 50.0e-6);
+    plant->i_phase[1] += (((0.48 * _i_load) - plant->i_phase[1]) * _dt / 50.0e-6);
+
+    buck.data.v_in = sim_ticks((plant->v_in + sim_noise(plant, 0.2)) * BUCK_VIN_FEEDBACK_GAIN);
+    buck.data.v_out = sim_ticks((plant->v_out + sim_noise(plant, 0.02)) * BUCK_VOUT_FEEDBACK_GAIN);
+    for (_i=0; _i<2; _i++)
+    {
+        buck.data.i_sns[_i] = sim_ticks((plant->i_phase[_i] + sim_noise(plant, 0.1)) *
+                        BUCK_ISNS_FEEDBACK_GAIN + BUCK_ISNS1_FEEDBACK_OFFSET);
+        buck.i_loop[_i].reference = buck.data.i_sns[_i];
+    }
+    buck.data.i_out = (buck.data.i_sns[0] + buck.data.i_sns[1]);
+
+    _duty = ((plant->v_out / plant->v_in) * BUCK_PWM_PERIOD);
+    PG2DC = (uint16_t)(_duty + sim_noise(plant, 4.0));
+    PG4DC = (uint16_t)(_duty + sim_noise(plant, 4.0));
+
+    // Firmware code of the control interrupt
+    telem_sample(&telemobj_Buck);
+    capture_sample(&capobj_Buck);
+    stats_sample(&statsobj_Buck);
+    param_apply(&paramobj_Buck);
+}
+
+static void sim_initialize(SIM_PLANT_t* plant, uint16_t address)
+{
+    volatile uint16_t _i=0;
+
+    memset(plant, 0, sizeof(SIM_PLANT_t));
+    plant->v_in = BUCK_VIN_NOMINAL;
+    plant->v_out = BUCK_VOUT_NOMINAL;
+    plant->i_load = 2.0;
+    plant->noise = 12345;
+
+    // Converter object in normal operation
+    buck.mode = BUCK_STATE_ONLINE;
+    buck.set_values.v_ref = BUCK_VOUT_REF;
+    buck.v_loop.reference = BUCK_VOUT_REF;
+    buck.data.temp = 1000;
+    buck.status.bits.enabled = true;
+    buck.status.bits.autorun = true;
+    buck.i_loop[0].feedback_offset = BUCK_ISNS1_OFFFSET;
+    buck.i_loop[1].feedback_offset = BUCK_ISNS2_OFFFSET;
+    buck.v_loop.controller = &v_loop;
+    buck.i_loop[0].controller = &i_loop_1;
+    buck.i_loop[1].controller = &i_loop_2;
+    buck.startup.v_ramp.ref_inc_step = BUCK_VREF_STEP;
+    buck.startup.i_ramp.ref_inc_step = ((BUCK_IREF_STEP > 0) ? BUCK_IREF_STEP : 1);
+    buck.startup.i_load = BUCK_ISNS_LOAD;
+
+    v_loop.Ports.Target.ptrAddress = &buck.i_loop[0].reference;
+    v_loop.Limits.MinOutput = 0;
+    v_loop.Limits.MaxOutput = BUCK_ISNS_REF_MAX;
+    i_loop_1.Ports.Target.ptrAddress = &PG2DC;
+    i_loop_2.Ports.Target.ptrAddress = &PG4DC;
+    v_loop.status.bits.enabled = true;
+    for (_i=0; _i<2; _i++)
+    {
+        buck.i_loop[_i].controller->Limits.MinOutput = BUCK_PWM_DC_MIN;
+        buck.i_loop[_i].controller->Limits.MaxOutput = BUCK_PWM_DC_MAX;
+        buck.i_loop[_i].controller->status.bits.enabled = true;
+    }
+
+    for (_i=0; _i<FLT_BUCK_COUNT; _i++)
+    {
+        fltengine_Buck.trip_level[_i] = fltdef_Buck[_i].trip_level;
+        fltengine_Buck.reset_level[_i] = fltdef_Buck[_i].reset_level;
+    }
+    fltengine_Buck.size = FLT_BUCK_COUNT;
+
+    appTelemetry_Initialize();
+    appCapture_Initialize();
+    appStats_Initialize();
+    appParams_Initialize();
+    appPMBus_Initialize();
+    appSequencer_Initialize();
+    appSettings_Initialize();
+    if ((!settingsobj_Buck.status.bits.valid) && (address != 0))
+        settingsobj_Buck.address = address;
+    appUart_Initialize();
+    U1STAbits.TRMT = 1;
+}
+
+static void sim_signal(int signal)
+{
+    (void)signal;
+    sim_stop = 1;
+}
+
+int main(int argc, char** argv)
+{
+    const char* _link = NULL;
+    const char* _bus = NULL;
+    const char* _serial_bus = NULL;
+    uint16_t _address = 0;
+    FILE* _file = NULL;
+    double _baudrate = UART_BAUDRATE;
+    long _load_period = 50;
+    long _fault_time = -1;
+    long _run_time = 0;
+    long _modules = 0;
+    int _retval = 0;
+    SIM_PLANT_t _plant;
+    struct timespec _next;
+    struct termios _tio;
+    uint8_t _rx[256];
+    uint8_t _tx[1024];
+    size_t _tx_pending = 0;
+    double _tx_budget = 0.0;
+    long _tick = 0;
+    ssize_t _n = 0;
+    uint8_t _byte = 0;
+    char _name[64];
+    int _master = 0;
+    int _slave = 0;
+    int _listen = -1;
+    int _client = -1;
+    struct sockaddr_un _sa;
+    uint8_t _msg[64];
+    uint8_t _rsp[8];
+    int _opt = 0;
+    uint32_t _c = 0;
+
+    while ((_opt = getopt(argc, argv, "l:B:a:n:i:b:L:F:N:t:")) != -1)
+    {
+        switch (_opt)
+        {
+            case 'l': _link = optarg; break;
+            case 'B': _serial_bus = optarg; break;
+            case 'a': _address = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 'n': sim_nvm_file = optarg; break;
+            case 'i': _bus = optarg; break;
+            case 'b': _baudrate = atof(optarg); break;
+            case 'L': _load_period = atol(optarg); break;
+            case 'F': _fault_time = atol(optarg); break;
+            case 'N': _modules = atol(optarg); break;
+            case 't': _run_time = atol(optarg) * 1000; break;
+            default:
+                fprintf(stderr, "usage: epc_sim [-l link | -B socket] [-a address] [-n file] [-i socket] [-b baudrate]\n"
+                                "               [-L load_step_ms] [-F fault_ms] [-N modules] [-t seconds]\n");
+                return(2);
+        }
+    }
+    if ((_address != 0) && ((_address < FRAME_ADDRESS_MIN) || (_address > FRAME_ADDRESS_MAX)))
+    {
+        fprintf(stderr, "invalid address %u\n", _address);
+        return(2);
+    }
+    if ((_modules < 0) || (_modules > RACK_MODULES_MAX))
+    {
+        fprintf(stderr, "invalid number of modules %ld (maximum %u)\n", _modules, RACK_MODULES_MAX);
+        return(2);
+    }
+
+    // Settings flash page: erased unless loaded from file
+    memset(sim_nvm, 0xFF, sizeof(sim_nvm));
+    if ((sim_nvm_file != NULL) && ((_file = fopen(sim_nvm_file, "rb")) != NULL))
+    {
+        if (fread(sim_nvm, sizeof(uint16_t), NVM_PAGE_WORDS, _file) != NVM_PAGE_WORDS)
+            memset(sim_nvm, 0xFF, sizeof(sim_nvm));
+        fclose(_file);
+    }
+
+    if (_serial_bus != NULL)
+    {
+        // Virtual serial bus: each message is one transmission of a participant
+        memset(&_sa, 0, sizeof(_sa));
+        _sa.sun_family = AF_UNIX;
+        strncpy(_sa.sun_path, _serial_bus, (sizeof(_sa.sun_path) - 1));
+        _master = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        _slave = -1;
+        if ((_master < 0) || (connect(_master, (struct sockaddr*)&_sa, sizeof(_sa)) < 0))
+        {
+            perror(_serial_bus);
+            return(1);
+        }
+        fcntl(_master, F_SETFL, O_NONBLOCK);
+        snprintf(_name, sizeof(_name), "%s", _serial_bus);
+    }
+    else if (openpty(&_master, &_slave, _name, NULL, NULL) < 0)
+    {
+        perror("openpty");
+        return(1);
+    }
+    else
+    {
+        tcgetattr(_slave, &_tio);   // the slave stays open, so the master never reports a hang-up
+        cfmakeraw(&_tio);
+        tcsetattr(_slave, TCSANOW, &_tio);
+        fcntl(_master, F_SETFL, O_NONBLOCK);
+    }
+
+    if ((_link != NULL) && (_serial_bus == NULL))
+    {
+        unlink(_link);
+        if (symlink(_name, _link) < 0)
+        {
+            perror(_link);
+            return(1);
+        }
+    }
+    if (_bus != NULL)
+    {
+        memset(&_sa, 0, sizeof(_sa));
+        _sa.sun_family = AF_UNIX;
+        strncpy(_sa.sun_path, _bus, (sizeof(_sa.sun_path) - 1));
+        unlink(_bus);
+        _listen = socket(AF_UNIX, (SOCK_SEQPACKET | SOCK_NONBLOCK), 0);
+        if ((_listen < 0) || (bind(_listen, (struct sockaddr*)&_sa, sizeof(_sa)) < 0) || 
+            (listen(_listen, 1) < 0))
+        {
+            perror(_bus);
+            return(1);
+        }
+    }
+    printf("%s\n", _name);
+    fflush(stdout);
+
+    signal(SIGINT, sim_signal);
+    signal(SIGTERM, sim_signal);
+
+    sim_initialize(&_plant, _address);
+    if ((_modules > 0) && (rack_start((uint16_t)_modules) != 0))
+    {
+        fprintf(stderr, "converter driver instances could not be started\n");
+        _retval = 1;
+        sim_stop = 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &_next);
+
+    while ((!sim_stop) && ((_run_time == 0) || (_tick < _run_time)))
+    {
+        // Receive: pseudo terminal -> receive ring buffer (receive interrupt)
+        while ((_n = read(_master, _rx, sizeof(_rx))) > 0)
+        {
+            for (_c=0; _c<(uint32_t)_n; _c++)
+                uart_ring_put(&uartdrv_Buck.rx, _rx[_c]);
+        }
+        if ((_n == 0) && (_serial_bus != NULL))
+            break; // virtual serial bus terminated
+
+        // Power stage and control interrupt
+        if ((_load_period > 0) && (_tick > 0) && ((_tick % _load_period) == 0))
+        {
+            _plant.v_out -= (0.05 * ((_plant.i_load < 6.0) ? 8.0 : -8.0)); // load step transient
+            _plant.i_load = ((_plant.i_load < 6.0) ? 10.0 : 2.0);
+        }
+        if (_tick == _fault_time)
+        {
+            fltengine_Buck.status |= FLT_MASK_BUCK_OCP;
+            buck.mode = BUCK_STATE_SUSPEND;
+            _plant.i_load = 0.0;
+            buck.v_loop.reference = 0;
+        }
+        for (_c=0; _c<SIM_CYCLES_PER_TICK; _c++)
+            sim_control_cycle(&_plant);
+
+        // I2C bus stand-in: one bus master at a time, transactions are executed in task context
+        if ((_listen >= 0) && (_client < 0) && ((_client = accept(_listen, NULL, NULL)) >= 0))
+            fcntl(_client, F_SETFL, O_NONBLOCK);
+        while ((_client >= 0) && ((_n = recv(_client, _msg, sizeof(_msg), 0)) != 0))
+        {
+            if (_n < 0)
+            {
+                if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) { close(_client); _client = -1; }
+                break;
+            }
+            send(_client, _rsp, sim_smbus_transaction(_msg, (size_t)_n, _rsp), MSG_NOSIGNAL);
+        }
+        if ((_client >= 0) && (_n == 0)) { close(_client); _client = -1; } // bus master disconnected
+
+        // Application tasks of the medium scheduler tier
+        appStats_Execute();
+        appUart_Execute();
+        appSequencer_Execute();
+
+        // Converter state machine: restarts from standby while the autorun option is set
+        if ((buck.mode != BUCK_STATE_ONLINE) && (buck.mode != BUCK_STATE_SUSPEND))
+            buck.mode = (buck.status.bits.autorun ? BUCK_STATE_ONLINE : BUCK_STATE_STANDBY);
+        if (buck.mode == BUCK_STATE_ONLINE)
+            buck.v_loop.reference = buck.set_values.v_ref;
+        else
+            buck.v_loop.reference = 0;
+
+        // Transmit: transmit ring buffer -> pseudo terminal at the emulated baud rate
+        _tx_budget += (_baudrate / 10.0 / 1000.0);
+        while ((_tx_pending < sizeof(_tx)) && (_tx_budget >= 1.0) &&
+               (uart_ring_get(&uartdrv_Buck.tx, &_byte)))
+        {
+            _tx[_tx_pending++] = _byte;
+            _tx_budget -= 1.0;
+        }
+        if (_tx_budget > 1.0) _tx_budget = 1.0; // no bursts after idle periods
+        if (_tx_pending > 0)
+        {
+            _n = write(_master, _tx, _tx_pending);
+            if (_n > 0)
+            {
+                memmove(_tx, &_tx[_n], (_tx_pending - (size_t)_n));
+                _tx_pending -= (size_t)_n;
+            }
+        }
+
+        // Wait for next step
+        _tick++;
+        _next.tv_nsec += SIM_TICK_NS;
+        if (_next.tv_nsec >= 1000000000L)
+        {
+            _next.tv_nsec -= 1000000000L;
+            _next.tv_sec++;
+        }
+        while ((clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &_next, NULL) == EINTR) && (!sim_stop));
+    }
+
+    if (_modules > 0)
+        _retval += rack_stop();
+
+    if ((_link != NULL) && (_serial_bus == NULL))
+        unlink(_link);
+    if (_bus != NULL)
+        unlink(_bus);
+    if (_client >= 0) close(_client);
+    if (_listen >= 0) close(_listen);
+    close(_master);
+    if (_slave >= 0) close(_slave);
+
+    return(_retval);
+}
@@ -0,0 +1,14 @@
+/*
+ * File:   dsp.h
+ * Author: M91406
+ * Comments: host-native replacement of the XC16 DSP library header (epc_sim)
+ * Revision history:
+ * 1.0  initial release
+ */
+
+#ifndef EPC_SIM_DSP_HEADER_H
+#define	EPC_SIM_DSP_HEADER_H
+
+typedef int fractional;
+
+#endif	/* EPC_SIM_DSP_HEADER_H */
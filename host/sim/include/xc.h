@@ -0,0 +1,48 @@
+/*
+ * File:   xc.h
+ * Author: M91406
+ * Comments: host-native replacement of the XC16 device header for the firmware
+ *           simulation (epc_sim). Declares the special function registers used
+ *           by the firmware modules included in the simulation build.
+ * Revision history:
+ * 1.0  initial release
+ */
+
+#ifndef EPC_SIM_XC_HEADER_H
+#define	EPC_SIM_XC_HEADER_H
+
+#include <stdint.h>
+
+// Compiler built-ins and instructions
+#define Nop()
+#define ClrWdt()
+#define __builtin_muluu(a,b) ((uint32_t)(uint16_t)(a) * (uint32_t)(uint16_t)(b))
+#define __builtin_mulss(a,b) ((int32_t)(int16_t)(a) * (int32_t)(int16_t)(b))
+#define __builtin_mulsu(a,b) ((int32_t)(int16_t)(a) * (int32_t)(uint16_t)(b))
+#define __builtin_divud(a,b) ((uint16_t)((uint32_t)(a) / (uint16_t)(b)))
+#define __builtin_divsd(a,b) ((int16_t)((int32_t)(a) / (int16_t)(b)))
+
+// Interrupt service routines are compiled as plain functions
+#define __interrupt__   __unused__
+#define auto_psv        __unused__
+#define no_auto_psv     __unused__
+#define context         __unused__
+
+// UART #1 registers
+typedef struct {
+    unsigned OERR:1, FERR:1, TRMT:1, RIDLE:1;
+} SIM_U1STA_BITS_t;
+
+typedef struct {
+    unsigned URXBE:1, URXBF:1, UTXBE:1, UTXBF:1;
+} SIM_U1STAH_BITS_t;
+
+extern volatile uint16_t U1RXREG, U1TXREG;
+extern volatile SIM_U1STA_BITS_t U1STAbits;
+extern volatile SIM_U1STAH_BITS_t U1STAHbits;
+extern volatile uint16_t _U1RXIE, _U1RXIF, _U1RXIP, _U1TXIE, _U1TXIF, _U1TXIP;
+
+// PWM duty cycle registers
+extern volatile uint16_t PG2DC, PG4DC;
+
+#endif	/* EPC_SIM_XC_HEADER_H */